@@ -27,6 +27,8 @@
 #include <TDMon/constants.h>
 
 #include <TGUI/TGUI.hpp>
+#include <chrono>
+#include <optional>
 
 namespace tdmon {
 /**
@@ -64,10 +66,51 @@ class ApplicationState {
    */
   virtual void cleanup(tgui::GuiSFML& gui) = 0;
 
+  /**
+   * @brief Hide this application state when switching to another one. The gui
+   * elements added in init() and other resources are kept, so the state can be
+   * resumed later without calling init() again.
+   * @param gui The gui
+   */
+  virtual void suspend(tgui::GuiSFML& gui) = 0;
+
+  /**
+   * @brief Show this application state again after suspend(). Resets the
+   * requested application state change to kNull.
+   * @param gui The gui
+   */
+  virtual void resume(tgui::GuiSFML& gui) = 0;
+
   /**
    * @brief Get the type of application state for this object
    * @return The application state type for this object
    */
   virtual SupportedApplicationStateTypes getApplicationStateType() const = 0;
+
+  /**
+   * @brief Get whether update() must be called regularly, even if no events
+   * occur, e.g. to check for the results of background work. Otherwise, the
+   * application waits for the next event while idle.
+   * @return true, if updates are needed without events
+   */
+  virtual bool needsUpdatesWithoutEvents() const = 0;
+
+  /**
+   * @brief Get the time until update() must be called next, even if no events
+   * occur, e.g. to revalidate data once it is outdated. Only used while
+   * needsUpdatesWithoutEvents() returns false.
+   * @return The time until the next update. Empty, if update() is only needed
+   * in reaction to events.
+   */
+  virtual std::optional<std::chrono::microseconds> getTimeUntilNextUpdate()
+      const = 0;
+
+  /**
+   * @brief Get whether update() changed the gui since the last call, so the
+   * window must be redrawn. Changes made in reaction to events do not need to
+   * be reported, since events always cause a redraw.
+   * @return true, if a redraw is needed. Resets the request.
+   */
+  virtual bool takeRedrawRequest() = 0;
 };
 }  // namespace tdmon
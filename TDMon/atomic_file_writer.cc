@@ -0,0 +1,151 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/atomic_file_writer.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace tdmon {
+namespace {
+/**
+ * @brief Write contents to a new file and flush it to the storage device.
+ * Throws, if this fails.
+ * @param path The path of the file. Replaced, if it exists.
+ * @param contents The contents
+ */
+void writeAndFlush(const std::filesystem::path& path,
+                   std::span<const char> contents) {
+  const std::string error_message = "Cannot write file: " + path.string();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr,
+                            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error(error_message);
+  }
+
+  bool success = true;
+  std::size_t offset = 0;
+  while (success && offset < contents.size()) {
+    const DWORD chunk_size = static_cast<DWORD>(
+        std::min<std::size_t>(contents.size() - offset, 1 << 30));
+    DWORD written_size = 0;
+    success = WriteFile(file, contents.data() + offset, chunk_size,
+                        &written_size, nullptr);
+    offset += written_size;
+  }
+  success = success && FlushFileBuffers(file);
+  CloseHandle(file);
+#else
+  const int file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (file == -1) {
+    throw std::runtime_error(error_message);
+  }
+
+  bool success = true;
+  std::size_t offset = 0;
+  while (success && offset < contents.size()) {
+    const ssize_t written_size =
+        ::write(file, contents.data() + offset, contents.size() - offset);
+    if (written_size >= 0) {
+      offset += static_cast<std::size_t>(written_size);
+    } else {
+      success = errno == EINTR;
+    }
+  }
+  success = success && fsync(file) == 0;
+  success = ::close(file) == 0 && success;
+#endif
+
+  if (!success) {
+    std::error_code ignored_error;
+    std::filesystem::remove(path, ignored_error);
+    throw std::runtime_error(error_message);
+  }
+}
+
+/**
+ * @brief Replace a file by another one atomically, and make sure the change
+ * reaches the storage device. Throws, if this fails.
+ * @param source The file to rename
+ * @param target The file to replace
+ */
+void replaceFile(const std::filesystem::path& source,
+                 const std::filesystem::path& target) {
+#ifdef _WIN32
+  if (!MoveFileExW(source.c_str(), target.c_str(),
+                   MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    std::error_code ignored_error;
+    std::filesystem::remove(source, ignored_error);
+    throw std::runtime_error("Cannot replace file: " + target.string());
+  }
+#else
+  std::error_code error;
+  std::filesystem::rename(source, target, error);
+  if (error) {
+    std::filesystem::remove(source, error);
+    throw std::runtime_error("Cannot replace file: " + target.string());
+  }
+
+  // the rename is only persistent, once the directory is flushed. Not all
+  // file systems support this, so failures are ignored
+  std::filesystem::path directory = target.parent_path();
+  if (directory.empty()) {
+    directory = ".";
+  }
+  const int directory_file = ::open(directory.c_str(), O_RDONLY);
+  if (directory_file != -1) {
+    fsync(directory_file);
+    ::close(directory_file);
+  }
+#endif
+}
+}  // namespace
+
+void AtomicFileWriter::write(const std::filesystem::path& path,
+                             std::span<const char> contents) {
+  const std::filesystem::path temporary_path = getTemporaryPath(path);
+  writeAndFlush(temporary_path, contents);
+  replaceFile(temporary_path, path);
+}
+
+std::filesystem::path AtomicFileWriter::getTemporaryPath(
+    const std::filesystem::path& path) {
+  std::filesystem::path temporary_path = path;
+  temporary_path += ".tmp";
+  return temporary_path;
+}
+}  // namespace tdmon
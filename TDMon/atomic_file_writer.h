@@ -0,0 +1,56 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+namespace tdmon {
+/**
+ * @brief Writes files crash-safely. The contents are written to a temporary
+ * file next to the target (<path>.tmp), which is flushed to the storage device
+ * and then renamed to the target. Renaming replaces the target atomically, so
+ * if the application is killed at any moment, the target contains either the
+ * old or the new contents, never a mix or a truncated file.
+ */
+class AtomicFileWriter {
+ public:
+  /**
+   * @brief Write a file atomically. Throws, if the file cannot be written.
+   * The target is unchanged in that case.
+   * @param path The path of the file
+   * @param contents The new contents of the file
+   */
+  static void write(const std::filesystem::path& path,
+                    std::span<const char> contents);
+
+  /**
+   * @brief Get the path of the temporary file used when writing a file
+   * @param path The path of the file
+   * @return The path of the temporary file
+   */
+  static std::filesystem::path getTemporaryPath(
+      const std::filesystem::path& path);
+};
+}  // namespace tdmon
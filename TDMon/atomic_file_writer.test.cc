@@ -0,0 +1,60 @@
+#include <TDMon/atomic_file_writer.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief Helper function. Read a whole file.
+ * @param path The path of the file
+ * @return The contents of the file
+ */
+std::string readWholeFile(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Test, if files are created and replaced, without leaving the
+ * temporary file behind
+ */
+TEST(AtomicFileWriter, CreatesAndReplacesFiles) {
+  const std::filesystem::path path = "./test_atomic_file_writer.txt";
+  std::filesystem::remove(path);
+
+  const std::string first_contents = "first contents, which are longer";
+  AtomicFileWriter::write(path, first_contents);
+  EXPECT_EQ(readWholeFile(path), first_contents);
+
+  const std::string second_contents = "second contents";
+  AtomicFileWriter::write(path, second_contents);
+  EXPECT_EQ(readWholeFile(path), second_contents);
+
+  AtomicFileWriter::write(path, std::string());
+  EXPECT_EQ(std::filesystem::file_size(path), 0);
+
+  EXPECT_FALSE(
+      std::filesystem::exists(AtomicFileWriter::getTemporaryPath(path)));
+  std::filesystem::remove(path);
+}
+
+/**
+ * @brief Test, if the target is unchanged, if it cannot be written
+ */
+TEST(AtomicFileWriter, KeepsTargetOnErrors) {
+  const std::filesystem::path path = "./test_atomic_file_writer_directory";
+  std::filesystem::remove_all(path);
+  std::filesystem::create_directory(path);
+
+  // a directory cannot be replaced by a file
+  EXPECT_ANY_THROW(AtomicFileWriter::write(path, std::string("contents")));
+  EXPECT_TRUE(std::filesystem::is_directory(path));
+  EXPECT_FALSE(
+      std::filesystem::exists(AtomicFileWriter::getTemporaryPath(path)));
+
+  std::filesystem::remove_all(path);
+}
+}  // namespace tdmon
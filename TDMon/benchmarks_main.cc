@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief The entry point of the benchmarks. Unless an output file is given on
+ * the command line (--benchmark_out), the results are also written as json to
+ * kDefaultBenchmarkOutputPath, so results of different builds can be compared.
+ */
+int main(int argc, char** argv) {
+  const std::string kDefaultBenchmarkOutputPath = "TDMonBenchmarks.json";
+
+  std::vector<std::string> arguments(argv, argv + argc);
+  bool has_output_argument = false;
+  for (const std::string& argument : arguments) {
+    has_output_argument |= std::string_view(argument).starts_with(
+        "--benchmark_out=");
+  }
+  if (!has_output_argument) {
+    arguments.push_back("--benchmark_out=" + kDefaultBenchmarkOutputPath);
+    arguments.push_back("--benchmark_out_format=json");
+  }
+
+  std::vector<char*> argument_pointers;
+  for (std::string& argument : arguments) {
+    argument_pointers.push_back(argument.data());
+  }
+  int argument_count = static_cast<int>(argument_pointers.size());
+
+  benchmark::Initialize(&argument_count, argument_pointers.data());
+  if (benchmark::ReportUnrecognizedArguments(argument_count,
+                                             argument_pointers.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,757 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/columnar_issue_store.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace tdmon {
+namespace {
+/**
+ * @brief The number of issues per block of the bitmaps
+ */
+const std::size_t kBlockSize = 64;
+
+/**
+ * @brief The sections of a snapshot, in the order they are stored in
+ */
+enum SnapshotSection : std::size_t {
+  kUserOffsets,
+  kUserCharacters,
+  kIssueTypeOffsets,
+  kIssueTypeCharacters,
+  kIssueTypeIds,
+  kAssigneeIds,
+  kReporterIds,
+  kWatchCounts,
+  kResolutionDates,
+  kResolvedBitmap,
+  kHasKeyBitmap,
+  kSnapshotSectionCount
+};
+
+/**
+ * @brief The position of a section in a snapshot
+ */
+struct SnapshotSectionDescriptor {
+  /**
+   * @brief The offset of the section from the start of the snapshot in bytes
+   */
+  std::uint64_t offset = 0;
+
+  /**
+   * @brief The size of the section in bytes
+   */
+  std::uint64_t size = 0;
+};
+
+/**
+ * @brief The header at the start of a snapshot
+ */
+struct SnapshotHeader {
+  /**
+   * @brief Identifies the file as snapshot. Equal to kSnapshotMagic.
+   */
+  std::array<char, 8> magic = {};
+
+  /**
+   * @brief The version of the snapshot format
+   */
+  std::uint32_t format_version = 0;
+
+  /**
+   * @brief Equal to kSnapshotByteOrderMark, if the snapshot was written with
+   * the native byte order
+   */
+  std::uint32_t byte_order_mark = 0;
+
+  /**
+   * @brief The number of issues
+   */
+  std::uint64_t issue_count = 0;
+
+  /**
+   * @brief DatabaseFileState::file_size of the source database
+   */
+  std::uint64_t source_file_size = 0;
+
+  /**
+   * @brief DatabaseFileState::last_write_time of the source database
+   */
+  std::int64_t source_last_write_time = 0;
+
+  /**
+   * @brief DatabaseFileState::file_change_counter of the source database
+   */
+  std::uint32_t source_file_change_counter = 0;
+
+  /**
+   * @brief Unused. Keeps the sections 8 byte aligned.
+   */
+  std::uint32_t reserved = 0;
+
+  /**
+   * @brief The positions of all sections
+   */
+  std::array<SnapshotSectionDescriptor, kSnapshotSectionCount> sections = {};
+};
+
+/**
+ * @brief The magic bytes at the start of every snapshot
+ */
+const std::array<char, 8> kSnapshotMagic = {'T', 'D', 'M', 'O',
+                                            'N', 'S', 'N', 'P'};
+
+/**
+ * @brief Written to the header to detect snapshots with another byte order
+ */
+const std::uint32_t kSnapshotByteOrderMark = 0x01020304;
+
+/**
+ * @brief Parse a fixed width, unsigned decimal number
+ * @param text The text to parse
+ * @param value Receives the parsed number
+ * @return true, if the whole text is a number
+ */
+bool parseNumber(std::string_view text, int& value) {
+  const auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  return error == std::errc() && end == text.data() + text.size();
+}
+
+/**
+ * @brief Set a bit in a bitmap
+ * @param bitmap The bitmap
+ * @param index The index of the bit
+ * @param value The value of the bit
+ */
+void setBit(std::vector<std::uint64_t>& bitmap, std::size_t index, bool value) {
+  bitmap[index / kBlockSize] |= static_cast<std::uint64_t>(value)
+                                << (index % kBlockSize);
+}
+
+/**
+ * @brief Round a size up to the next multiple of the snapshot alignment
+ * @param size The size
+ * @return The aligned size
+ */
+std::uint64_t alignSnapshotOffset(std::uint64_t size) {
+  const std::uint64_t alignment = ColumnarIssueStore::kSnapshotAlignment;
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief Read the header of a snapshot image. Does not validate it.
+ * @param image The snapshot image
+ * @param header Receives the header
+ * @return true, if the image is large enough to contain a header
+ */
+bool readSnapshotHeader(std::span<const std::byte> image,
+                        SnapshotHeader& header) {
+  if (image.size() < sizeof(SnapshotHeader)) {
+    return false;
+  }
+  std::memcpy(&header, image.data(), sizeof(SnapshotHeader));
+  return true;
+}
+
+/**
+ * @brief Get the bytes of a vector
+ * @param values The vector
+ * @return The bytes of all elements
+ */
+template <typename T>
+std::span<const std::byte> asBytes(const std::vector<T>& values) {
+  return std::as_bytes(std::span<const T>(values));
+}
+
+/**
+ * @brief Get a section of a snapshot image as span of values. The bounds and
+ * alignment of the section must have been validated before.
+ * @param image The snapshot image
+ * @param section The section descriptor
+ * @return The values in the section
+ */
+template <typename T>
+std::span<const T> getSnapshotSection(
+    std::span<const std::byte> image,
+    const SnapshotSectionDescriptor& section) {
+  return {reinterpret_cast<const T*>(image.data() + section.offset),
+          static_cast<std::size_t>(section.size / sizeof(T))};
+}
+
+/**
+ * @brief Sort a dictionary, so strings can be looked up using binary search,
+ * and encode it as offsets and characters.
+ * @param strings_by_id The strings of the dictionary, indexed by their id
+ * @param offsets Receives the offsets of the sorted strings
+ * @param characters Receives the characters of the sorted strings
+ * @return For each old id, the new id of the string
+ */
+std::vector<std::uint32_t> sortAndEncodeDictionary(
+    const std::vector<std::string>& strings_by_id,
+    std::vector<std::uint32_t>& offsets, std::vector<char>& characters) {
+  std::vector<std::uint32_t> sorted_ids(strings_by_id.size());
+  std::iota(sorted_ids.begin(), sorted_ids.end(), 0);
+  std::sort(sorted_ids.begin(), sorted_ids.end(),
+            [&strings_by_id](std::uint32_t a, std::uint32_t b) {
+              return strings_by_id[a] < strings_by_id[b];
+            });
+
+  std::vector<std::uint32_t> new_ids(strings_by_id.size());
+  offsets.clear();
+  characters.clear();
+  for (std::uint32_t new_id = 0; new_id < sorted_ids.size(); ++new_id) {
+    const std::string& value = strings_by_id[sorted_ids[new_id]];
+    new_ids[sorted_ids[new_id]] = new_id;
+    offsets.push_back(static_cast<std::uint32_t>(characters.size()));
+    characters.insert(characters.end(), value.begin(), value.end());
+  }
+  offsets.push_back(static_cast<std::uint32_t>(characters.size()));
+
+  return new_ids;
+}
+}  // namespace
+
+const std::size_t ColumnarIssueStore::kMaxIssueTypeCount;
+
+const std::uint32_t ColumnarIssueStore::kNotFound;
+
+const std::uint32_t ColumnarIssueStore::kSnapshotFormatVersion;
+
+const std::size_t ColumnarIssueStore::kSnapshotAlignment;
+
+ColumnarIssueStore::ColumnarIssueStore() = default;
+
+ColumnarIssueStore::ColumnarIssueStore(ColumnarIssueStore&& other) noexcept {
+  *this = std::move(other);
+}
+
+ColumnarIssueStore& ColumnarIssueStore::operator=(
+    ColumnarIssueStore&& other) noexcept {
+  if (this != &other) {
+    // moving the owned image and the mapped file keeps the addresses of their
+    // data, so the spans stay valid
+    owned_snapshot_image_ = std::move(other.owned_snapshot_image_);
+    mapped_snapshot_file_ = std::move(other.mapped_snapshot_file_);
+    snapshot_image_ = other.snapshot_image_;
+    issue_count_ = other.issue_count_;
+    users_ = other.users_;
+    issue_types_ = other.issue_types_;
+    issue_type_ids_ = other.issue_type_ids_;
+    assignee_ids_ = other.assignee_ids_;
+    reporter_ids_ = other.reporter_ids_;
+    watch_counts_ = other.watch_counts_;
+    resolution_dates_ = other.resolution_dates_;
+    resolved_bitmap_ = other.resolved_bitmap_;
+    has_key_bitmap_ = other.has_key_bitmap_;
+    other.clear();
+  }
+  return *this;
+}
+
+void ColumnarIssueStore::loadFromDatabase(const std::filesystem::path& path,
+                                          const std::string& table_name) {
+  SQLite::Database db(path.string(), SQLite::OPEN_READONLY);
+
+  std::size_t issue_count = 0;
+  {
+    SQLite::Statement count_query(db, "SELECT COUNT(*) FROM " + table_name);
+    if (count_query.executeStep()) {
+      issue_count =
+          static_cast<std::size_t>(count_query.getColumn(0).getInt64());
+    }
+  }
+
+  std::unordered_map<std::string, std::uint32_t> user_ids_by_identifier;
+  std::unordered_map<std::string, std::uint32_t> issue_type_ids_by_name;
+  std::vector<std::uint8_t> issue_type_ids;
+  std::vector<std::uint32_t> assignee_ids;
+  std::vector<std::uint32_t> reporter_ids;
+  std::vector<std::uint32_t> watch_counts;
+  std::vector<std::int64_t> resolution_dates;
+  std::vector<std::uint64_t> resolved_bitmap;
+  std::vector<std::uint64_t> has_key_bitmap;
+  issue_type_ids.reserve(issue_count);
+  assignee_ids.reserve(issue_count);
+  reporter_ids.reserve(issue_count);
+  watch_counts.reserve(issue_count);
+  resolution_dates.reserve(issue_count);
+
+  // NULL users never match a user-identifier in the sql queries, so they get
+  // an id that is never looked up
+  auto encode_user = [&user_ids_by_identifier](const SQLite::Column& column) {
+    if (column.isNull()) {
+      return kNotFound;
+    }
+    return user_ids_by_identifier
+        .try_emplace(column.getString(),
+                     static_cast<std::uint32_t>(user_ids_by_identifier.size()))
+        .first->second;
+  };
+
+  SQLite::Statement query(
+      db,
+      "SELECT type, assignee, reporter, resolution_date IS NOT '', "
+      "resolution_date, watch_count, key IS NOT NULL FROM " +
+          table_name);
+
+  std::size_t issue_index = 0;
+  while (query.executeStep()) {
+    const std::string issue_type = query.getColumn(0).getString();
+    auto [issue_type_id, inserted] = issue_type_ids_by_name.try_emplace(
+        issue_type, static_cast<std::uint32_t>(issue_type_ids_by_name.size()));
+    if (inserted && issue_type_ids_by_name.size() > kMaxIssueTypeCount) {
+      throw std::runtime_error(
+          "The dataset contains too many distinct issue types");
+    }
+
+    if (issue_index % kBlockSize == 0) {
+      resolved_bitmap.push_back(0);
+      has_key_bitmap.push_back(0);
+    }
+
+    const bool resolved = query.getColumn(3).getInt() != 0;
+
+    issue_type_ids.push_back(static_cast<std::uint8_t>(issue_type_id->second));
+    assignee_ids.push_back(encode_user(query.getColumn(1)));
+    reporter_ids.push_back(encode_user(query.getColumn(2)));
+    resolution_dates.push_back(
+        resolved && !query.getColumn(4).isNull()
+            ? parseDate(query.getColumn(4).getString())
+            : 0);
+    watch_counts.push_back(
+        static_cast<std::uint32_t>(query.getColumn(5).getInt64()));
+    setBit(resolved_bitmap, issue_index, resolved);
+    setBit(has_key_bitmap, issue_index, query.getColumn(6).getInt() != 0);
+
+    ++issue_index;
+  }
+  issue_count = issue_index;
+
+  // sort the dictionaries, so they can be searched in place when mapped, and
+  // remap the id columns to the sorted ids
+  std::vector<std::string> users_by_id(user_ids_by_identifier.size());
+  for (const auto& [user_identifier, user_id] : user_ids_by_identifier) {
+    users_by_id[user_id] = user_identifier;
+  }
+  std::vector<std::string> issue_types_by_id(issue_type_ids_by_name.size());
+  for (const auto& [issue_type, issue_type_id] : issue_type_ids_by_name) {
+    issue_types_by_id[issue_type_id] = issue_type;
+  }
+
+  std::vector<std::uint32_t> user_offsets;
+  std::vector<char> user_characters;
+  const std::vector<std::uint32_t> new_user_ids =
+      sortAndEncodeDictionary(users_by_id, user_offsets, user_characters);
+  std::vector<std::uint32_t> issue_type_offsets;
+  std::vector<char> issue_type_characters;
+  const std::vector<std::uint32_t> new_issue_type_ids = sortAndEncodeDictionary(
+      issue_types_by_id, issue_type_offsets, issue_type_characters);
+
+  for (std::size_t i = 0; i < issue_count; ++i) {
+    issue_type_ids[i] =
+        static_cast<std::uint8_t>(new_issue_type_ids[issue_type_ids[i]]);
+    if (assignee_ids[i] != kNotFound) {
+      assignee_ids[i] = new_user_ids[assignee_ids[i]];
+    }
+    if (reporter_ids[i] != kNotFound) {
+      reporter_ids[i] = new_user_ids[reporter_ids[i]];
+    }
+  }
+
+  // build the snapshot image
+  std::array<std::span<const std::byte>, kSnapshotSectionCount> sections;
+  sections[kUserOffsets] = asBytes(user_offsets);
+  sections[kUserCharacters] = asBytes(user_characters);
+  sections[kIssueTypeOffsets] = asBytes(issue_type_offsets);
+  sections[kIssueTypeCharacters] = asBytes(issue_type_characters);
+  sections[kIssueTypeIds] = asBytes(issue_type_ids);
+  sections[kAssigneeIds] = asBytes(assignee_ids);
+  sections[kReporterIds] = asBytes(reporter_ids);
+  sections[kWatchCounts] = asBytes(watch_counts);
+  sections[kResolutionDates] = asBytes(resolution_dates);
+  sections[kResolvedBitmap] = asBytes(resolved_bitmap);
+  sections[kHasKeyBitmap] = asBytes(has_key_bitmap);
+
+  SnapshotHeader header;
+  header.magic = kSnapshotMagic;
+  header.format_version = kSnapshotFormatVersion;
+  header.byte_order_mark = kSnapshotByteOrderMark;
+  header.issue_count = issue_count;
+
+  std::uint64_t image_size = sizeof(SnapshotHeader);
+  for (std::size_t section = 0; section < kSnapshotSectionCount; ++section) {
+    header.sections[section].offset = alignSnapshotOffset(image_size);
+    header.sections[section].size = sections[section].size();
+    image_size = header.sections[section].offset + sections[section].size();
+  }
+
+  std::vector<std::uint64_t> image_words(
+      (image_size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+  std::byte* image = reinterpret_cast<std::byte*>(image_words.data());
+  std::memcpy(image, &header, sizeof(SnapshotHeader));
+  for (std::size_t section = 0; section < kSnapshotSectionCount; ++section) {
+    if (!sections[section].empty()) {
+      std::memcpy(image + header.sections[section].offset,
+                  sections[section].data(), sections[section].size());
+    }
+  }
+
+  // build the new contents in a separate store, so this store stays unchanged
+  // if loading fails
+  ColumnarIssueStore store;
+  store.owned_snapshot_image_ = std::move(image_words);
+  if (!store.useSnapshotImage(
+          {image, static_cast<std::size_t>(image_size)})) {
+    throw std::runtime_error("Cannot build the columnar issue store");
+  }
+
+  *this = std::move(store);
+}
+
+void ColumnarIssueStore::writeSnapshot(
+    const std::filesystem::path& path,
+    const DatabaseFileState& source_state) const {
+  SnapshotHeader header;
+  if (!readSnapshotHeader(snapshot_image_, header)) {
+    throw std::runtime_error("The columnar issue store is empty");
+  }
+
+  header.source_file_size = source_state.file_size;
+  header.source_last_write_time = source_state.last_write_time;
+  header.source_file_change_counter = source_state.file_change_counter;
+
+  std::filesystem::path temporary_path = path;
+  temporary_path += ".tmp";
+
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(SnapshotHeader));
+    file.write(
+        reinterpret_cast<const char*>(snapshot_image_.data()) +
+            sizeof(SnapshotHeader),
+        static_cast<std::streamsize>(snapshot_image_.size() -
+                                     sizeof(SnapshotHeader)));
+    file.close();
+    if (!file) {
+      std::filesystem::remove(temporary_path);
+      throw std::runtime_error("Cannot write snapshot: " + path.string());
+    }
+  }
+
+  std::filesystem::rename(temporary_path, path);
+}
+
+bool ColumnarIssueStore::mapSnapshot(const std::filesystem::path& path,
+                                     const DatabaseFileState& source_state) {
+  std::error_code error;
+  if (!std::filesystem::exists(path, error)) {
+    return false;
+  }
+
+  try {
+    ColumnarIssueStore store;
+    store.mapped_snapshot_file_ = MemoryMappedFile(path);
+
+    SnapshotHeader header;
+    if (!store.useSnapshotImage(store.mapped_snapshot_file_.getData()) ||
+        !readSnapshotHeader(store.snapshot_image_, header) ||
+        header.source_file_size != source_state.file_size ||
+        header.source_last_write_time != source_state.last_write_time ||
+        header.source_file_change_counter !=
+            source_state.file_change_counter) {
+      return false;
+    }
+
+    *this = std::move(store);
+    return true;
+  } catch (const std::exception&) {
+    // an unreadable snapshot is treated like a missing one
+    return false;
+  }
+}
+
+std::size_t ColumnarIssueStore::getIssueCount() const { return issue_count_; }
+
+std::uint32_t ColumnarIssueStore::findUserId(
+    const std::string& user_identifier) const {
+  return users_.find(user_identifier);
+}
+
+std::uint32_t ColumnarIssueStore::findIssueTypeId(
+    const std::string& issue_type) const {
+  return issue_types_.find(issue_type);
+}
+
+ColumnarIssueStore::IssueTypeMask ColumnarIssueStore::createIssueTypeMask(
+    const std::vector<std::string>& issue_types) const {
+  IssueTypeMask mask = 0;
+  for (const std::string& issue_type : issue_types) {
+    const std::uint32_t issue_type_id = findIssueTypeId(issue_type);
+    if (issue_type_id != kNotFound) {
+      mask |= IssueTypeMask{1} << issue_type_id;
+    }
+  }
+  return mask;
+}
+
+long long ColumnarIssueStore::getResolutionDate(
+    std::size_t issue_index) const {
+  if (issue_index >= resolution_dates_.size()) {
+    throw std::out_of_range("The issue index is out of range");
+  }
+  return resolution_dates_[issue_index];
+}
+
+std::uint32_t ColumnarIssueStore::countResolvedIssuesAssignedTo(
+    std::uint32_t user_id, IssueTypeMask issue_types) const {
+  if (user_id == kNotFound) {
+    return 0;
+  }
+
+  std::uint32_t count = 0;
+  for (std::size_t block = 0; block < resolved_bitmap_.size(); ++block) {
+    count += std::popcount(
+        matchBlock(assignee_ids_, block * kBlockSize, user_id, issue_types) &
+        resolved_bitmap_[block] & has_key_bitmap_[block]);
+  }
+  return count;
+}
+
+std::uint32_t ColumnarIssueStore::countIssuesReportedBy(
+    std::uint32_t user_id, IssueTypeMask issue_types) const {
+  if (user_id == kNotFound) {
+    return 0;
+  }
+
+  std::uint32_t count = 0;
+  for (std::size_t block = 0; block < has_key_bitmap_.size(); ++block) {
+    count += std::popcount(
+        matchBlock(reporter_ids_, block * kBlockSize, user_id, issue_types) &
+        has_key_bitmap_[block]);
+  }
+  return count;
+}
+
+std::uint64_t ColumnarIssueStore::sumWatchCountsOfIssuesReportedBy(
+    std::uint32_t user_id, IssueTypeMask issue_types) const {
+  if (user_id == kNotFound) {
+    return 0;
+  }
+
+  // multiply instead of branching, so the loop can be vectorized
+  std::uint64_t sum = 0;
+  for (std::size_t i = 0; i < reporter_ids_.size(); ++i) {
+    const std::uint64_t match =
+        static_cast<std::uint64_t>(reporter_ids_[i] == user_id) &
+        (issue_types >> (issue_type_ids_[i] % kMaxIssueTypeCount));
+    sum += watch_counts_[i] * match;
+  }
+  return sum;
+}
+
+long long ColumnarIssueStore::parseDate(const std::string& date) {
+  const std::string_view text(date);
+
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  if (text.size() < 10 || text[4] != '-' || text[7] != '-' ||
+      !parseNumber(text.substr(0, 4), year) ||
+      !parseNumber(text.substr(5, 2), month) ||
+      !parseNumber(text.substr(8, 2), day)) {
+    return 0;
+  }
+
+  const std::chrono::year_month_day year_month_day{
+      std::chrono::year(year), std::chrono::month(month),
+      std::chrono::day(day)};
+  if (!year_month_day.ok()) {
+    return 0;
+  }
+
+  long long seconds = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::sys_days(year_month_day)
+                              .time_since_epoch())
+                          .count();
+
+  int hours = 0;
+  int minutes = 0;
+  int secs = 0;
+  if (text.size() >= 19 && (text[10] == ' ' || text[10] == 'T') &&
+      text[13] == ':' && text[16] == ':' &&
+      parseNumber(text.substr(11, 2), hours) &&
+      parseNumber(text.substr(14, 2), minutes) &&
+      parseNumber(text.substr(17, 2), secs)) {
+    seconds += hours * 3600LL + minutes * 60LL + secs;
+  }
+
+  return seconds;
+}
+
+std::uint32_t ColumnarIssueStore::Dictionary::find(
+    std::string_view value) const {
+  if (offsets.empty()) {
+    return kNotFound;
+  }
+
+  std::uint32_t first = 0;
+  std::uint32_t last = static_cast<std::uint32_t>(offsets.size() - 1);
+  while (first < last) {
+    const std::uint32_t middle = first + (last - first) / 2;
+    const std::string_view entry(characters.data() + offsets[middle],
+                                 offsets[middle + 1] - offsets[middle]);
+    if (entry < value) {
+      first = middle + 1;
+    } else {
+      last = middle;
+    }
+  }
+
+  if (first < offsets.size() - 1 &&
+      std::string_view(characters.data() + offsets[first],
+                       offsets[first + 1] - offsets[first]) == value) {
+    return first;
+  }
+  return kNotFound;
+}
+
+bool ColumnarIssueStore::useSnapshotImage(std::span<const std::byte> image) {
+  SnapshotHeader header;
+  if (!readSnapshotHeader(image, header) || header.magic != kSnapshotMagic ||
+      header.format_version != kSnapshotFormatVersion ||
+      header.byte_order_mark != kSnapshotByteOrderMark) {
+    return false;
+  }
+
+  // validate the bounds of all sections. The contents of the columns are not
+  // validated, so they are not touched before they are used
+  for (const SnapshotSectionDescriptor& section : header.sections) {
+    if (section.offset % kSnapshotAlignment != 0 ||
+        section.offset > image.size() ||
+        section.size > image.size() - section.offset) {
+      return false;
+    }
+  }
+
+  const std::uint64_t issue_count = header.issue_count;
+  const std::uint64_t block_count = (issue_count + kBlockSize - 1) / kBlockSize;
+  const auto& sections = header.sections;
+  if (sections[kIssueTypeIds].size != issue_count ||
+      sections[kAssigneeIds].size != issue_count * sizeof(std::uint32_t) ||
+      sections[kReporterIds].size != issue_count * sizeof(std::uint32_t) ||
+      sections[kWatchCounts].size != issue_count * sizeof(std::uint32_t) ||
+      sections[kResolutionDates].size != issue_count * sizeof(std::int64_t) ||
+      sections[kResolvedBitmap].size != block_count * sizeof(std::uint64_t) ||
+      sections[kHasKeyBitmap].size != block_count * sizeof(std::uint64_t)) {
+    return false;
+  }
+
+  Dictionary users{
+      getSnapshotSection<std::uint32_t>(image, sections[kUserOffsets]),
+      getSnapshotSection<char>(image, sections[kUserCharacters])};
+  Dictionary issue_types{
+      getSnapshotSection<std::uint32_t>(image, sections[kIssueTypeOffsets]),
+      getSnapshotSection<char>(image, sections[kIssueTypeCharacters])};
+  for (const Dictionary* dictionary : {&users, &issue_types}) {
+    if (dictionary->offsets.empty() ||
+        !std::is_sorted(dictionary->offsets.begin(),
+                        dictionary->offsets.end()) ||
+        dictionary->offsets.back() != dictionary->characters.size()) {
+      return false;
+    }
+  }
+  if (issue_types.offsets.size() - 1 > kMaxIssueTypeCount) {
+    return false;
+  }
+
+  snapshot_image_ = image;
+  issue_count_ = static_cast<std::size_t>(issue_count);
+  users_ = users;
+  issue_types_ = issue_types;
+  issue_type_ids_ =
+      getSnapshotSection<std::uint8_t>(image, sections[kIssueTypeIds]);
+  assignee_ids_ =
+      getSnapshotSection<std::uint32_t>(image, sections[kAssigneeIds]);
+  reporter_ids_ =
+      getSnapshotSection<std::uint32_t>(image, sections[kReporterIds]);
+  watch_counts_ =
+      getSnapshotSection<std::uint32_t>(image, sections[kWatchCounts]);
+  resolution_dates_ =
+      getSnapshotSection<std::int64_t>(image, sections[kResolutionDates]);
+  resolved_bitmap_ =
+      getSnapshotSection<std::uint64_t>(image, sections[kResolvedBitmap]);
+  has_key_bitmap_ =
+      getSnapshotSection<std::uint64_t>(image, sections[kHasKeyBitmap]);
+  return true;
+}
+
+void ColumnarIssueStore::clear() {
+  owned_snapshot_image_.clear();
+  mapped_snapshot_file_.close();
+  snapshot_image_ = {};
+  issue_count_ = 0;
+  users_ = {};
+  issue_types_ = {};
+  issue_type_ids_ = {};
+  assignee_ids_ = {};
+  reporter_ids_ = {};
+  watch_counts_ = {};
+  resolution_dates_ = {};
+  resolved_bitmap_ = {};
+  has_key_bitmap_ = {};
+}
+
+std::uint64_t ColumnarIssueStore::matchBlock(
+    std::span<const std::uint32_t> user_ids, std::size_t first_issue,
+    std::uint32_t user_id, IssueTypeMask issue_types) const {
+  const std::size_t block_size =
+      std::min(kBlockSize, user_ids.size() - first_issue);
+
+  // no branches in the loop body, so the compiler can vectorize the compares.
+  // The modulo keeps the shift defined for corrupted snapshots
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < block_size; ++i) {
+    const std::uint64_t match =
+        static_cast<std::uint64_t>(user_ids[first_issue + i] == user_id) &
+        (issue_types >>
+         (issue_type_ids_[first_issue + i] % kMaxIssueTypeCount));
+    mask |= match << i;
+  }
+  return mask;
+}
+}  // namespace tdmon
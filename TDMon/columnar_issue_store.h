@@ -0,0 +1,354 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <TDMon/database_file_state.h>
+#include <TDMon/memory_mapped_file.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief An in-memory, column oriented (struct of arrays) snapshot of the
+ * issues table of the technical debt dataset.
+ *
+ * The table is bulk loaded once. Issue types and users (assignees and
+ * reporters) are dictionary encoded to integer ids. Whether an issue is
+ * resolved and whether it has a key are stored in bitmaps with one bit per
+ * issue. The resolution date is additionally stored as seconds since epoch and
+ * the watch count as a packed integer column.
+ *
+ * The counting functions ("kernels") filter and count 64 issues at a time:
+ * they compare the integer columns without branches, pack the results into a
+ * 64 bit mask, combine it with the bitmaps and count the set bits. These loops
+ * are simple enough for the compiler to vectorize, so answering a query takes
+ * microseconds instead of a sql round trip.
+ *
+ * All columns and dictionaries are stored in one contiguous "snapshot image"
+ * in the binary snapshot format, and are only referenced by spans. The image
+ * is either built in memory (loadFromDatabase()), or is a snapshot file mapped
+ * into memory (mapSnapshot()). In the latter case, nothing is parsed or copied
+ * at startup: the columns are read directly from the mapped file.
+ *
+ * The snapshot format consists of a header (see kSnapshotFormatVersion)
+ * containing the fingerprint of the source database, followed by sections for
+ * each dictionary and column. Every section starts at a multiple of
+ * kSnapshotAlignment. Integers are stored in the native byte order, as the
+ * snapshot is a local cache.
+ */
+class ColumnarIssueStore {
+ public:
+  /**
+   * @brief A set of issue types, as bitmask over the issue type ids. Bit i is
+   * set, if the issue type with id i is part of the set.
+   */
+  using IssueTypeMask = std::uint64_t;
+
+  /**
+   * @brief The maximum number of distinct issue types which can be stored. This
+   * is limited by the number of bits in IssueTypeMask.
+   */
+  static const std::size_t kMaxIssueTypeCount = 64;
+
+  /**
+   * @brief Returned when looking up a user or issue type that does not exist
+   */
+  static const std::uint32_t kNotFound = UINT32_MAX;
+
+  /**
+   * @brief The version of the snapshot format. Increment when changing the
+   * format, so old snapshots are rebuilt.
+   */
+  static const std::uint32_t kSnapshotFormatVersion = 1;
+
+  /**
+   * @brief The alignment of the sections of a snapshot in bytes. Matches the
+   * page size, so every column starts at a page boundary when mapped.
+   */
+  static const std::size_t kSnapshotAlignment = 4096;
+
+  /**
+   * @brief The constructor. Creates an empty store.
+   */
+  ColumnarIssueStore();
+
+  /**
+   * @brief The move constructor
+   * @param other The store to move from. Empty afterwards.
+   */
+  ColumnarIssueStore(ColumnarIssueStore&& other) noexcept;
+
+  /**
+   * @brief The move assignment operator
+   * @param other The store to move from. Empty afterwards.
+   * @return This store
+   */
+  ColumnarIssueStore& operator=(ColumnarIssueStore&& other) noexcept;
+
+  ColumnarIssueStore(const ColumnarIssueStore&) = delete;
+  ColumnarIssueStore& operator=(const ColumnarIssueStore&) = delete;
+
+  /**
+   * @brief Load the issues table from a sqlite database. Replaces the current
+   * contents of the store. Throws, if the database cannot be read or contains
+   * more than kMaxIssueTypeCount distinct issue types.
+   * @param path The path to the sqlite database
+   * @param table_name The name of the issues table
+   */
+  void loadFromDatabase(const std::filesystem::path& path,
+                        const std::string& table_name);
+
+  /**
+   * @brief Write the contents of the store to a snapshot file. The file is
+   * written to a temporary file first and then renamed, so a concurrent reader
+   * never sees a partially written snapshot. Throws, if the file cannot be
+   * written.
+   * @param path The path of the snapshot file
+   * @param source_state The state of the database the issues were loaded from.
+   * Stored in the header as fingerprint.
+   */
+  void writeSnapshot(const std::filesystem::path& path,
+                     const DatabaseFileState& source_state) const;
+
+  /**
+   * @brief Map a snapshot file into memory and use it as the contents of the
+   * store. The store is left unchanged, if the snapshot cannot be used.
+   * @param path The path of the snapshot file
+   * @param source_state The current state of the source database. The snapshot
+   * is only used, if it was created from a database in this state.
+   * @return true, if the snapshot is used. false, if it does not exist, is
+   * invalid, has another format version or is outdated.
+   */
+  bool mapSnapshot(const std::filesystem::path& path,
+                   const DatabaseFileState& source_state);
+
+  /**
+   * @brief Get the number of stored issues
+   * @return The number of issues
+   */
+  std::size_t getIssueCount() const;
+
+  /**
+   * @brief Get the id of a user
+   * @param user_identifier The user-identifier
+   * @return The id, or kNotFound if the user does not appear in the issues
+   */
+  std::uint32_t findUserId(const std::string& user_identifier) const;
+
+  /**
+   * @brief Get the id of an issue type
+   * @param issue_type The issue type, e.g. 'Test'
+   * @return The id, or kNotFound if the issue type does not appear in the
+   * issues
+   */
+  std::uint32_t findIssueTypeId(const std::string& issue_type) const;
+
+  /**
+   * @brief Build the mask containing the given issue types. Issue types which
+   * do not appear in the issues are ignored.
+   * @param issue_types The issue types
+   * @return The mask
+   */
+  IssueTypeMask createIssueTypeMask(
+      const std::vector<std::string>& issue_types) const;
+
+  /**
+   * @brief Get the resolution date of an issue
+   * @param issue_index The index of the issue
+   * @return The resolution date in seconds since epoch. 0, if the issue is not
+   * resolved or the date could not be parsed.
+   */
+  long long getResolutionDate(std::size_t issue_index) const;
+
+  /**
+   * @brief Count the resolved issues with a key assigned to a user (the attack
+   * value)
+   * @param user_id The id of the assignee
+   * @param issue_types The issue types to count
+   * @return The number of issues
+   */
+  std::uint32_t countResolvedIssuesAssignedTo(std::uint32_t user_id,
+                                              IssueTypeMask issue_types) const;
+
+  /**
+   * @brief Count the issues with a key reported by a user (the defense value)
+   * @param user_id The id of the reporter
+   * @param issue_types The issue types to count
+   * @return The number of issues
+   */
+  std::uint32_t countIssuesReportedBy(std::uint32_t user_id,
+                                      IssueTypeMask issue_types) const;
+
+  /**
+   * @brief Sum up the watch counts of all issues reported by a user (the speed
+   * value)
+   * @param user_id The id of the reporter
+   * @param issue_types The issue types to sum up
+   * @return The sum of the watch counts
+   */
+  std::uint64_t sumWatchCountsOfIssuesReportedBy(
+      std::uint32_t user_id, IssueTypeMask issue_types) const;
+
+  /**
+   * @brief Parse a date of the form 'YYYY-MM-DD', optionally followed by a time
+   * of the form ' HH:MM:SS' or 'THH:MM:SS'.
+   * @param date The date string
+   * @return The date in seconds since epoch. 0, if the date cannot be parsed.
+   */
+  static long long parseDate(const std::string& date);
+
+ private:
+  /**
+   * @brief A sorted dictionary of strings, stored as the concatenated
+   * characters of all strings and the offsets of each string into them. The id
+   * of a string is its index.
+   */
+  struct Dictionary {
+    /**
+     * @brief The offset of each string into the characters, followed by the
+     * total number of characters. Contains one more element than the
+     * dictionary contains strings.
+     */
+    std::span<const std::uint32_t> offsets;
+
+    /**
+     * @brief The concatenated characters of all strings
+     */
+    std::span<const char> characters;
+
+    /**
+     * @brief Get the id of a string, using binary search
+     * @param value The string
+     * @return The id, or kNotFound if the dictionary does not contain the
+     * string
+     */
+    std::uint32_t find(std::string_view value) const;
+  };
+
+  /**
+   * @brief Use a snapshot image as the contents of the store. Validates the
+   * header and the bounds of all sections, and points the dictionaries and
+   * columns into the image.
+   * @param image The snapshot image. Must outlive the store, or until another
+   * image is used.
+   * @return true, if the image is valid
+   */
+  bool useSnapshotImage(std::span<const std::byte> image);
+
+  /**
+   * @brief Reset the store to empty
+   */
+  void clear();
+
+  /**
+   * @brief Build the 64 bit match mask of one block of (up to) 64 issues. Bit
+   * i is set, if the user column of issue (first_issue + i) equals the user id
+   * and the issue type is part of the mask.
+   * @param user_ids The user column to compare (assignees or reporters)
+   * @param first_issue The index of the first issue in the block
+   * @param user_id The user id to compare with
+   * @param issue_types The issue types to match
+   * @return The match mask
+   */
+  std::uint64_t matchBlock(std::span<const std::uint32_t> user_ids,
+                           std::size_t first_issue, std::uint32_t user_id,
+                           IssueTypeMask issue_types) const;
+
+  /**
+   * @brief The snapshot image, if it was built in memory. Stored as 64 bit
+   * words, so all sections are aligned.
+   */
+  std::vector<std::uint64_t> owned_snapshot_image_;
+
+  /**
+   * @brief The snapshot file, if it was mapped into memory
+   */
+  MemoryMappedFile mapped_snapshot_file_;
+
+  /**
+   * @brief The snapshot image in use, either owned or mapped
+   */
+  std::span<const std::byte> snapshot_image_;
+
+  /**
+   * @brief The number of stored issues
+   */
+  std::size_t issue_count_ = 0;
+
+  /**
+   * @brief The dictionary of users
+   */
+  Dictionary users_;
+
+  /**
+   * @brief The dictionary of issue types
+   */
+  Dictionary issue_types_;
+
+  /**
+   * @brief The issue type id of each issue
+   */
+  std::span<const std::uint8_t> issue_type_ids_;
+
+  /**
+   * @brief The user id of the assignee of each issue
+   */
+  std::span<const std::uint32_t> assignee_ids_;
+
+  /**
+   * @brief The user id of the reporter of each issue
+   */
+  std::span<const std::uint32_t> reporter_ids_;
+
+  /**
+   * @brief The watch count of each issue
+   */
+  std::span<const std::uint32_t> watch_counts_;
+
+  /**
+   * @brief The resolution date of each issue in seconds since epoch
+   */
+  std::span<const std::int64_t> resolution_dates_;
+
+  /**
+   * @brief One bit per issue. Set, if the issue is resolved (its resolution
+   * date is not empty). The bits of the last block beyond the issue count are
+   * 0.
+   */
+  std::span<const std::uint64_t> resolved_bitmap_;
+
+  /**
+   * @brief One bit per issue. Set, if the issue has a key. The bits of the last
+   * block beyond the issue count are 0.
+   */
+  std::span<const std::uint64_t> has_key_bitmap_;
+};
+}  // namespace tdmon
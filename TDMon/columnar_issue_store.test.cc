@@ -0,0 +1,165 @@
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/columnar_issue_store.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief The path to the database containing test data for the columnar issue
+ * store
+ */
+const std::string kColumnarStoreTestDbPath = "./columnar_store_test.db";
+
+/**
+ * @brief Helper function. Create the database containing test data for the
+ * columnar issue store. Contains 130 issues, so the issues span three blocks of
+ * the bitmaps:
+ * - 100 'Test' issues reported by Human1 and assigned to Human2. Every even
+ * issue is resolved, every issue has a watch count of 2.
+ * - 30 'Bug' issues reported and assigned to Human1, all resolved.
+ */
+void createColumnarStoreTestDb() {
+  std::filesystem::remove(kColumnarStoreTestDbPath);
+
+  SQLite::Database db(kColumnarStoreTestDbPath,
+                      SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+
+  db.exec(
+      "CREATE TABLE JIRA_ISSUES (KEY INTEGER, TYPE TEXT, ASSIGNEE TEXT, "
+      "RESOLUTION_DATE TEXT, REPORTER TEXT, WATCH_COUNT INTEGER)");
+
+  SQLite::Transaction transaction(db);
+  SQLite::Statement insert(db,
+                           "INSERT INTO JIRA_ISSUES VALUES (?, ?, ?, ?, ?, ?)");
+  for (int i = 0; i < 130; ++i) {
+    const bool is_test = i < 100;
+    insert.bind(1, i);
+    insert.bind(2, is_test ? "Test" : "Bug");
+    insert.bind(3, is_test ? "Human2" : "Human1");
+    insert.bind(4, is_test && i % 2 != 0 ? "" : "2000-01-02 03:04:05");
+    insert.bind(5, "Human1");
+    insert.bind(6, 2);
+    insert.exec();
+    insert.reset();
+  }
+  transaction.commit();
+}
+
+/**
+ * @brief Test, if the issues are loaded and counted correctly across multiple
+ * blocks
+ */
+TEST(ColumnarIssueStore, CountsIssuesCorrectly) {
+  createColumnarStoreTestDb();
+
+  ColumnarIssueStore store;
+  store.loadFromDatabase(kColumnarStoreTestDbPath, "JIRA_ISSUES");
+
+  EXPECT_EQ(store.getIssueCount(), 130);
+
+  const std::uint32_t human1 = store.findUserId("Human1");
+  const std::uint32_t human2 = store.findUserId("Human2");
+  ASSERT_NE(human1, ColumnarIssueStore::kNotFound);
+  ASSERT_NE(human2, ColumnarIssueStore::kNotFound);
+
+  const ColumnarIssueStore::IssueTypeMask tests =
+      store.createIssueTypeMask({"Test"});
+  const ColumnarIssueStore::IssueTypeMask all =
+      store.createIssueTypeMask({"Test", "Bug", "Unknown"});
+
+  EXPECT_EQ(store.countResolvedIssuesAssignedTo(human2, tests), 50);
+  EXPECT_EQ(store.countResolvedIssuesAssignedTo(human1, tests), 0);
+  EXPECT_EQ(store.countResolvedIssuesAssignedTo(human1, all), 30);
+  EXPECT_EQ(store.countIssuesReportedBy(human1, tests), 100);
+  EXPECT_EQ(store.countIssuesReportedBy(human1, all), 130);
+  EXPECT_EQ(store.countIssuesReportedBy(human2, all), 0);
+  EXPECT_EQ(store.sumWatchCountsOfIssuesReportedBy(human1, all), 260);
+
+  EXPECT_EQ(store.countIssuesReportedBy(store.findUserId("Nobody"), all), 0);
+  EXPECT_EQ(store.createIssueTypeMask({"Unknown"}), 0);
+
+  EXPECT_EQ(store.getResolutionDate(0),
+            ColumnarIssueStore::parseDate("2000-01-02 03:04:05"));
+  EXPECT_EQ(store.getResolutionDate(1), 0);
+}
+
+/**
+ * @brief Test, if a snapshot is written and mapped correctly, and if outdated
+ * or invalid snapshots are rejected
+ */
+TEST(ColumnarIssueStore, WritesAndMapsSnapshots) {
+  createColumnarStoreTestDb();
+  const std::string snapshot_path = "./columnar_store_test.snapshot";
+
+  const DatabaseFileState source_state =
+      DatabaseFileState::read(kColumnarStoreTestDbPath);
+
+  {
+    ColumnarIssueStore store;
+    store.loadFromDatabase(kColumnarStoreTestDbPath, "JIRA_ISSUES");
+    store.writeSnapshot(snapshot_path, source_state);
+  }
+
+  // sections are page aligned
+  EXPECT_GT(std::filesystem::file_size(snapshot_path),
+            ColumnarIssueStore::kSnapshotAlignment);
+
+  ColumnarIssueStore store;
+  ASSERT_TRUE(store.mapSnapshot(snapshot_path, source_state));
+
+  EXPECT_EQ(store.getIssueCount(), 130);
+  const std::uint32_t human1 = store.findUserId("Human1");
+  const std::uint32_t human2 = store.findUserId("Human2");
+  const ColumnarIssueStore::IssueTypeMask tests =
+      store.createIssueTypeMask({"Test"});
+  EXPECT_EQ(store.countResolvedIssuesAssignedTo(human2, tests), 50);
+  EXPECT_EQ(store.countIssuesReportedBy(human1, tests), 100);
+  EXPECT_EQ(store.sumWatchCountsOfIssuesReportedBy(human1, tests), 200);
+
+  // the mapping moves with the store
+  ColumnarIssueStore moved_store = std::move(store);
+  EXPECT_EQ(store.getIssueCount(), 0);
+  EXPECT_EQ(moved_store.countIssuesReportedBy(human1, tests), 100);
+
+  // an outdated snapshot is rejected and leaves the store unchanged
+  DatabaseFileState changed_state = source_state;
+  ++changed_state.file_change_counter;
+  EXPECT_FALSE(moved_store.mapSnapshot(snapshot_path, changed_state));
+  EXPECT_EQ(moved_store.getIssueCount(), 130);
+
+  // a truncated snapshot is rejected
+  std::filesystem::resize_file(snapshot_path,
+                               ColumnarIssueStore::kSnapshotAlignment);
+  EXPECT_FALSE(moved_store.mapSnapshot(snapshot_path, source_state));
+
+  // garbage is rejected
+  {
+    std::ofstream file(snapshot_path, std::ios::binary | std::ios::trunc);
+    file << "not a snapshot";
+  }
+  EXPECT_FALSE(moved_store.mapSnapshot(snapshot_path, source_state));
+
+  std::filesystem::remove(snapshot_path);
+  EXPECT_FALSE(moved_store.mapSnapshot(snapshot_path, source_state));
+}
+
+/**
+ * @brief Test, if dates are parsed correctly
+ */
+TEST(ColumnarIssueStore, ParsesDatesCorrectly) {
+  EXPECT_EQ(ColumnarIssueStore::parseDate("1970-01-01"), 0);
+  EXPECT_EQ(ColumnarIssueStore::parseDate("2000-01-01"), 946684800);
+  EXPECT_EQ(ColumnarIssueStore::parseDate("2000-01-01 01:00:01"), 946688401);
+  EXPECT_EQ(ColumnarIssueStore::parseDate("2000-01-01T01:00:01.000+0000"),
+            946688401);
+  EXPECT_EQ(ColumnarIssueStore::parseDate(""), 0);
+  EXPECT_EQ(ColumnarIssueStore::parseDate("2000-13-01"), 0);
+  EXPECT_EQ(ColumnarIssueStore::parseDate("not a date"), 0);
+}
+}  // namespace tdmon
@@ -48,4 +48,6 @@ const std::string UiConstants::kBackButtonText = "Back";
 
 const std::string UiConstants::kRefreshButtonText = "Refresh";
 
+const std::string UiConstants::kUpdatingTdMonText = "Updating TD-Mon...";
+
 }
@@ -93,6 +93,10 @@ struct UiConstants {
    * @brief The refresh button text string
    */
   static const std::string kRefreshButtonText;
+  /**
+   * @brief The text string shown while the td-mon is being updated
+   */
+  static const std::string kUpdatingTdMonText;
 };
 
 /**
@@ -26,15 +26,30 @@
 
 #include <TDMon/application_state.h>
 #include <TDMon/constants.h>
+#include <TDMon/frame_scheduler.h>
+#include <TDMon/frame_timing_overlay.h>
+#include <TDMon/frame_timing_stats.h>
+#include <TDMon/operation_latencies.h>
+#include <TDMon/startup_pipeline.h>
 #include <TDMon/td_mon_cache.h>
+#include <TDMon/td_mon_cache_write_behind.h>
 #include <TDMon/td_mon_factory.h>
+#include <TDMon/td_mon_history_log.h>
+#include <TDMon/texture_manager.h>
+#include <TDMon/trace_recorder.h>
 
 #include <SFML/Graphics.hpp>
 #include <TGUI/Backends/SFML.hpp>
 #include <TGUI/TGUI.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <concepts>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace tdmon {
 /**
@@ -42,7 +57,18 @@ namespace tdmon {
  * states. Creates one instance each of: TdMonCacheType and TdMonFactoryType to
  * pass them to the appropriate application states where they are needed. Uses
  * the MainMenuType, SetupMenuType and ObserveMenuType to switch to different
- * application states respectively.
+ * application states respectively. Also owns the TdMonHistoryLog, which the
+ * observe menu appends every new td-mon to, and the TextureManager.
+ *
+ * During startup, the window is created while the cache is loaded, the td-mon
+ * textures are decoded and the data sources are connected in the background
+ * (see StartupPipeline), to show the first frame as early as possible.
+ * Afterwards, a FrameScheduler decides when to update and redraw, so an idle
+ * application waits for events instead of keeping a cpu core busy.
+ *
+ * Each application state is constructed and initialized on its first visit
+ * only. When switching to another state, it is suspended and kept alive, so
+ * switching back resumes it with its gui and resources.
  *
  * @tparam TdMonFactoryType The td-mon factory to use. Must inherit from
  * TdMonFactory.
@@ -59,7 +85,8 @@ template <class TdMonFactoryType, class TdMonCacheType, class MainMenuType,
           class SetupMenuType, class ObserveMenuType>
   requires std::constructible_from<SetupMenuType, TdMonFactoryType&> &&
            std::constructible_from<ObserveMenuType, TdMonCacheType&,
-                                   TdMonFactoryType&> &&
+                                   TdMonFactoryType&, TdMonHistoryLog&,
+                                   TextureManager&> &&
            std::derived_from<TdMonFactoryType, TdMonFactory> &&
            std::derived_from<TdMonCacheType, TdMonCache> &&
            std::derived_from<MainMenuType, ApplicationState> &&
@@ -74,51 +101,53 @@ class Core {
   Core()
       : tdmon_factory_(std::make_unique<TdMonFactoryType>()),
         tdmon_cache_(std::make_unique<TdMonCacheType>()) {
-    application_state_ = std::make_unique<MainMenuType>();
+    std::unique_ptr<ApplicationState>& main_menu =
+        application_states_[getApplicationStateIndex(
+            SupportedApplicationStateTypes::kMainMenu)];
+    main_menu = std::make_unique<MainMenuType>();
+    application_state_ = main_menu.get();
   };
 
   /**
-   * @brief run the application
+   * @brief run the application. Writes the recorded trace to
+   * TraceRecorder::kTraceFilePath afterwards, if tracing is enabled.
    */
   void run() {
-    // try to load the cache from disk
-    if (tdmon_cache_->existsOnDisk()) {
-      tdmon_cache_->loadFromDisk();
-    }
-
-    // init window and gui
-    window_.create(sf::VideoMode(600, 600), "Technical Debt Monsters!",
-                   sf::Style::Close);
-    gui_.setTarget(window_);
+    runApplication();
 
-    application_state_->init(gui_);
-
-    while (window_.isOpen()) {
-      sf::Event event;
-      while (window_.pollEvent(event)) {
-        gui_.handleEvent(event);
-
-        if (event.type == sf::Event::Closed) window_.close();
-      }
-
-      // update the application state
-      // if false is returned, close the application
-      if (!updateApplicationState()) {
-        window_.close();
-      }
-
-      window_.clear(sf::Color(186, 186, 186));
-      gui_.draw();
-      window_.display();
+#ifdef TDMON_ENABLE_TRACING
+    try {
+      TraceRecorder::getGlobal().writeChromeTrace(
+          TraceRecorder::kTraceFilePath);
+    } catch (const std::exception& e) {
+      std::cout << "cannot store trace. Reason: " << e.what() << std::endl;
     }
+#endif
+  };
 
-    // if the cache contains data, write it to disk when closing the application
-    if (tdmon_cache_->hasCache()) {
-      tdmon_cache_->storeOnDisk();
-    }
+  /**
+   * @brief Get the timings of the startup phases of the last call to run()
+   * @return The startup phase timings. Empty, if run() was not called.
+   */
+  const std::vector<StartupPipeline::PhaseTiming>& getStartupPhaseTimings()
+      const {
+    return startup_phase_timings_;
+  }
 
-    application_state_->cleanup(gui_);
-  };
+  /**
+   * @brief Get the frame scheduler, e.g. to change the scheduling mode before
+   * calling run()
+   * @return The frame scheduler
+   */
+  FrameScheduler& getFrameScheduler() { return frame_scheduler_; }
+
+  /**
+   * @brief Get the timings of the recently rendered frames
+   * @return The frame timing stats
+   */
+  const FrameTimingStats& getFrameTimingStats() const {
+    return frame_timing_stats_;
+  }
 
  private:
   /**
@@ -138,6 +167,38 @@ class Core {
    * @brief The TdMonCache to use in the application.
    */
   std::unique_ptr<TdMonCacheType> tdmon_cache_ = nullptr;
+  /**
+   * @brief The history of all td-mons created in the application. Not open,
+   * if the log file cannot be used.
+   */
+  TdMonHistoryLog tdmon_history_log_;
+  /**
+   * @brief Stores the cache on disk in the background, once it changed.
+   * Created when the application runs.
+   */
+  std::unique_ptr<TdMonCacheWriteBehind> tdmon_cache_write_behind_ = nullptr;
+  /**
+   * @brief The textures shared by the application states. Preloaded during
+   * startup.
+   */
+  TextureManager texture_manager_;
+  /**
+   * @brief The timings of the startup phases
+   */
+  std::vector<StartupPipeline::PhaseTiming> startup_phase_timings_;
+  /**
+   * @brief Decides when to update the application state and redraw the
+   * window. Event-driven by default.
+   */
+  FrameScheduler frame_scheduler_;
+  /**
+   * @brief The timings of the recently rendered frames
+   */
+  FrameTimingStats frame_timing_stats_;
+  /**
+   * @brief Shows the frame timing stats on top of the application states
+   */
+  FrameTimingOverlay frame_timing_overlay_;
 
   /**
    * @brief The previous application state. This is cached to support the
@@ -146,9 +207,241 @@ class Core {
   SupportedApplicationStateTypes previous_state_type_ =
       SupportedApplicationStateTypes::kNull;
   /**
-   * @brief The current application state
+   * @brief The number of application state types, including kNull
+   */
+  static constexpr std::size_t kApplicationStateTypeCount =
+      static_cast<std::size_t>(SupportedApplicationStateTypes::kObserveMenu) +
+      1;
+  /**
+   * @brief How often waitEventFor() checks for events. The same interval is
+   * used by sf::Window::waitEvent() in SFML 2.
+   */
+  static constexpr std::chrono::microseconds kEventPollInterval =
+      std::chrono::milliseconds(10);
+  /**
+   * @brief All application states constructed so far, indexed by their type
+   * (see getApplicationStateIndex()). Kept alive, so they can be resumed.
+   */
+  std::array<std::unique_ptr<ApplicationState>, kApplicationStateTypeCount>
+      application_states_;
+  /**
+   * @brief The current application state. Owned by application_states_.
+   */
+  ApplicationState* application_state_ = nullptr;
+
+  /**
+   * @brief Get the index of an application state type in application_states_
+   * @param state_type The application state type
+   * @return The index
+   */
+  static std::size_t getApplicationStateIndex(
+      SupportedApplicationStateTypes state_type) {
+    return static_cast<std::size_t>(state_type);
+  }
+
+  /**
+   * @brief Start the application, run the main loop until the window is
+   * closed and shut down the application
+   */
+  void runApplication() {
+    TDMON_TRACE_SCOPE("run");
+    StartupPipeline startup_pipeline;
+
+    // try to load the cache from disk
+    startup_pipeline.addBackgroundPhase("load cache", [this]() {
+      if (tdmon_cache_->existsOnDisk()) {
+        OperationLatencies::Timer timer(Operation::kCacheLoad);
+        tdmon_cache_->loadFromDisk();
+      }
+    });
+
+    // decode the textures, so the application states only have to upload them
+    for (const std::string& path :
+         TextureManager::findTextures(TextureManager::kTextureDirectory)) {
+      startup_pipeline.addBackgroundPhase(
+          "decode " + path, [this, path]() { texture_manager_.preload(path); });
+    }
+
+    // try to open the td-mon history. The application works without it
+    startup_pipeline.addBackgroundPhase("open td-mon history", [this]() {
+      try {
+        tdmon_history_log_.open(TdMonHistoryLog::kDefaultFilePath);
+        tdmon_history_log_.compactIfDue(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()));
+      } catch (const std::exception& e) {
+        std::cout << "cannot use td-mon history. Reason: " << e.what()
+                  << std::endl;
+      }
+    });
+
+    // init window and gui on this thread, which owns the window
+    startup_pipeline.runPhase("create window", [this]() {
+      window_.create(sf::VideoMode(600, 600), "Technical Debt Monsters!",
+                     sf::Style::Close);
+      gui_.setTarget(window_);
+      frame_timing_overlay_.init(gui_);
+    });
+
+    // the application states use the results of all phases
+    startup_pipeline.wait();
+
+    // store changes of the cache in the background from now on
+    tdmon_cache_write_behind_ =
+        std::make_unique<TdMonCacheWriteBehind>(*tdmon_cache_);
+
+    startup_pipeline.runPhase("init application state",
+                              [this]() { application_state_->init(gui_); });
+
+    startup_phase_timings_ = startup_pipeline.getPhaseTimings();
+    startup_pipeline.printPhaseTimings(std::cout);
+
+    while (window_.isOpen()) {
+      // wait until the next frame is due, or block until the next event, if
+      // nothing needs to be done without one. A shown overlay refreshes
+      // itself
+      const std::optional<std::chrono::microseconds> wait_time =
+          frame_scheduler_.getWaitTime(
+              application_state_->needsUpdatesWithoutEvents() ||
+              frame_timing_overlay_.isVisible());
+      sf::Event event;
+      bool has_waited_event = false;
+      if (!wait_time) {
+        // the application state may still need an update at a later time,
+        // e.g. to revalidate its data
+        const std::optional<std::chrono::microseconds> time_until_update =
+            application_state_->getTimeUntilNextUpdate();
+        if (time_until_update) {
+          has_waited_event = waitEventFor(event, *time_until_update);
+        } else {
+          has_waited_event = window_.waitEvent(event);
+        }
+      } else if (wait_time->count() > 0) {
+        sf::sleep(sf::microseconds(wait_time->count()));
+      }
+
+      // the frame starts once waiting is over
+      const std::chrono::steady_clock::time_point events_start =
+          std::chrono::steady_clock::now();
+      if (has_waited_event) {
+        handleEvent(event);
+      }
+      while (window_.pollEvent(event)) {
+        handleEvent(event);
+      }
+      const std::chrono::steady_clock::time_point update_start =
+          std::chrono::steady_clock::now();
+
+      // update the application state
+      // if false is returned, close the application
+      for (unsigned int step_count = frame_scheduler_.beginFrame();
+           step_count > 0 && window_.isOpen(); --step_count) {
+        if (!updateApplicationState()) {
+          window_.close();
+        }
+      }
+      if (application_state_->takeRedrawRequest()) {
+        frame_scheduler_.requestRedraw();
+      }
+
+      // store the cache, if it changed
+      tdmon_cache_write_behind_->checkpointIfDue();
+
+      if (frame_timing_overlay_.update(frame_timing_stats_)) {
+        frame_scheduler_.requestRedraw();
+      }
+
+      if (frame_scheduler_.finishFrame()) {
+        TDMON_TRACE_SCOPE("render frame");
+        const std::chrono::steady_clock::time_point draw_start =
+            std::chrono::steady_clock::now();
+        window_.clear(sf::Color(186, 186, 186));
+        gui_.draw();
+        frame_timing_overlay_.draw(window_);
+        const std::chrono::steady_clock::time_point display_start =
+            std::chrono::steady_clock::now();
+        window_.display();
+        const std::chrono::steady_clock::time_point frame_end =
+            std::chrono::steady_clock::now();
+
+        // only rendered frames are recorded, skipped ones did no work
+        frame_timing_stats_.addFrame(
+            getMicroseconds(update_start - events_start),
+            getMicroseconds(draw_start - update_start),
+            getMicroseconds(display_start - draw_start),
+            getMicroseconds(frame_end - display_start));
+      }
+    }
+
+    // write the last changes of the cache to disk when closing the
+    // application. Waits for a slow disk for a limited time only, the cache
+    // file stays readable in any case
+    if (!tdmon_cache_write_behind_->shutdown()) {
+      std::cout << "cache was not stored in time" << std::endl;
+    }
+
+    // clean up all states, including the suspended ones
+    for (std::unique_ptr<ApplicationState>& application_state :
+         application_states_) {
+      if (application_state) {
+        application_state->cleanup(gui_);
+      }
+    }
+  }
+
+  /**
+   * @brief Convert a duration measured with std::chrono::steady_clock to
+   * microseconds
+   * @param duration The duration
+   * @return The duration in microseconds
+   */
+  static std::chrono::microseconds getMicroseconds(
+      std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration);
+  }
+
+  /**
+   * @brief Wait for the next event, but at most for the given time. SFML 2
+   * cannot wait for events with a timeout, so events are polled every
+   * kEventPollInterval, just like sf::Window::waitEvent() does internally.
+   * @param event Receives the event
+   * @param timeout The maximum time to wait
+   * @return true, if an event was received
    */
-  std::unique_ptr<ApplicationState> application_state_;
+  bool waitEventFor(sf::Event& event, std::chrono::microseconds timeout) {
+    const std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + timeout;
+    while (!window_.pollEvent(event)) {
+      const std::chrono::steady_clock::time_point now =
+          std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        return false;
+      }
+      sf::sleep(sf::microseconds(
+          std::min(kEventPollInterval, getMicroseconds(deadline - now))
+              .count()));
+    }
+    return true;
+  }
+
+  /**
+   * @brief Pass an event to the gui, close the window, if requested, and
+   * toggle the frame timing overlay on its key. Events may change the gui, so
+   * a redraw is requested.
+   * @param event The event
+   */
+  void handleEvent(const sf::Event& event) {
+    gui_.handleEvent(event);
+
+    if (event.type == sf::Event::Closed) window_.close();
+
+    if (event.type == sf::Event::KeyPressed &&
+        event.key.code == FrameTimingOverlay::kToggleKey) {
+      frame_timing_overlay_.toggle();
+    }
+
+    frame_scheduler_.requestRedraw();
+  }
 
   /**
    * @brief Update the current application state. May trigger a switch to a
@@ -193,15 +486,49 @@ class Core {
   };
 
   /**
-   * @brief Switch to a different application state. Also, update
-   * previous_state_type_.
+   * @brief Switch to a different application state. Suspends the current
+   * state, and resumes the new one, or constructs and initializes it on its
+   * first visit. Also, update previous_state_type_.
    * @param state The new state type to switch to
    */
   void switchToApplicationState(SupportedApplicationStateTypes new_state_type) {
+    TDMON_TRACE_SCOPE("switch application state");
+    std::unique_ptr<ApplicationState>& new_application_state =
+        application_states_[getApplicationStateIndex(new_state_type)];
+    const bool is_first_visit = new_application_state == nullptr;
+
+    // Construct new state on the first visit
+    if (is_first_visit) {
+      new_application_state = createApplicationState(new_state_type);
+    }
+
+    // store previous state type to enable switching back to the previous state
+    // later
+    previous_state_type_ = application_state_->getApplicationStateType();
+
+    // suspend the current state. It is kept alive to be resumed later
+    application_state_->suspend(gui_);
+    // switch application state
+    application_state_ = new_application_state.get();
+    // run init on a new application state, resume a known one
+    if (is_first_visit) {
+      application_state_->init(gui_);
+    } else {
+      application_state_->resume(gui_);
+    }
+    frame_scheduler_.requestRedraw();
+  }
+
+  /**
+   * @brief Construct an application state
+   * @param state_type The type of the state to construct
+   * @return The constructed state
+   */
+  std::unique_ptr<ApplicationState> createApplicationState(
+      SupportedApplicationStateTypes state_type) {
     std::unique_ptr<ApplicationState> new_application_state = nullptr;
 
-    // Construct new state
-    switch (new_state_type) {
+    switch (state_type) {
       case tdmon::SupportedApplicationStateTypes::kNull:
         throw std::exception("cannot switch to application state type kNull");
         break;
@@ -214,28 +541,19 @@ class Core {
         break;
       case tdmon::SupportedApplicationStateTypes::kObserveMenu:
         new_application_state =
-            std::make_unique<ObserveMenuType>(*tdmon_cache_, *tdmon_factory_);
+            std::make_unique<ObserveMenuType>(*tdmon_cache_, *tdmon_factory_,
+                                              tdmon_history_log_,
+                                              texture_manager_);
         break;
       default:
         throw std::exception("new_state_type not supported");
         break;
     }
 
-    // store previous state type to enable switching back to the previous state
-    // later
-    previous_state_type_ = application_state_->getApplicationStateType();
-
-    // change to the new state
-    if (new_application_state != nullptr) {
-      // run cleanup on current applications state
-      application_state_->cleanup(gui_);
-      // switch application state
-      application_state_ = std::move(new_application_state);
-      // run init on new application state
-      application_state_->init(gui_);
-    } else {
+    if (new_application_state == nullptr) {
       throw std::exception("new_application_state is nullptr");
     }
+    return new_application_state;
   }
 };
 }  // namespace tdmon
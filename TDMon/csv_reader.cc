@@ -0,0 +1,211 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#include <TDMon/csv_reader.h>
+
+#include <bit>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TDMON_CSV_READER_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace tdmon {
+namespace {
+/**
+ * @brief The UTF-8 byte order mark
+ */
+const std::string_view kUtf8ByteOrderMark = "\xEF\xBB\xBF";
+}  // namespace
+
+CsvReader::CsvReader(std::span<const char> data) : data_(data) {
+  if (std::string_view(data_.data(), data_.size())
+          .starts_with(kUtf8ByteOrderMark)) {
+    position_ = kUtf8ByteOrderMark.size();
+  }
+}
+
+bool CsvReader::readRow(std::vector<std::string_view>& fields) {
+  fields.clear();
+  field_ranges_.clear();
+
+  const char* const end = data_.data() + data_.size();
+  const char* position = data_.data() + position_;
+  if (position == end) {
+    return false;
+  }
+
+  bool row_has_escaped_fields = false;
+  while (true) {
+    FieldRange field_range;
+
+    if (*position == '"') {
+      // quoted field. Only quotes are special until the closing quote
+      ++position;
+      field_range.begin = position;
+      while (true) {
+        const char* quote = findQuote(position, end);
+        if (quote == end) {
+          throw std::runtime_error("Unterminated quoted field in csv data");
+        }
+        if (quote + 1 != end && quote[1] == '"') {
+          // an escaped quote
+          field_range.escaped = true;
+          position = quote + 2;
+          continue;
+        }
+        field_range.length =
+            static_cast<std::size_t>(quote - field_range.begin);
+        position = quote + 1;
+        break;
+      }
+      row_has_escaped_fields |= field_range.escaped;
+    } else {
+      const char* field_end = findFieldEnd(position, end);
+      field_range.begin = position;
+      field_range.length = static_cast<std::size_t>(field_end - position);
+      position = field_end;
+    }
+
+    field_ranges_.push_back(field_range);
+
+    if (position == end) {
+      break;
+    }
+    if (*position == ',') {
+      ++position;
+      if (position == end) {
+        // a trailing delimiter ends with an empty field
+        field_ranges_.push_back({position, 0, false});
+        break;
+      }
+      continue;
+    }
+    if (*position == '\r') {
+      ++position;
+      if (position != end && *position == '\n') {
+        ++position;
+      }
+      break;
+    }
+    if (*position == '\n') {
+      ++position;
+      break;
+    }
+    throw std::runtime_error(
+        "Unexpected character after quoted field in csv data");
+  }
+
+  position_ = static_cast<std::size_t>(position - data_.data());
+
+  // unescape all escaped fields first, so the buffer does not grow while views
+  // into it exist
+  std::vector<std::size_t> unescaped_offsets;
+  if (row_has_escaped_fields) {
+    unescaped_fields_.clear();
+    for (const FieldRange& field_range : field_ranges_) {
+      unescaped_offsets.push_back(unescaped_fields_.size());
+      if (field_range.escaped) {
+        for (std::size_t i = 0; i < field_range.length; ++i) {
+          unescaped_fields_.push_back(field_range.begin[i]);
+          // skip the second quote of an escaped quote
+          if (field_range.begin[i] == '"') {
+            ++i;
+          }
+        }
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < field_ranges_.size(); ++i) {
+    const FieldRange& field_range = field_ranges_[i];
+    if (field_range.escaped) {
+      const std::size_t length =
+          (i + 1 < unescaped_offsets.size() ? unescaped_offsets[i + 1]
+                                            : unescaped_fields_.size()) -
+          unescaped_offsets[i];
+      fields.emplace_back(unescaped_fields_.data() + unescaped_offsets[i],
+                          length);
+    } else {
+      fields.emplace_back(field_range.begin, field_range.length);
+    }
+  }
+
+  return true;
+}
+
+std::size_t CsvReader::getPosition() const { return position_; }
+
+const char* CsvReader::findFieldEnd(const char* begin, const char* end) {
+#ifdef TDMON_CSV_READER_USE_SSE2
+  const __m128i comma = _mm_set1_epi8(',');
+  const __m128i carriage_return = _mm_set1_epi8('\r');
+  const __m128i line_feed = _mm_set1_epi8('\n');
+
+  while (end - begin >= 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    const __m128i matches = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, comma),
+                     _mm_cmpeq_epi8(chunk, carriage_return)),
+        _mm_cmpeq_epi8(chunk, line_feed));
+    const unsigned int mask =
+        static_cast<unsigned int>(_mm_movemask_epi8(matches));
+    if (mask != 0) {
+      return begin + std::countr_zero(mask);
+    }
+    begin += 16;
+  }
+#endif
+
+  while (begin != end && *begin != ',' && *begin != '\r' && *begin != '\n') {
+    ++begin;
+  }
+  return begin;
+}
+
+const char* CsvReader::findQuote(const char* begin, const char* end) {
+#ifdef TDMON_CSV_READER_USE_SSE2
+  const __m128i quote = _mm_set1_epi8('"');
+
+  while (end - begin >= 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    const unsigned int mask = static_cast<unsigned int>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)));
+    if (mask != 0) {
+      return begin + std::countr_zero(mask);
+    }
+    begin += 16;
+  }
+#endif
+
+  while (begin != end && *begin != '"') {
+    ++begin;
+  }
+  return begin;
+}
+}  // namespace tdmon
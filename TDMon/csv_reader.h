@@ -0,0 +1,129 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief A streaming reader for csv data (RFC 4180) held in memory, e.g. a
+ * memory mapped file.
+ *
+ * Rows are read one at a time. Fields are returned as views into the data, so
+ * reading a row does not copy or allocate, unless a quoted field contains
+ * escaped quotes (""). Quoted fields may contain delimiters and line breaks.
+ * Rows can end with "\n" or "\r\n". A leading UTF-8 byte order mark is skipped.
+ *
+ * The end of a field is searched 16 bytes at a time using SSE2, if available,
+ * with a scalar fallback for other platforms and the tail of the data.
+ */
+class CsvReader {
+ public:
+  /**
+   * @brief The constructor
+   * @param data The csv data. Must outlive the reader and the fields returned
+   * by it.
+   */
+  explicit CsvReader(std::span<const char> data);
+
+  /**
+   * @brief Read the next row. Throws, if the row is malformed (an unterminated
+   * quoted field, or characters after the closing quote of a field).
+   * @param fields Receives the fields of the row. Valid until the next row is
+   * read.
+   * @return false, if there are no more rows
+   */
+  bool readRow(std::vector<std::string_view>& fields);
+
+  /**
+   * @brief Get the number of bytes read so far
+   * @return The position in the data
+   */
+  std::size_t getPosition() const;
+
+  /**
+   * @brief Find the end of an unquoted field: the first ',', '\r' or '\n'
+   * @param begin The start of the search
+   * @param end The end of the search
+   * @return The position of the first match, or end
+   */
+  static const char* findFieldEnd(const char* begin, const char* end);
+
+  /**
+   * @brief Find the first quote ('"')
+   * @param begin The start of the search
+   * @param end The end of the search
+   * @return The position of the first quote, or end
+   */
+  static const char* findQuote(const char* begin, const char* end);
+
+ private:
+  /**
+   * @brief The position of a field in the data
+   */
+  struct FieldRange {
+    /**
+     * @brief The start of the field, without the opening quote
+     */
+    const char* begin = nullptr;
+
+    /**
+     * @brief The length of the field, without the closing quote
+     */
+    std::size_t length = 0;
+
+    /**
+     * @brief True, if the field contains escaped quotes ("")
+     */
+    bool escaped = false;
+  };
+
+  /**
+   * @brief The csv data
+   */
+  std::span<const char> data_;
+
+  /**
+   * @brief The position of the next row in the data
+   */
+  std::size_t position_ = 0;
+
+  /**
+   * @brief The positions of the fields of the current row. Reused for every
+   * row.
+   */
+  std::vector<FieldRange> field_ranges_;
+
+  /**
+   * @brief The unescaped contents of the escaped fields of the current row.
+   * Reused for every row.
+   */
+  std::string unescaped_fields_;
+};
+}  // namespace tdmon
@@ -0,0 +1,94 @@
+#include <TDMon/csv_reader.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief Helper function. Read all rows of csv data.
+ * @param data The csv data
+ * @return The fields of all rows
+ */
+std::vector<std::vector<std::string>> readAllCsvRows(std::string_view data) {
+  CsvReader reader(data);
+
+  std::vector<std::vector<std::string>> rows;
+  std::vector<std::string_view> fields;
+  while (reader.readRow(fields)) {
+    rows.emplace_back(fields.begin(), fields.end());
+  }
+  EXPECT_EQ(reader.getPosition(), data.size());
+  return rows;
+}
+
+/**
+ * @brief Test, if unquoted and quoted fields are read correctly, including
+ * escaped quotes, delimiters and line breaks in quoted fields, and fields long
+ * enough to be scanned in chunks of 16 bytes
+ */
+TEST(CsvReader, ReadsFields) {
+  const std::string long_field(40, 'x');
+  const std::string data =
+      "\xEF\xBB\xBFKEY,TYPE,DESCRIPTION\r\n"
+      "1,Test,plain\n"
+      "2,\"Documentation\",\"with \"\"quotes\"\", commas\nand lines\"\n"
+      "3,," +
+      long_field + "\n\"" + long_field + "\"\"" + long_field + "\",\"\",x";
+
+  const std::vector<std::vector<std::string>> rows = readAllCsvRows(data);
+  const std::vector<std::vector<std::string>> expected_rows = {
+      {"KEY", "TYPE", "DESCRIPTION"},
+      {"1", "Test", "plain"},
+      {"2", "Documentation", "with \"quotes\", commas\nand lines"},
+      {"3", "", long_field},
+      {long_field + "\"" + long_field, "", "x"}};
+  EXPECT_EQ(rows, expected_rows);
+}
+
+/**
+ * @brief Test, if empty lines and trailing delimiters produce empty fields
+ */
+TEST(CsvReader, ReadsEmptyFields) {
+  const std::vector<std::vector<std::string>> expected_rows = {
+      {"a", ""}, {""}, {"b"}};
+  EXPECT_EQ(readAllCsvRows("a,\n\nb\n"), expected_rows);
+  EXPECT_TRUE(readAllCsvRows("").empty());
+}
+
+/**
+ * @brief Test, if malformed quoted fields throw
+ */
+TEST(CsvReader, ThrowsOnMalformedData) {
+  std::vector<std::string_view> fields;
+
+  CsvReader unterminated(std::string_view("a,\"never closed\nb"));
+  EXPECT_THROW(unterminated.readRow(fields), std::runtime_error);
+
+  CsvReader characters_after_quote(std::string_view("\"a\"b,c"));
+  EXPECT_THROW(characters_after_quote.readRow(fields), std::runtime_error);
+}
+
+/**
+ * @brief Test, if the scanners find the first match at every position of a
+ * chunk, and return the end if there is no match
+ */
+TEST(CsvReader, FindsStructuralCharacters) {
+  for (std::size_t position = 0; position < 40; ++position) {
+    for (char character : {',', '\r', '\n', '"'}) {
+      std::string data(40, 'x');
+      data[position] = character;
+      const char* begin = data.data();
+      const char* end = data.data() + data.size();
+
+      const char* expected_field_end =
+          character == '"' ? end : begin + position;
+      const char* expected_quote = character == '"' ? begin + position : end;
+      EXPECT_EQ(CsvReader::findFieldEnd(begin, end), expected_field_end);
+      EXPECT_EQ(CsvReader::findQuote(begin, end), expected_quote);
+    }
+  }
+}
+}  // namespace tdmon
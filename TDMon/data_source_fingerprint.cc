@@ -0,0 +1,60 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#include <TDMon/data_source_fingerprint.h>
+#include <TDMon/database_file_state.h>
+
+namespace tdmon {
+DataSourceFingerprint DataSourceFingerprint::createForFile(
+    const std::filesystem::path& path, const std::string& user_identifier,
+    const IssueFilter& issue_filter) {
+  // the unit separator does not appear in paths or user-identifiers
+  const char kSeparator = '\x1f';
+
+  DataSourceFingerprint fingerprint;
+  fingerprint.identity = std::filesystem::absolute(path).string() +
+                         kSeparator + user_identifier + kSeparator +
+                         issue_filter.createKey();
+
+  const DatabaseFileState file_state = DatabaseFileState::read(path);
+  fingerprint.version = std::to_string(file_state.file_size) + kSeparator +
+                        std::to_string(file_state.last_write_time) +
+                        kSeparator +
+                        std::to_string(file_state.file_change_counter);
+
+  std::filesystem::path wal_path = path;
+  wal_path += "-wal";
+  std::error_code error_code;
+  if (std::filesystem::exists(wal_path, error_code)) {
+    fingerprint.version +=
+        kSeparator + std::to_string(std::filesystem::file_size(wal_path)) +
+        kSeparator +
+        std::to_string(std::filesystem::last_write_time(wal_path)
+                           .time_since_epoch()
+                           .count());
+  }
+
+  return fingerprint;
+}
+}  // namespace tdmon
@@ -0,0 +1,75 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <TDMon/issue_filter.h>
+
+#include <filesystem>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief Identifies the data a td-mon was created from, and the version of
+ * that data. If a td-mon factory reports the same fingerprint as the one stored
+ * with a cached td-mon, the td-mon would not change, so it does not need to be
+ * created again.
+ */
+struct DataSourceFingerprint {
+  /**
+   * @brief Identifies which data is used, e.g. the path of the dataset, the
+   * user-identifier and the issue filter
+   */
+  std::string identity;
+
+  /**
+   * @brief Identifies the version of the data, e.g. the size, last write time
+   * and change counter of the dataset file
+   */
+  std::string version;
+
+  /**
+   * @brief Create the fingerprint of a td-mon created from a dataset file.
+   *
+   * The version consists of the DatabaseFileState of the file. If the file is
+   * a sqlite database in WAL mode, commits are appended to the write-ahead log
+   * (<path>-wal) first, without changing the database file. So the size and
+   * last write time of the log are part of the version as well, if it exists.
+   * Throws, if the file cannot be read.
+   * @param path The path to the dataset file
+   * @param user_identifier The user-identifier whose issues are used
+   * @param issue_filter Specifies which issues are used
+   * @return The fingerprint
+   */
+  static DataSourceFingerprint createForFile(const std::filesystem::path& path,
+                                             const std::string& user_identifier,
+                                             const IssueFilter& issue_filter);
+
+  /**
+   * @brief Compare two fingerprints memberwise
+   * @return true, if all members are equal
+   */
+  bool operator==(const DataSourceFingerprint&) const = default;
+};
+}  // namespace tdmon
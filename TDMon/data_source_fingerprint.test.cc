@@ -0,0 +1,77 @@
+#include <TDMon/data_source_fingerprint.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace tdmon {
+const std::string kFingerprintTestFilePath = "./fingerprint_test.db";
+
+/**
+ * @brief Helper function. Write the test file.
+ * @param content The content of the file
+ */
+void writeFingerprintTestFile(const std::string& content) {
+  std::ofstream file(kFingerprintTestFilePath, std::ios::binary);
+  file << content;
+}
+
+TEST(DataSourceFingerprint, IdentifiesUserAndFilter) {
+  writeFingerprintTestFile("dataset");
+
+  const DataSourceFingerprint fingerprint =
+      DataSourceFingerprint::createForFile(kFingerprintTestFilePath, "Human1",
+                                           IssueFilter::createDefault());
+  EXPECT_EQ(fingerprint, DataSourceFingerprint::createForFile(
+                             kFingerprintTestFilePath, "Human1",
+                             IssueFilter::createDefault()));
+
+  const DataSourceFingerprint other_user_fingerprint =
+      DataSourceFingerprint::createForFile(kFingerprintTestFilePath, "Human2",
+                                           IssueFilter::createDefault());
+  EXPECT_NE(fingerprint.identity, other_user_fingerprint.identity);
+  EXPECT_EQ(fingerprint.version, other_user_fingerprint.version);
+
+  const DataSourceFingerprint other_filter_fingerprint =
+      DataSourceFingerprint::createForFile(kFingerprintTestFilePath, "Human1",
+                                           IssueFilter());
+  EXPECT_NE(fingerprint.identity, other_filter_fingerprint.identity);
+}
+
+TEST(DataSourceFingerprint, ChangesWithFile) {
+  std::filesystem::path wal_path = kFingerprintTestFilePath;
+  wal_path += "-wal";
+  std::filesystem::remove(wal_path);
+  writeFingerprintTestFile("dataset");
+
+  const DataSourceFingerprint fingerprint =
+      DataSourceFingerprint::createForFile(kFingerprintTestFilePath, "Human1",
+                                           IssueFilter());
+
+  // a size change is detected, even if the last write time is too coarse
+  writeFingerprintTestFile("changed dataset");
+  const DataSourceFingerprint changed_fingerprint =
+      DataSourceFingerprint::createForFile(kFingerprintTestFilePath, "Human1",
+                                           IssueFilter());
+  EXPECT_EQ(fingerprint.identity, changed_fingerprint.identity);
+  EXPECT_NE(fingerprint.version, changed_fingerprint.version);
+
+  // commits in WAL mode only change the write-ahead log
+  {
+    std::ofstream wal_file(wal_path, std::ios::binary);
+    wal_file << "commit";
+  }
+  EXPECT_NE(changed_fingerprint.version,
+            DataSourceFingerprint::createForFile(kFingerprintTestFilePath,
+                                                 "Human1", IssueFilter())
+                .version);
+  std::filesystem::remove(wal_path);
+}
+
+TEST(DataSourceFingerprint, ThrowsForMissingFile) {
+  std::filesystem::remove(kFingerprintTestFilePath);
+  EXPECT_ANY_THROW(DataSourceFingerprint::createForFile(
+      kFingerprintTestFilePath, "Human1", IssueFilter()));
+}
+}  // namespace tdmon
@@ -0,0 +1,58 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#include <TDMon/database_file_state.h>
+
+#include <array>
+#include <fstream>
+#include <stdexcept>
+
+namespace tdmon {
+DatabaseFileState DatabaseFileState::read(const std::filesystem::path& path) {
+  DatabaseFileState state;
+  state.file_size = std::filesystem::file_size(path);
+  state.last_write_time =
+      std::filesystem::last_write_time(path).time_since_epoch().count();
+
+  if (state.file_size >= kFileChangeCounterOffset + 4) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+      throw std::runtime_error("cannot open database file to read its state");
+    }
+
+    // the counter is stored as a 4 byte big-endian integer
+    std::array<unsigned char, 4> bytes{};
+    file.seekg(kFileChangeCounterOffset);
+    file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    if (file) {
+      state.file_change_counter = (std::uint32_t(bytes[0]) << 24) |
+                                  (std::uint32_t(bytes[1]) << 16) |
+                                  (std::uint32_t(bytes[2]) << 8) |
+                                  std::uint32_t(bytes[3]);
+    }
+  }
+
+  return state;
+}
+}  // namespace tdmon
@@ -0,0 +1,78 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+namespace tdmon {
+/**
+ * @brief The state of a sqlite database file on disk. Used to detect whether
+ * the file changed since it was last read.
+ *
+ * Besides the size and last write time of the file, the "file change counter"
+ * from the sqlite database header is used. sqlite increments it on every
+ * committed write transaction, so changes are detected even if the size and
+ * the (coarse) last write time of the file stay the same.
+ */
+struct DatabaseFileState {
+  /**
+   * @brief The byte offset of the file change counter in the sqlite database
+   * header
+   */
+  static const std::uintmax_t kFileChangeCounterOffset = 24;
+
+  /**
+   * @brief The size of the file in bytes
+   */
+  std::uintmax_t file_size = 0;
+
+  /**
+   * @brief The last write time of the file, in ticks of
+   * std::filesystem::file_time_type
+   */
+  long long last_write_time = 0;
+
+  /**
+   * @brief The file change counter from the sqlite database header. 0, if the
+   * file is too small to contain a header.
+   */
+  std::uint32_t file_change_counter = 0;
+
+  /**
+   * @brief Read the current state of a database file from disk. Throws, if the
+   * file does not exist or cannot be read.
+   * @param path The path to the database file
+   * @return The state of the file
+   */
+  static DatabaseFileState read(const std::filesystem::path& path);
+
+  /**
+   * @brief Compare two states memberwise
+   * @return true, if all members are equal
+   */
+  bool operator==(const DatabaseFileState&) const = default;
+};
+}  // namespace tdmon
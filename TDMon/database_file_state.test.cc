@@ -0,0 +1,50 @@
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/database_file_state.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief The path to the database used by the DatabaseFileState tests
+ */
+const std::string kFileStateTestDbPath = "./file_state_test.db";
+
+/**
+ * @brief Test, if reading the state of a missing file throws.
+ */
+TEST(DatabaseFileState, ThrowsForMissingFile) {
+  std::filesystem::remove(kFileStateTestDbPath);
+
+  EXPECT_ANY_THROW(DatabaseFileState::read(kFileStateTestDbPath));
+}
+
+/**
+ * @brief Test, if a committed write changes the state, even if the size of the
+ * database file stays the same.
+ */
+TEST(DatabaseFileState, DetectsCommittedWrites) {
+  std::filesystem::remove(kFileStateTestDbPath);
+
+  SQLite::Database db(kFileStateTestDbPath,
+                      SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+  db.exec("CREATE TABLE TEST (VALUE INTEGER); INSERT INTO TEST VALUES (1);");
+
+  const DatabaseFileState state0 =
+      DatabaseFileState::read(kFileStateTestDbPath);
+  EXPECT_EQ(state0, DatabaseFileState::read(kFileStateTestDbPath));
+
+  // small update, which does not change the size of the file
+  db.exec("UPDATE TEST SET VALUE = 2;");
+
+  const DatabaseFileState state1 =
+      DatabaseFileState::read(kFileStateTestDbPath);
+  EXPECT_EQ(state0.file_size, state1.file_size);
+  EXPECT_NE(state0.file_change_counter, state1.file_change_counter);
+  EXPECT_NE(state0, state1);
+}
+}  // namespace tdmon
@@ -0,0 +1,113 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#include <TDMon/technical_debt_dataset_generator.h>
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+/**
+ * @brief Print the usage of the dataset generator
+ * @param program_name The name of the program
+ */
+void printUsage(std::string_view program_name) {
+  std::cerr
+      << "Usage: " << program_name << " <output.db> [options]\n"
+      << "Options:\n"
+      << "  --issues=<count>      number of issues (default 10000)\n"
+      << "  --seed=<seed>         seed of the random number generator "
+         "(default 1)\n"
+      << "  --users=<count>       number of users (default 1000)\n"
+      << "  --zipf=<exponent>     Zipf exponent of the users (default 1.0)\n"
+      << "  --projects=<count>    number of projects (default 30)\n"
+      << "  --resolved=<ratio>    ratio of resolved issues (default 0.8)\n"
+      << "  --watch-mean=<mean>   mean watch count (default 2.0)\n";
+}
+
+/**
+ * @brief Parse a command line option of the form --name=value
+ * @param argument The command line argument
+ * @param name The name of the option, including the leading dashes
+ * @param value The value of the option, if the argument matches
+ * @return true, if the argument is the given option
+ */
+bool parseOption(std::string_view argument, std::string_view name,
+                 std::string& value) {
+  if (!argument.starts_with(name) || argument.size() <= name.size() ||
+      argument[name.size()] != '=') {
+    return false;
+  }
+  value = argument.substr(name.size() + 1);
+  return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  tdmon::TechnicalDebtDatasetGenerator::Options options;
+  try {
+    for (int i = 2; i < argc; ++i) {
+      std::string value;
+      if (parseOption(argv[i], "--issues", value)) {
+        options.issue_count = std::stoull(value);
+      } else if (parseOption(argv[i], "--seed", value)) {
+        options.seed = std::stoull(value);
+      } else if (parseOption(argv[i], "--users", value)) {
+        options.user_count = static_cast<std::uint32_t>(std::stoul(value));
+      } else if (parseOption(argv[i], "--zipf", value)) {
+        options.user_zipf_exponent = std::stod(value);
+      } else if (parseOption(argv[i], "--projects", value)) {
+        options.project_count = static_cast<std::uint32_t>(std::stoul(value));
+      } else if (parseOption(argv[i], "--resolved", value)) {
+        options.resolved_ratio = std::stod(value);
+      } else if (parseOption(argv[i], "--watch-mean", value)) {
+        options.mean_watch_count = std::stod(value);
+      } else {
+        std::cerr << "Unknown option: " << argv[i] << "\n";
+        printUsage(argv[0]);
+        return 1;
+      }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    tdmon::TechnicalDebtDatasetGenerator(options).generate(argv[1]);
+    const std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << "Generated " << options.issue_count << " issues in "
+              << duration.count() << "s\n";
+  } catch (const std::exception& e) {
+    std::cerr << "Generating the dataset failed: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,45 @@
+#include <TDMon/default_td_mon.h>
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+namespace tdmon {
+/**
+ * @brief Benchmark serializing a td-mon to json
+ */
+void BM_DefaultTdMonToJson(benchmark::State& state) {
+  DefaultTdMon td_mon(12, 34, 56);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(td_mon.toJson());
+  }
+}
+BENCHMARK(BM_DefaultTdMonToJson);
+
+/**
+ * @brief Benchmark deserializing a td-mon from json
+ */
+void BM_DefaultTdMonFromJson(benchmark::State& state) {
+  const nlohmann::json json = DefaultTdMon(12, 34, 56).toJson();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DefaultTdMon::fromJson(json));
+  }
+}
+BENCHMARK(BM_DefaultTdMonFromJson);
+
+/**
+ * @brief Benchmark getting the texture path (including the level calculation)
+ * of a td-mon. The argument is the value of attack, defense and speed, so each
+ * of the three textures is covered.
+ */
+void BM_DefaultTdMonGetTexturePath(benchmark::State& state) {
+  const unsigned int value = static_cast<unsigned int>(state.range(0));
+  DefaultTdMon td_mon(value, value, value);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(td_mon.getTexturePath());
+  }
+}
+BENCHMARK(BM_DefaultTdMonGetTexturePath)
+    ->Arg(0)
+    ->Arg(DefaultTdMon::kLevelCap1)
+    ->Arg(DefaultTdMon::kLevelCap2);
+}  // namespace tdmon
@@ -59,6 +59,8 @@ nlohmann::json tdmon::DefaultTdMon::toJson() const {
   return json;
 }
 
+std::uint32_t DefaultTdMon::getTypeId() const { return kTypeId; }
+
 std::unique_ptr<TdMon> DefaultTdMon::fromJson(nlohmann::json json) {
   return std::make_unique<DefaultTdMon>(
       json.at(kAttackKeyString).get<unsigned int>(),
@@ -76,7 +78,7 @@ const std::string& DefaultTdMon::getTexturePath()const {
   }
 }
 
-const std::string DefaultTdMon::kTypeIdentifierString = "DefaultTdMon";
+const std::string DefaultTdMon::kTypeIdentifierString(kTypeIdentifier);
 const std::string DefaultTdMon::kAttackKeyString = "Attack";
 const std::string DefaultTdMon::kDefenseKeyString = "Defense";
 const std::string DefaultTdMon::kSpeedKeyString = "Speed";
@@ -39,6 +39,17 @@ class DefaultTdMon : public TdMon {
    */
   static const std::string kTypeIdentifierString;
 
+  /**
+   * @brief This classes type identifier string at compile time. Has the same
+   * value as kTypeIdentifierString.
+   */
+  static constexpr std::string_view kTypeIdentifier = "DefaultTdMon";
+
+  /**
+   * @brief This classes type id (see TdMon::hashTypeIdentifier())
+   */
+  static constexpr std::uint32_t kTypeId = hashTypeIdentifier(kTypeIdentifier);
+
   /**
    * @brief The key string for the attack value when serializing this class to
    * json
@@ -121,6 +132,12 @@ class DefaultTdMon : public TdMon {
    */
   nlohmann::json toJson() const override;
 
+  /**
+   * @brief Get the type id of this class
+   * @return kTypeId
+   */
+  std::uint32_t getTypeId() const override;
+
   /**
    * @brief Create a new DefaultTdMon from json
    * @param json The json to create from
@@ -0,0 +1,33 @@
+#include <TDMon/default_td_mon.h>
+#include <TDMon/default_td_mon_cache.h>
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+namespace tdmon {
+/**
+ * @brief Benchmark storing the cache on disk
+ */
+void BM_DefaultTdMonCacheStoreOnDisk(benchmark::State& state) {
+  DefaultTdMonCache cache;
+  cache.updateCache(std::make_unique<DefaultTdMon>(12, 34, 56));
+  for (auto _ : state) {
+    cache.storeOnDisk();
+  }
+}
+BENCHMARK(BM_DefaultTdMonCacheStoreOnDisk);
+
+/**
+ * @brief Benchmark loading the cache from disk
+ */
+void BM_DefaultTdMonCacheLoadFromDisk(benchmark::State& state) {
+  DefaultTdMonCache cache;
+  cache.updateCache(std::make_unique<DefaultTdMon>(12, 34, 56));
+  cache.storeOnDisk();
+  for (auto _ : state) {
+    cache.loadFromDisk();
+    benchmark::DoNotOptimize(cache.getCache());
+  }
+}
+BENCHMARK(BM_DefaultTdMonCacheLoadFromDisk);
+}  // namespace tdmon
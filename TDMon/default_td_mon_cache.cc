@@ -22,54 +22,60 @@
  *
  *********************************/
 
-#include <TDMon/default_td_mon.h>
+#include <TDMon/atomic_file_writer.h>
 #include <TDMon/default_td_mon_cache.h>
 
-#include <fstream>
-
 namespace tdmon {
 void DefaultTdMonCache::storeOnDisk() const {
+  AtomicFileWriter::write(kCacheFilePath, encodeForDisk());
+}
+
+std::vector<char> DefaultTdMonCache::encodeForDisk() const {
   if (!hasCache()) {
     throw std::exception("cannot store empty cache");
   }
 
-  std::ofstream file(kCacheFilePath);
-  if (!file.is_open()) {
-    throw std::exception("cannot open cache file to write cache to disk");
+  if (file_format_ == TdMonCacheFileFormat::kBinary) {
+    TdMonCacheFile cache_file;
+    cache_file.add(*cache_, last_updated_timestamp_, data_source_fingerprint_);
+    return cache_file.encode(file_format_);
   }
 
-  nlohmann::json json = cache_->toJson();
-  // append timestamp
-  json[kTimestampKeyString] = last_updated_timestamp_.count();
+  // a single entry, readable by older versions
+  const std::string contents =
+      TdMonCacheFile::entryToJson(*cache_, last_updated_timestamp_,
+                                  data_source_fingerprint_)
+          .dump();
+  return std::vector<char>(contents.begin(), contents.end());
+}
 
-  file << json;
+std::filesystem::path DefaultTdMonCache::getCacheFilePath() const {
+  return kCacheFilePath;
+}
+
+std::uint64_t DefaultTdMonCache::getModificationCount() const {
+  return modification_count_;
 }
 
 void DefaultTdMonCache::loadFromDisk() {
-  nlohmann::json json;
-  std::ifstream file(kCacheFilePath);
-  if (!file.is_open()) {
-    throw std::exception("cannot open cache file to read cache from disk");
+  std::vector<TdMonCacheEntry> entries = TdMonCacheFile::read(kCacheFilePath);
+  if (entries.empty()) {
+    throw std::exception("cache file does not contain a td-mon");
   }
 
-  file >> json;
-
-  // deserialize
-  if (json[TdMon::kJsonTypeIdentifierKey] ==
-      DefaultTdMon::kTypeIdentifierString) {
-    // deserialize default td-mon
-    cache_ = DefaultTdMon::fromJson(json);
-    // deserialize lsat updated timestamp
-    last_updated_timestamp_ = std::chrono::microseconds(
-        json.at(kTimestampKeyString).get<long long>());
-  } else {
-    throw std::exception(
-        "td-mon type not suppoted for deserialization in DefaultTdMonCache");
-  }
+  // only a single td-mon is cached. Files holding more entries start with the
+  // most recently used one
+  cache_ = std::move(entries.front().td_mon);
+  last_updated_timestamp_ = entries.front().last_updated_timestamp;
+  data_source_fingerprint_ =
+      std::move(entries.front().data_source_fingerprint);
+  ++modification_count_;
 }
 
 void DefaultTdMonCache::updateCache(std::unique_ptr<TdMon> data) {
   cache_ = std::move(data);
+  data_source_fingerprint_ = std::nullopt;
+  ++modification_count_;
 
   // update the "last updated" timestamp to the current seconds since Unix epoch
   last_updated_timestamp_ =
@@ -85,11 +91,40 @@ std::chrono::microseconds DefaultTdMonCache::getLastUpdatedTimestamp() const {
 
 bool DefaultTdMonCache::hasCache() const { return cache_ != nullptr; }
 
+void DefaultTdMonCache::setDataSourceFingerprint(
+    std::optional<DataSourceFingerprint> fingerprint) {
+  data_source_fingerprint_ = std::move(fingerprint);
+  ++modification_count_;
+}
+
+const std::optional<DataSourceFingerprint>&
+DefaultTdMonCache::getDataSourceFingerprint() const {
+  return data_source_fingerprint_;
+}
+
+bool DefaultTdMonCache::selectEntry(const std::string& source_identity) {
+  return hasCache() && data_source_fingerprint_ &&
+         data_source_fingerprint_->identity == source_identity;
+}
+
+void DefaultTdMonCache::setFileFormat(TdMonCacheFileFormat file_format) {
+  file_format_ = file_format;
+  ++modification_count_;
+}
+
+TdMonCacheFileFormat DefaultTdMonCache::getFileFormat() const {
+  return file_format_;
+}
+
 bool DefaultTdMonCache::existsOnDisk() const {
   return std::filesystem::exists(std::filesystem::path(kCacheFilePath));
 }
 
 const std::string DefaultTdMonCache::kCacheFilePath = "./cache.json";
 const std::string DefaultTdMonCache::kTimestampKeyString = "_timestamp";
+const std::string DefaultTdMonCache::kSourceIdentityKeyString =
+    "_source_identity";
+const std::string DefaultTdMonCache::kSourceVersionKeyString =
+    "_source_version";
 
 }  // namespace tdmon
@@ -26,14 +26,16 @@
 
 #include <TDMon/td_mon.h>
 #include <TDMon/td_mon_cache.h>
+#include <TDMon/td_mon_cache_file.h>
 
 #include <chrono>
+#include <optional>
 
 namespace tdmon {
 /**
- * @brief The default implementation of the TdMonCache. This implementation
- * currently only supports serialization/deserialization of DefaultTdMon
- * objects
+ * @brief The default implementation of the TdMonCache. It holds a single
+ * td-mon of any type registered in the TdMonCacheTypeRegistry, which is
+ * deserialized by the type named in the cache file.
  */
 class DefaultTdMonCache : public TdMonCache {
  public:
@@ -47,15 +49,48 @@ class DefaultTdMonCache : public TdMonCache {
    */
   static const std::string kTimestampKeyString;
 
+  /**
+   * @brief The json key for the identity of the data source fingerprint. Only
+   * stored, if the fingerprint is known.
+   */
+  static const std::string kSourceIdentityKeyString;
+
+  /**
+   * @brief The json key for the version of the data source fingerprint. Only
+   * stored, if the fingerprint is known.
+   */
+  static const std::string kSourceVersionKeyString;
+
   // Inherited via TdMonCache
 
   /**
-   * @brief Stores the current cache to disk. Throws, if the internal cache is currently empty.
+   * @brief Stores the current cache to disk in the selected file format.
+   * Throws, if the internal cache is currently empty.
    */
   void storeOnDisk() const override;
 
   /**
-   * @brief Loads the current cache from disk
+   * @brief Encode the current cache as it is stored on disk. Throws, if the
+   * internal cache is currently empty.
+   * @return The contents of the cache file
+   */
+  std::vector<char> encodeForDisk() const override;
+
+  /**
+   * @brief Get the path of the cache file on disk
+   * @return kCacheFilePath
+   */
+  std::filesystem::path getCacheFilePath() const override;
+
+  /**
+   * @brief Get the number of modifications of the cache
+   * @return The number of modifications
+   */
+  std::uint64_t getModificationCount() const override;
+
+  /**
+   * @brief Loads the current cache from disk. The file format is detected
+   * automatically, independent of the selected one.
    */
   void loadFromDisk() override;
 
@@ -88,6 +123,41 @@ class DefaultTdMonCache : public TdMonCache {
   */
   std::chrono::microseconds getLastUpdatedTimestamp() const override;
 
+  /**
+   * @brief Set the fingerprint of the data the cached td-mon was created from
+   * @param fingerprint The fingerprint. Empty, if it is unknown.
+   */
+  void setDataSourceFingerprint(
+      std::optional<DataSourceFingerprint> fingerprint) override;
+
+  /**
+   * @brief Get the fingerprint of the data the cached td-mon was created from
+   * @return The fingerprint. Empty, if it is unknown.
+   */
+  const std::optional<DataSourceFingerprint>& getDataSourceFingerprint()
+      const override;
+
+  /**
+   * @brief Check whether the cached td-mon was created from the data source
+   * with the given identity. Only a single td-mon is cached, so there is
+   * nothing else to select.
+   * @param source_identity The identity of the data source
+   * @return true, if the cached td-mon was created from the data source
+   */
+  bool selectEntry(const std::string& source_identity) override;
+
+  /**
+   * @brief Select the format to store the cache file in. Json by default.
+   * @param file_format The file format
+   */
+  void setFileFormat(TdMonCacheFileFormat file_format);
+
+  /**
+   * @brief Get the format the cache file is stored in
+   * @return The file format
+   */
+  TdMonCacheFileFormat getFileFormat() const;
+
  private:
   /**
    * @brief The cache
@@ -99,5 +169,20 @@ class DefaultTdMonCache : public TdMonCache {
   */
   std::chrono::microseconds last_updated_timestamp_ =
       std::chrono::microseconds(0);
+
+  /**
+   * @brief The fingerprint of the data the cached td-mon was created from
+   */
+  std::optional<DataSourceFingerprint> data_source_fingerprint_;
+
+  /**
+   * @brief The format to store the cache file in
+   */
+  TdMonCacheFileFormat file_format_ = TdMonCacheFileFormat::kJson;
+
+  /**
+   * @brief The number of modifications of the cache
+   */
+  std::uint64_t modification_count_ = 0;
 };
 }  // namespace tdmon
@@ -205,4 +205,74 @@ TEST(DefaultTdMonCache, ChangesTimestampOnUpdate) {
   EXPECT_NE(timestamp0, timestamp1);
 }
 
+/**
+ * @brief Test, if the data source fingerprint is stored to and loaded from
+ * disk, and cleared when the cache is updated without one.
+ */
+TEST(DefaultTdMonCache, StoresDataSourceFingerprint) {
+  const DataSourceFingerprint fingerprint{"dataset.db Human1", "1 2 3"};
+
+  {
+    DefaultTdMonCache cache;
+    cache.updateCache(std::make_unique<DefaultTdMon>(100, 200, 300));
+    EXPECT_FALSE(cache.getDataSourceFingerprint().has_value());
+    cache.setDataSourceFingerprint(fingerprint);
+    cache.storeOnDisk();
+  }
+
+  DefaultTdMonCache cache;
+  cache.loadFromDisk();
+  EXPECT_EQ(cache.getDataSourceFingerprint(), fingerprint);
+
+  cache.updateCache(std::make_unique<DefaultTdMon>(100, 200, 300));
+  EXPECT_FALSE(cache.getDataSourceFingerprint().has_value());
+
+  // caches without fingerprint have none after loading
+  cache.storeOnDisk();
+  cache.setDataSourceFingerprint(fingerprint);
+  cache.loadFromDisk();
+  EXPECT_FALSE(cache.getDataSourceFingerprint().has_value());
+}
+
+/**
+ * @brief Test, if the cache is stored in the binary format, if selected, and
+ * loaded again without selecting the format.
+ */
+TEST(DefaultTdMonCache, StoresInBinaryFormat) {
+  const DataSourceFingerprint fingerprint{"dataset.db Human1", "1 2 3"};
+
+  {
+    DefaultTdMonCache cache;
+    EXPECT_EQ(cache.getFileFormat(), TdMonCacheFileFormat::kJson);
+    cache.setFileFormat(TdMonCacheFileFormat::kBinary);
+    cache.updateCache(std::make_unique<DefaultTdMon>(100, 200, 300));
+    cache.setDataSourceFingerprint(fingerprint);
+    cache.storeOnDisk();
+  }
+
+  DefaultTdMonCache cache;
+  cache.loadFromDisk();
+  EXPECT_EQ(cache.getCache()->getDefenseValue(), 200);
+  EXPECT_EQ(cache.getDataSourceFingerprint(), fingerprint);
+  EXPECT_NE(cache.getLastUpdatedTimestamp(), std::chrono::microseconds(0));
+
+  std::filesystem::remove(DefaultTdMonCache::kCacheFilePath);
+}
+
+/**
+ * @brief Test, if only the data source of the cached td-mon can be selected
+ */
+TEST(DefaultTdMonCache, SelectsEntryOfCachedDataSourceOnly) {
+  DefaultTdMonCache cache;
+  EXPECT_FALSE(cache.selectEntry("dataset.db Human1"));
+
+  cache.updateCache(std::make_unique<DefaultTdMon>(100, 200, 300));
+  EXPECT_FALSE(cache.selectEntry("dataset.db Human1"));
+
+  cache.setDataSourceFingerprint(
+      DataSourceFingerprint{"dataset.db Human1", "1 2 3"});
+  EXPECT_TRUE(cache.selectEntry("dataset.db Human1"));
+  EXPECT_FALSE(cache.selectEntry("dataset.db Human2"));
+  EXPECT_TRUE(cache.hasCache());
+}
 }  // namespace tdmon
@@ -0,0 +1,138 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/frame_scheduler.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace tdmon {
+FrameScheduler::FrameScheduler(FrameSchedulingMode mode, ClockFunction clock)
+    : clock_(std::move(clock)),
+      mode_(mode),
+      next_frame_time_(clock_()),
+      next_step_time_(next_frame_time_) {}
+
+void FrameScheduler::setMode(FrameSchedulingMode mode) {
+  mode_ = mode;
+  // start stepping from now, instead of catching up
+  next_step_time_ = clock_();
+  redraw_requested_ = true;
+}
+
+FrameSchedulingMode FrameScheduler::getMode() const { return mode_; }
+
+void FrameScheduler::setFrameRateLimit(unsigned int frame_rate_limit) {
+  frame_period_ =
+      std::chrono::microseconds(1000000 / std::max(frame_rate_limit, 1u));
+}
+
+void FrameScheduler::setFixedTimestep(
+    std::chrono::microseconds fixed_timestep) {
+  fixed_timestep_ = std::max(fixed_timestep, std::chrono::microseconds(1));
+}
+
+void FrameScheduler::setIdlePollInterval(
+    std::chrono::microseconds idle_poll_interval) {
+  idle_poll_interval_ = idle_poll_interval;
+}
+
+void FrameScheduler::requestRedraw() { redraw_requested_ = true; }
+
+bool FrameScheduler::isRedrawRequested() const { return redraw_requested_; }
+
+std::optional<std::chrono::microseconds> FrameScheduler::getWaitTime(
+    bool needs_updates_without_events) const {
+  const Clock::time_point now = clock_();
+  // time until a point in time, but not negative
+  auto getTimeUntil = [now](Clock::time_point time_point) {
+    return std::max(std::chrono::duration_cast<std::chrono::microseconds>(
+                        time_point - now),
+                    std::chrono::microseconds(0));
+  };
+
+  switch (mode_) {
+    case FrameSchedulingMode::kEventDriven:
+      if (redraw_requested_) {
+        return getTimeUntil(next_frame_time_);
+      }
+      if (needs_updates_without_events) {
+        return idle_poll_interval_;
+      }
+      // nothing to do until the next event
+      return std::nullopt;
+    case FrameSchedulingMode::kCappedFrameRate:
+      return getTimeUntil(next_frame_time_);
+    case FrameSchedulingMode::kFixedTimestep:
+    default:
+      return getTimeUntil(next_step_time_);
+  }
+}
+
+unsigned int FrameScheduler::beginFrame() {
+  if (mode_ != FrameSchedulingMode::kFixedTimestep) {
+    return 1;
+  }
+
+  const Clock::time_point now = clock_();
+  current_step_count_ = 0;
+  while (next_step_time_ <= now && current_step_count_ < kMaxStepsPerFrame) {
+    next_step_time_ += fixed_timestep_;
+    ++current_step_count_;
+  }
+  // skip the steps that cannot be caught up with
+  if (next_step_time_ <= now) {
+    next_step_time_ = now + fixed_timestep_;
+  }
+  return current_step_count_;
+}
+
+bool FrameScheduler::finishFrame() {
+  const Clock::time_point now = clock_();
+
+  bool redraw = false;
+  switch (mode_) {
+    case FrameSchedulingMode::kEventDriven:
+      redraw = redraw_requested_ && now >= next_frame_time_;
+      break;
+    case FrameSchedulingMode::kCappedFrameRate:
+      redraw = now >= next_frame_time_;
+      break;
+    case FrameSchedulingMode::kFixedTimestep:
+    default:
+      // the state only changes in update steps
+      redraw = current_step_count_ > 0 || redraw_requested_;
+      break;
+  }
+
+  if (redraw) {
+    redraw_requested_ = false;
+    // keep the cadence of the frames, unless the last one is too long ago
+    next_frame_time_ += frame_period_;
+    if (next_frame_time_ <= now) {
+      next_frame_time_ = now + frame_period_;
+    }
+  }
+  return redraw;
+}
+}  // namespace tdmon
@@ -0,0 +1,234 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <optional>
+
+namespace tdmon {
+/**
+ * @brief The ways the FrameScheduler schedules frames
+ */
+enum class FrameSchedulingMode {
+  /**
+   * @brief Redraw only after events or when a redraw was requested. While
+   * idle, the main loop waits for events instead of running. Best for the
+   * mostly static ui of the application.
+   */
+  kEventDriven,
+
+  /**
+   * @brief Update and redraw continuously, at most at the frame rate limit
+   */
+  kCappedFrameRate,
+
+  /**
+   * @brief Update in steps of a fixed duration and redraw after each batch of
+   * steps. Keeps animations at a constant speed, independent of the frame
+   * rate.
+   */
+  kFixedTimestep
+};
+
+/**
+ * @brief Decides when the main loop waits, updates the application state and
+ * redraws the window, so the application does not keep a cpu core busy while
+ * nothing changes.
+ *
+ * Each iteration of the main loop asks getWaitTime() how long to wait for
+ * events, handles the events, calls beginFrame() to get the number of updates
+ * to run, and redraws the window, if finishFrame() returns true. Events and
+ * changes of the gui request a redraw with requestRedraw().
+ *
+ * The current time is taken from an injectable clock, so the behavior can be
+ * tested without waiting. Not thread-safe.
+ */
+class FrameScheduler {
+ public:
+  /**
+   * @brief The clock used to schedule frames
+   */
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Returns the current time
+   */
+  using ClockFunction = std::function<Clock::time_point()>;
+
+  /**
+   * @brief The default maximum number of frames per second
+   */
+  static constexpr unsigned int kDefaultFrameRateLimit = 60;
+
+  /**
+   * @brief The default duration of an update step in kFixedTimestep mode
+   */
+  static constexpr std::chrono::microseconds kDefaultFixedTimestep =
+      std::chrono::microseconds(1000000 / 60);
+
+  /**
+   * @brief The default time to wait for events in kEventDriven mode, if the
+   * application state needs updates without events. Bounds the input latency
+   * in that case.
+   */
+  static constexpr std::chrono::microseconds kDefaultIdlePollInterval =
+      std::chrono::milliseconds(10);
+
+  /**
+   * @brief The maximum number of update steps per frame in kFixedTimestep
+   * mode. If updating takes longer than the timestep, further steps are
+   * skipped, instead of falling behind more and more.
+   */
+  static constexpr unsigned int kMaxStepsPerFrame = 5;
+
+  /**
+   * @brief The constructor. The first frame is redrawn in any mode.
+   * @param mode The scheduling mode
+   * @param clock Returns the current time. Defaults to the steady clock.
+   */
+  explicit FrameScheduler(
+      FrameSchedulingMode mode = FrameSchedulingMode::kEventDriven,
+      ClockFunction clock = &Clock::now);
+
+  /**
+   * @brief Set the scheduling mode. Requests a redraw.
+   * @param mode The scheduling mode
+   */
+  void setMode(FrameSchedulingMode mode);
+
+  /**
+   * @brief Get the scheduling mode
+   * @return The scheduling mode
+   */
+  FrameSchedulingMode getMode() const;
+
+  /**
+   * @brief Set the maximum number of frames per second. Limits redraws in
+   * kEventDriven and kCappedFrameRate mode.
+   * @param frame_rate_limit The frame rate limit. At least 1 is used.
+   */
+  void setFrameRateLimit(unsigned int frame_rate_limit);
+
+  /**
+   * @brief Set the duration of an update step in kFixedTimestep mode
+   * @param fixed_timestep The duration of a step. At least 1 microsecond is
+   * used.
+   */
+  void setFixedTimestep(std::chrono::microseconds fixed_timestep);
+
+  /**
+   * @brief Set the time to wait for events in kEventDriven mode, if the
+   * application state needs updates without events
+   * @param idle_poll_interval The poll interval
+   */
+  void setIdlePollInterval(std::chrono::microseconds idle_poll_interval);
+
+  /**
+   * @brief Request a redraw, e.g. after an event or a change of the gui
+   */
+  void requestRedraw();
+
+  /**
+   * @brief Get whether a redraw was requested since the last one
+   * @return true, if a redraw is requested
+   */
+  bool isRedrawRequested() const;
+
+  /**
+   * @brief Get how long the main loop should wait for events before the next
+   * frame
+   * @param needs_updates_without_events true, if the application state must be
+   * updated regularly, even if no events occur
+   * @return The time to wait. Zero, if the next frame is due. Empty, if the
+   * main loop should block until the next event.
+   */
+  std::optional<std::chrono::microseconds> getWaitTime(
+      bool needs_updates_without_events) const;
+
+  /**
+   * @brief Start a frame, after waiting and handling the events
+   * @return The number of times to update the application state in this
+   * frame. Always 1, except in kFixedTimestep mode, where it is the number of
+   * steps due (may be 0).
+   */
+  unsigned int beginFrame();
+
+  /**
+   * @brief Finish a frame, after updating the application state
+   * @return true, if the window should be redrawn now. The redraw request is
+   * reset in that case.
+   */
+  bool finishFrame();
+
+ private:
+  /**
+   * @brief Returns the current time
+   */
+  ClockFunction clock_;
+
+  /**
+   * @brief The scheduling mode
+   */
+  FrameSchedulingMode mode_;
+
+  /**
+   * @brief The minimum time between two redraws
+   */
+  std::chrono::microseconds frame_period_ =
+      std::chrono::microseconds(1000000 / kDefaultFrameRateLimit);
+
+  /**
+   * @brief The duration of an update step in kFixedTimestep mode
+   */
+  std::chrono::microseconds fixed_timestep_ = kDefaultFixedTimestep;
+
+  /**
+   * @brief The time to wait for events in kEventDriven mode, if the
+   * application state needs updates without events
+   */
+  std::chrono::microseconds idle_poll_interval_ = kDefaultIdlePollInterval;
+
+  /**
+   * @brief true, if a redraw was requested since the last one
+   */
+  bool redraw_requested_ = true;
+
+  /**
+   * @brief No redraw before this time, except in kFixedTimestep mode
+   */
+  Clock::time_point next_frame_time_;
+
+  /**
+   * @brief The time of the next update step in kFixedTimestep mode
+   */
+  Clock::time_point next_step_time_;
+
+  /**
+   * @brief The number of update steps of the current frame in kFixedTimestep
+   * mode
+   */
+  unsigned int current_step_count_ = 0;
+};
+}  // namespace tdmon
@@ -0,0 +1,133 @@
+#include <TDMon/frame_scheduler.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+namespace tdmon {
+/**
+ * @brief A clock that only advances when told to
+ */
+class FakeFrameClock {
+ public:
+  /**
+   * @brief Get the current time
+   * @return The current time
+   */
+  FrameScheduler::Clock::time_point now() const { return now_; }
+
+  /**
+   * @brief Advance the time
+   * @param duration The duration to advance by
+   */
+  void advance(std::chrono::milliseconds duration) { now_ += duration; }
+
+ private:
+  /**
+   * @brief The current time
+   */
+  FrameScheduler::Clock::time_point now_ =
+      FrameScheduler::Clock::time_point(std::chrono::hours(1000));
+};
+
+/**
+ * @brief Helper function. Create a scheduler using the fake clock, with a
+ * frame rate limit of 100 frames per second.
+ * @param mode The scheduling mode
+ * @param clock The fake clock. Must outlive the scheduler.
+ * @return The scheduler
+ */
+FrameScheduler createSchedulerWithFakeClock(FrameSchedulingMode mode,
+                                            FakeFrameClock& clock) {
+  FrameScheduler scheduler(mode, [&clock]() { return clock.now(); });
+  scheduler.setFrameRateLimit(100);
+  return scheduler;
+}
+
+/**
+ * @brief Test, if the event-driven mode only redraws after requests, and
+ * blocks for events while idle.
+ */
+TEST(FrameScheduler, EventDrivenModeWaitsForEventsWhileIdle) {
+  FakeFrameClock clock;
+  FrameScheduler scheduler =
+      createSchedulerWithFakeClock(FrameSchedulingMode::kEventDriven, clock);
+
+  // the first frame is drawn right away
+  EXPECT_EQ(scheduler.getWaitTime(false), std::chrono::microseconds(0));
+  EXPECT_EQ(scheduler.beginFrame(), 1);
+  EXPECT_TRUE(scheduler.finishFrame());
+
+  // idle: block, unless the application state needs updates
+  EXPECT_EQ(scheduler.getWaitTime(false), std::nullopt);
+  EXPECT_EQ(scheduler.getWaitTime(true),
+            FrameScheduler::kDefaultIdlePollInterval);
+  EXPECT_EQ(scheduler.beginFrame(), 1);
+  EXPECT_FALSE(scheduler.finishFrame());
+
+  // an event right after the last frame waits for the frame rate limit
+  clock.advance(std::chrono::milliseconds(4));
+  scheduler.requestRedraw();
+  EXPECT_EQ(scheduler.getWaitTime(false), std::chrono::milliseconds(6));
+  clock.advance(std::chrono::milliseconds(6));
+  scheduler.beginFrame();
+  EXPECT_TRUE(scheduler.finishFrame());
+  EXPECT_FALSE(scheduler.isRedrawRequested());
+
+  // after a long idle time, the next event is redrawn right away
+  clock.advance(std::chrono::seconds(10));
+  scheduler.requestRedraw();
+  EXPECT_EQ(scheduler.getWaitTime(false), std::chrono::microseconds(0));
+  scheduler.beginFrame();
+  EXPECT_TRUE(scheduler.finishFrame());
+}
+
+/**
+ * @brief Test, if the capped frame rate mode redraws every frame, but not
+ * more often than the frame rate limit allows.
+ */
+TEST(FrameScheduler, CappedFrameRateModeLimitsFrameRate) {
+  FakeFrameClock clock;
+  FrameScheduler scheduler = createSchedulerWithFakeClock(
+      FrameSchedulingMode::kCappedFrameRate, clock);
+
+  EXPECT_TRUE(scheduler.finishFrame());
+  // the next frame is due 10 ms after the last one, no matter how long the
+  // frame took
+  clock.advance(std::chrono::milliseconds(3));
+  EXPECT_EQ(scheduler.getWaitTime(false), std::chrono::milliseconds(7));
+  EXPECT_FALSE(scheduler.finishFrame());
+  clock.advance(std::chrono::milliseconds(7));
+  EXPECT_EQ(scheduler.getWaitTime(false), std::chrono::microseconds(0));
+  EXPECT_EQ(scheduler.beginFrame(), 1);
+  EXPECT_TRUE(scheduler.finishFrame());
+}
+
+/**
+ * @brief Test, if the fixed timestep mode runs one update per elapsed step,
+ * and skips steps it cannot catch up with.
+ */
+TEST(FrameScheduler, FixedTimestepModeRunsElapsedSteps) {
+  FakeFrameClock clock;
+  FrameScheduler scheduler =
+      createSchedulerWithFakeClock(FrameSchedulingMode::kFixedTimestep, clock);
+  scheduler.setFixedTimestep(std::chrono::milliseconds(10));
+
+  EXPECT_EQ(scheduler.beginFrame(), 1);
+  EXPECT_TRUE(scheduler.finishFrame());
+
+  // no step due yet, so nothing changed
+  clock.advance(std::chrono::milliseconds(4));
+  EXPECT_EQ(scheduler.getWaitTime(false), std::chrono::milliseconds(6));
+  EXPECT_EQ(scheduler.beginFrame(), 0);
+  EXPECT_FALSE(scheduler.finishFrame());
+
+  clock.advance(std::chrono::milliseconds(26));
+  EXPECT_EQ(scheduler.beginFrame(), 3);
+  EXPECT_TRUE(scheduler.finishFrame());
+
+  // a long stall only runs the maximum number of steps
+  clock.advance(std::chrono::seconds(1));
+  EXPECT_EQ(scheduler.beginFrame(), FrameScheduler::kMaxStepsPerFrame);
+  EXPECT_EQ(scheduler.getWaitTime(false), std::chrono::milliseconds(10));
+}
+}  // namespace tdmon
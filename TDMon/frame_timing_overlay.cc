@@ -0,0 +1,127 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/frame_timing_overlay.h>
+#include <TDMon/operation_latencies.h>
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+
+namespace tdmon {
+void FrameTimingOverlay::init(tgui::GuiSFML& gui) {
+  stats_label_ = tgui::Label::create();
+  stats_label_->setTextSize(kFontSize);
+  stats_label_->setPosition(0, 0);
+  stats_label_->getRenderer()->setTextColor(sf::Color::White);
+  stats_label_->getRenderer()->setBackgroundColor(sf::Color(0, 0, 0, 180));
+  stats_label_->setVisible(false);
+  gui.add(stats_label_);
+
+  for (sf::RectangleShape& histogram_bar : histogram_bars_) {
+    histogram_bar.setFillColor(sf::Color::Green);
+  }
+}
+
+void FrameTimingOverlay::toggle() {
+  is_visible_ = !is_visible_;
+  stats_label_->setVisible(is_visible_);
+  // refresh on the next update
+  next_refresh_time_ = std::chrono::steady_clock::time_point();
+}
+
+bool FrameTimingOverlay::isVisible() const { return is_visible_; }
+
+bool FrameTimingOverlay::update(const FrameTimingStats& stats) {
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  if (!is_visible_ || now < next_refresh_time_) {
+    return false;
+  }
+  next_refresh_time_ = now + kTextRefreshInterval;
+
+  const auto to_milliseconds = [](std::chrono::microseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  };
+
+  stats_text_.clear();
+  auto out = std::back_inserter(stats_text_);
+  out = std::format_to(
+      out, "frames: {}\nframe time p50/p95/p99: {:.2f}/{:.2f}/{:.2f} ms\n",
+      stats.getSampleCount(),
+      to_milliseconds(stats.getPercentile(FramePhase::kTotal, 50.0)),
+      to_milliseconds(stats.getPercentile(FramePhase::kTotal, 95.0)),
+      to_milliseconds(stats.getPercentile(FramePhase::kTotal, 99.0)));
+  out = std::format_to(
+      out,
+      "events/update/draw/display: {:.2f}/{:.2f}/{:.2f}/{:.2f} ms\n",
+      to_milliseconds(stats.getAverage(FramePhase::kEvents)),
+      to_milliseconds(stats.getAverage(FramePhase::kUpdate)),
+      to_milliseconds(stats.getAverage(FramePhase::kDraw)),
+      to_milliseconds(stats.getAverage(FramePhase::kDisplay)));
+  for (std::size_t i = 0; i < OperationLatencies::kOperationCount; ++i) {
+    const Operation operation = static_cast<Operation>(i);
+    const std::optional<std::chrono::microseconds> latency =
+        OperationLatencies::getLast(operation);
+    if (latency) {
+      out = std::format_to(out, "{}: {:.2f} ms\n",
+                           OperationLatencies::getName(operation),
+                           to_milliseconds(*latency));
+    } else {
+      out = std::format_to(out, "{}: -\n",
+                           OperationLatencies::getName(operation));
+    }
+  }
+  stats_label_->setText(stats_text_);
+  // stay on top of the gui elements added by later application states
+  stats_label_->moveToFront();
+
+  // scale the histogram to its highest bar
+  const auto& histogram = stats.getHistogram();
+  const std::size_t max_count =
+      std::max<std::size_t>(*std::max_element(histogram.begin(),
+                                              histogram.end()),
+                            1);
+  for (std::size_t i = 0; i < histogram.size(); ++i) {
+    histogram_bar_heights_[i] = kHistogramHeight *
+                                static_cast<float>(histogram[i]) /
+                                static_cast<float>(max_count);
+    histogram_bars_[i].setSize(
+        sf::Vector2f(kHistogramBarWidth - 1.0f, histogram_bar_heights_[i]));
+  }
+  return true;
+}
+
+void FrameTimingOverlay::draw(sf::RenderWindow& window) {
+  if (!is_visible_) {
+    return;
+  }
+  // the histogram grows upwards from the bottom left corner of the window
+  const float bottom = static_cast<float>(window.getSize().y);
+  for (std::size_t i = 0; i < histogram_bars_.size(); ++i) {
+    histogram_bars_[i].setPosition(static_cast<float>(i) * kHistogramBarWidth,
+                                   bottom - histogram_bar_heights_[i]);
+    window.draw(histogram_bars_[i]);
+  }
+}
+}  // namespace tdmon
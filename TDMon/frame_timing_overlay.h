@@ -0,0 +1,142 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <TDMon/frame_timing_stats.h>
+
+#include <SFML/Graphics.hpp>
+#include <TGUI/Backends/SFML.hpp>
+#include <TGUI/TGUI.hpp>
+#include <array>
+#include <chrono>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief A debug overlay on top of all application states. Shows the
+ * percentiles of the frame time, the average duration of each frame phase,
+ * the latencies of the last factory and cache operations and a histogram of
+ * the recent frame times. Hidden by default and toggled with kToggleKey.
+ *
+ * The overlay only reads the FrameTimingStats and OperationLatencies, so
+ * collecting them does not depend on whether it is visible.
+ */
+class FrameTimingOverlay {
+ public:
+  /**
+   * @brief The key to show or hide the overlay with
+   */
+  static constexpr sf::Keyboard::Key kToggleKey = sf::Keyboard::F3;
+
+  /**
+   * @brief The minimum time between two refreshes of the text, so it stays
+   * readable and refreshing it does not dominate the measured frames
+   */
+  static constexpr std::chrono::milliseconds kTextRefreshInterval =
+      std::chrono::milliseconds(250);
+
+  /**
+   * @brief The font size of the text
+   */
+  static const int kFontSize = 12;
+
+  /**
+   * @brief The width of a histogram bar in pixels
+   */
+  static constexpr float kHistogramBarWidth = 6.0f;
+
+  /**
+   * @brief The height of the highest histogram bar in pixels
+   */
+  static constexpr float kHistogramHeight = 40.0f;
+
+  /**
+   * @brief Add the gui elements of the overlay to the gui. The overlay is
+   * hidden.
+   * @param gui The gui
+   */
+  void init(tgui::GuiSFML& gui);
+
+  /**
+   * @brief Show the overlay, if it is hidden, or hide it, if it is shown
+   */
+  void toggle();
+
+  /**
+   * @brief Check, whether the overlay is shown
+   * @return true, if it is shown
+   */
+  bool isVisible() const;
+
+  /**
+   * @brief Refresh the overlay from the given stats and the last operation
+   * latencies. Does nothing, if the overlay is hidden or the last refresh was
+   * less than kTextRefreshInterval ago.
+   * @param stats The stats of the recent frames
+   * @return true, if the overlay changed and has to be redrawn
+   */
+  bool update(const FrameTimingStats& stats);
+
+  /**
+   * @brief Draw the histogram of the overlay. Call after drawing the gui, so
+   * it is drawn on top.
+   * @param window The window to draw to
+   */
+  void draw(sf::RenderWindow& window);
+
+ private:
+  /**
+   * @brief Whether the overlay is shown
+   */
+  bool is_visible_ = false;
+
+  /**
+   * @brief The time the overlay may be refreshed next
+   */
+  std::chrono::steady_clock::time_point next_refresh_time_;
+
+  /**
+   * @brief The label showing the stats
+   */
+  tgui::Label::Ptr stats_label_;
+
+  /**
+   * @brief The text of stats_label_. Reused, so refreshing it does not
+   * allocate once its capacity suffices.
+   */
+  std::string stats_text_;
+
+  /**
+   * @brief One bar per bucket of the frame time histogram
+   */
+  std::array<sf::RectangleShape, FrameTimingStats::kHistogramBucketCount>
+      histogram_bars_;
+
+  /**
+   * @brief The height of each histogram bar in pixels
+   */
+  std::array<float, FrameTimingStats::kHistogramBucketCount>
+      histogram_bar_heights_ = {};
+};
+}  // namespace tdmon
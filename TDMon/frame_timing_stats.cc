@@ -0,0 +1,113 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/frame_timing_stats.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace tdmon {
+void FrameTimingStats::addFrame(std::chrono::microseconds events_duration,
+                                std::chrono::microseconds update_duration,
+                                std::chrono::microseconds draw_duration,
+                                std::chrono::microseconds display_duration) {
+  const std::chrono::microseconds frame_time =
+      events_duration + update_duration + draw_duration + display_duration;
+
+  std::array<std::chrono::microseconds, kSampleCount>& total_samples =
+      samples_[static_cast<std::size_t>(FramePhase::kTotal)];
+  // the oldest frame leaves the histogram, once the ring buffers are full
+  if (sample_count_ == kSampleCount) {
+    --histogram_[getHistogramBucket(total_samples[next_sample_index_])];
+  } else {
+    ++sample_count_;
+  }
+  ++histogram_[getHistogramBucket(frame_time)];
+
+  samples_[static_cast<std::size_t>(FramePhase::kEvents)][next_sample_index_] =
+      events_duration;
+  samples_[static_cast<std::size_t>(FramePhase::kUpdate)][next_sample_index_] =
+      update_duration;
+  samples_[static_cast<std::size_t>(FramePhase::kDraw)][next_sample_index_] =
+      draw_duration;
+  samples_[static_cast<std::size_t>(FramePhase::kDisplay)]
+          [next_sample_index_] = display_duration;
+  total_samples[next_sample_index_] = frame_time;
+
+  next_sample_index_ = (next_sample_index_ + 1) % kSampleCount;
+}
+
+std::size_t FrameTimingStats::getSampleCount() const { return sample_count_; }
+
+std::chrono::microseconds FrameTimingStats::getPercentile(
+    FramePhase phase, double percentile) const {
+  if (sample_count_ == 0) {
+    return std::chrono::microseconds(0);
+  }
+
+  // nearest rank: the smallest duration, which is greater than or equal to
+  // the given percentage of all durations
+  const double clamped_percentile = std::clamp(percentile, 0.0, 100.0);
+  const std::size_t rank = std::max<std::size_t>(
+      static_cast<std::size_t>(
+          std::ceil(clamped_percentile / 100.0 * sample_count_)),
+      1);
+
+  const std::array<std::chrono::microseconds, kSampleCount>& samples =
+      samples_[static_cast<std::size_t>(phase)];
+  // the first sample_count_ samples are the recorded ones in any case
+  std::copy_n(samples.begin(), sample_count_, percentile_buffer_.begin());
+  auto nth = percentile_buffer_.begin() + (rank - 1);
+  std::nth_element(percentile_buffer_.begin(), nth,
+                   percentile_buffer_.begin() + sample_count_);
+  return *nth;
+}
+
+std::chrono::microseconds FrameTimingStats::getAverage(
+    FramePhase phase) const {
+  if (sample_count_ == 0) {
+    return std::chrono::microseconds(0);
+  }
+
+  const std::array<std::chrono::microseconds, kSampleCount>& samples =
+      samples_[static_cast<std::size_t>(phase)];
+  std::chrono::microseconds sum(0);
+  for (std::size_t i = 0; i < sample_count_; ++i) {
+    sum += samples[i];
+  }
+  return sum / static_cast<long long>(sample_count_);
+}
+
+const std::array<std::size_t, FrameTimingStats::kHistogramBucketCount>&
+FrameTimingStats::getHistogram() const {
+  return histogram_;
+}
+
+std::size_t FrameTimingStats::getHistogramBucket(
+    std::chrono::microseconds frame_time) {
+  const std::size_t bucket = static_cast<std::size_t>(
+      std::max(frame_time, std::chrono::microseconds(0)) /
+      kHistogramBucketWidth);
+  return std::min(bucket, kHistogramBucketCount - 1);
+}
+}  // namespace tdmon
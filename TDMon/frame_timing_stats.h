@@ -0,0 +1,173 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace tdmon {
+/**
+ * @brief The phases of a frame measured by FrameTimingStats
+ */
+enum class FramePhase {
+  /**
+   * @brief Handling the events of the window
+   */
+  kEvents,
+
+  /**
+   * @brief Updating the application state
+   */
+  kUpdate,
+
+  /**
+   * @brief Drawing the gui
+   */
+  kDraw,
+
+  /**
+   * @brief Displaying the drawn frame
+   */
+  kDisplay,
+
+  /**
+   * @brief The whole frame, i.e. the sum of all other phases
+   */
+  kTotal
+};
+
+/**
+ * @brief Collects the durations of the phases of the most recent frames and
+ * calculates percentiles, averages and a histogram of them.
+ *
+ * The durations are stored in ring buffers of a fixed size, which are
+ * allocated with the object, so recording a frame never allocates memory. The
+ * histogram of the frame times is updated incrementally. The time spent
+ * waiting between frames is not part of a frame. Not thread-safe.
+ */
+class FrameTimingStats {
+ public:
+  /**
+   * @brief The number of frames to keep
+   */
+  static constexpr std::size_t kSampleCount = 240;
+
+  /**
+   * @brief The number of phases, including kTotal
+   */
+  static constexpr std::size_t kFramePhaseCount =
+      static_cast<std::size_t>(FramePhase::kTotal) + 1;
+
+  /**
+   * @brief The number of buckets of the histogram
+   */
+  static constexpr std::size_t kHistogramBucketCount = 16;
+
+  /**
+   * @brief The range of frame times of a histogram bucket. The last bucket
+   * also holds all longer frame times.
+   */
+  static constexpr std::chrono::microseconds kHistogramBucketWidth =
+      std::chrono::milliseconds(2);
+
+  /**
+   * @brief Record the durations of the phases of a frame. Replaces the oldest
+   * frame, once kSampleCount frames are recorded.
+   * @param events_duration The time spent handling events
+   * @param update_duration The time spent updating the application state
+   * @param draw_duration The time spent drawing the gui
+   * @param display_duration The time spent displaying the frame
+   */
+  void addFrame(std::chrono::microseconds events_duration,
+                std::chrono::microseconds update_duration,
+                std::chrono::microseconds draw_duration,
+                std::chrono::microseconds display_duration);
+
+  /**
+   * @brief Get the number of recorded frames, at most kSampleCount
+   * @return The number of frames
+   */
+  std::size_t getSampleCount() const;
+
+  /**
+   * @brief Get a percentile of the durations of a phase (nearest rank)
+   * @param phase The phase
+   * @param percentile The percentile, between 0 and 100
+   * @return The duration. Zero, if no frame was recorded.
+   */
+  std::chrono::microseconds getPercentile(FramePhase phase,
+                                          double percentile) const;
+
+  /**
+   * @brief Get the average duration of a phase
+   * @param phase The phase
+   * @return The average duration. Zero, if no frame was recorded.
+   */
+  std::chrono::microseconds getAverage(FramePhase phase) const;
+
+  /**
+   * @brief Get the histogram of the frame times of the recorded frames
+   * @return The number of frames per bucket (see kHistogramBucketWidth)
+   */
+  const std::array<std::size_t, kHistogramBucketCount>& getHistogram() const;
+
+ private:
+  /**
+   * @brief The ring buffers of the durations, one per phase
+   */
+  std::array<std::array<std::chrono::microseconds, kSampleCount>,
+             kFramePhaseCount>
+      samples_ = {};
+
+  /**
+   * @brief The index in the ring buffers to write the next frame to
+   */
+  std::size_t next_sample_index_ = 0;
+
+  /**
+   * @brief The number of recorded frames, at most kSampleCount
+   */
+  std::size_t sample_count_ = 0;
+
+  /**
+   * @brief The number of recorded frames per histogram bucket
+   */
+  std::array<std::size_t, kHistogramBucketCount> histogram_ = {};
+
+  /**
+   * @brief Preallocated buffer to find percentiles in, without modifying the
+   * ring buffers
+   */
+  mutable std::array<std::chrono::microseconds, kSampleCount>
+      percentile_buffer_ = {};
+
+  /**
+   * @brief Private function to get the histogram bucket of a frame time
+   * @param frame_time The frame time
+   * @return The index of the bucket
+   */
+  static std::size_t getHistogramBucket(std::chrono::microseconds frame_time);
+};
+}  // namespace tdmon
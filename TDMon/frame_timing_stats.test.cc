@@ -0,0 +1,101 @@
+#include <TDMon/frame_timing_stats.h>
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+namespace tdmon {
+/**
+ * @brief Test, if the percentiles and averages of the frame times and of the
+ * single phases are computed from the recorded frames.
+ */
+TEST(FrameTimingStats, ComputesPercentilesAndAverages) {
+  FrameTimingStats stats;
+  EXPECT_EQ(stats.getSampleCount(), 0);
+  EXPECT_EQ(stats.getPercentile(FramePhase::kTotal, 50.0),
+            std::chrono::microseconds(0));
+  EXPECT_EQ(stats.getAverage(FramePhase::kTotal),
+            std::chrono::microseconds(0));
+
+  // frame times of 1 ms, 2 ms, ..., 100 ms in a shuffled order
+  for (int i = 0; i < 100; ++i) {
+    const int milliseconds = (i * 37) % 100 + 1;
+    stats.addFrame(std::chrono::microseconds(0),
+                   std::chrono::milliseconds(milliseconds),
+                   std::chrono::microseconds(0), std::chrono::microseconds(0));
+  }
+
+  EXPECT_EQ(stats.getSampleCount(), 100);
+  EXPECT_EQ(stats.getPercentile(FramePhase::kTotal, 50.0),
+            std::chrono::milliseconds(50));
+  EXPECT_EQ(stats.getPercentile(FramePhase::kTotal, 95.0),
+            std::chrono::milliseconds(95));
+  EXPECT_EQ(stats.getPercentile(FramePhase::kTotal, 99.0),
+            std::chrono::milliseconds(99));
+  EXPECT_EQ(stats.getPercentile(FramePhase::kTotal, 100.0),
+            std::chrono::milliseconds(100));
+  EXPECT_EQ(stats.getPercentile(FramePhase::kUpdate, 0.0),
+            std::chrono::milliseconds(1));
+  EXPECT_EQ(stats.getPercentile(FramePhase::kDraw, 99.0),
+            std::chrono::microseconds(0));
+  EXPECT_EQ(stats.getAverage(FramePhase::kUpdate),
+            std::chrono::microseconds(50500));
+}
+
+/**
+ * @brief Test, if the frame time is the sum of the phases.
+ */
+TEST(FrameTimingStats, SumsThePhasesToTheFrameTime) {
+  FrameTimingStats stats;
+  stats.addFrame(std::chrono::microseconds(100),
+                 std::chrono::microseconds(200),
+                 std::chrono::microseconds(300),
+                 std::chrono::microseconds(400));
+
+  EXPECT_EQ(stats.getAverage(FramePhase::kEvents),
+            std::chrono::microseconds(100));
+  EXPECT_EQ(stats.getAverage(FramePhase::kUpdate),
+            std::chrono::microseconds(200));
+  EXPECT_EQ(stats.getAverage(FramePhase::kDraw),
+            std::chrono::microseconds(300));
+  EXPECT_EQ(stats.getAverage(FramePhase::kDisplay),
+            std::chrono::microseconds(400));
+  EXPECT_EQ(stats.getPercentile(FramePhase::kTotal, 50.0),
+            std::chrono::microseconds(1000));
+}
+
+/**
+ * @brief Test, if only the latest frames are kept and the histogram follows
+ * them.
+ */
+TEST(FrameTimingStats, KeepsOnlyTheLatestFrames) {
+  FrameTimingStats stats;
+  for (std::size_t i = 0; i < FrameTimingStats::kSampleCount; ++i) {
+    stats.addFrame(std::chrono::microseconds(0), std::chrono::milliseconds(1),
+                   std::chrono::microseconds(0), std::chrono::microseconds(0));
+  }
+  EXPECT_EQ(stats.getHistogram()[0], FrameTimingStats::kSampleCount);
+
+  // overwrite half of the frames with slow ones, which exceed the histogram
+  for (std::size_t i = 0; i < FrameTimingStats::kSampleCount / 2; ++i) {
+    stats.addFrame(std::chrono::microseconds(0),
+                   std::chrono::milliseconds(1000),
+                   std::chrono::microseconds(0), std::chrono::microseconds(0));
+  }
+
+  EXPECT_EQ(stats.getSampleCount(), FrameTimingStats::kSampleCount);
+  EXPECT_EQ(stats.getAverage(FramePhase::kTotal),
+            std::chrono::microseconds(500500));
+  EXPECT_EQ(stats.getPercentile(FramePhase::kTotal, 50.0),
+            std::chrono::milliseconds(1));
+  EXPECT_EQ(stats.getPercentile(FramePhase::kTotal, 51.0),
+            std::chrono::milliseconds(1000));
+
+  const auto& histogram = stats.getHistogram();
+  EXPECT_EQ(histogram[0], FrameTimingStats::kSampleCount / 2);
+  EXPECT_EQ(histogram[FrameTimingStats::kHistogramBucketCount - 1],
+            FrameTimingStats::kSampleCount / 2);
+  EXPECT_EQ(std::accumulate(histogram.begin(), histogram.end(),
+                            std::size_t(0)),
+            FrameTimingStats::kSampleCount);
+}
+}  // namespace tdmon
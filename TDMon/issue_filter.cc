@@ -0,0 +1,147 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/issue_filter.h>
+
+namespace tdmon {
+namespace {
+/**
+ * @brief Create the sql list of numbered parameters, e.g. '?2, ?3'
+ * @param first_parameter_index The number of the first parameter
+ * @param parameter_count The number of parameters
+ * @return The parameter list
+ */
+std::string createParameterList(int first_parameter_index,
+                                std::size_t parameter_count) {
+  std::string parameter_list;
+  for (std::size_t i = 0; i < parameter_count; ++i) {
+    if (i != 0) {
+      parameter_list += ", ";
+    }
+    parameter_list +=
+        "?" + std::to_string(first_parameter_index + static_cast<int>(i));
+  }
+  return parameter_list;
+}
+}  // namespace
+
+IssueFilter IssueFilter::createDefault() {
+  IssueFilter filter;
+  filter.issue_types = {"Test", "Documentation"};
+  return filter;
+}
+
+std::string IssueFilter::createSqlCondition(int first_parameter_index) const {
+  std::vector<std::string> conditions;
+  int parameter_index = first_parameter_index;
+
+  // the order of the parameters must match bindSqlParameters()
+  if (!issue_types.empty()) {
+    conditions.push_back("type IN (" +
+                         createParameterList(parameter_index,
+                                             issue_types.size()) +
+                         ")");
+    parameter_index += static_cast<int>(issue_types.size());
+  }
+  if (created_from) {
+    conditions.push_back("creation_date >= ?" +
+                         std::to_string(parameter_index++));
+  }
+  if (created_before) {
+    conditions.push_back("creation_date < ?" +
+                         std::to_string(parameter_index++));
+  }
+  if (!projects.empty()) {
+    conditions.push_back(
+        "project_id IN (" +
+        createParameterList(parameter_index, projects.size()) + ")");
+    parameter_index += static_cast<int>(projects.size());
+  }
+
+  // same semantics as the attack value: NULL counts as resolved
+  if (resolution_state == ResolutionState::kResolved) {
+    conditions.push_back("resolution_date IS NOT ''");
+  } else if (resolution_state == ResolutionState::kUnresolved) {
+    conditions.push_back("resolution_date IS ''");
+  }
+
+  if (conditions.empty()) {
+    return "1";
+  }
+
+  std::string sql_condition = "(" + conditions.front();
+  for (std::size_t i = 1; i < conditions.size(); ++i) {
+    sql_condition += " AND " + conditions[i];
+  }
+  return sql_condition + ")";
+}
+
+int IssueFilter::getSqlParameterCount() const {
+  return static_cast<int>(issue_types.size()) + (created_from ? 1 : 0) +
+         (created_before ? 1 : 0) + static_cast<int>(projects.size());
+}
+
+void IssueFilter::bindSqlParameters(SQLite::Statement& statement,
+                                    int first_parameter_index) const {
+  int parameter_index = first_parameter_index;
+
+  for (const std::string& issue_type : issue_types) {
+    statement.bind(parameter_index++, issue_type);
+  }
+  if (created_from) {
+    statement.bind(parameter_index++, *created_from);
+  }
+  if (created_before) {
+    statement.bind(parameter_index++, *created_before);
+  }
+  for (const std::string& project : projects) {
+    statement.bind(parameter_index++, project);
+  }
+}
+
+std::string IssueFilter::createKey() const {
+  // the unit separator does not appear in the values of the dataset. Every
+  // value is prefixed with the criterion it belongs to
+  const char kSeparator = '\x1f';
+
+  std::string key;
+  for (const std::string& issue_type : issue_types) {
+    key += "t" + issue_type + kSeparator;
+  }
+  if (created_from) {
+    key += "f" + *created_from + kSeparator;
+  }
+  if (created_before) {
+    key += "b" + *created_before + kSeparator;
+  }
+  key += "r" + std::to_string(static_cast<int>(resolution_state)) + kSeparator;
+  for (const std::string& project : projects) {
+    key += "p" + project + kSeparator;
+  }
+  return key;
+}
+}  // namespace tdmon
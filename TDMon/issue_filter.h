@@ -0,0 +1,149 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <compare>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace SQLite {
+class Statement;
+}  // namespace SQLite
+
+namespace tdmon {
+/**
+ * @brief Which issues to use, depending on whether they are resolved
+ */
+enum class ResolutionState {
+  /**
+   * @brief Use resolved and unresolved issues
+   */
+  kAny,
+
+  /**
+   * @brief Only use resolved issues (the resolution date is not empty)
+   */
+  kResolved,
+
+  /**
+   * @brief Only use unresolved issues (the resolution date is empty)
+   */
+  kUnresolved
+};
+
+/**
+ * @brief Specifies which issues of the technical debt dataset to use when
+ * creating a td-mon.
+ *
+ * The filter is turned into a parameterized sql condition: the sql only depends
+ * on which criteria are used and how many values they have, while the values
+ * themselves are bound as parameters. Columns are only referenced by criteria
+ * that are used, so a dataset only needs the columns of the used criteria.
+ *
+ * Filters are ordered and compared memberwise, so they can be used as keys,
+ * e.g. to cache the statements prepared for them.
+ */
+struct IssueFilter {
+  /**
+   * @brief The issue types to use (column 'type'), e.g. 'Test'. Empty, to use
+   * all issue types.
+   */
+  std::vector<std::string> issue_types;
+
+  /**
+   * @brief If set, only issues created at or after this date are used (column
+   * 'creation_date'). Dates are compared as text, so use the format of the
+   * dataset, e.g. '2010-01-01'.
+   */
+  std::optional<std::string> created_from;
+
+  /**
+   * @brief If set, only issues created before this date are used (column
+   * 'creation_date'). Dates are compared as text, so use the format of the
+   * dataset, e.g. '2011-01-01'.
+   */
+  std::optional<std::string> created_before;
+
+  /**
+   * @brief Whether to use resolved issues, unresolved issues, or both (column
+   * 'resolution_date')
+   */
+  ResolutionState resolution_state = ResolutionState::kAny;
+
+  /**
+   * @brief The projects to use (column 'project_id'). Empty, to use all
+   * projects.
+   */
+  std::vector<std::string> projects;
+
+  /**
+   * @brief Create the default filter. It uses the issues of type 'Test' or
+   * 'Documentation', as other types (for example 'bug') are not TD.
+   * @return The default filter
+   */
+  static IssueFilter createDefault();
+
+  /**
+   * @brief Create the sql condition of the filter, to be used in a WHERE
+   * clause. Values are not part of the condition, but referenced as numbered
+   * parameters (?NNN).
+   * @param first_parameter_index The number of the first parameter used by the
+   * condition. The condition uses getSqlParameterCount() consecutive
+   * parameters.
+   * @return The sql condition. '1', if the filter uses all issues.
+   */
+  std::string createSqlCondition(int first_parameter_index) const;
+
+  /**
+   * @brief Get the number of parameters used by the sql condition
+   * @return The number of parameters
+   */
+  int getSqlParameterCount() const;
+
+  /**
+   * @brief Bind the values of the filter to the parameters of a statement
+   * containing the sql condition
+   * @param statement The statement
+   * @param first_parameter_index The number of the first parameter used by the
+   * condition. Must be the same as passed to createSqlCondition().
+   */
+  void bindSqlParameters(SQLite::Statement& statement,
+                         int first_parameter_index) const;
+
+  /**
+   * @brief Create a text identifying the filter. Two filters have the same key,
+   * if and only if they are equal. Used to detect whether stored data was
+   * calculated with another filter.
+   * @return The key
+   */
+  std::string createKey() const;
+
+  /**
+   * @brief Compare two filters memberwise
+   */
+  auto operator<=>(const IssueFilter&) const = default;
+};
+}  // namespace tdmon
@@ -0,0 +1,129 @@
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/issue_filter.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief Helper function. Count the issues of an in-memory test table that
+ * match a filter.
+ * @param filter The filter
+ * @return The number of matching issues
+ */
+int countIssuesMatchingFilter(const IssueFilter& filter) {
+  SQLite::Database db(":memory:", SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+  db.exec(
+      "CREATE TABLE JIRA_ISSUES (TYPE TEXT, CREATION_DATE TEXT, "
+      "RESOLUTION_DATE TEXT, PROJECT_ID INTEGER);"
+      "INSERT INTO JIRA_ISSUES VALUES ('Test','2009-05-01','',1);"
+      "INSERT INTO JIRA_ISSUES VALUES ('Test','2010-05-01','2011-01-01',1);"
+      "INSERT INTO JIRA_ISSUES VALUES ('Documentation','2011-05-01','',2);"
+      "INSERT INTO JIRA_ISSUES VALUES ('Bug','2010-06-01','2010-07-01',2);");
+
+  // parameter 1 is left unused, like the user-identifier in the factory
+  SQLite::Statement query(db, "SELECT COUNT(*) FROM JIRA_ISSUES WHERE " +
+                                  filter.createSqlCondition(2));
+  filter.bindSqlParameters(query, 2);
+  query.executeStep();
+  return query.getColumn(0).getInt();
+}
+
+/**
+ * @brief Test, if the sql condition only references the used criteria and
+ * numbers its parameters correctly
+ */
+TEST(IssueFilter, CreatesSqlCondition) {
+  EXPECT_EQ(IssueFilter().createSqlCondition(1), "1");
+  EXPECT_EQ(IssueFilter().getSqlParameterCount(), 0);
+
+  const IssueFilter default_filter = IssueFilter::createDefault();
+  EXPECT_EQ(default_filter.createSqlCondition(2), "(type IN (?2, ?3))");
+  EXPECT_EQ(default_filter.getSqlParameterCount(), 2);
+
+  IssueFilter filter;
+  filter.issue_types = {"Test"};
+  filter.created_from = "2010-01-01";
+  filter.created_before = "2011-01-01";
+  filter.resolution_state = ResolutionState::kResolved;
+  filter.projects = {"1", "2"};
+  EXPECT_EQ(filter.createSqlCondition(4),
+            "(type IN (?4) AND creation_date >= ?5 AND creation_date < ?6 AND "
+            "project_id IN (?7, ?8) AND resolution_date IS NOT '')");
+  EXPECT_EQ(filter.getSqlParameterCount(), 5);
+}
+
+/**
+ * @brief Test, if each criterion selects the correct issues
+ */
+TEST(IssueFilter, SelectsMatchingIssues) {
+  EXPECT_EQ(countIssuesMatchingFilter(IssueFilter()), 4);
+  EXPECT_EQ(countIssuesMatchingFilter(IssueFilter::createDefault()), 3);
+
+  IssueFilter filter;
+  filter.created_from = "2010-01-01";
+  EXPECT_EQ(countIssuesMatchingFilter(filter), 3);
+  filter.created_before = "2011-01-01";
+  EXPECT_EQ(countIssuesMatchingFilter(filter), 2);
+
+  filter = IssueFilter();
+  filter.resolution_state = ResolutionState::kResolved;
+  EXPECT_EQ(countIssuesMatchingFilter(filter), 2);
+  filter.resolution_state = ResolutionState::kUnresolved;
+  EXPECT_EQ(countIssuesMatchingFilter(filter), 2);
+
+  filter = IssueFilter::createDefault();
+  filter.projects = {"2"};
+  EXPECT_EQ(countIssuesMatchingFilter(filter), 1);
+}
+
+/**
+ * @brief Test, if filters can be used as keys
+ */
+TEST(IssueFilter, IsOrderedMemberwise) {
+  IssueFilter other_filter = IssueFilter::createDefault();
+  other_filter.resolution_state = ResolutionState::kUnresolved;
+
+  EXPECT_EQ(IssueFilter::createDefault(), IssueFilter::createDefault());
+  EXPECT_NE(IssueFilter::createDefault(), other_filter);
+
+  std::map<IssueFilter, int> filters;
+  filters[IssueFilter::createDefault()] = 1;
+  filters[other_filter] = 2;
+  filters[IssueFilter::createDefault()] = 3;
+  EXPECT_EQ(filters.size(), 2);
+  EXPECT_EQ(filters[IssueFilter::createDefault()], 3);
+}
+
+/**
+ * @brief Test, if the key of a filter identifies it
+ */
+TEST(IssueFilter, CreatesDistinctKeys) {
+  EXPECT_EQ(IssueFilter::createDefault().createKey(),
+            IssueFilter::createDefault().createKey());
+
+  // the same value used by different criteria
+  IssueFilter type_filter;
+  type_filter.issue_types = {"2010"};
+  IssueFilter date_filter;
+  date_filter.created_from = "2010";
+  IssueFilter project_filter;
+  project_filter.projects = {"2010"};
+
+  EXPECT_NE(type_filter.createKey(), date_filter.createKey());
+  EXPECT_NE(type_filter.createKey(), project_filter.createKey());
+  EXPECT_NE(date_filter.createKey(), project_filter.createKey());
+  EXPECT_NE(IssueFilter().createKey(), type_filter.createKey());
+
+  // values are not merged
+  IssueFilter split_filter;
+  split_filter.issue_types = {"Te", "st"};
+  IssueFilter joined_filter;
+  joined_filter.issue_types = {"Test"};
+  EXPECT_NE(split_filter.createKey(), joined_filter.createKey());
+}
+}  // namespace tdmon
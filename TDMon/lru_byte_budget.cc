@@ -0,0 +1,77 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/lru_byte_budget.h>
+
+namespace tdmon {
+LruByteBudget::LruByteBudget(std::size_t byte_budget)
+    : byte_budget_(byte_budget) {}
+
+std::vector<std::string> LruByteBudget::insert(const std::string& key,
+                                               std::size_t size) {
+  erase(key);
+  entries_.push_front({key, size});
+  entry_index_.emplace(key, entries_.begin());
+  used_bytes_ += size;
+
+  // evict the least recently used resources, but never the inserted one
+  std::vector<std::string> evicted_keys;
+  while (used_bytes_ > byte_budget_ && entries_.size() > 1) {
+    Entry& entry = entries_.back();
+    used_bytes_ -= entry.size;
+    entry_index_.erase(entry.key);
+    evicted_keys.push_back(std::move(entry.key));
+    entries_.pop_back();
+  }
+  return evicted_keys;
+}
+
+bool LruByteBudget::touch(const std::string& key) {
+  auto it = entry_index_.find(key);
+  if (it == entry_index_.end()) {
+    return false;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return true;
+}
+
+void LruByteBudget::erase(const std::string& key) {
+  auto it = entry_index_.find(key);
+  if (it == entry_index_.end()) {
+    return;
+  }
+  used_bytes_ -= it->second->size;
+  entries_.erase(it->second);
+  entry_index_.erase(it);
+}
+
+bool LruByteBudget::contains(const std::string& key) const {
+  return entry_index_.contains(key);
+}
+
+std::size_t LruByteBudget::getUsedBytes() const { return used_bytes_; }
+
+std::size_t LruByteBudget::getByteBudget() const { return byte_budget_; }
+
+std::size_t LruByteBudget::getEntryCount() const { return entries_.size(); }
+}  // namespace tdmon
@@ -0,0 +1,135 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief Keeps track of the size of resources held in memory (e.g. textures)
+ * and decides which ones to evict, once their total size exceeds a budget.
+ *
+ * Resources are identified by a key and ordered from the most recently used to
+ * the least recently used one. Inserting a resource evicts the least recently
+ * used ones until the total size fits the budget again. The inserted resource
+ * itself is never evicted, so a single resource larger than the budget is
+ * still held. The caller releases the evicted resources.
+ */
+class LruByteBudget {
+ public:
+  /**
+   * @brief The constructor
+   * @param byte_budget The maximum total size of all resources in bytes
+   */
+  explicit LruByteBudget(std::size_t byte_budget);
+
+  /**
+   * @brief Insert a resource as the most recently used one, or update its size,
+   * if it was inserted before
+   * @param key The key of the resource
+   * @param size The size of the resource in bytes
+   * @return The keys of the evicted resources, least recently used first
+   */
+  std::vector<std::string> insert(const std::string& key, std::size_t size);
+
+  /**
+   * @brief Mark a resource as the most recently used one
+   * @param key The key of the resource
+   * @return true, if the resource is held. false, if it was never inserted or
+   * was evicted.
+   */
+  bool touch(const std::string& key);
+
+  /**
+   * @brief Remove a resource, without counting it as evicted
+   * @param key The key of the resource
+   */
+  void erase(const std::string& key);
+
+  /**
+   * @brief Get whether a resource is held
+   * @param key The key of the resource
+   * @return true, if the resource is held
+   */
+  bool contains(const std::string& key) const;
+
+  /**
+   * @brief Get the total size of all held resources
+   * @return The total size in bytes
+   */
+  std::size_t getUsedBytes() const;
+
+  /**
+   * @brief Get the maximum total size of all resources
+   * @return The budget in bytes
+   */
+  std::size_t getByteBudget() const;
+
+  /**
+   * @brief Get the number of held resources
+   * @return The number of resources
+   */
+  std::size_t getEntryCount() const;
+
+ private:
+  /**
+   * @brief A held resource
+   */
+  struct Entry {
+    /**
+     * @brief The key of the resource
+     */
+    std::string key;
+
+    /**
+     * @brief The size of the resource in bytes
+     */
+    std::size_t size;
+  };
+
+  /**
+   * @brief The maximum total size of all resources in bytes
+   */
+  std::size_t byte_budget_;
+
+  /**
+   * @brief The total size of all held resources in bytes
+   */
+  std::size_t used_bytes_ = 0;
+
+  /**
+   * @brief The held resources. The most recently used one first.
+   */
+  std::list<Entry> entries_;
+
+  /**
+   * @brief Maps the keys of all held resources to their position in entries_
+   */
+  std::unordered_map<std::string, std::list<Entry>::iterator> entry_index_;
+};
+}  // namespace tdmon
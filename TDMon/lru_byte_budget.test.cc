@@ -0,0 +1,48 @@
+#include <TDMon/lru_byte_budget.h>
+#include <gtest/gtest.h>
+
+namespace tdmon {
+/**
+ * @brief Test, if the least recently used resources are evicted once the
+ * budget is exceeded.
+ */
+TEST(LruByteBudget, EvictsLeastRecentlyUsedResources) {
+  LruByteBudget budget(100);
+
+  EXPECT_TRUE(budget.insert("a", 40).empty());
+  EXPECT_TRUE(budget.insert("b", 40).empty());
+  EXPECT_EQ(budget.getUsedBytes(), 80);
+
+  // using "a" makes "b" the least recently used resource
+  EXPECT_TRUE(budget.touch("a"));
+  EXPECT_EQ(budget.insert("c", 40), std::vector<std::string>({"b"}));
+  EXPECT_TRUE(budget.contains("a"));
+  EXPECT_FALSE(budget.contains("b"));
+  EXPECT_FALSE(budget.touch("b"));
+  EXPECT_EQ(budget.getUsedBytes(), 80);
+
+  // updating the size of a resource may evict others, too
+  EXPECT_EQ(budget.insert("c", 70), std::vector<std::string>({"a"}));
+  EXPECT_EQ(budget.getUsedBytes(), 70);
+  EXPECT_EQ(budget.getEntryCount(), 1);
+}
+
+/**
+ * @brief Test, if a resource larger than the budget is still held, and erased
+ * resources are not counted anymore.
+ */
+TEST(LruByteBudget, HoldsInsertedResource) {
+  LruByteBudget budget(100);
+
+  budget.insert("a", 10);
+  EXPECT_EQ(budget.insert("huge", 500), std::vector<std::string>({"a"}));
+  EXPECT_TRUE(budget.contains("huge"));
+  EXPECT_EQ(budget.getUsedBytes(), 500);
+
+  budget.erase("huge");
+  budget.erase("unknown");
+  EXPECT_EQ(budget.getUsedBytes(), 0);
+  EXPECT_EQ(budget.getEntryCount(), 0);
+  EXPECT_EQ(budget.getByteBudget(), 100);
+}
+}  // namespace tdmon
@@ -0,0 +1,217 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/atomic_file_writer.h>
+#include <TDMon/default_td_mon_cache.h>
+#include <TDMon/lru_td_mon_cache.h>
+#include <TDMon/trace_recorder.h>
+
+#include <filesystem>
+#include <stdexcept>
+
+namespace tdmon {
+LruTdMonCache::LruTdMonCache(std::size_t capacity) : capacity_(capacity) {
+  if (capacity_ == 0) {
+    throw std::runtime_error("LruTdMonCache capacity must not be 0");
+  }
+}
+
+void LruTdMonCache::storeOnDisk() const {
+  TDMON_TRACE_SCOPE("write cache file");
+  AtomicFileWriter::write(kCacheFilePath, encodeForDisk());
+}
+
+std::vector<char> LruTdMonCache::encodeForDisk() const {
+  TDMON_TRACE_SCOPE("encode cache");
+  if (!hasCache()) {
+    throw std::runtime_error("cannot store empty cache");
+  }
+
+  TdMonCacheFile cache_file;
+  for (const Entry& entry : entries_) {
+    cache_file.add(*entry.td_mon, entry.last_updated_timestamp,
+                   entry.data_source_fingerprint);
+  }
+  return cache_file.encode(file_format_);
+}
+
+std::filesystem::path LruTdMonCache::getCacheFilePath() const {
+  return kCacheFilePath;
+}
+
+std::uint64_t LruTdMonCache::getModificationCount() const {
+  return modification_count_;
+}
+
+void LruTdMonCache::loadFromDisk() {
+  TDMON_TRACE_SCOPE("read cache file");
+  // fall back to the cache of older versions
+  const std::string& path = std::filesystem::exists(kCacheFilePath)
+                                ? kCacheFilePath
+                                : DefaultTdMonCache::kCacheFilePath;
+  std::vector<TdMonCacheEntry> cache_file_entries = TdMonCacheFile::read(path);
+
+  // build a new list, so the cache is unchanged on errors
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> entry_index;
+  for (TdMonCacheEntry& cache_file_entry : cache_file_entries) {
+    if (entries.size() == capacity_) {
+      break;
+    }
+
+    Entry entry;
+    entry.td_mon = std::move(cache_file_entry.td_mon);
+    entry.last_updated_timestamp = cache_file_entry.last_updated_timestamp;
+    entry.data_source_fingerprint =
+        std::move(cache_file_entry.data_source_fingerprint);
+    if (entry.data_source_fingerprint) {
+      entry.key = entry.data_source_fingerprint->identity;
+    }
+
+    // keys are unique. Keep the more recently used entry
+    if (entry_index.contains(entry.key)) {
+      continue;
+    }
+    entries.push_back(std::move(entry));
+    entry_index.emplace(entries.back().key, std::prev(entries.end()));
+  }
+
+  entries_ = std::move(entries);
+  entry_index_ = std::move(entry_index);
+  has_selected_entry_ = !entries_.empty();
+  ++modification_count_;
+}
+
+bool LruTdMonCache::existsOnDisk() const {
+  return std::filesystem::exists(std::filesystem::path(kCacheFilePath)) ||
+         std::filesystem::exists(
+             std::filesystem::path(DefaultTdMonCache::kCacheFilePath));
+}
+
+void LruTdMonCache::updateCache(std::unique_ptr<TdMon> data) {
+  Entry entry;
+  entry.td_mon = std::move(data);
+  // update the "last updated" timestamp to the current seconds since Unix epoch
+  entry.last_updated_timestamp =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch());
+
+  insertEntry(std::move(entry));
+}
+
+TdMon* LruTdMonCache::getCache() const {
+  if (!hasCache()) {
+    return nullptr;
+  }
+  return entries_.front().td_mon.get();
+}
+
+bool LruTdMonCache::hasCache() const { return has_selected_entry_; }
+
+std::chrono::microseconds LruTdMonCache::getLastUpdatedTimestamp() const {
+  if (!hasCache()) {
+    return std::chrono::microseconds(0);
+  }
+  return entries_.front().last_updated_timestamp;
+}
+
+void LruTdMonCache::setDataSourceFingerprint(
+    std::optional<DataSourceFingerprint> fingerprint) {
+  if (!hasCache()) {
+    return;
+  }
+
+  // take the selected entry out and insert it again under its new key
+  Entry entry = std::move(entries_.front());
+  entry_index_.erase(entry.key);
+  entries_.pop_front();
+
+  entry.key = fingerprint ? fingerprint->identity : std::string();
+  entry.data_source_fingerprint = std::move(fingerprint);
+  insertEntry(std::move(entry));
+}
+
+const std::optional<DataSourceFingerprint>&
+LruTdMonCache::getDataSourceFingerprint() const {
+  static const std::optional<DataSourceFingerprint> kUnknownFingerprint;
+
+  if (!hasCache()) {
+    return kUnknownFingerprint;
+  }
+  return entries_.front().data_source_fingerprint;
+}
+
+bool LruTdMonCache::selectEntry(const std::string& source_identity) {
+  auto it = entry_index_.find(source_identity);
+  if (it == entry_index_.end()) {
+    return false;
+  }
+
+  // the order of the entries is stored, so selecting another entry modifies
+  // the cache
+  if (!has_selected_entry_ || it->second != entries_.begin()) {
+    ++modification_count_;
+  }
+
+  // mark as most recently used. Splicing does not invalidate the iterator
+  entries_.splice(entries_.begin(), entries_, it->second);
+  has_selected_entry_ = true;
+  return true;
+}
+
+std::size_t LruTdMonCache::getEntryCount() const { return entries_.size(); }
+
+std::size_t LruTdMonCache::getCapacity() const { return capacity_; }
+
+void LruTdMonCache::setFileFormat(TdMonCacheFileFormat file_format) {
+  file_format_ = file_format;
+  ++modification_count_;
+}
+
+TdMonCacheFileFormat LruTdMonCache::getFileFormat() const {
+  return file_format_;
+}
+
+void LruTdMonCache::insertEntry(Entry entry) {
+  auto it = entry_index_.find(entry.key);
+  if (it != entry_index_.end()) {
+    entries_.erase(it->second);
+    entry_index_.erase(it);
+  }
+
+  entries_.push_front(std::move(entry));
+  entry_index_.emplace(entries_.front().key, entries_.begin());
+  has_selected_entry_ = true;
+  ++modification_count_;
+
+  // the selected entry is the first one, so it is never evicted
+  while (entries_.size() > capacity_) {
+    entry_index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+}
+
+const std::string LruTdMonCache::kCacheFilePath = "./td_mon_cache.dat";
+const std::size_t LruTdMonCache::kDefaultCapacity = 32;
+
+}  // namespace tdmon
@@ -0,0 +1,261 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <TDMon/td_mon.h>
+#include <TDMon/td_mon_cache.h>
+#include <TDMon/td_mon_cache_file.h>
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace tdmon {
+/**
+ * @brief An implementation of the TdMonCache which holds the td-mons of
+ * multiple data sources, e.g. of different users or issue filters. Entries
+ * are keyed by the identity of their data source fingerprint (dataset path,
+ * user-identifier and issue filter), so switching back to a previously viewed
+ * td-mon does not require creating it again.
+ *
+ * The number of entries is bounded. If it is exceeded, the least recently used
+ * entry is evicted. Lookup, selection and eviction take constant time. The
+ * selected entry, which is returned by getCache(), is always the most recently
+ * used one. All entries are stored in a single file on disk, in the binary
+ * format of the TdMonCacheFile by default.
+ *
+ * Like the DefaultTdMonCache, this implementation stores and loads every
+ * td-mon type registered in the TdMonCacheTypeRegistry. Each entry is
+ * deserialized by the type named in the file.
+ */
+class LruTdMonCache : public TdMonCache {
+ public:
+  /**
+   * @brief The path to the cache file location on disk.
+   */
+  static const std::string kCacheFilePath;
+
+  /**
+   * @brief The default maximum number of entries
+   */
+  static const std::size_t kDefaultCapacity;
+
+  /**
+   * @brief The constructor.
+   * @param capacity The maximum number of entries. Must not be 0.
+   */
+  explicit LruTdMonCache(std::size_t capacity = kDefaultCapacity);
+
+  // Inherited via TdMonCache
+
+  /**
+   * @brief Stores all entries to disk in the selected file format, ordered
+   * from the most to the least recently used one. Throws, if no entry is
+   * selected.
+   */
+  void storeOnDisk() const override;
+
+  /**
+   * @brief Encode all entries as they are stored on disk. Throws, if no entry
+   * is selected.
+   * @return The contents of the cache file
+   */
+  std::vector<char> encodeForDisk() const override;
+
+  /**
+   * @brief Get the path of the cache file on disk
+   * @return kCacheFilePath
+   */
+  std::filesystem::path getCacheFilePath() const override;
+
+  /**
+   * @brief Get the number of modifications of the cache. Selecting another
+   * entry counts as modification, since the order of the entries is stored.
+   * @return The number of modifications
+   */
+  std::uint64_t getModificationCount() const override;
+
+  /**
+   * @brief Loads all entries from disk and selects the most recently used one.
+   * Entries exceeding the capacity are dropped. The file format is detected
+   * automatically. If no cache file exists, the cache file of the
+   * DefaultTdMonCache is loaded instead, so td-mons cached by older versions
+   * are kept.
+   */
+  void loadFromDisk() override;
+
+  /**
+   * @brief Check whether the cache exists on disk
+   * @return true if kCacheFilePath or the cache file of the DefaultTdMonCache
+   * exists
+   */
+  bool existsOnDisk() const override;
+
+  /**
+   * @brief Add a td-mon of an unknown data source and select it. It replaces a
+   * previously added td-mon of an unknown data source, until its fingerprint
+   * is set. Note that this does not yet write the cache to disk.
+   * @param data The td-mon to store in cache.
+   */
+  void updateCache(std::unique_ptr<TdMon> data) override;
+
+  /**
+   * @brief Get the selected td-mon
+   * @return A pointer to the td-mon. Returns nullptr if no entry is selected.
+   */
+  TdMon* getCache() const override;
+
+  /**
+   * @brief Check whether an entry is selected
+   * @return true if it is
+   */
+  bool hasCache() const override;
+
+  /**
+   * @brief Get the timestamp of when the selected entry was last updated
+   * @return The timestamp in microseconds since unix epoch. 0, if no entry is
+   * selected.
+   */
+  std::chrono::microseconds getLastUpdatedTimestamp() const override;
+
+  /**
+   * @brief Set the fingerprint of the data the selected td-mon was created
+   * from. This moves the entry to the key of the fingerprint, replacing a
+   * previous entry of the same data source. Does nothing, if no entry is
+   * selected.
+   * @param fingerprint The fingerprint. Empty, if it is unknown.
+   */
+  void setDataSourceFingerprint(
+      std::optional<DataSourceFingerprint> fingerprint) override;
+
+  /**
+   * @brief Get the fingerprint of the data the selected td-mon was created
+   * from
+   * @return The fingerprint. Empty, if it is unknown or no entry is selected.
+   */
+  const std::optional<DataSourceFingerprint>& getDataSourceFingerprint()
+      const override;
+
+  /**
+   * @brief Select the entry of the data source with the given identity and
+   * mark it as the most recently used one
+   * @param source_identity The identity of the data source
+   * @return true, if an entry of the data source exists
+   */
+  bool selectEntry(const std::string& source_identity) override;
+
+  /**
+   * @brief Get the number of entries
+   * @return The number of entries
+   */
+  std::size_t getEntryCount() const;
+
+  /**
+   * @brief Get the maximum number of entries
+   * @return The capacity
+   */
+  std::size_t getCapacity() const;
+
+  /**
+   * @brief Select the format to store the cache file in. Binary by default.
+   * @param file_format The file format
+   */
+  void setFileFormat(TdMonCacheFileFormat file_format);
+
+  /**
+   * @brief Get the format the cache file is stored in
+   * @return The file format
+   */
+  TdMonCacheFileFormat getFileFormat() const;
+
+ private:
+  /**
+   * @brief A cached td-mon and the information about it
+   */
+  struct Entry {
+    /**
+     * @brief The key of the entry. The identity of the data source
+     * fingerprint, or an empty string, if the data source is unknown.
+     */
+    std::string key;
+
+    /**
+     * @brief The td-mon
+     */
+    std::unique_ptr<TdMon> td_mon;
+
+    /**
+     * @brief The timestamp when the entry was last updated in microseconds
+     * since unix epoch
+     */
+    std::chrono::microseconds last_updated_timestamp;
+
+    /**
+     * @brief The fingerprint of the data the td-mon was created from
+     */
+    std::optional<DataSourceFingerprint> data_source_fingerprint;
+  };
+
+  /**
+   * @brief The maximum number of entries
+   */
+  std::size_t capacity_;
+
+  /**
+   * @brief The format to store the cache file in
+   */
+  TdMonCacheFileFormat file_format_ = TdMonCacheFileFormat::kBinary;
+
+  /**
+   * @brief The entries, ordered from the most to the least recently used one
+   */
+  std::list<Entry> entries_;
+
+  /**
+   * @brief Maps the key of each entry to its position in entries_
+   */
+  std::unordered_map<std::string, std::list<Entry>::iterator> entry_index_;
+
+  /**
+   * @brief Whether the first (most recently used) entry is selected
+   */
+  bool has_selected_entry_ = false;
+
+  /**
+   * @brief The number of modifications of the cache
+   */
+  std::uint64_t modification_count_ = 0;
+
+  /**
+   * @brief Private function to add an entry as the most recently used one and
+   * select it. Replaces an existing entry with the same key and evicts the
+   * least recently used entries, if the capacity is exceeded.
+   * @param entry The entry
+   */
+  void insertEntry(Entry entry);
+};
+}  // namespace tdmon
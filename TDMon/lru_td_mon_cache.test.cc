@@ -0,0 +1,176 @@
+#include <TDMon/default_td_mon.h>
+#include <TDMon/default_td_mon_cache.h>
+#include <TDMon/lru_td_mon_cache.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief Helper function. Add a td-mon of the given data source to the cache.
+ * @param cache The cache
+ * @param source_identity The identity of the data source
+ * @param attack The attack value of the td-mon, used to tell td-mons apart
+ */
+void addTdMonOfDataSource(LruTdMonCache& cache,
+                          const std::string& source_identity, int attack) {
+  cache.updateCache(std::make_unique<DefaultTdMon>(attack, 0, 0));
+  cache.setDataSourceFingerprint(
+      DataSourceFingerprint{source_identity, "version"});
+}
+
+/**
+ * @brief Test, if the td-mons of different data sources are kept and can be
+ * selected again.
+ */
+TEST(LruTdMonCache, SelectsEntriesByDataSource) {
+  LruTdMonCache cache;
+  EXPECT_FALSE(cache.hasCache());
+  EXPECT_EQ(cache.getCache(), nullptr);
+  EXPECT_FALSE(cache.getDataSourceFingerprint().has_value());
+
+  addTdMonOfDataSource(cache, "Human1", 1);
+  addTdMonOfDataSource(cache, "Human2", 2);
+  EXPECT_EQ(cache.getEntryCount(), 2);
+  EXPECT_EQ(cache.getCache()->getAttackValue(), 2);
+
+  EXPECT_TRUE(cache.selectEntry("Human1"));
+  EXPECT_EQ(cache.getCache()->getAttackValue(), 1);
+  EXPECT_EQ(cache.getDataSourceFingerprint()->identity, "Human1");
+
+  // unknown data sources do not change the selection
+  EXPECT_FALSE(cache.selectEntry("Human3"));
+  EXPECT_EQ(cache.getCache()->getAttackValue(), 1);
+
+  // a new td-mon of the same data source replaces the old one
+  addTdMonOfDataSource(cache, "Human2", 22);
+  EXPECT_EQ(cache.getEntryCount(), 2);
+  EXPECT_TRUE(cache.selectEntry("Human2"));
+  EXPECT_EQ(cache.getCache()->getAttackValue(), 22);
+}
+
+/**
+ * @brief Test, if switching from a cached data source to an uncached one is
+ * reported as a miss, although the previous td-mon stays selected.
+ */
+TEST(LruTdMonCache, ReportsMissWhenSwitchingToUncachedDataSource) {
+  LruTdMonCache cache;
+  EXPECT_FALSE(cache.selectEntryOfDataSource(std::nullopt));
+
+  addTdMonOfDataSource(cache, "Human1", 1);
+  const DataSourceFingerprint human1_fingerprint{"Human1", "version"};
+  const DataSourceFingerprint human2_fingerprint{"Human2", "version"};
+  EXPECT_TRUE(cache.selectEntryOfDataSource(human1_fingerprint));
+
+  // the td-mon of Human1 must not be used for Human2
+  EXPECT_FALSE(cache.selectEntryOfDataSource(human2_fingerprint));
+  EXPECT_NE(cache.getDataSourceFingerprint(), human2_fingerprint);
+
+  // without a fingerprint, any td-mon is used
+  EXPECT_TRUE(cache.selectEntryOfDataSource(std::nullopt));
+
+  addTdMonOfDataSource(cache, "Human2", 2);
+  EXPECT_TRUE(cache.selectEntryOfDataSource(human1_fingerprint));
+  EXPECT_TRUE(cache.selectEntryOfDataSource(human2_fingerprint));
+  EXPECT_EQ(cache.getCache()->getAttackValue(), 2);
+}
+
+/**
+ * @brief Test, if the least recently used entry is evicted once the capacity
+ * is exceeded.
+ */
+TEST(LruTdMonCache, EvictsLeastRecentlyUsedEntry) {
+  LruTdMonCache cache(3);
+  addTdMonOfDataSource(cache, "Human1", 1);
+  addTdMonOfDataSource(cache, "Human2", 2);
+  addTdMonOfDataSource(cache, "Human3", 3);
+
+  // Human1 is used more recently than Human2 now
+  EXPECT_TRUE(cache.selectEntry("Human1"));
+  addTdMonOfDataSource(cache, "Human4", 4);
+
+  EXPECT_EQ(cache.getEntryCount(), 3);
+  EXPECT_FALSE(cache.selectEntry("Human2"));
+  EXPECT_TRUE(cache.selectEntry("Human1"));
+  EXPECT_TRUE(cache.selectEntry("Human3"));
+  EXPECT_TRUE(cache.selectEntry("Human4"));
+}
+
+/**
+ * @brief Test, if all entries, their order and their fingerprints are stored
+ * to and loaded from disk.
+ */
+TEST(LruTdMonCache, StoresAllEntriesOnDisk) {
+  std::filesystem::remove(LruTdMonCache::kCacheFilePath);
+
+  {
+    LruTdMonCache cache;
+    EXPECT_FALSE(cache.existsOnDisk());
+    addTdMonOfDataSource(cache, "Human1", 1);
+    addTdMonOfDataSource(cache, "Human2", 2);
+    // a td-mon of an unknown data source
+    cache.updateCache(std::make_unique<DefaultTdMon>(3, 0, 0));
+    EXPECT_TRUE(cache.selectEntry("Human1"));
+    cache.storeOnDisk();
+    EXPECT_TRUE(cache.existsOnDisk());
+  }
+
+  LruTdMonCache cache;
+  cache.loadFromDisk();
+  EXPECT_EQ(cache.getEntryCount(), 3);
+
+  // the most recently used entry is selected
+  EXPECT_EQ(cache.getCache()->getAttackValue(), 1);
+  EXPECT_NE(cache.getLastUpdatedTimestamp(), std::chrono::microseconds(0));
+  EXPECT_EQ(cache.getDataSourceFingerprint(),
+            (DataSourceFingerprint{"Human1", "version"}));
+
+  EXPECT_TRUE(cache.selectEntry("Human2"));
+  EXPECT_EQ(cache.getCache()->getAttackValue(), 2);
+
+  // entries exceeding the capacity are dropped, starting with the least
+  // recently used one
+  LruTdMonCache small_cache(1);
+  small_cache.loadFromDisk();
+  EXPECT_EQ(small_cache.getEntryCount(), 1);
+  EXPECT_EQ(small_cache.getCache()->getAttackValue(), 1);
+
+  std::filesystem::remove(LruTdMonCache::kCacheFilePath);
+}
+
+/**
+ * @brief Test, if the cache file of the DefaultTdMonCache is loaded, if no
+ * cache file of the LruTdMonCache exists, and if json is supported as well.
+ */
+TEST(LruTdMonCache, LoadsCacheOfOlderVersions) {
+  std::filesystem::remove(LruTdMonCache::kCacheFilePath);
+
+  {
+    DefaultTdMonCache cache;
+    cache.updateCache(std::make_unique<DefaultTdMon>(5, 0, 0));
+    cache.setDataSourceFingerprint(DataSourceFingerprint{"Human5", "version"});
+    cache.storeOnDisk();
+  }
+
+  {
+    LruTdMonCache cache;
+    EXPECT_TRUE(cache.existsOnDisk());
+    cache.loadFromDisk();
+    EXPECT_EQ(cache.getEntryCount(), 1);
+    EXPECT_TRUE(cache.selectEntry("Human5"));
+
+    addTdMonOfDataSource(cache, "Human6", 6);
+    cache.setFileFormat(TdMonCacheFileFormat::kJson);
+    cache.storeOnDisk();
+  }
+  std::filesystem::remove(DefaultTdMonCache::kCacheFilePath);
+
+  LruTdMonCache cache;
+  cache.loadFromDisk();
+  EXPECT_EQ(cache.getEntryCount(), 2);
+  EXPECT_EQ(cache.getCache()->getAttackValue(), 6);
+
+  std::filesystem::remove(LruTdMonCache::kCacheFilePath);
+}
+}  // namespace tdmon
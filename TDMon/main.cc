@@ -23,11 +23,11 @@
  *********************************/
 
 #include <TDMon/core.h>
+#include <TDMon/lru_td_mon_cache.h>
 #include <TDMon/main_menu.h>
 #include <TDMon/observe_menu.h>
 #include <TDMon/technical_debt_dataset_connectable_default_td_mon_factory.h>
 #include <TDMon/technical_debt_dataset_setup_menu.h>
-#include <TDMon/default_td_mon_cache.h>
 
 /**
  * @brief The program entry point. This function cannot be placed into the tdmon
@@ -36,10 +36,13 @@
  */
 int main() {
   try {
+    // The connectable factory is used rather than the columnar one: the
+    // dataset path is only known after the setup menu, and the columnar
+    // factory has no issue filter, sidecar index or incremental refresh.
     // using 'typename' is important here for type deduction
     tdmon::Core<
         typename tdmon::TechnicalDebtDatasetConnectableDefaultTdMonFactory,
-        typename tdmon::DefaultTdMonCache, typename tdmon::MainMenu,
+        typename tdmon::LruTdMonCache, typename tdmon::MainMenu,
         typename tdmon::TechnicalDebtDatasetSetupMenu<
             typename tdmon::TechnicalDebtDatasetConnectableDefaultTdMonFactory>,
         typename tdmon::ObserveMenu>
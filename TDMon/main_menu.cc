@@ -66,7 +66,26 @@ SupportedApplicationStateChanges MainMenu::update() {
 }
 
 void MainMenu::cleanup(tgui::GuiSFML& gui) { gui.remove(main_menu_group_); }
+
+void MainMenu::suspend(tgui::GuiSFML& /*gui*/) {
+  main_menu_group_->setVisible(false);
+}
+
+void MainMenu::resume(tgui::GuiSFML& /*gui*/) {
+  next_application_state_change_ = SupportedApplicationStateChanges::kNull;
+  main_menu_group_->setVisible(true);
+}
+
 SupportedApplicationStateTypes MainMenu::getApplicationStateType() const {
   return SupportedApplicationStateTypes::kMainMenu;
 }
+
+bool MainMenu::needsUpdatesWithoutEvents() const { return false; }
+
+std::optional<std::chrono::microseconds> MainMenu::getTimeUntilNextUpdate()
+    const {
+  return std::nullopt;
+}
+
+bool MainMenu::takeRedrawRequest() { return false; }
 }  // namespace tdmon
@@ -27,6 +27,8 @@
 #include <TDMon/application_state.h>
 #include <TDMon/constants.h>
 
+#include <chrono>
+#include <optional>
 #include <string>
 
 namespace tdmon {
@@ -58,12 +60,45 @@ class MainMenu : public ApplicationState {
    */
   void cleanup(tgui::GuiSFML& gui) override;
 
+  /**
+   * @brief Implementation of the suspend function from ApplicationState.
+   * Hides the gui elements that were added in init()
+   * @param gui The gui
+   */
+  void suspend(tgui::GuiSFML& gui) override;
+
+  /**
+   * @brief Implementation of the resume function from ApplicationState.
+   * Shows the gui elements that were added in init() again
+   * @param gui The gui
+   */
+  void resume(tgui::GuiSFML& gui) override;
+
   /**
    * @brief Get this classes application state type
    * @return The application state type
    */
   SupportedApplicationStateTypes getApplicationStateType() const override;
 
+  /**
+   * @brief The main menu only changes in reaction to events
+   * @return false
+   */
+  bool needsUpdatesWithoutEvents() const override;
+
+  /**
+   * @brief The main menu does not need scheduled updates
+   * @return Empty
+   */
+  std::optional<std::chrono::microseconds> getTimeUntilNextUpdate()
+      const override;
+
+  /**
+   * @brief The main menu only changes in reaction to events
+   * @return false
+   */
+  bool takeRedrawRequest() override;
+
  private:
   /**
    * @brief Store the next application state change to be requested in update().
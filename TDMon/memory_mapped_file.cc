@@ -0,0 +1,149 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#include <TDMon/memory_mapped_file.h>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tdmon {
+MemoryMappedFile::MemoryMappedFile() = default;
+
+MemoryMappedFile::MemoryMappedFile(const std::filesystem::path& path) {
+  const std::string error_message =
+      "Cannot map file into memory: " + path.string();
+
+#ifdef _WIN32
+  // FILE_SHARE_DELETE allows replacing the file while it is mapped
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error(error_message);
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    throw std::runtime_error(error_message);
+  }
+
+  // empty files cannot be mapped
+  if (file_size.QuadPart == 0) {
+    CloseHandle(file);
+    return;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  // the mapping keeps the file open
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    throw std::runtime_error(error_message);
+  }
+
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  // the view keeps the mapping open
+  CloseHandle(mapping);
+  if (data == nullptr) {
+    throw std::runtime_error(error_message);
+  }
+
+  data_ = static_cast<const std::byte*>(data);
+  size_ = static_cast<std::size_t>(file_size.QuadPart);
+#else
+  const int file = open(path.c_str(), O_RDONLY);
+  if (file == -1) {
+    throw std::runtime_error(error_message);
+  }
+
+  struct stat file_status;
+  if (fstat(file, &file_status) != 0) {
+    ::close(file);
+    throw std::runtime_error(error_message);
+  }
+
+  // empty files cannot be mapped
+  if (file_status.st_size == 0) {
+    ::close(file);
+    return;
+  }
+
+  void* data = mmap(nullptr, static_cast<std::size_t>(file_status.st_size),
+                    PROT_READ, MAP_SHARED, file, 0);
+  // the mapping keeps the file open
+  ::close(file);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error(error_message);
+  }
+
+  data_ = static_cast<const std::byte*>(data);
+  size_ = static_cast<std::size_t>(file_status.st_size);
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile() { close(); }
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MemoryMappedFile& MemoryMappedFile::operator=(
+    MemoryMappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+std::span<const std::byte> MemoryMappedFile::getData() const {
+  return {data_, size_};
+}
+
+void MemoryMappedFile::close() {
+  if (data_ != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<std::byte*>(data_), size_);
+#endif
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+}  // namespace tdmon
@@ -0,0 +1,98 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace tdmon {
+/**
+ * @brief A file mapped read-only into memory. The contents of the file are
+ * loaded lazily by the operating system, when they are accessed.
+ *
+ * Uses MapViewOfFile on Windows and mmap on other platforms. The file can be
+ * deleted or replaced while it is mapped (on Windows, it can be renamed), the
+ * mapping keeps the old contents.
+ */
+class MemoryMappedFile {
+ public:
+  /**
+   * @brief The constructor. Creates an empty object, that does not map a file.
+   */
+  MemoryMappedFile();
+
+  /**
+   * @brief The constructor. Maps a file. Throws, if the file cannot be opened
+   * or mapped.
+   * @param path The path to the file
+   */
+  explicit MemoryMappedFile(const std::filesystem::path& path);
+
+  /**
+   * @brief The destructor. Unmaps the file.
+   */
+  ~MemoryMappedFile();
+
+  /**
+   * @brief The move constructor. Takes over the mapping of another object.
+   * @param other The object to take the mapping from. Empty afterwards.
+   */
+  MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+
+  /**
+   * @brief The move assignment operator. Unmaps the current file and takes
+   * over the mapping of another object.
+   * @param other The object to take the mapping from. Empty afterwards.
+   * @return This object
+   */
+  MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+  /**
+   * @brief Get the contents of the mapped file
+   * @return The contents. Empty, if no file is mapped or the file is empty.
+   */
+  std::span<const std::byte> getData() const;
+
+  /**
+   * @brief Unmap the file, if one is mapped
+   */
+  void close();
+
+ private:
+  /**
+   * @brief The start of the mapping. nullptr, if no file is mapped.
+   */
+  const std::byte* data_ = nullptr;
+
+  /**
+   * @brief The size of the mapping in bytes
+   */
+  std::size_t size_ = 0;
+};
+}  // namespace tdmon
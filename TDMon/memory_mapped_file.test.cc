@@ -0,0 +1,49 @@
+#include <TDMon/memory_mapped_file.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief Test, if the contents of a file are mapped correctly, and if the
+ * mapping can be moved
+ */
+TEST(MemoryMappedFile, MapsFileContents) {
+  const std::filesystem::path path = "./memory_mapped_file_test.bin";
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "TD-Mon";
+  }
+
+  MemoryMappedFile mapped_file(path);
+  ASSERT_EQ(mapped_file.getData().size(), 6);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(
+                            mapped_file.getData().data()),
+                        mapped_file.getData().size()),
+            "TD-Mon");
+
+  MemoryMappedFile moved_file = std::move(mapped_file);
+  EXPECT_TRUE(mapped_file.getData().empty());
+  EXPECT_EQ(moved_file.getData().size(), 6);
+
+  moved_file.close();
+  EXPECT_TRUE(moved_file.getData().empty());
+
+  std::filesystem::remove(path);
+}
+
+/**
+ * @brief Test, if empty files and missing files are handled
+ */
+TEST(MemoryMappedFile, HandlesEmptyAndMissingFiles) {
+  const std::filesystem::path path = "./memory_mapped_file_empty_test.bin";
+  { std::ofstream file(path, std::ios::binary | std::ios::trunc); }
+
+  EXPECT_TRUE(MemoryMappedFile(path).getData().empty());
+  std::filesystem::remove(path);
+
+  EXPECT_THROW(MemoryMappedFile("./does_not_exist.bin"), std::exception);
+}
+}  // namespace tdmon
@@ -27,10 +27,16 @@
 
 #include <format>
 #include <iostream>
+#include <utility>
 
 namespace tdmon {
-ObserveMenu::ObserveMenu(TdMonCache& tdmon_cache, TdMonFactory& tdmon_factory)
-    : tdmon_cache_(tdmon_cache), tdmon_factory_(tdmon_factory) {}
+ObserveMenu::ObserveMenu(TdMonCache& tdmon_cache, TdMonFactory& tdmon_factory,
+                         TdMonHistoryLog& tdmon_history_log,
+                         TextureManager& texture_manager)
+    : tdmon_cache_(tdmon_cache),
+      tdmon_factory_(tdmon_factory),
+      tdmon_history_log_(tdmon_history_log),
+      texture_manager_(texture_manager) {}
 
 void ObserveMenu::init(tgui::GuiSFML& gui) {
   observe_menu_group_ = tgui::Group::create();
@@ -70,47 +76,233 @@ void ObserveMenu::init(tgui::GuiSFML& gui) {
   tdmon_data_label_->setPosition(0, 520);
   observe_menu_group_->add(tdmon_data_label_);
 
+  refresh_progress_bar_ = tgui::ProgressBar::create();
+  refresh_progress_bar_->setPosition(110, 10);
+  refresh_progress_bar_->setSize(380, 30);
+  refresh_progress_bar_->setMinimum(0);
+  refresh_progress_bar_->setMaximum(100);
+  refresh_progress_bar_->setText(UiConstants::kUpdatingTdMonText);
+  refresh_progress_bar_->setVisible(false);
+  observe_menu_group_->add(refresh_progress_bar_);
+
   gui.add(observe_menu_group_);
 
   // initialize the td-mon and relevant UI
-  try {
-    refreshTdMon(true);
-  } catch (std::exception e) {
-    std::cout
-        << "cannot initialize TdMon. Reason: " << e.what()
-        << "\nPlease make sure that you entered correct information in the setup."
-        << std::endl;
-  }
-
+  showTdMon();
 }
 
 SupportedApplicationStateChanges ObserveMenu::update() {
+  finishTdMonCreationIfReady();
+
+  // revalidate a stale td-mon, retry after failures or handle requests
+  if (refresh_scheduler_.isRefreshDue()) {
+    try {
+      startTdMonCreation();
+    } catch (const std::exception& e) {
+      std::cout << "cannot update TdMon. Reason: " << e.what() << std::endl;
+    }
+  }
+
   return next_application_state_change_;
 }
 
 void ObserveMenu::cleanup(tgui::GuiSFML& gui) {
+  cancelTdMonCreation();
+
   gui.remove(observe_menu_group_);
 }
 
+void ObserveMenu::suspend(tgui::GuiSFML& /*gui*/) {
+  cancelTdMonCreation();
+  refresh_progress_bar_->setVisible(false);
+
+  observe_menu_group_->setVisible(false);
+}
+
+void ObserveMenu::resume(tgui::GuiSFML& /*gui*/) {
+  next_application_state_change_ = SupportedApplicationStateChanges::kNull;
+  observe_menu_group_->setVisible(true);
+
+  // the data source may have changed in the meantime
+  showTdMon();
+}
+
 SupportedApplicationStateTypes ObserveMenu::getApplicationStateType() const {
   return SupportedApplicationStateTypes::kObserveMenu;
 }
 
+bool ObserveMenu::needsUpdatesWithoutEvents() const {
+  return pending_td_mon_.valid() || refresh_scheduler_.isRefreshDue();
+}
+
+std::optional<std::chrono::microseconds> ObserveMenu::getTimeUntilNextUpdate()
+    const {
+  const std::optional<TdMonRefreshScheduler::Clock::duration>
+      time_until_refresh_due = refresh_scheduler_.getTimeUntilRefreshDue();
+  if (!time_until_refresh_due) {
+    return std::nullopt;
+  }
+  // rounded up, so the refresh is due when the update happens
+  return std::chrono::ceil<std::chrono::microseconds>(*time_until_refresh_due);
+}
+
+bool ObserveMenu::takeRedrawRequest() {
+  return std::exchange(redraw_requested_, false);
+}
+
+void ObserveMenu::showTdMon() {
+  try {
+    refreshTdMon(true);
+  } catch (std::exception e) {
+    std::cout
+        << "cannot initialize TdMon. Reason: " << e.what()
+        << "\nPlease make sure that you entered correct information in the setup."
+        << std::endl;
+  }
+}
+
 void ObserveMenu::refreshTdMon(bool prefer_cache) {
+  // the td-mon that is being created replaces the displayed one anyway. The
+  // factory is not touched, as it is busy until the creation is finished
+  if (pending_td_mon_.valid()) {
+    return;
+  }
+
+  // select the cached td-mon of the current data source, if there is one. A
+  // td-mon of another data source (e.g. another user) counts as no cache
+  const bool has_cache = tdmon_cache_.selectEntryOfDataSource(
+      tdmon_factory_.getDataSourceFingerprint());
+
   // if no cache exists OR cache should not be preferred, create a new TdMon
-  // from factory
-  if (!prefer_cache || !tdmon_cache_.hasCache()) {
-    try {
-      std::unique_ptr<TdMon> td_mon = tdmon_factory_.create();
-      tdmon_cache_.updateCache(std::move(td_mon));
-    } catch (std::exception e) {
-      std::cout << "error while updating TD-Mon: " << e.what() << std::endl;
+  // from factory. The creation is started in update() and the new td-mon is
+  // displayed there, once it is available
+  if (!prefer_cache || !has_cache) {
+    refresh_scheduler_.requestRefresh();
+
+    // nothing to display until the new td-mon is available
+    if (!has_cache) {
+      clearTdMon();
+      return;
     }
+  } else {
+    // the cached td-mon is revalidated in update(), once it is stale
+    refresh_scheduler_.setLastValidatedTime(
+        TdMonRefreshScheduler::Clock::time_point{
+            tdmon_cache_.getLastUpdatedTimestamp()});
   }
 
+  displayTdMon();
+}
+
+void ObserveMenu::startTdMonCreation() {
+  // a td-mon is already being created
+  if (pending_td_mon_.valid()) {
+    return;
+  }
+
+  // read the fingerprint before creating the td-mon, so changes made while it
+  // is being created are detected on the next refresh
+  std::optional<DataSourceFingerprint> fingerprint =
+      tdmon_factory_.getDataSourceFingerprint();
+  // the data did not change since the cached td-mon was created
+  if (fingerprint && tdmon_cache_.hasCache() &&
+      tdmon_cache_.getDataSourceFingerprint() == fingerprint) {
+    refresh_scheduler_.onRefreshStarted();
+    refresh_scheduler_.onRefreshSucceeded();
+    return;
+  }
+  pending_td_mon_fingerprint_ = std::move(fingerprint);
+
+  refresh_scheduler_.onRefreshStarted();
+  pending_td_mon_stop_source_ = std::stop_source();
+  pending_td_mon_progress_ = 0.0f;
+  pending_td_mon_start_time_ = std::chrono::steady_clock::now();
+  try {
+    pending_td_mon_ = tdmon_factory_.createAsync(
+        pending_td_mon_stop_source_.get_token(),
+        [this](float progress) { pending_td_mon_progress_ = progress; });
+  } catch (...) {
+    refresh_scheduler_.onRefreshFailed();
+    throw;
+  }
+
+  refresh_progress_bar_->setValue(0);
+  refresh_progress_bar_->setVisible(true);
+  redraw_requested_ = true;
+}
+
+void ObserveMenu::finishTdMonCreationIfReady() {
+  if (!pending_td_mon_.valid()) {
+    return;
+  }
+
+  const unsigned int progress =
+      static_cast<unsigned int>(pending_td_mon_progress_ * 100.0f);
+  if (progress != refresh_progress_bar_->getValue()) {
+    refresh_progress_bar_->setValue(progress);
+    redraw_requested_ = true;
+  }
+
+  if (pending_td_mon_.wait_for(std::chrono::seconds(0)) !=
+      std::future_status::ready) {
+    return;
+  }
+
+  refresh_progress_bar_->setVisible(false);
+  redraw_requested_ = true;
+
+  try {
+    // get() rethrows exceptions from the factory and invalidates the future
+    tdmon_cache_.updateCache(pending_td_mon_.get());
+    OperationLatencies::record(
+        Operation::kTdMonCreation,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - pending_td_mon_start_time_));
+    // record the td-mon in the history. Failures do not affect the cache
+    if (pending_td_mon_fingerprint_ && tdmon_history_log_.isOpen()) {
+      try {
+        OperationLatencies::Timer timer(Operation::kHistoryAppend);
+        tdmon_history_log_.append(pending_td_mon_fingerprint_->identity,
+                                  *tdmon_cache_.getCache(),
+                                  tdmon_cache_.getLastUpdatedTimestamp());
+      } catch (const std::exception& e) {
+        std::cout << "cannot append to td-mon history. Reason: " << e.what()
+                  << std::endl;
+      }
+    }
+    tdmon_cache_.setDataSourceFingerprint(
+        std::move(pending_td_mon_fingerprint_));
+    refresh_scheduler_.onRefreshSucceeded();
+    displayTdMon();
+  } catch (const TdMonCreationCancelledError&) {
+    refresh_scheduler_.onRefreshCancelled();
+  } catch (const std::exception& e) {
+    refresh_scheduler_.onRefreshFailed();
+    std::cout << "error while updating TD-Mon: " << e.what() << std::endl;
+  }
+}
+
+void ObserveMenu::cancelTdMonCreation() {
+  if (!pending_td_mon_.valid()) {
+    return;
+  }
+
+  pending_td_mon_stop_source_.request_stop();
+  // the factory interrupts the creation, so this does not block for long
+  pending_td_mon_.wait();
+  pending_td_mon_ = std::future<std::unique_ptr<TdMon>>();
+  refresh_scheduler_.onRefreshCancelled();
+}
+
+void ObserveMenu::clearTdMon() {
+  tdmon_data_label_->setText("No data");
+  tdmon_picture_->setVisible(false);
+}
+
+void ObserveMenu::displayTdMon() {
   const TdMon* currentTdMon = tdmon_cache_.getCache();
   if (!currentTdMon) {
-    throw std::exception("ObserveMenu::refreshTdMon currentTdMon is nullptr");
+    throw std::exception("ObserveMenu::displayTdMon currentTdMon is nullptr");
   }
 
   // convert stored timestamp to a time point, then to zoned_time (local
@@ -128,9 +320,10 @@ void ObserveMenu::refreshTdMon(bool prefer_cache) {
       // use std::format to display the zoned_time in a
       "\nLast updated: " + std::format("{:%x %T}", zoned_time));
 
-  // visual representation
+  // visual representation. Usually preloaded during startup
+  tdmon_picture_->setVisible(true);
 
-  tdmon_visual_representation_.loadFromFile(currentTdMon->getTexturePath());
-  tdmon_picture_->getRenderer()->setTexture(tdmon_visual_representation_);
+  tdmon_picture_->getRenderer()->setTexture(
+      *texture_manager_.getTexture(currentTdMon->getTexturePath()));
 }
 }  // namespace tdmon
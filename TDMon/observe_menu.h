@@ -25,14 +25,33 @@
 #pragma once
 
 #include <TDMon/application_state.h>
+#include <TDMon/operation_latencies.h>
 #include <TDMon/td_mon_cache.h>
 #include <TDMon/td_mon_factory.h>
+#include <TDMon/td_mon_history_log.h>
+#include <TDMon/td_mon_refresh_scheduler.h>
+#include <TDMon/texture_manager.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <stop_token>
 
 namespace tdmon {
 /**
  * @brief The observe menu application state. Responsible for displaying the
  * td-mon from cache and updating it from the td-mon factory passed in the
  * constructor, if requested by the click of a button.
+ *
+ * New td-mons are created asynchronously, so the application keeps rendering
+ * frames while the factory is working. A progress bar is shown in the meantime.
+ * Leaving the menu cancels a running creation.
+ *
+ * The cached td-mon is shown right away and revalidated in the background once
+ * it is stale (stale-while-revalidate). When to create a new td-mon is decided
+ * by a TdMonRefreshScheduler. Every new td-mon of a known data source is
+ * appended to the td-mon history log.
  */
 class ObserveMenu : public ApplicationState {
  public:
@@ -41,8 +60,14 @@ class ObserveMenu : public ApplicationState {
    * @param tdmon_cache The td-mon cache to load and store the td-mon
    * @param tdmon_factory The td-mon factory to use for the creation of new
    * td-mon instances
+   * @param tdmon_history_log The log to append new td-mons to. Nothing is
+   * appended, if it is not open.
+   * @param texture_manager The texture manager to get the visual
+   * representation of the td-mon from
    */
-  ObserveMenu(TdMonCache& tdmon_cache, TdMonFactory& tdmon_factory);
+  ObserveMenu(TdMonCache& tdmon_cache, TdMonFactory& tdmon_factory,
+              TdMonHistoryLog& tdmon_history_log,
+              TextureManager& texture_manager);
 
   // Inherited via ApplicationState
 
@@ -54,24 +79,64 @@ class ObserveMenu : public ApplicationState {
   void init(tgui::GuiSFML& gui) override;
 
   /**
-   * @brief Implementation of the update function from ApplicationState
+   * @brief Implementation of the update function from ApplicationState. Also
+   * checks whether a running td-mon creation has finished.
    * @return The application state to change to
    */
   SupportedApplicationStateChanges update() override;
 
   /**
    * @brief Implementation of the cleanup function from ApplicationState.
-   * Removes the gui elements that were added in init()
+   * Removes the gui elements that were added in init(). Cancels a running
+   * td-mon creation and waits for it to stop.
    * @param gui The gui
    */
   void cleanup(tgui::GuiSFML& gui) override;
 
+  /**
+   * @brief Implementation of the suspend function from ApplicationState.
+   * Hides the gui elements that were added in init(). Cancels a running td-mon
+   * creation, since the data source may be changed in the meantime.
+   * @param gui The gui
+   */
+  void suspend(tgui::GuiSFML& gui) override;
+
+  /**
+   * @brief Implementation of the resume function from ApplicationState.
+   * Shows the gui elements that were added in init() again, and displays the
+   * cached td-mon of the current data source, like init().
+   * @param gui The gui
+   */
+  void resume(tgui::GuiSFML& gui) override;
+
   /**
    * @brief Get this classes application state type
    * @return The application state type
    */
   SupportedApplicationStateTypes getApplicationStateType() const override;
 
+  /**
+   * @brief The observe menu checks for a td-mon that is being created, and
+   * starts due refreshes without user input
+   * @return true, if a td-mon is being created or a refresh is due
+   */
+  bool needsUpdatesWithoutEvents() const override;
+
+  /**
+   * @brief The cached td-mon is revalidated once it is stale, and failed
+   * refreshes are retried after a backoff
+   * @return The time until the next refresh is due. Empty, while a td-mon is
+   * being created.
+   */
+  std::optional<std::chrono::microseconds> getTimeUntilNextUpdate()
+      const override;
+
+  /**
+   * @brief Get whether update() changed the progress or the displayed td-mon
+   * @return true, if a redraw is needed. Resets the request.
+   */
+  bool takeRedrawRequest() override;
+
  private:
   /**
    * @brief A reference to the TdMonCache to use for load/save
@@ -84,10 +149,15 @@ class ObserveMenu : public ApplicationState {
   TdMonFactory& tdmon_factory_;
 
   /**
-   * @brief The currently used texture for the visual representation of the
-   * td-mon
+   * @brief A reference to the TdMonHistoryLog to append new td-mons to
+   */
+  TdMonHistoryLog& tdmon_history_log_;
+
+  /**
+   * @brief A reference to the TextureManager providing the textures for the
+   * visual representation of the td-mon
    */
-  sf::Texture tdmon_visual_representation_;
+  TextureManager& texture_manager_;
 
   /**
    * @brief Store the next application state change to be requested in update().
@@ -97,6 +167,12 @@ class ObserveMenu : public ApplicationState {
   SupportedApplicationStateChanges next_application_state_change_ =
       SupportedApplicationStateChanges::kNull;
 
+  /**
+   * @brief true, if the gui changed without an event since the last call to
+   * takeRedrawRequest()
+   */
+  bool redraw_requested_ = false;
+
   /**
    * @brief The observe menu group ui element
    */
@@ -122,13 +198,98 @@ class ObserveMenu : public ApplicationState {
    */
   tgui::Label::Ptr tdmon_data_label_ = nullptr;
 
+  /**
+   * @brief The progress bar ui element. Only visible while a td-mon is being
+   * created.
+   */
+  tgui::ProgressBar::Ptr refresh_progress_bar_ = nullptr;
+
+  /**
+   * @brief The progress of the running td-mon creation between 0 and 1. Written
+   * by the worker thread of the factory.
+   */
+  std::atomic<float> pending_td_mon_progress_ = 0.0f;
+
+  /**
+   * @brief Used to cancel the running td-mon creation
+   */
+  std::stop_source pending_td_mon_stop_source_;
+
+  /**
+   * @brief The fingerprint of the data the td-mon which is currently being
+   * created is created from. Stored in the cache together with the td-mon.
+   */
+  std::optional<DataSourceFingerprint> pending_td_mon_fingerprint_;
+
+  /**
+   * @brief The time the td-mon which is currently being created was started.
+   * Used to record the latency of the creation.
+   */
+  std::chrono::steady_clock::time_point pending_td_mon_start_time_;
+
+  /**
+   * @brief The td-mon which is currently being created by the factory. Not
+   * valid, if no creation is running. Declared after the members used by the
+   * worker thread, so it is destroyed (and waited for) before them.
+   */
+  std::future<std::unique_ptr<TdMon>> pending_td_mon_;
+
+  /**
+   * @brief Decides when to create a new td-mon. Coalesces refresh requests
+   * and delays retries after failures.
+   */
+  TdMonRefreshScheduler refresh_scheduler_;
+
+  /**
+   * @brief Private function to display the cached td-mon of the current data
+   * source, or request a new one, if none is cached. Prints errors.
+   */
+  void showTdMon();
+
   /**
    * @brief Private function to refresh the td-mon (load from cache or create a
-   * new one from factory)
+   * new one from factory). Selects the cached td-mon of the data source of the
+   * factory first, if the cache holds one. Does nothing while a td-mon is
+   * being created.
    * @param prefer_cache true, if the cache should be preferred over creating a
    * new td-mon from factory. If no cache is available, or prefer_cache ==
-   * false, a new td-mon is created from factory
+   * false, a refresh is requested from the scheduler. Otherwise, the cached
+   * td-mon is only revalidated once it is stale. The cached td-mon (if any) is
+   * shown until the new one is available.
    */
   void refreshTdMon(bool prefer_cache = false);
+
+  /**
+   * @brief Start creating a new td-mon asynchronously, if no creation is
+   * running yet. Shows the progress bar. Does nothing, if the factory reports
+   * the same data source fingerprint as the one of the cached td-mon, since
+   * the same td-mon would be created again. The cached td-mon counts as
+   * validated in that case. Reports the start to the refresh scheduler.
+   */
+  void startTdMonCreation();
+
+  /**
+   * @brief Update the progress bar of a running td-mon creation. If the
+   * creation has finished, store the td-mon in the cache, append it to the
+   * history and display it. Reports the result to the refresh scheduler.
+   */
+  void finishTdMonCreationIfReady();
+
+  /**
+   * @brief Cancel a running td-mon creation and wait for it to stop.
+   */
+  void cancelTdMonCreation();
+
+  /**
+   * @brief Display the td-mon currently stored in the cache. Throws, if the
+   * cache is empty.
+   */
+  void displayTdMon();
+
+  /**
+   * @brief Display that no td-mon is available, e.g. because none of the
+   * current data source is cached yet
+   */
+  void clearTdMon();
 };
 }  // namespace tdmon
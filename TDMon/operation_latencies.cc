@@ -0,0 +1,73 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/operation_latencies.h>
+
+namespace tdmon {
+OperationLatencies::Timer::Timer(Operation operation)
+    : operation_(operation), start_time_(std::chrono::steady_clock::now()) {}
+
+OperationLatencies::Timer::~Timer() {
+  record(operation_, std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - start_time_));
+}
+
+void OperationLatencies::record(Operation operation,
+                                std::chrono::microseconds latency) {
+  last_latencies_[static_cast<std::size_t>(operation)].store(
+      latency.count(), std::memory_order_relaxed);
+}
+
+std::optional<std::chrono::microseconds> OperationLatencies::getLast(
+    Operation operation) {
+  const std::int64_t latency =
+      last_latencies_[static_cast<std::size_t>(operation)].load(
+          std::memory_order_relaxed);
+  if (latency < 0) {
+    return std::nullopt;
+  }
+  return std::chrono::microseconds(latency);
+}
+
+std::string_view OperationLatencies::getName(Operation operation) {
+  switch (operation) {
+    case Operation::kTdMonCreation:
+      return "td-mon creation";
+    case Operation::kCacheLoad:
+      return "cache load";
+    case Operation::kCacheEncode:
+      return "cache encode";
+    case Operation::kCacheWrite:
+      return "cache write";
+    case Operation::kHistoryAppend:
+      return "history append";
+    default:
+      return "unknown";
+  }
+}
+
+static_assert(OperationLatencies::kOperationCount == 5,
+              "initialize the slots of all operations");
+std::array<std::atomic<std::int64_t>, OperationLatencies::kOperationCount>
+    OperationLatencies::last_latencies_ = {-1, -1, -1, -1, -1};
+}  // namespace tdmon
@@ -0,0 +1,142 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace tdmon {
+/**
+ * @brief The operations, whose latencies are recorded in OperationLatencies
+ */
+enum class Operation {
+  /**
+   * @brief Creating a td-mon in the observe menu, from the start of the
+   * creation until the new td-mon is available
+   */
+  kTdMonCreation,
+
+  /**
+   * @brief Loading the cache from disk
+   */
+  kCacheLoad,
+
+  /**
+   * @brief Encoding the cache to store it on disk
+   */
+  kCacheEncode,
+
+  /**
+   * @brief Writing the encoded cache to disk
+   */
+  kCacheWrite,
+
+  /**
+   * @brief Appending a td-mon to the history log
+   */
+  kHistoryAppend
+};
+
+/**
+ * @brief Holds the latency of the last run of each Operation, e.g. to show it
+ * in the FrameTimingOverlay.
+ *
+ * There is one slot per operation, which is a static atomic, so latencies can
+ * be recorded from any thread without locking or allocating memory, and
+ * without passing a recorder to every component.
+ */
+class OperationLatencies {
+ public:
+  /**
+   * @brief The number of operations
+   */
+  static constexpr std::size_t kOperationCount =
+      static_cast<std::size_t>(Operation::kHistoryAppend) + 1;
+
+  /**
+   * @brief Measures the time from its construction until its destruction and
+   * records it as the latency of an operation
+   */
+  class Timer {
+   public:
+    /**
+     * @brief The constructor. Starts measuring.
+     * @param operation The operation to record the latency of
+     */
+    explicit Timer(Operation operation);
+
+    /**
+     * @brief The destructor. Records the latency.
+     */
+    ~Timer();
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+   private:
+    /**
+     * @brief The operation to record the latency of
+     */
+    Operation operation_;
+
+    /**
+     * @brief The time the measurement started
+     */
+    std::chrono::steady_clock::time_point start_time_;
+  };
+
+  /**
+   * @brief Record the latency of an operation. Thread-safe.
+   * @param operation The operation
+   * @param latency The latency
+   */
+  static void record(Operation operation, std::chrono::microseconds latency);
+
+  /**
+   * @brief Get the latency of the last run of an operation. Thread-safe.
+   * @param operation The operation
+   * @return The latency. Empty, if the operation was not recorded yet.
+   */
+  static std::optional<std::chrono::microseconds> getLast(Operation operation);
+
+  /**
+   * @brief Get a short name of an operation to display
+   * @param operation The operation
+   * @return The name
+   */
+  static std::string_view getName(Operation operation);
+
+ private:
+  /**
+   * @brief The latency of the last run of each operation in microseconds. -1,
+   * if the operation was not recorded yet.
+   */
+  static std::array<std::atomic<std::int64_t>, kOperationCount> last_latencies_;
+};
+}  // namespace tdmon
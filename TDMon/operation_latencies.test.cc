@@ -0,0 +1,48 @@
+#include <TDMon/operation_latencies.h>
+#include <gtest/gtest.h>
+
+namespace tdmon {
+/**
+ * @brief Test, if the last recorded latency of each operation is returned.
+ */
+TEST(OperationLatencies, ReturnsTheLastRecordedLatency) {
+  OperationLatencies::record(Operation::kCacheEncode,
+                             std::chrono::microseconds(10));
+  OperationLatencies::record(Operation::kCacheEncode,
+                             std::chrono::microseconds(20));
+  OperationLatencies::record(Operation::kCacheWrite,
+                             std::chrono::microseconds(30));
+
+  EXPECT_EQ(OperationLatencies::getLast(Operation::kCacheEncode),
+            std::chrono::microseconds(20));
+  EXPECT_EQ(OperationLatencies::getLast(Operation::kCacheWrite),
+            std::chrono::microseconds(30));
+}
+
+/**
+ * @brief Test, if the timer records the time between its construction and
+ * its destruction.
+ */
+TEST(OperationLatencies, TimerRecordsItsLifetime) {
+  OperationLatencies::record(Operation::kHistoryAppend,
+                             std::chrono::hours(1));
+  {
+    OperationLatencies::Timer timer(Operation::kHistoryAppend);
+  }
+
+  const auto latency = OperationLatencies::getLast(Operation::kHistoryAppend);
+  ASSERT_TRUE(latency.has_value());
+  EXPECT_GE(*latency, std::chrono::microseconds(0));
+  EXPECT_LT(*latency, std::chrono::hours(1));
+}
+
+/**
+ * @brief Test, if every operation has a name to display.
+ */
+TEST(OperationLatencies, NamesEveryOperation) {
+  for (std::size_t i = 0; i < OperationLatencies::kOperationCount; ++i) {
+    EXPECT_NE(OperationLatencies::getName(static_cast<Operation>(i)),
+              "unknown");
+  }
+}
+}  // namespace tdmon
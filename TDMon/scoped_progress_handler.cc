@@ -0,0 +1,60 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/scoped_progress_handler.h>
+
+#include <sqlite3.h>
+
+namespace tdmon {
+namespace {
+/**
+ * @brief sqlite progress handler. Interrupts the running query, if a stop was
+ * requested on the std::stop_token passed as context.
+ * @param stop_token Pointer to the std::stop_token
+ * @return non-zero, to interrupt the query
+ */
+int interruptIfStopRequested(void* stop_token) {
+  return static_cast<const std::stop_token*>(stop_token)->stop_requested() ? 1
+                                                                           : 0;
+}
+}  // namespace
+
+ScopedProgressHandler::ScopedProgressHandler(SQLite::Database& db,
+                                             const std::stop_token& stop_token,
+                                             int instruction_count)
+    : db_(db) {
+  if (stop_token.stop_possible()) {
+    sqlite3_progress_handler(db_.getHandle(), instruction_count,
+                             &interruptIfStopRequested,
+                             const_cast<std::stop_token*>(&stop_token));
+  }
+}
+
+ScopedProgressHandler::~ScopedProgressHandler() {
+  sqlite3_progress_handler(db_.getHandle(), 0, nullptr, nullptr);
+}
+}  // namespace tdmon
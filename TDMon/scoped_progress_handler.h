@@ -0,0 +1,72 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <stop_token>
+
+namespace SQLite {
+class Database;
+}  // namespace SQLite
+
+namespace tdmon {
+/**
+ * @brief Installs a sqlite progress handler on a database connection for the
+ * lifetime of this object. The handler interrupts the running statement, once
+ * a stop is requested on a std::stop_token. The interrupted statement throws
+ * a SQLite::Exception.
+ */
+class ScopedProgressHandler {
+ public:
+  /**
+   * @brief The default number of sqlite virtual machine instructions between
+   * two calls of the progress handler
+   */
+  static const int kDefaultInstructionCount = 10000;
+
+  /**
+   * @brief The constructor. Installs the progress handler, if a stop can be
+   * requested on the stop_token.
+   * @param db The database connection
+   * @param stop_token The stop token. Must outlive this object.
+   * @param instruction_count The number of instructions between two calls of
+   * the progress handler
+   */
+  ScopedProgressHandler(SQLite::Database& db, const std::stop_token& stop_token,
+                        int instruction_count = kDefaultInstructionCount);
+
+  /**
+   * @brief The destructor. Removes the progress handler.
+   */
+  ~ScopedProgressHandler();
+
+  ScopedProgressHandler(const ScopedProgressHandler&) = delete;
+  ScopedProgressHandler& operator=(const ScopedProgressHandler&) = delete;
+
+ private:
+  /**
+   * @brief The database connection
+   */
+  SQLite::Database& db_;
+};
+}  // namespace tdmon
@@ -0,0 +1,166 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/startup_pipeline.h>
+#include <TDMon/trace_recorder.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace tdmon {
+StartupPipeline::StartupPipeline(std::size_t thread_count)
+    : construction_time_(std::chrono::steady_clock::now()) {
+  thread_count = std::max<std::size_t>(thread_count, 1);
+  worker_threads_.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    worker_threads_.emplace_back(&StartupPipeline::runBackgroundPhases, this);
+  }
+}
+
+StartupPipeline::~StartupPipeline() { joinWorkerThreads(); }
+
+void StartupPipeline::addBackgroundPhase(std::string name,
+                                         std::function<void()> phase) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_requested_) {
+      throw std::runtime_error(
+          "cannot add a background phase after StartupPipeline::wait()");
+    }
+    pending_phases_.push_back({std::move(name), std::move(phase)});
+  }
+  condition_.notify_one();
+}
+
+void StartupPipeline::runPhase(std::string name,
+                               const std::function<void()>& phase) {
+  runAndMeasure(name, phase, false);
+}
+
+void StartupPipeline::wait() {
+  joinWorkerThreads();
+
+  std::exception_ptr exception = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // rethrow only once
+    std::swap(exception, first_exception_);
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+std::vector<StartupPipeline::PhaseTiming> StartupPipeline::getPhaseTimings()
+    const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return phase_timings_;
+}
+
+std::chrono::microseconds StartupPipeline::getElapsedTime() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - construction_time_);
+}
+
+void StartupPipeline::printPhaseTimings(std::ostream& stream) const {
+  for (const PhaseTiming& timing : getPhaseTimings()) {
+    stream << "startup phase '" << timing.name << "' ("
+           << (timing.is_background_phase ? "background" : "main thread")
+           << "): started at " << timing.start_time.count() / 1000.0
+           << " ms, took " << timing.duration.count() / 1000.0 << " ms"
+           << std::endl;
+  }
+}
+
+void StartupPipeline::runBackgroundPhases() {
+  while (true) {
+    PendingPhase pending_phase;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this] {
+        return stop_requested_ || !pending_phases_.empty();
+      });
+      if (pending_phases_.empty()) {
+        // stop requested and no phase left
+        return;
+      }
+      pending_phase = std::move(pending_phases_.front());
+      pending_phases_.pop_front();
+    }
+
+    try {
+      runAndMeasure(pending_phase.name, pending_phase.phase, true);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!first_exception_) {
+        first_exception_ = std::current_exception();
+      }
+    }
+  }
+}
+
+void StartupPipeline::runAndMeasure(const std::string& name,
+                                    const std::function<void()>& phase,
+                                    bool is_background_phase) {
+  TDMON_TRACE_SCOPE(name);
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  // record the timing of failed phases, too
+  auto record_timing = [&]() {
+    const std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    phase_timings_.push_back(
+        {name,
+         std::chrono::duration_cast<std::chrono::microseconds>(
+             start - construction_time_),
+         std::chrono::duration_cast<std::chrono::microseconds>(end - start),
+         is_background_phase});
+  };
+
+  try {
+    phase();
+  } catch (...) {
+    record_timing();
+    throw;
+  }
+  record_timing();
+}
+
+void StartupPipeline::joinWorkerThreads() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_requested_ = true;
+  }
+  condition_.notify_all();
+
+  for (std::thread& worker_thread : worker_threads_) {
+    if (worker_thread.joinable()) {
+      worker_thread.join();
+    }
+  }
+  worker_threads_.clear();
+}
+}  // namespace tdmon
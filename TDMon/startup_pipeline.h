@@ -0,0 +1,217 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief Runs the phases of the application startup concurrently on a small
+ * pool of worker threads and records how long each phase took.
+ *
+ * Background phases (e.g. loading the cache or decoding textures) are added
+ * with addBackgroundPhase() and run by the worker threads, while phases that
+ * must run on the calling thread (e.g. creating the window) are run with
+ * runPhase(). wait() blocks until all background phases are finished. The
+ * timings of all phases are measured relative to the construction of the
+ * pipeline, so they can be compared with each other.
+ */
+class StartupPipeline {
+ public:
+  /**
+   * @brief The default number of worker threads
+   */
+  static constexpr std::size_t kDefaultThreadCount = 3;
+
+  /**
+   * @brief The timing of a finished phase
+   */
+  struct PhaseTiming {
+    /**
+     * @brief The name of the phase
+     */
+    std::string name;
+
+    /**
+     * @brief The time the phase started, relative to the construction of the
+     * pipeline
+     */
+    std::chrono::microseconds start_time;
+
+    /**
+     * @brief The time the phase took
+     */
+    std::chrono::microseconds duration;
+
+    /**
+     * @brief true, if the phase ran on a worker thread
+     */
+    bool is_background_phase;
+  };
+
+  /**
+   * @brief The constructor. Starts the worker threads.
+   * @param thread_count The number of worker threads. At least one is used.
+   */
+  explicit StartupPipeline(std::size_t thread_count = kDefaultThreadCount);
+
+  /**
+   * @brief The destructor. Waits for all background phases, but ignores their
+   * exceptions.
+   */
+  ~StartupPipeline();
+
+  StartupPipeline(const StartupPipeline&) = delete;
+  StartupPipeline& operator=(const StartupPipeline&) = delete;
+
+  /**
+   * @brief Add a phase to run on a worker thread. Phases start in the order
+   * they were added.
+   * @param name The name of the phase
+   * @param phase The function to run. Must be thread-safe with respect to all
+   * other phases.
+   */
+  void addBackgroundPhase(std::string name, std::function<void()> phase);
+
+  /**
+   * @brief Run a phase on the calling thread and record its timing. Exceptions
+   * are passed on to the caller.
+   * @param name The name of the phase
+   * @param phase The function to run
+   */
+  void runPhase(std::string name, const std::function<void()>& phase);
+
+  /**
+   * @brief Wait until all background phases are finished and stop the worker
+   * threads. No more background phases can be added afterwards.
+   * @throws The exception of the first background phase that failed, if any
+   */
+  void wait();
+
+  /**
+   * @brief Get the timings of all finished phases, in the order they finished
+   * @return The phase timings
+   */
+  std::vector<PhaseTiming> getPhaseTimings() const;
+
+  /**
+   * @brief Get the time since the construction of the pipeline
+   * @return The elapsed time
+   */
+  std::chrono::microseconds getElapsedTime() const;
+
+  /**
+   * @brief Print the timings of all finished phases, one per line
+   * @param stream The stream to print to
+   */
+  void printPhaseTimings(std::ostream& stream) const;
+
+ private:
+  /**
+   * @brief A background phase, which has not been started yet
+   */
+  struct PendingPhase {
+    /**
+     * @brief The name of the phase
+     */
+    std::string name;
+
+    /**
+     * @brief The function to run
+     */
+    std::function<void()> phase;
+  };
+
+  /**
+   * @brief The time the pipeline was constructed
+   */
+  std::chrono::steady_clock::time_point construction_time_;
+
+  /**
+   * @brief Protects all members below
+   */
+  mutable std::mutex mutex_;
+
+  /**
+   * @brief Notified when a phase is added and when the workers should stop
+   */
+  std::condition_variable condition_;
+
+  /**
+   * @brief The background phases, which have not been started yet
+   */
+  std::deque<PendingPhase> pending_phases_;
+
+  /**
+   * @brief The timings of all finished phases
+   */
+  std::vector<PhaseTiming> phase_timings_;
+
+  /**
+   * @brief The exception of the first background phase that failed
+   */
+  std::exception_ptr first_exception_ = nullptr;
+
+  /**
+   * @brief true, if the workers should stop once all phases are finished
+   */
+  bool stop_requested_ = false;
+
+  /**
+   * @brief The worker threads. Empty after wait().
+   */
+  std::vector<std::thread> worker_threads_;
+
+  /**
+   * @brief Private function run by the worker threads. Runs background phases
+   * until a stop is requested and no phase is left.
+   */
+  void runBackgroundPhases();
+
+  /**
+   * @brief Private function to run a phase and record its timing
+   * @param name The name of the phase
+   * @param phase The function to run
+   * @param is_background_phase true, if called by a worker thread
+   */
+  void runAndMeasure(const std::string& name,
+                     const std::function<void()>& phase,
+                     bool is_background_phase);
+
+  /**
+   * @brief Private function to stop and join the worker threads
+   */
+  void joinWorkerThreads();
+};
+}  // namespace tdmon
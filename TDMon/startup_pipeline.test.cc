@@ -0,0 +1,89 @@
+#include <TDMon/startup_pipeline.h>
+#include <gtest/gtest.h>
+
+#include <future>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace tdmon {
+/**
+ * @brief Test, if background phases run concurrently with each other and with
+ * the phases on the calling thread.
+ */
+TEST(StartupPipeline, RunsPhasesConcurrently) {
+  StartupPipeline pipeline(2);
+
+  // each background phase waits for the other one, so this only finishes, if
+  // both run at the same time
+  std::promise<void> first_started;
+  std::promise<void> second_started;
+  std::shared_future<void> first_started_future =
+      first_started.get_future().share();
+  std::shared_future<void> second_started_future =
+      second_started.get_future().share();
+  std::promise<void> main_phase_finished;
+  std::shared_future<void> main_phase_finished_future =
+      main_phase_finished.get_future().share();
+
+  pipeline.addBackgroundPhase("first", [&]() {
+    first_started.set_value();
+    second_started_future.wait();
+    main_phase_finished_future.wait();
+  });
+  pipeline.addBackgroundPhase("second", [&]() {
+    second_started.set_value();
+    first_started_future.wait();
+    main_phase_finished_future.wait();
+  });
+
+  pipeline.runPhase("main", [&]() { first_started_future.wait(); });
+  main_phase_finished.set_value();
+
+  pipeline.wait();
+
+  std::vector<StartupPipeline::PhaseTiming> timings =
+      pipeline.getPhaseTimings();
+  ASSERT_EQ(timings.size(), 3);
+  // the main phase finished before the background phases
+  EXPECT_EQ(timings.front().name, "main");
+  EXPECT_FALSE(timings.front().is_background_phase);
+  EXPECT_TRUE(timings.back().is_background_phase);
+  for (const StartupPipeline::PhaseTiming& timing : timings) {
+    EXPECT_LE(timing.start_time + timing.duration, pipeline.getElapsedTime());
+  }
+
+  std::stringstream stream;
+  pipeline.printPhaseTimings(stream);
+  EXPECT_NE(stream.str().find("'second' (background)"), std::string::npos);
+}
+
+/**
+ * @brief Test, if wait() rethrows the exception of a failed background phase,
+ * while the other phases still finish.
+ */
+TEST(StartupPipeline, RethrowsExceptionOfBackgroundPhase) {
+  StartupPipeline pipeline(1);
+
+  bool other_phase_finished = false;
+  pipeline.addBackgroundPhase(
+      "failing", []() { throw std::runtime_error("phase failed"); });
+  pipeline.addBackgroundPhase("other",
+                              [&]() { other_phase_finished = true; });
+
+  EXPECT_THROW(pipeline.wait(), std::runtime_error);
+  EXPECT_TRUE(other_phase_finished);
+  // the failed phase is measured, too
+  EXPECT_EQ(pipeline.getPhaseTimings().size(), 2);
+
+  // the exception is only thrown once, and no phases can be added anymore
+  EXPECT_NO_THROW(pipeline.wait());
+  EXPECT_THROW(pipeline.addBackgroundPhase("late", []() {}),
+               std::runtime_error);
+
+  // exceptions of phases on the calling thread are passed on directly
+  EXPECT_THROW(pipeline.runPhase(
+                   "main", []() { throw std::runtime_error("phase failed"); }),
+               std::runtime_error);
+}
+}  // namespace tdmon
@@ -24,7 +24,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <nlohmann/json.hpp>
+#include <string_view>
 
 namespace tdmon {
 /**
@@ -42,6 +44,22 @@ class TdMon {
    */
   static const std::string kJsonTypeIdentifierKey;
 
+  /**
+   * @brief Hash a type identifier string to a type id with the 32 bit FNV-1a
+   * hash. Usable at compile time, so derived classes can declare their type
+   * id as a constant (see TdMonTypeRegistry).
+   * @param type_identifier The type identifier string
+   * @return The type id
+   */
+  static constexpr std::uint32_t hashTypeIdentifier(
+      std::string_view type_identifier) {
+    std::uint32_t hash = 0x811C9DC5u;
+    for (char character : type_identifier) {
+      hash = (hash ^ static_cast<unsigned char>(character)) * 0x01000193u;
+    }
+    return hash;
+  }
+
   /**
    * @brief Virtual default destructor to allow deletion of derived classes
    * from a pointer to this base class
@@ -78,6 +96,13 @@ class TdMon {
    */
   virtual nlohmann::json toJson() const = 0;
 
+  /**
+   * @brief Get the type id of the derived class. Stored instead of the type
+   * identifier string in binary formats.
+   * @return The hash of the type identifier string (see hashTypeIdentifier())
+   */
+  virtual std::uint32_t getTypeId() const = 0;
+
   /**
    * @brief Get the path to the texture representing the current visual of the
    * TD-Mon.
@@ -24,10 +24,16 @@
 
 #pragma once
 
+#include <TDMon/data_source_fingerprint.h>
 #include <TDMon/td_mon.h>
 
 #include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace tdmon {
 /**
@@ -46,10 +52,33 @@ class TdMonCache {
    *
    * Stores the currently cached td-mon, as well as a timestamp indicating when
    * the cache was last changed. Cache must contain a td-mon (not be empty) when
-   * calling this method.
+   * calling this method. The file is replaced atomically, so it stays readable
+   * if the application crashes while storing.
    */
   virtual void storeOnDisk() const = 0;
 
+  /**
+   * @brief Encode the cache as it is stored on disk, without writing it. This
+   * allows writing the cache on another thread (see TdMonCacheWriteBehind).
+   * Cache must contain a td-mon (not be empty) when calling this method.
+   * @return The contents of the cache file
+   */
+  virtual std::vector<char> encodeForDisk() const = 0;
+
+  /**
+   * @brief Get the path of the cache file on disk
+   * @return The path
+   */
+  virtual std::filesystem::path getCacheFilePath() const = 0;
+
+  /**
+   * @brief Get the number of modifications of the cache. Increases every time
+   * the contents stored on disk would change, so it can be used to detect
+   * unsaved changes.
+   * @return The number of modifications
+   */
+  virtual std::uint64_t getModificationCount() const = 0;
+
   /**
    * @brief Load the cache from disk.
    *
@@ -66,10 +95,55 @@ class TdMonCache {
   /**
    * @brief Update the cache with new td-mon data. Overrides the current cache.
    * Also updates the "last-modified" timestamp to the current system time.
+   * Clears the data source fingerprint, since the source of the data is
+   * unknown.
    * @param data
    */
   virtual void updateCache(std::unique_ptr<TdMon> data) = 0;
 
+  /**
+   * @brief Set the fingerprint of the data the cached td-mon was created from.
+   * Stored to and loaded from disk together with the td-mon.
+   * @param fingerprint The fingerprint. Empty, if it is unknown.
+   */
+  virtual void setDataSourceFingerprint(
+      std::optional<DataSourceFingerprint> fingerprint) = 0;
+
+  /**
+   * @brief Get the fingerprint of the data the cached td-mon was created from.
+   * @return The fingerprint. Empty, if it is unknown.
+   */
+  virtual const std::optional<DataSourceFingerprint>&
+  getDataSourceFingerprint() const = 0;
+
+  /**
+   * @brief Select the cached td-mon created from the data source with the given
+   * identity (see DataSourceFingerprint::identity). Implementations holding
+   * more than one td-mon return it from getCache() afterwards. If no td-mon of
+   * the data source is cached, the selection does not change.
+   * @param source_identity The identity of the data source
+   * @return true, if a td-mon of the data source is cached and selected now.
+   * false otherwise.
+   */
+  virtual bool selectEntry(const std::string& source_identity) = 0;
+
+  /**
+   * @brief Select the cached td-mon of the data source with the given
+   * fingerprint (see selectEntry()). On a miss, the previous selection
+   * belongs to another data source and must not be used for this one.
+   * @param fingerprint The fingerprint of the data source. Empty, if it is
+   * unknown.
+   * @return true, if a td-mon of the data source is cached and selected now.
+   * If the fingerprint is unknown, true, if any td-mon is cached.
+   */
+  bool selectEntryOfDataSource(
+      const std::optional<DataSourceFingerprint>& fingerprint) {
+    if (!fingerprint) {
+      return hasCache();
+    }
+    return selectEntry(fingerprint->identity);
+  }
+
   /**
    * @brief Check whether a cache is loaded currently.
    * @return true, if a loaded cache exists. false otherwise.
@@ -0,0 +1,59 @@
+#include <TDMon/default_td_mon.h>
+#include <TDMon/td_mon_cache_file.h>
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief The path of the cache file used by the benchmarks
+ */
+const std::filesystem::path kBenchmarkCacheFilePath =
+    "./benchmark_td_mon_cache_file";
+
+/**
+ * @brief Helper function. Write a cache file with many entries, each with a
+ * fingerprint of realistic size.
+ * @param format The format to write the file in
+ * @param entry_count The number of entries
+ */
+void writeBenchmarkCacheFile(TdMonCacheFileFormat format,
+                             std::size_t entry_count) {
+  std::vector<DefaultTdMon> td_mons;
+  std::vector<std::optional<DataSourceFingerprint>> fingerprints;
+  td_mons.reserve(entry_count);
+  fingerprints.reserve(entry_count);
+
+  TdMonCacheFile cache_file;
+  for (std::size_t i = 0; i < entry_count; ++i) {
+    td_mons.emplace_back(static_cast<unsigned int>(i % 100), 20, 30);
+    fingerprints.push_back(DataSourceFingerprint{
+        "C:/datasets/td_V2.db\x1fuser" + std::to_string(i) +
+            "\x1f" "Bug,Improvement,New Feature",
+        "54321987 13312345678901234 42\x1f" "1024 13312345678901234"});
+    cache_file.add(td_mons.back(), std::chrono::microseconds(i),
+                   fingerprints.back());
+  }
+  cache_file.write(kBenchmarkCacheFilePath, format);
+}
+
+/**
+ * @brief Benchmark reading a cache file. The first argument is the format, the
+ * second one the number of entries.
+ */
+void BM_TdMonCacheFileRead(benchmark::State& state) {
+  writeBenchmarkCacheFile(static_cast<TdMonCacheFileFormat>(state.range(0)),
+                          static_cast<std::size_t>(state.range(1)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TdMonCacheFile::read(kBenchmarkCacheFilePath));
+  }
+  std::filesystem::remove(kBenchmarkCacheFilePath);
+}
+BENCHMARK(BM_TdMonCacheFileRead)
+    ->ArgsProduct({{static_cast<int>(TdMonCacheFileFormat::kJson),
+                    static_cast<int>(TdMonCacheFileFormat::kBinary)},
+                   {1, 100000}})
+    ->Unit(benchmark::kMillisecond);
+}  // namespace tdmon
@@ -0,0 +1,432 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/atomic_file_writer.h>
+#include <TDMon/default_td_mon_cache.h>
+#include <TDMon/memory_mapped_file.h>
+#include <TDMon/td_mon_cache_file.h>
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace tdmon {
+namespace {
+/**
+ * @brief The header at the start of a binary cache file
+ */
+struct BinaryHeader {
+  /**
+   * @brief Identifies the file as binary cache file. Equal to kBinaryMagic.
+   */
+  std::array<char, 8> magic = {};
+
+  /**
+   * @brief The version of the binary format
+   */
+  std::uint32_t format_version = 0;
+
+  /**
+   * @brief Equal to kBinaryByteOrderMark, if the file was written with the
+   * native byte order
+   */
+  std::uint32_t byte_order_mark = 0;
+
+  /**
+   * @brief The number of records
+   */
+  std::uint64_t entry_count = 0;
+
+  /**
+   * @brief The size of the string table in bytes
+   */
+  std::uint64_t string_table_size = 0;
+
+  /**
+   * @brief The checksum of the records and the string table
+   */
+  std::uint64_t checksum = 0;
+};
+
+/**
+ * @brief A td-mon in a binary cache file. Strings are stored in the string
+ * table and referenced by offset and size.
+ */
+struct BinaryRecord {
+  /**
+   * @brief The timestamp when the td-mon was last updated in microseconds since
+   * unix epoch
+   */
+  std::int64_t last_updated_timestamp = 0;
+
+  /**
+   * @brief Identifies the type of the td-mon. Equal to the hash of its type
+   * identifier string.
+   */
+  std::uint32_t type = 0;
+
+  /**
+   * @brief The attack value of the td-mon
+   */
+  std::uint32_t attack_value = 0;
+
+  /**
+   * @brief The defense value of the td-mon
+   */
+  std::uint32_t defense_value = 0;
+
+  /**
+   * @brief The speed value of the td-mon
+   */
+  std::uint32_t speed_value = 0;
+
+  /**
+   * @brief kHasFingerprintFlag, if the fingerprint is known
+   */
+  std::uint32_t flags = 0;
+
+  /**
+   * @brief The offset of the fingerprint identity in the string table
+   */
+  std::uint32_t identity_offset = 0;
+
+  /**
+   * @brief The size of the fingerprint identity in bytes
+   */
+  std::uint32_t identity_size = 0;
+
+  /**
+   * @brief The offset of the fingerprint version in the string table
+   */
+  std::uint32_t version_offset = 0;
+
+  /**
+   * @brief The size of the fingerprint version in bytes
+   */
+  std::uint32_t version_size = 0;
+
+  /**
+   * @brief Unused. Keeps the records 8 byte aligned.
+   */
+  std::uint32_t reserved = 0;
+};
+
+/**
+ * @brief The magic bytes at the start of every binary cache file. Json files
+ * cannot start with them.
+ */
+const std::array<char, 8> kBinaryMagic = {'T', 'D', 'M', 'O',
+                                          'N', 'C', 'C', 'H'};
+
+/**
+ * @brief Written to the header to detect files with another byte order
+ */
+const std::uint32_t kBinaryByteOrderMark = 0x01020304;
+
+/**
+ * @brief Set in BinaryRecord::flags, if the fingerprint is known
+ */
+const std::uint32_t kHasFingerprintFlag = 1;
+
+/**
+ * @brief The first multiplier of the checksum
+ */
+const std::uint64_t kChecksumPrime1 = 0x9E3779B185EBCA87ull;
+
+/**
+ * @brief The second multiplier of the checksum
+ */
+const std::uint64_t kChecksumPrime2 = 0xC2B2AE3D27D4EB4Full;
+
+/**
+ * @brief Add a word to a lane of the checksum
+ * @param lane The lane
+ * @param word The word
+ * @return The new value of the lane
+ */
+std::uint64_t addToChecksumLane(std::uint64_t lane, std::uint64_t word) {
+  return std::rotl(lane ^ (word * kChecksumPrime2), 31) * kChecksumPrime1;
+}
+
+/**
+ * @brief Calculate the checksum of the contents of a binary cache file. Reads
+ * 32 bytes per step into four independent lanes, so the cpu can work on them
+ * in parallel, and loading is not slowed down noticeably. Detects damaged
+ * files, but is not meant to detect deliberate changes.
+ * @param data The contents to calculate the checksum of
+ * @return The checksum
+ */
+std::uint64_t calculateChecksum(std::span<const std::byte> data) {
+  const std::size_t kLaneCount = 4;
+  const std::size_t kStripeSize = kLaneCount * sizeof(std::uint64_t);
+
+  std::array<std::uint64_t, kLaneCount> lanes = {1, 2, 3, 4};
+  std::size_t offset = 0;
+  for (; offset + kStripeSize <= data.size(); offset += kStripeSize) {
+    std::array<std::uint64_t, kLaneCount> words;
+    std::memcpy(words.data(), data.data() + offset, kStripeSize);
+    for (std::size_t lane = 0; lane < kLaneCount; ++lane) {
+      lanes[lane] = addToChecksumLane(lanes[lane], words[lane]);
+    }
+  }
+
+  std::uint64_t checksum = data.size() * kChecksumPrime1;
+  for (std::uint64_t lane : lanes) {
+    checksum = addToChecksumLane(checksum, lane);
+  }
+  for (; offset < data.size(); ++offset) {
+    checksum = addToChecksumLane(checksum,
+                                 std::to_integer<std::uint64_t>(data[offset]));
+  }
+
+  // mix the bits, so every input bit affects every output bit
+  checksum ^= checksum >> 33;
+  checksum *= kChecksumPrime2;
+  checksum ^= checksum >> 29;
+  return checksum;
+}
+
+/**
+ * @brief Decode the contents of a binary cache file. Throws, if they are
+ * invalid.
+ * @param data The contents of the file
+ * @return The entries
+ */
+std::vector<TdMonCacheEntry> decodeBinary(std::span<const std::byte> data) {
+  BinaryHeader header;
+  if (data.size() < sizeof(BinaryHeader)) {
+    throw std::runtime_error("binary cache file is truncated");
+  }
+  std::memcpy(&header, data.data(), sizeof(BinaryHeader));
+  if (header.format_version != TdMonCacheFile::kBinaryFormatVersion ||
+      header.byte_order_mark != kBinaryByteOrderMark) {
+    throw std::runtime_error("binary cache file has an unsupported format");
+  }
+
+  const std::span<const std::byte> contents =
+      data.subspan(sizeof(BinaryHeader));
+  if (header.entry_count > contents.size() / sizeof(BinaryRecord) ||
+      header.string_table_size !=
+          contents.size() - header.entry_count * sizeof(BinaryRecord)) {
+    throw std::runtime_error("binary cache file is truncated");
+  }
+  if (calculateChecksum(contents) != header.checksum) {
+    throw std::runtime_error("binary cache file is damaged");
+  }
+
+  const std::span<const std::byte> records =
+      contents.first(header.entry_count * sizeof(BinaryRecord));
+  const std::string_view strings(
+      reinterpret_cast<const char*>(contents.data() + records.size()),
+      header.string_table_size);
+  // validate the bounds before accessing the string table
+  auto getString = [&strings](std::uint32_t offset, std::uint32_t size) {
+    if (offset > strings.size() || size > strings.size() - offset) {
+      throw std::runtime_error("binary cache file is damaged");
+    }
+    return std::string(strings.substr(offset, size));
+  };
+
+  std::vector<TdMonCacheEntry> entries(header.entry_count);
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    BinaryRecord record;
+    std::memcpy(&record, records.data() + i * sizeof(BinaryRecord),
+                sizeof(BinaryRecord));
+
+    TdMonCacheEntry& entry = entries[i];
+    entry.td_mon = TdMonCacheTypeRegistry::fromValues(
+        record.type, record.attack_value, record.defense_value,
+        record.speed_value);
+    entry.last_updated_timestamp =
+        std::chrono::microseconds(record.last_updated_timestamp);
+    if (record.flags & kHasFingerprintFlag) {
+      entry.data_source_fingerprint = DataSourceFingerprint{
+          getString(record.identity_offset, record.identity_size),
+          getString(record.version_offset, record.version_size)};
+    }
+  }
+  return entries;
+}
+}  // namespace
+
+const std::uint32_t TdMonCacheFile::kBinaryFormatVersion;
+
+void TdMonCacheFile::add(
+    const TdMon& td_mon, std::chrono::microseconds last_updated_timestamp,
+    const std::optional<DataSourceFingerprint>& data_source_fingerprint) {
+  entries_.push_back(
+      {&td_mon, last_updated_timestamp, &data_source_fingerprint});
+}
+
+std::size_t TdMonCacheFile::getEntryCount() const { return entries_.size(); }
+
+std::vector<char> TdMonCacheFile::encode(TdMonCacheFileFormat format) const {
+  if (format == TdMonCacheFileFormat::kBinary) {
+    return encodeBinary();
+  }
+
+  nlohmann::json entries = nlohmann::json::array();
+  for (const PendingEntry& entry : entries_) {
+    entries.push_back(entryToJson(*entry.td_mon, entry.last_updated_timestamp,
+                                  *entry.data_source_fingerprint));
+  }
+  nlohmann::json json;
+  json[kEntriesKeyString] = std::move(entries);
+  const std::string contents = json.dump();
+  return std::vector<char>(contents.begin(), contents.end());
+}
+
+void TdMonCacheFile::write(const std::filesystem::path& path,
+                           TdMonCacheFileFormat format) const {
+  AtomicFileWriter::write(path, encode(format));
+}
+
+std::vector<TdMonCacheEntry> TdMonCacheFile::read(
+    const std::filesystem::path& path) {
+  if (!std::filesystem::exists(path)) {
+    throw std::runtime_error("cannot open cache file to read cache from disk");
+  }
+
+  const MemoryMappedFile file(path);
+  const std::span<const std::byte> data = file.getData();
+  if (data.size() >= kBinaryMagic.size() &&
+      std::memcmp(data.data(), kBinaryMagic.data(), kBinaryMagic.size()) ==
+          0) {
+    return decodeBinary(data);
+  }
+
+  const char* characters = reinterpret_cast<const char*>(data.data());
+  const nlohmann::json json =
+      nlohmann::json::parse(characters, characters + data.size());
+
+  std::vector<TdMonCacheEntry> entries;
+  if (json.contains(kEntriesKeyString)) {
+    for (const nlohmann::json& entry_json : json.at(kEntriesKeyString)) {
+      entries.push_back(entryFromJson(entry_json));
+    }
+  } else {
+    // a single entry, as written by the DefaultTdMonCache
+    entries.push_back(entryFromJson(json));
+  }
+  return entries;
+}
+
+nlohmann::json TdMonCacheFile::entryToJson(
+    const TdMon& td_mon, std::chrono::microseconds last_updated_timestamp,
+    const std::optional<DataSourceFingerprint>& data_source_fingerprint) {
+  nlohmann::json json = td_mon.toJson();
+  // append timestamp
+  json[DefaultTdMonCache::kTimestampKeyString] =
+      last_updated_timestamp.count();
+  // append the fingerprint, if it is known
+  if (data_source_fingerprint) {
+    json[DefaultTdMonCache::kSourceIdentityKeyString] =
+        data_source_fingerprint->identity;
+    json[DefaultTdMonCache::kSourceVersionKeyString] =
+        data_source_fingerprint->version;
+  }
+  return json;
+}
+
+TdMonCacheEntry TdMonCacheFile::entryFromJson(const nlohmann::json& json) {
+  TdMonCacheEntry entry;
+  entry.td_mon = TdMonCacheTypeRegistry::fromJson(json);
+  entry.last_updated_timestamp = std::chrono::microseconds(
+      json.at(DefaultTdMonCache::kTimestampKeyString).get<long long>());
+  // caches written by older versions have no fingerprint
+  if (json.contains(DefaultTdMonCache::kSourceIdentityKeyString) &&
+      json.contains(DefaultTdMonCache::kSourceVersionKeyString)) {
+    entry.data_source_fingerprint = DataSourceFingerprint{
+        json.at(DefaultTdMonCache::kSourceIdentityKeyString)
+            .get<std::string>(),
+        json.at(DefaultTdMonCache::kSourceVersionKeyString)
+            .get<std::string>()};
+  }
+  return entry;
+}
+
+std::vector<char> TdMonCacheFile::encodeBinary() const {
+  std::vector<BinaryRecord> records(entries_.size());
+  std::string strings;
+  // append a string to the string table and return its offset
+  auto addString = [&strings](const std::string& value) {
+    if (strings.size() + value.size() > UINT32_MAX) {
+      throw std::runtime_error("cache is too large for the binary format");
+    }
+    const std::uint32_t offset = static_cast<std::uint32_t>(strings.size());
+    strings += value;
+    return offset;
+  };
+
+  for (std::size_t i = 0; i < entries_.size(); ++i) {
+    const PendingEntry& entry = entries_[i];
+    const TdMon& td_mon = *entry.td_mon;
+    if (!TdMonCacheTypeRegistry::contains(td_mon.getTypeId())) {
+      throw std::runtime_error(
+          "td-mon type not suppoted for serialization in TdMonCacheFile");
+    }
+
+    BinaryRecord& record = records[i];
+    record.last_updated_timestamp = entry.last_updated_timestamp.count();
+    record.type = td_mon.getTypeId();
+    record.attack_value = td_mon.getAttackValue();
+    record.defense_value = td_mon.getDefenseValue();
+    record.speed_value = td_mon.getSpeedValue();
+    if (const auto& fingerprint = *entry.data_source_fingerprint) {
+      record.flags = kHasFingerprintFlag;
+      record.identity_offset = addString(fingerprint->identity);
+      record.identity_size =
+          static_cast<std::uint32_t>(fingerprint->identity.size());
+      record.version_offset = addString(fingerprint->version);
+      record.version_size =
+          static_cast<std::uint32_t>(fingerprint->version.size());
+    }
+  }
+
+  BinaryHeader header;
+  header.magic = kBinaryMagic;
+  header.format_version = kBinaryFormatVersion;
+  header.byte_order_mark = kBinaryByteOrderMark;
+  header.entry_count = records.size();
+  header.string_table_size = strings.size();
+
+  const std::size_t records_size = records.size() * sizeof(BinaryRecord);
+  std::vector<char> contents(sizeof(BinaryHeader) + records_size +
+                             strings.size());
+  char* records_begin = contents.data() + sizeof(BinaryHeader);
+  if (!records.empty()) {
+    std::memcpy(records_begin, records.data(), records_size);
+  }
+  std::memcpy(records_begin + records_size, strings.data(), strings.size());
+
+  header.checksum = calculateChecksum(std::as_bytes(std::span<const char>(
+      records_begin, records_size + strings.size())));
+  std::memcpy(contents.data(), &header, sizeof(BinaryHeader));
+  return contents;
+}
+
+const std::string TdMonCacheFile::kEntriesKeyString = "entries";
+
+}  // namespace tdmon
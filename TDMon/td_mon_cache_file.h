@@ -0,0 +1,217 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <TDMon/data_source_fingerprint.h>
+#include <TDMon/default_td_mon.h>
+#include <TDMon/td_mon.h>
+#include <TDMon/td_mon_type_registry.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief The encodings of cache files
+ */
+enum class TdMonCacheFileFormat {
+  /**
+   * @brief Human-readable json
+   */
+  kJson,
+
+  /**
+   * @brief Compact binary format with fixed width records. Much faster to
+   * load than json, if the cache holds many td-mons.
+   */
+  kBinary
+};
+
+/**
+ * @brief A td-mon stored in a cache file, and the information about it
+ */
+struct TdMonCacheEntry {
+  /**
+   * @brief The td-mon
+   */
+  std::unique_ptr<TdMon> td_mon;
+
+  /**
+   * @brief The timestamp when the td-mon was last updated in microseconds since
+   * unix epoch
+   */
+  std::chrono::microseconds last_updated_timestamp =
+      std::chrono::microseconds(0);
+
+  /**
+   * @brief The fingerprint of the data the td-mon was created from. Empty, if
+   * it is unknown.
+   */
+  std::optional<DataSourceFingerprint> data_source_fingerprint;
+};
+
+/**
+ * @brief The td-mon types, which can be stored in cache files. Register new
+ * td-mon types here.
+ */
+using TdMonCacheTypeRegistry = TdMonTypeRegistry<DefaultTdMon>;
+
+/**
+ * @brief Reads and writes the cache files of TdMonCache implementations.
+ * Collect the entries to write with add(), then write() them in the selected
+ * format. read() detects the format of a file by its header.
+ *
+ * In json, an entry is the json of the td-mon with the keys of the
+ * DefaultTdMonCache for the timestamp and fingerprint appended. A file
+ * contains an array of entries (see kEntriesKeyString), or a single entry, as
+ * written by the DefaultTdMonCache and older versions.
+ *
+ * The binary format consists of a header (see kBinaryFormatVersion), followed
+ * by one fixed width record per entry and a table of the characters of all
+ * strings. A checksum over the records and the string table detects damaged
+ * files. Integers are stored in the native byte order, as the cache is a local
+ * file.
+ *
+ * All td-mon types in TdMonCacheTypeRegistry are supported, and a file may
+ * contain td-mons of different types. Binary records store the type id (see
+ * TdMon::getTypeId()) and the attack, defense and speed values of a td-mon.
+ */
+class TdMonCacheFile {
+ public:
+  /**
+   * @brief The json key for the array of entries
+   */
+  static const std::string kEntriesKeyString;
+
+  /**
+   * @brief The version of the binary format. Increment when changing the
+   * format.
+   */
+  static const std::uint32_t kBinaryFormatVersion = 1;
+
+  /**
+   * @brief Add an entry to write. The td-mon and fingerprint are referenced,
+   * not copied, so they must outlive the call to write().
+   * @param td_mon The td-mon
+   * @param last_updated_timestamp The timestamp when the td-mon was last
+   * updated in microseconds since unix epoch
+   * @param data_source_fingerprint The fingerprint of the data the td-mon was
+   * created from. Empty, if it is unknown.
+   */
+  void add(const TdMon& td_mon,
+           std::chrono::microseconds last_updated_timestamp,
+           const std::optional<DataSourceFingerprint>& data_source_fingerprint);
+
+  /**
+   * @brief Get the number of added entries
+   * @return The number of entries
+   */
+  std::size_t getEntryCount() const;
+
+  /**
+   * @brief Encode all added entries, in the order they were added. Throws, if
+   * a td-mon type is not supported.
+   * @param format The format to encode the entries in
+   * @return The contents of the file
+   */
+  std::vector<char> encode(TdMonCacheFileFormat format) const;
+
+  /**
+   * @brief Write all added entries to a file, in the order they were added.
+   * The file is replaced atomically (see AtomicFileWriter). Throws, if the
+   * file cannot be written or a td-mon type is not supported.
+   * @param path The path of the file
+   * @param format The format of the file
+   */
+  void write(const std::filesystem::path& path,
+             TdMonCacheFileFormat format) const;
+
+  /**
+   * @brief Read all entries from a file in any format. Throws, if the file
+   * cannot be read or is invalid.
+   * @param path The path of the file
+   * @return The entries, in the order they were written
+   */
+  static std::vector<TdMonCacheEntry> read(const std::filesystem::path& path);
+
+  /**
+   * @brief Serialize a single entry to json
+   * @param td_mon The td-mon
+   * @param last_updated_timestamp The timestamp when the td-mon was last
+   * updated in microseconds since unix epoch
+   * @param data_source_fingerprint The fingerprint of the data the td-mon was
+   * created from. Not stored, if it is unknown.
+   * @return The entry in json format
+   */
+  static nlohmann::json entryToJson(
+      const TdMon& td_mon, std::chrono::microseconds last_updated_timestamp,
+      const std::optional<DataSourceFingerprint>& data_source_fingerprint);
+
+  /**
+   * @brief Deserialize a single entry from json. Throws, if the td-mon type is
+   * not supported.
+   * @param json The entry in json format
+   * @return The entry
+   */
+  static TdMonCacheEntry entryFromJson(const nlohmann::json& json);
+
+ private:
+  /**
+   * @brief An added entry, referencing the data to write
+   */
+  struct PendingEntry {
+    /**
+     * @brief The td-mon
+     */
+    const TdMon* td_mon;
+
+    /**
+     * @brief The timestamp when the td-mon was last updated
+     */
+    std::chrono::microseconds last_updated_timestamp;
+
+    /**
+     * @brief The fingerprint of the data the td-mon was created from
+     */
+    const std::optional<DataSourceFingerprint>* data_source_fingerprint;
+  };
+
+  /**
+   * @brief The added entries
+   */
+  std::vector<PendingEntry> entries_;
+
+  /**
+   * @brief Private function to encode all added entries in the binary format
+   * @return The contents of the file
+   */
+  std::vector<char> encodeBinary() const;
+};
+}  // namespace tdmon
@@ -0,0 +1,118 @@
+#include <TDMon/default_td_mon.h>
+#include <TDMon/default_td_mon_cache.h>
+#include <TDMon/td_mon_cache_file.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief The path of the cache file used by the tests
+ */
+const std::filesystem::path kTestCacheFilePath = "./test_td_mon_cache_file";
+
+/**
+ * @brief Helper function. Write two entries, one of them with fingerprint, and
+ * read them again.
+ * @param format The format to write the file in
+ */
+void expectEntriesRoundTrip(TdMonCacheFileFormat format) {
+  const DefaultTdMon td_mon0(1, 2, 3);
+  const DefaultTdMon td_mon1(4, 5, 6);
+  const std::optional<DataSourceFingerprint> fingerprint0 =
+      DataSourceFingerprint{"dataset.db Human1", "1 2 3"};
+  const std::optional<DataSourceFingerprint> fingerprint1;
+
+  TdMonCacheFile cache_file;
+  cache_file.add(td_mon0, std::chrono::microseconds(100), fingerprint0);
+  cache_file.add(td_mon1, std::chrono::microseconds(200), fingerprint1);
+  EXPECT_EQ(cache_file.getEntryCount(), 2);
+  cache_file.write(kTestCacheFilePath, format);
+
+  std::vector<TdMonCacheEntry> entries =
+      TdMonCacheFile::read(kTestCacheFilePath);
+  ASSERT_EQ(entries.size(), 2);
+
+  EXPECT_EQ(entries[0].td_mon->getAttackValue(), 1);
+  EXPECT_EQ(entries[0].td_mon->getDefenseValue(), 2);
+  EXPECT_EQ(entries[0].td_mon->getSpeedValue(), 3);
+  EXPECT_EQ(entries[0].last_updated_timestamp, std::chrono::microseconds(100));
+  EXPECT_EQ(entries[0].data_source_fingerprint, fingerprint0);
+
+  EXPECT_EQ(entries[1].td_mon->getAttackValue(), 4);
+  EXPECT_EQ(entries[1].last_updated_timestamp, std::chrono::microseconds(200));
+  EXPECT_FALSE(entries[1].data_source_fingerprint.has_value());
+
+  std::filesystem::remove(kTestCacheFilePath);
+}
+
+TEST(TdMonCacheFile, ReadsWhatWasWrittenInJson) {
+  expectEntriesRoundTrip(TdMonCacheFileFormat::kJson);
+}
+
+TEST(TdMonCacheFile, ReadsWhatWasWrittenInBinary) {
+  expectEntriesRoundTrip(TdMonCacheFileFormat::kBinary);
+}
+
+/**
+ * @brief Test, if a single entry in the layout of the DefaultTdMonCache is read
+ */
+TEST(TdMonCacheFile, ReadsSingleJsonEntry) {
+  {
+    std::ofstream file(kTestCacheFilePath);
+    file << TdMonCacheFile::entryToJson(DefaultTdMon(7, 8, 9),
+                                        std::chrono::microseconds(12345),
+                                        std::nullopt);
+  }
+
+  std::vector<TdMonCacheEntry> entries =
+      TdMonCacheFile::read(kTestCacheFilePath);
+  ASSERT_EQ(entries.size(), 1);
+  EXPECT_EQ(entries[0].td_mon->getSpeedValue(), 9);
+  EXPECT_EQ(entries[0].last_updated_timestamp,
+            std::chrono::microseconds(12345));
+
+  std::filesystem::remove(kTestCacheFilePath);
+}
+
+/**
+ * @brief Test, if damaged and truncated binary files are rejected
+ */
+TEST(TdMonCacheFile, RejectsDamagedBinaryFiles) {
+  const DefaultTdMon td_mon(1, 2, 3);
+  const std::optional<DataSourceFingerprint> fingerprint =
+      DataSourceFingerprint{"dataset.db Human1", "1 2 3"};
+  TdMonCacheFile cache_file;
+  cache_file.add(td_mon, std::chrono::microseconds(100), fingerprint);
+  cache_file.write(kTestCacheFilePath, TdMonCacheFileFormat::kBinary);
+
+  std::string contents;
+  {
+    std::ifstream file(kTestCacheFilePath, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+  }
+
+  // change a character of the fingerprint
+  {
+    std::string damaged_contents = contents;
+    damaged_contents.back() ^= 1;
+    std::ofstream file(kTestCacheFilePath, std::ios::binary | std::ios::trunc);
+    file << damaged_contents;
+  }
+  EXPECT_ANY_THROW(TdMonCacheFile::read(kTestCacheFilePath));
+
+  // cut off the string table
+  {
+    std::ofstream file(kTestCacheFilePath, std::ios::binary | std::ios::trunc);
+    file << contents.substr(0, contents.size() - 5);
+  }
+  EXPECT_ANY_THROW(TdMonCacheFile::read(kTestCacheFilePath));
+
+  std::filesystem::remove(kTestCacheFilePath);
+  EXPECT_ANY_THROW(TdMonCacheFile::read(kTestCacheFilePath));
+}
+}  // namespace tdmon
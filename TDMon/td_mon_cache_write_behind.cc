@@ -0,0 +1,161 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/atomic_file_writer.h>
+#include <TDMon/operation_latencies.h>
+#include <TDMon/td_mon_cache_write_behind.h>
+#include <TDMon/trace_recorder.h>
+
+#include <iostream>
+#include <utility>
+
+namespace tdmon {
+TdMonCacheWriteBehind::TdMonCacheWriteBehind(
+    const TdMonCache& tdmon_cache,
+    std::chrono::milliseconds checkpoint_interval)
+    : tdmon_cache_(tdmon_cache),
+      checkpoint_modification_count_(tdmon_cache.getModificationCount()),
+      shared_state_(std::make_shared<SharedState>()) {
+  shared_state_->checkpoint_interval = checkpoint_interval;
+  shared_state_->next_write_time =
+      std::chrono::steady_clock::now() + checkpoint_interval;
+  worker_thread_ =
+      std::thread(&TdMonCacheWriteBehind::writeCheckpoints, shared_state_);
+}
+
+TdMonCacheWriteBehind::~TdMonCacheWriteBehind() {
+  if (worker_thread_.joinable()) {
+    shutdown();
+  }
+}
+
+void TdMonCacheWriteBehind::checkpointIfDue() { makeCheckpoint(false); }
+
+void TdMonCacheWriteBehind::checkpoint() { makeCheckpoint(true); }
+
+void TdMonCacheWriteBehind::makeCheckpoint(bool write_immediately) {
+  if (!worker_thread_.joinable() ||
+      tdmon_cache_.getModificationCount() == checkpoint_modification_count_ ||
+      !tdmon_cache_.hasCache()) {
+    return;
+  }
+  checkpoint_modification_count_ = tdmon_cache_.getModificationCount();
+
+  PendingWrite pending_write;
+  try {
+    pending_write.path = tdmon_cache_.getCacheFilePath();
+    OperationLatencies::Timer timer(Operation::kCacheEncode);
+    pending_write.contents = tdmon_cache_.encodeForDisk();
+  } catch (const std::exception& e) {
+    std::cout << "cannot store TdMon cache. Reason: " << e.what()
+              << std::endl;
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(shared_state_->mutex);
+    // replaces an older checkpoint, which was not written yet
+    shared_state_->pending_write = std::move(pending_write);
+    shared_state_->write_immediately =
+        shared_state_->write_immediately || write_immediately;
+  }
+  shared_state_->condition.notify_all();
+}
+
+bool TdMonCacheWriteBehind::shutdown(std::chrono::milliseconds timeout) {
+  if (!worker_thread_.joinable()) {
+    return false;
+  }
+  checkpoint();
+
+  bool is_written;
+  {
+    std::unique_lock<std::mutex> lock(shared_state_->mutex);
+    shared_state_->stop_requested = true;
+    shared_state_->condition.notify_all();
+    is_written =
+        shared_state_->condition.wait_for(lock, timeout, [this]() {
+          return !shared_state_->pending_write && !shared_state_->is_writing;
+        });
+  }
+
+  if (is_written) {
+    worker_thread_.join();
+  } else {
+    // the worker thread finishes the write on its own. It shares ownership of
+    // the state, so it stays valid
+    worker_thread_.detach();
+  }
+  return is_written;
+}
+
+std::size_t TdMonCacheWriteBehind::getWriteCount() const {
+  std::lock_guard<std::mutex> lock(shared_state_->mutex);
+  return shared_state_->write_count;
+}
+
+void TdMonCacheWriteBehind::writeCheckpoints(
+    std::shared_ptr<SharedState> shared_state) {
+  std::unique_lock<std::mutex> lock(shared_state->mutex);
+  while (true) {
+    shared_state->condition.wait(lock, [&shared_state]() {
+      return shared_state->pending_write || shared_state->stop_requested;
+    });
+    if (!shared_state->pending_write) {
+      // stop requested and all checkpoints are written
+      return;
+    }
+
+    // hold the checkpoint back until the interval has passed since the last
+    // write. Newer checkpoints replace it in the meantime
+    shared_state->condition.wait_until(
+        lock, shared_state->next_write_time, [&shared_state]() {
+          return shared_state->write_immediately ||
+                 shared_state->stop_requested;
+        });
+
+    PendingWrite pending_write = std::move(*shared_state->pending_write);
+    shared_state->pending_write.reset();
+    shared_state->write_immediately = false;
+    shared_state->is_writing = true;
+
+    // write without holding the lock, so new checkpoints are not blocked
+    lock.unlock();
+    try {
+      TDMON_TRACE_SCOPE("write cache checkpoint");
+      OperationLatencies::Timer timer(Operation::kCacheWrite);
+      AtomicFileWriter::write(pending_write.path, pending_write.contents);
+    } catch (const std::exception& e) {
+      std::cout << "cannot store TdMon cache. Reason: " << e.what()
+                << std::endl;
+    }
+    lock.lock();
+
+    shared_state->is_writing = false;
+    shared_state->next_write_time =
+        std::chrono::steady_clock::now() + shared_state->checkpoint_interval;
+    ++shared_state->write_count;
+    shared_state->condition.notify_all();
+  }
+}
+}  // namespace tdmon
@@ -0,0 +1,231 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <TDMon/td_mon_cache.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief Stores a td-mon cache on disk in the background (write-behind).
+ *
+ * checkpointIfDue() is called regularly (e.g. once per frame) on the thread
+ * that modifies the cache. If the cache was modified since the last
+ * checkpoint, it is encoded on the calling thread, which is fast, and written
+ * by a worker thread, which may take a while (see AtomicFileWriter). The worker
+ * thread keeps its own timer: it holds a checkpoint back until the checkpoint
+ * interval has passed since its previous write, so the calling thread does not
+ * need to wake up for it. Only the most recent checkpoint is written, if
+ * several are made in the meantime.
+ *
+ * shutdown() writes the last checkpoint and waits for the worker thread, but
+ * at most for a given timeout, so closing the application is never blocked by
+ * a slow disk. Since files are replaced atomically, the cache file stays
+ * readable, even if the application exits (or is killed) during a write.
+ */
+class TdMonCacheWriteBehind {
+ public:
+  /**
+   * @brief The default minimum time between two writes
+   */
+  static constexpr std::chrono::milliseconds kDefaultCheckpointInterval =
+      std::chrono::seconds(5);
+
+  /**
+   * @brief The default maximum time to wait for the worker thread in
+   * shutdown()
+   */
+  static constexpr std::chrono::milliseconds kDefaultShutdownTimeout =
+      std::chrono::seconds(2);
+
+  /**
+   * @brief The constructor. Starts the worker thread. The current state of the
+   * cache counts as stored.
+   * @param tdmon_cache The cache to store. Must outlive this object.
+   * @param checkpoint_interval The minimum time between two writes of
+   * checkpoints made by checkpointIfDue()
+   */
+  explicit TdMonCacheWriteBehind(
+      const TdMonCache& tdmon_cache,
+      std::chrono::milliseconds checkpoint_interval =
+          kDefaultCheckpointInterval);
+
+  /**
+   * @brief The destructor. Calls shutdown() with the default timeout, if it
+   * was not called before.
+   */
+  ~TdMonCacheWriteBehind();
+
+  TdMonCacheWriteBehind(const TdMonCacheWriteBehind&) = delete;
+  TdMonCacheWriteBehind& operator=(const TdMonCacheWriteBehind&) = delete;
+
+  /**
+   * @brief Make a checkpoint, if the cache was modified since the last one.
+   * The worker thread writes it once the checkpoint interval has passed since
+   * its previous write. Cheap, if the cache was not modified.
+   */
+  void checkpointIfDue();
+
+  /**
+   * @brief Make a checkpoint, which the worker thread writes right away,
+   * regardless of the checkpoint interval. See makeCheckpoint().
+   */
+  void checkpoint();
+
+  /**
+   * @brief Make a last checkpoint and stop the worker thread after it has
+   * written all checkpoints. Waits for this at most for the given timeout.
+   * Afterwards, the worker thread finishes its current write in the
+   * background, and no more checkpoints are made.
+   * @param timeout The maximum time to wait
+   * @return true, if all checkpoints were written in time
+   */
+  bool shutdown(std::chrono::milliseconds timeout = kDefaultShutdownTimeout);
+
+  /**
+   * @brief Get the number of checkpoints the worker thread has finished
+   * writing (successfully or not)
+   * @return The number of written checkpoints
+   */
+  std::size_t getWriteCount() const;
+
+ private:
+  /**
+   * @brief A checkpoint to write
+   */
+  struct PendingWrite {
+    /**
+     * @brief The path of the cache file
+     */
+    std::filesystem::path path;
+
+    /**
+     * @brief The contents of the cache file
+     */
+    std::vector<char> contents;
+  };
+
+  /**
+   * @brief The state shared with the worker thread. Owned by both, so the
+   * worker thread can finish a write after shutdown() timed out.
+   */
+  struct SharedState {
+    /**
+     * @brief Protects all other members
+     */
+    std::mutex mutex;
+
+    /**
+     * @brief Notified when a checkpoint is passed to the worker thread, when
+     * the worker should stop, and when a write finishes
+     */
+    std::condition_variable condition;
+
+    /**
+     * @brief The most recent checkpoint which was not written yet
+     */
+    std::optional<PendingWrite> pending_write;
+
+    /**
+     * @brief true, if the pending checkpoint should be written without
+     * waiting for next_write_time
+     */
+    bool write_immediately = false;
+
+    /**
+     * @brief The minimum time between two writes
+     */
+    std::chrono::milliseconds checkpoint_interval;
+
+    /**
+     * @brief The pending checkpoint is held back until this time, unless
+     * write_immediately or stop_requested is set
+     */
+    std::chrono::steady_clock::time_point next_write_time;
+
+    /**
+     * @brief true, while the worker thread writes a checkpoint
+     */
+    bool is_writing = false;
+
+    /**
+     * @brief true, if the worker thread should stop once all checkpoints are
+     * written
+     */
+    bool stop_requested = false;
+
+    /**
+     * @brief The number of checkpoints written
+     */
+    std::size_t write_count = 0;
+  };
+
+  /**
+   * @brief The cache to store
+   */
+  const TdMonCache& tdmon_cache_;
+
+  /**
+   * @brief The modification count of the cache at the last checkpoint
+   */
+  std::uint64_t checkpoint_modification_count_;
+
+  /**
+   * @brief The state shared with the worker thread
+   */
+  std::shared_ptr<SharedState> shared_state_;
+
+  /**
+   * @brief The worker thread. Not joinable after shutdown().
+   */
+  std::thread worker_thread_;
+
+  /**
+   * @brief Private function to make a checkpoint: if the cache was modified
+   * since the last checkpoint and is not empty, encode it and pass it to the
+   * worker thread. Encoding errors are printed and the checkpoint is skipped.
+   * @param write_immediately true, if the worker thread should not wait for
+   * the checkpoint interval
+   */
+  void makeCheckpoint(bool write_immediately);
+
+  /**
+   * @brief Private function run by the worker thread. Writes checkpoints, at
+   * most one per checkpoint interval, until a stop is requested and all
+   * checkpoints are written.
+   * @param shared_state The state shared with the worker thread
+   */
+  static void writeCheckpoints(std::shared_ptr<SharedState> shared_state);
+};
+}  // namespace tdmon
@@ -0,0 +1,90 @@
+#include <TDMon/default_td_mon.h>
+#include <TDMon/default_td_mon_cache.h>
+#include <TDMon/td_mon_cache_write_behind.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+namespace tdmon {
+/**
+ * @brief Test, if only modified caches are written, and the last modification
+ * is written on shutdown.
+ */
+TEST(TdMonCacheWriteBehind, WritesModifiedCache) {
+  std::filesystem::remove(DefaultTdMonCache::kCacheFilePath);
+
+  DefaultTdMonCache cache;
+  TdMonCacheWriteBehind write_behind(cache, std::chrono::milliseconds(0));
+
+  // an empty cache is not written
+  write_behind.checkpointIfDue();
+  cache.updateCache(std::make_unique<DefaultTdMon>(1, 2, 3));
+  write_behind.checkpointIfDue();
+  // not modified since the last checkpoint
+  write_behind.checkpointIfDue();
+
+  cache.updateCache(std::make_unique<DefaultTdMon>(4, 5, 6));
+  EXPECT_TRUE(write_behind.shutdown(std::chrono::seconds(10)));
+  EXPECT_GE(write_behind.getWriteCount(), 1);
+  EXPECT_LE(write_behind.getWriteCount(), 2);
+
+  // no more checkpoints after shutdown
+  cache.updateCache(std::make_unique<DefaultTdMon>(7, 8, 9));
+  write_behind.checkpoint();
+  EXPECT_FALSE(write_behind.shutdown());
+
+  DefaultTdMonCache loaded_cache;
+  loaded_cache.loadFromDisk();
+  EXPECT_EQ(loaded_cache.getCache()->getAttackValue(), 4);
+
+  std::filesystem::remove(DefaultTdMonCache::kCacheFilePath);
+}
+
+/**
+ * @brief Test, if a loaded cache is not written again, as long as it is not
+ * modified.
+ */
+TEST(TdMonCacheWriteBehind, SkipsUnmodifiedCache) {
+  DefaultTdMonCache cache;
+  cache.updateCache(std::make_unique<DefaultTdMon>(1, 2, 3));
+
+  TdMonCacheWriteBehind write_behind(cache, std::chrono::milliseconds(0));
+  write_behind.checkpointIfDue();
+  EXPECT_TRUE(write_behind.shutdown(std::chrono::seconds(10)));
+  EXPECT_EQ(write_behind.getWriteCount(), 0);
+}
+
+TEST(TdMonCacheWriteBehind, CoalescesCheckpointsWithinInterval) {
+  std::filesystem::remove(DefaultTdMonCache::kCacheFilePath);
+
+  DefaultTdMonCache cache;
+  TdMonCacheWriteBehind write_behind(cache, std::chrono::milliseconds(300));
+
+  // both checkpoints are made right away, but held back by the worker thread
+  cache.updateCache(std::make_unique<DefaultTdMon>(1, 2, 3));
+  write_behind.checkpointIfDue();
+  cache.updateCache(std::make_unique<DefaultTdMon>(4, 5, 6));
+  write_behind.checkpointIfDue();
+  EXPECT_EQ(write_behind.getWriteCount(), 0);
+
+  // the worker thread writes the most recent one on its own
+  const std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (write_behind.getWriteCount() == 0 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(write_behind.getWriteCount(), 1);
+
+  DefaultTdMonCache loaded_cache;
+  loaded_cache.loadFromDisk();
+  EXPECT_EQ(loaded_cache.getCache()->getAttackValue(), 4);
+
+  EXPECT_TRUE(write_behind.shutdown(std::chrono::seconds(10)));
+  EXPECT_EQ(write_behind.getWriteCount(), 1);
+
+  std::filesystem::remove(DefaultTdMonCache::kCacheFilePath);
+}
+}  // namespace tdmon
@@ -0,0 +1,56 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#include <TDMon/td_mon_factory.h>
+
+namespace tdmon {
+TdMonCreationCancelledError::TdMonCreationCancelledError()
+    : std::runtime_error("td-mon creation was cancelled") {}
+
+std::future<std::unique_ptr<TdMon>> TdMonFactory::createAsync(
+    std::stop_token stop_token, ProgressCallback progress_callback) {
+  return std::async(
+      std::launch::async,
+      [this, stop_token = std::move(stop_token),
+       progress_callback = std::move(progress_callback)]() {
+        if (stop_token.stop_requested()) {
+          throw TdMonCreationCancelledError();
+        }
+        if (progress_callback) {
+          progress_callback(0.0f);
+        }
+
+        std::unique_ptr<TdMon> td_mon = create();
+
+        if (progress_callback) {
+          progress_callback(1.0f);
+        }
+        return td_mon;
+      });
+}
+
+std::optional<DataSourceFingerprint> TdMonFactory::getDataSourceFingerprint() {
+  return std::nullopt;
+}
+}  // namespace tdmon
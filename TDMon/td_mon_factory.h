@@ -24,11 +24,29 @@
 
 #pragma once
 
+#include <TDMon/data_source_fingerprint.h>
 #include <TDMon/td_mon.h>
 
+#include <functional>
+#include <future>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
 
 namespace tdmon {
+/**
+ * @brief Thrown from the future returned by TdMonFactory::createAsync(), if the
+ * creation was cancelled before it completed.
+ */
+class TdMonCreationCancelledError : public std::runtime_error {
+ public:
+  /**
+   * @brief The constructor.
+   */
+  TdMonCreationCancelledError();
+};
+
 /**
  * @brief Interface for TdMon factory implementations. It's purpose is to
  * create instances of classes that inherit from the TdMon interface.
@@ -42,6 +60,13 @@ namespace tdmon {
  */
 class TdMonFactory {
  public:
+  /**
+   * @brief Callback to report the progress of an asynchronous td-mon creation.
+   * Called with a value between 0 and 1 (completed). It is called from the
+   * worker thread, so implementations must be thread-safe.
+   */
+  using ProgressCallback = std::function<void(float)>;
+
   /**
    * @brief Virtual default destructor to allow deletion of derived classes
    * from a pointer to this base class
@@ -53,5 +78,34 @@ class TdMonFactory {
    * @return A unique_ptr containing the created td-mon
    */
   virtual std::unique_ptr<TdMon> create() = 0;
+
+  /**
+   * @brief Create the td-mon asynchronously on a worker thread.
+   *
+   * The default implementation runs create() on a worker thread. It only checks
+   * for cancellation before starting and reports the progress when starting and
+   * when done. Implementations can override this to report progress and react
+   * to cancellation while the td-mon is being created. The factory must outlive
+   * the returned future.
+   * @param stop_token Request a stop on the associated std::stop_source to
+   * cancel the creation. The future then throws TdMonCreationCancelledError.
+   * @param progress_callback Called with the progress of the creation. May be
+   * empty.
+   * @return A future containing the created td-mon
+   */
+  virtual std::future<std::unique_ptr<TdMon>> createAsync(
+      std::stop_token stop_token, ProgressCallback progress_callback);
+
+  /**
+   * @brief Get the fingerprint of the data the next td-mon would be created
+   * from. If it equals the fingerprint stored with a cached td-mon, create()
+   * would return the same td-mon, so creating it can be skipped.
+   *
+   * The default implementation returns no fingerprint, so td-mons are always
+   * created. Implementations should only return a fingerprint, if it is cheap
+   * to determine (e.g. without reading the whole data source).
+   * @return The fingerprint. Empty, if it cannot be determined.
+   */
+  virtual std::optional<DataSourceFingerprint> getDataSourceFingerprint();
 };
 }  // namespace tdmon
@@ -0,0 +1,70 @@
+#include <TDMon/default_td_mon.h>
+#include <TDMon/td_mon_factory.h>
+#include <gtest/gtest.h>
+
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief Minimal factory, which only implements create(). Used to test the
+ * default implementations of TdMonFactory.
+ */
+class CreateOnlyTdMonFactory : public TdMonFactory {
+ public:
+  /**
+   * @brief Create a td-mon with fixed values
+   * @return The td-mon
+   */
+  std::unique_ptr<TdMon> create() override {
+    return std::make_unique<DefaultTdMon>(1, 2, 3);
+  }
+};
+
+/**
+ * @brief Test, if the default createAsync() creates the td-mon using create()
+ * and reports the start and completion.
+ */
+TEST(TdMonFactory, CreatesAsynchronouslyByDefault) {
+  CreateOnlyTdMonFactory factory;
+
+  std::vector<float> reported_progress;
+  std::unique_ptr<TdMon> td_mon =
+      factory
+          .createAsync(std::stop_token(),
+                       [&](float progress) {
+                         reported_progress.push_back(progress);
+                       })
+          .get();
+
+  EXPECT_EQ(td_mon->getAttackValue(), 1);
+  EXPECT_EQ(td_mon->getDefenseValue(), 2);
+  EXPECT_EQ(td_mon->getSpeedValue(), 3);
+
+  EXPECT_EQ(reported_progress, std::vector<float>({0.0f, 1.0f}));
+}
+
+/**
+ * @brief Test, if the default createAsync() does not create a td-mon, if a stop
+ * was requested before it started.
+ */
+TEST(TdMonFactory, CancelsAsynchronousCreationByDefault) {
+  CreateOnlyTdMonFactory factory;
+
+  std::stop_source stop_source;
+  stop_source.request_stop();
+
+  EXPECT_THROW(factory.createAsync(stop_source.get_token(), nullptr).get(),
+               TdMonCreationCancelledError);
+}
+
+/**
+ * @brief Test, if factories report no fingerprint by default, so td-mons are
+ * always created.
+ */
+TEST(TdMonFactory, HasNoDataSourceFingerprintByDefault) {
+  CreateOnlyTdMonFactory factory;
+  EXPECT_FALSE(factory.getDataSourceFingerprint().has_value());
+}
+}  // namespace tdmon
@@ -0,0 +1,86 @@
+#include <TDMon/default_td_mon.h>
+#include <TDMon/td_mon_history_log.h>
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief The path of the log file used by the benchmarks
+ */
+const std::filesystem::path kBenchmarkHistoryLogPath =
+    "./benchmark_td_mon_history.log";
+
+/**
+ * @brief The number of data sources in the benchmark log
+ */
+const int kBenchmarkHistorySourceCount = 1000;
+
+/**
+ * @brief Helper function. Create a log with one record per data source and
+ * hour.
+ * @param record_count The number of records
+ */
+void createBenchmarkHistoryLog(int record_count) {
+  std::filesystem::remove(kBenchmarkHistoryLogPath);
+  TdMonHistoryLog log;
+  log.open(kBenchmarkHistoryLogPath);
+  const DefaultTdMon td_mon(10, 20, 30);
+  for (int i = 0; i < record_count; ++i) {
+    log.append("user" + std::to_string(i % kBenchmarkHistorySourceCount),
+               td_mon,
+               std::chrono::hours(i / kBenchmarkHistorySourceCount));
+  }
+}
+
+/**
+ * @brief Benchmark appending a record
+ */
+void BM_TdMonHistoryLogAppend(benchmark::State& state) {
+  std::filesystem::remove(kBenchmarkHistoryLogPath);
+  TdMonHistoryLog log;
+  log.open(kBenchmarkHistoryLogPath);
+  const DefaultTdMon td_mon(10, 20, 30);
+  std::int64_t hour = 0;
+  for (auto _ : state) {
+    log.append("user1", td_mon, std::chrono::hours(++hour));
+  }
+  log.close();
+  std::filesystem::remove(kBenchmarkHistoryLogPath);
+}
+BENCHMARK(BM_TdMonHistoryLogAppend);
+
+/**
+ * @brief Benchmark opening a log (mapping and indexing it). The argument is
+ * the number of records.
+ */
+void BM_TdMonHistoryLogOpen(benchmark::State& state) {
+  createBenchmarkHistoryLog(static_cast<int>(state.range(0)));
+  TdMonHistoryLog log;
+  for (auto _ : state) {
+    log.open(kBenchmarkHistoryLogPath);
+    benchmark::DoNotOptimize(log.getRecordCount());
+  }
+  log.close();
+  std::filesystem::remove(kBenchmarkHistoryLogPath);
+}
+BENCHMARK(BM_TdMonHistoryLogOpen)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark querying one day of records of one data source. The
+ * argument is the number of records in the log.
+ */
+void BM_TdMonHistoryLogGetEntries(benchmark::State& state) {
+  createBenchmarkHistoryLog(static_cast<int>(state.range(0)));
+  TdMonHistoryLog log;
+  log.open(kBenchmarkHistoryLogPath);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(log.getEntries("user500", std::chrono::hours(50),
+                                            std::chrono::hours(74)));
+  }
+  log.close();
+  std::filesystem::remove(kBenchmarkHistoryLogPath);
+}
+BENCHMARK(BM_TdMonHistoryLogGetEntries)->Arg(100000);
+}  // namespace tdmon
@@ -0,0 +1,329 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/td_mon_history_log.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace tdmon {
+namespace {
+/**
+ * @brief The header at the start of a log file
+ */
+struct LogHeader {
+  /**
+   * @brief Identifies the file as td-mon history log. Equal to kLogMagic.
+   */
+  std::array<char, 8> magic = {};
+
+  /**
+   * @brief The version of the log format
+   */
+  std::uint32_t format_version = 0;
+
+  /**
+   * @brief Equal to kLogByteOrderMark, if the log was written with the native
+   * byte order
+   */
+  std::uint32_t byte_order_mark = 0;
+
+  /**
+   * @brief The time of the last compaction in microseconds since unix epoch
+   */
+  std::int64_t last_compaction_timestamp = 0;
+
+  /**
+   * @brief Unused. Keeps the records 32 byte aligned.
+   */
+  std::uint64_t reserved = 0;
+};
+
+/**
+ * @brief The magic bytes at the start of every log file
+ */
+const std::array<char, 8> kLogMagic = {'T', 'D', 'M', 'O', 'N', 'H', 'S', 'T'};
+
+/**
+ * @brief Written to the header to detect logs with another byte order
+ */
+const std::uint32_t kLogByteOrderMark = 0x01020304;
+}  // namespace
+
+const std::uint32_t TdMonHistoryLog::kFormatVersion;
+
+void TdMonHistoryLog::open(const std::filesystem::path& path) {
+  close();
+
+  if (!std::filesystem::exists(path)) {
+    writeLogFile(path,
+                 std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::system_clock::now().time_since_epoch()),
+                 {});
+  }
+
+  // remove an incomplete record, so appended records are aligned
+  const std::uintmax_t file_size = std::filesystem::file_size(path);
+  if (file_size < sizeof(LogHeader)) {
+    throw std::runtime_error("Invalid td-mon history log: " + path.string());
+  }
+  const std::uintmax_t incomplete_record_size =
+      (file_size - sizeof(LogHeader)) % sizeof(Record);
+  if (incomplete_record_size != 0) {
+    std::filesystem::resize_file(path, file_size - incomplete_record_size);
+  }
+
+  MemoryMappedFile mapped_file(path);
+  const std::span<const std::byte> data = mapped_file.getData();
+  LogHeader header;
+  std::memcpy(&header, data.data(), sizeof(LogHeader));
+  if (header.magic != kLogMagic || header.format_version != kFormatVersion ||
+      header.byte_order_mark != kLogByteOrderMark) {
+    throw std::runtime_error("Invalid td-mon history log: " + path.string());
+  }
+  if ((data.size() - sizeof(LogHeader)) / sizeof(Record) > UINT32_MAX) {
+    throw std::runtime_error("td-mon history log is too large: " +
+                             path.string());
+  }
+
+  appender_.open(path, std::ios::binary | std::ios::app);
+  if (!appender_.is_open()) {
+    throw std::runtime_error("Cannot open td-mon history log: " +
+                             path.string());
+  }
+
+  path_ = path;
+  mapped_records_ = {
+      reinterpret_cast<const Record*>(data.data() + sizeof(LogHeader)),
+      (data.size() - sizeof(LogHeader)) / sizeof(Record)};
+  mapped_file_ = std::move(mapped_file);
+  last_compaction_timestamp_ =
+      std::chrono::microseconds(header.last_compaction_timestamp);
+
+  for (std::uint32_t position = 0; position < mapped_records_.size();
+       ++position) {
+    addToIndex(position);
+  }
+}
+
+bool TdMonHistoryLog::isOpen() const { return appender_.is_open(); }
+
+void TdMonHistoryLog::close() {
+  appender_.close();
+  appender_.clear();
+  source_index_.clear();
+  appended_records_.clear();
+  mapped_records_ = {};
+  mapped_file_.close();
+  path_.clear();
+  last_compaction_timestamp_ = std::chrono::microseconds(0);
+}
+
+void TdMonHistoryLog::append(const std::string& source_identity,
+                             const TdMon& td_mon,
+                             std::chrono::microseconds timestamp) {
+  if (!isOpen()) {
+    throw std::runtime_error("td-mon history log is not open");
+  }
+  if (getRecordCount() == UINT32_MAX) {
+    throw std::runtime_error("td-mon history log is full");
+  }
+
+  Record record;
+  record.timestamp = timestamp.count();
+  record.source_key = createSourceKey(source_identity);
+  record.attack_value = td_mon.getAttackValue();
+  record.defense_value = td_mon.getDefenseValue();
+  record.speed_value = td_mon.getSpeedValue();
+
+  // flush, so the record is not lost if the application crashes
+  appender_.write(reinterpret_cast<const char*>(&record), sizeof(Record));
+  appender_.flush();
+  if (!appender_) {
+    // an incomplete record is removed when opening the log again
+    appender_.clear();
+    throw std::runtime_error("Cannot append to td-mon history log: " +
+                             path_.string());
+  }
+
+  appended_records_.push_back(record);
+  addToIndex(static_cast<std::uint32_t>(getRecordCount() - 1));
+}
+
+std::vector<TdMonHistoryLog::Entry> TdMonHistoryLog::getEntries(
+    const std::string& source_identity, std::chrono::microseconds begin,
+    std::chrono::microseconds end) const {
+  const auto it = source_index_.find(createSourceKey(source_identity));
+  if (it == source_index_.end()) {
+    return {};
+  }
+
+  const std::vector<std::uint32_t>& positions = it->second;
+  auto first = std::lower_bound(
+      positions.begin(), positions.end(), begin.count(),
+      [this](std::uint32_t position, std::int64_t timestamp) {
+        return getRecord(position).timestamp < timestamp;
+      });
+
+  std::vector<Entry> entries;
+  for (; first != positions.end(); ++first) {
+    const Record& record = getRecord(*first);
+    if (record.timestamp >= end.count()) {
+      break;
+    }
+    entries.push_back({std::chrono::microseconds(record.timestamp),
+                       record.attack_value, record.defense_value,
+                       record.speed_value});
+  }
+  return entries;
+}
+
+std::size_t TdMonHistoryLog::getRecordCount() const {
+  return mapped_records_.size() + appended_records_.size();
+}
+
+std::chrono::microseconds TdMonHistoryLog::getLastCompactionTimestamp() const {
+  return last_compaction_timestamp_;
+}
+
+void TdMonHistoryLog::compact(std::chrono::microseconds now,
+                              std::chrono::microseconds full_resolution_age,
+                              std::chrono::microseconds bucket_size) {
+  if (!isOpen()) {
+    throw std::runtime_error("td-mon history log is not open");
+  }
+  if (bucket_size.count() <= 0) {
+    throw std::runtime_error("bucket size must be positive");
+  }
+
+  const std::int64_t full_resolution_begin =
+      (now - full_resolution_age).count();
+  // the time bucket of an old record. Rounds down for negative timestamps
+  auto getBucket = [&bucket_size](std::int64_t timestamp) {
+    const std::int64_t bucket = timestamp / bucket_size.count();
+    return timestamp % bucket_size.count() < 0 ? bucket - 1 : bucket;
+  };
+
+  // keep all recent records, and the most recent old record of each data
+  // source and time bucket. Walk the indices, so the records of a data source
+  // are visited ordered by time
+  std::vector<Record> records;
+  records.reserve(getRecordCount());
+  for (const auto& [source_key, positions] : source_index_) {
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      const Record& record = getRecord(positions[i]);
+      if (record.timestamp < full_resolution_begin &&
+          i + 1 < positions.size()) {
+        const Record& next_record = getRecord(positions[i + 1]);
+        if (next_record.timestamp < full_resolution_begin &&
+            getBucket(next_record.timestamp) == getBucket(record.timestamp)) {
+          // a more recent record of the same bucket is kept instead
+          continue;
+        }
+      }
+      records.push_back(record);
+    }
+  }
+  // keep the order of appending for records of different data sources
+  std::stable_sort(records.begin(), records.end(),
+                   [](const Record& a, const Record& b) {
+                     return a.timestamp < b.timestamp;
+                   });
+
+  const std::filesystem::path path = path_;
+  std::filesystem::path temporary_path = path;
+  temporary_path += ".tmp";
+  writeLogFile(temporary_path, now, records);
+
+  close();
+  std::filesystem::rename(temporary_path, path);
+  open(path);
+}
+
+bool TdMonHistoryLog::compactIfDue(std::chrono::microseconds now) {
+  if (now - last_compaction_timestamp_ < kCompactionInterval) {
+    return false;
+  }
+  compact(now);
+  return true;
+}
+
+std::uint64_t TdMonHistoryLog::createSourceKey(
+    const std::string& source_identity) {
+  std::uint64_t hash = 0xCBF29CE484222325ull;
+  for (char character : source_identity) {
+    hash = (hash ^ static_cast<unsigned char>(character)) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+const TdMonHistoryLog::Record& TdMonHistoryLog::getRecord(
+    std::uint32_t position) const {
+  if (position < mapped_records_.size()) {
+    return mapped_records_[position];
+  }
+  return appended_records_[position - mapped_records_.size()];
+}
+
+void TdMonHistoryLog::addToIndex(std::uint32_t position) {
+  const Record& record = getRecord(position);
+  std::vector<std::uint32_t>& positions = source_index_[record.source_key];
+
+  // records are usually appended in order. Otherwise, insert the position
+  // where it belongs, so the index stays ordered by time
+  auto it = std::upper_bound(
+      positions.begin(), positions.end(), record.timestamp,
+      [this](std::int64_t timestamp, std::uint32_t other_position) {
+        return timestamp < getRecord(other_position).timestamp;
+      });
+  positions.insert(it, position);
+}
+
+void TdMonHistoryLog::writeLogFile(
+    const std::filesystem::path& path,
+    std::chrono::microseconds last_compaction_timestamp,
+    const std::vector<Record>& records) {
+  LogHeader header;
+  header.magic = kLogMagic;
+  header.format_version = kFormatVersion;
+  header.byte_order_mark = kLogByteOrderMark;
+  header.last_compaction_timestamp = last_compaction_timestamp.count();
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(LogHeader));
+  file.write(reinterpret_cast<const char*>(records.data()),
+             static_cast<std::streamsize>(records.size() * sizeof(Record)));
+  file.close();
+  if (!file) {
+    std::filesystem::remove(path);
+    throw std::runtime_error("Cannot write td-mon history log: " +
+                             path.string());
+  }
+}
+
+const std::string TdMonHistoryLog::kDefaultFilePath = "./td_mon_history.log";
+
+}  // namespace tdmon
@@ -0,0 +1,300 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <TDMon/memory_mapped_file.h>
+#include <TDMon/td_mon.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief An append-only log of td-mon snapshots, recording how the td-mons of
+ * all data sources (e.g. users) evolve over time.
+ *
+ * The log file consists of a header (see kFormatVersion) followed by fixed
+ * width records of 32 bytes: timestamp, data source key, attack, defense and
+ * speed. The data source key is a hash of the identity of the data source
+ * fingerprint. Integers are stored in the native byte order, as the log is a
+ * local file.
+ *
+ * When the log is opened, the file is mapped into memory and an index of the
+ * records of each data source is built in a single pass. Appending writes one
+ * record to the end of the file and the index, so it takes constant time. The
+ * records of a data source in a time range are found by binary search in its
+ * index.
+ *
+ * Old records are downsampled by compaction: records older than a given age
+ * are reduced to the most recent one per data source and time bucket (e.g.
+ * one per day). compactIfDue() compacts at most once per kCompactionInterval.
+ * Not thread-safe.
+ */
+class TdMonHistoryLog {
+ public:
+  /**
+   * @brief A td-mon snapshot in the log
+   */
+  struct Entry {
+    /**
+     * @brief The time of the snapshot in microseconds since unix epoch
+     */
+    std::chrono::microseconds timestamp;
+
+    /**
+     * @brief The attack value of the td-mon
+     */
+    unsigned int attack_value;
+
+    /**
+     * @brief The defense value of the td-mon
+     */
+    unsigned int defense_value;
+
+    /**
+     * @brief The speed value of the td-mon
+     */
+    unsigned int speed_value;
+  };
+
+  /**
+   * @brief The default path of the log file
+   */
+  static const std::string kDefaultFilePath;
+
+  /**
+   * @brief The version of the log format. Increment when changing the format.
+   */
+  static const std::uint32_t kFormatVersion = 1;
+
+  /**
+   * @brief The minimum time between two compactions in compactIfDue()
+   */
+  static constexpr std::chrono::hours kCompactionInterval =
+      std::chrono::hours(24);
+
+  /**
+   * @brief The default age after which records are downsampled
+   */
+  static constexpr std::chrono::hours kDefaultFullResolutionAge =
+      std::chrono::hours(24 * 30);
+
+  /**
+   * @brief The default size of the time buckets of downsampled records
+   */
+  static constexpr std::chrono::hours kDefaultBucketSize =
+      std::chrono::hours(24);
+
+  /**
+   * @brief Open the log file. Creates it, if it does not exist. Closes the
+   * currently opened log. Throws, if the file cannot be created or is not a
+   * valid log. An incomplete record at the end of the file (e.g. after a
+   * crash during an append) is removed.
+   * @param path The path of the log file
+   */
+  void open(const std::filesystem::path& path);
+
+  /**
+   * @brief Check whether a log is opened
+   * @return true, if a log is opened
+   */
+  bool isOpen() const;
+
+  /**
+   * @brief Close the log, if one is opened
+   */
+  void close();
+
+  /**
+   * @brief Append a td-mon snapshot to the log. Throws, if no log is opened
+   * or the record cannot be written.
+   * @param source_identity The identity of the data source the td-mon was
+   * created from (see DataSourceFingerprint::identity)
+   * @param td_mon The td-mon
+   * @param timestamp The time of the snapshot in microseconds since unix epoch
+   */
+  void append(const std::string& source_identity, const TdMon& td_mon,
+              std::chrono::microseconds timestamp);
+
+  /**
+   * @brief Get the snapshots of a data source in a time range
+   * @param source_identity The identity of the data source
+   * @param begin The start of the time range (inclusive) in microseconds since
+   * unix epoch
+   * @param end The end of the time range (exclusive) in microseconds since
+   * unix epoch
+   * @return The snapshots, ordered by time
+   */
+  std::vector<Entry> getEntries(const std::string& source_identity,
+                                std::chrono::microseconds begin,
+                                std::chrono::microseconds end) const;
+
+  /**
+   * @brief Get the number of records in the log
+   * @return The number of records
+   */
+  std::size_t getRecordCount() const;
+
+  /**
+   * @brief Get the time of the last compaction
+   * @return The time of the last compaction in microseconds since unix epoch.
+   * The time the log was created, if it was never compacted.
+   */
+  std::chrono::microseconds getLastCompactionTimestamp() const;
+
+  /**
+   * @brief Downsample old records. Of all records older than now -
+   * full_resolution_age, only the most recent one per data source and time
+   * bucket is kept. The log is rewritten to a temporary file, which then
+   * replaces the log file. Throws, if no log is opened or the log cannot be
+   * rewritten.
+   * @param now The current time in microseconds since unix epoch
+   * @param full_resolution_age The age after which records are downsampled
+   * @param bucket_size The size of the time buckets
+   */
+  void compact(std::chrono::microseconds now,
+               std::chrono::microseconds full_resolution_age =
+                   kDefaultFullResolutionAge,
+               std::chrono::microseconds bucket_size = kDefaultBucketSize);
+
+  /**
+   * @brief Compact the log with the default parameters, if the last
+   * compaction is at least kCompactionInterval ago
+   * @param now The current time in microseconds since unix epoch
+   * @return true, if the log was compacted
+   */
+  bool compactIfDue(std::chrono::microseconds now);
+
+  /**
+   * @brief Create the key of a data source, which is stored in the records
+   * @param source_identity The identity of the data source
+   * @return The key. The 64 bit FNV-1a hash of the identity.
+   */
+  static std::uint64_t createSourceKey(const std::string& source_identity);
+
+ private:
+  /**
+   * @brief A record in the log file
+   */
+  struct Record {
+    /**
+     * @brief The time of the snapshot in microseconds since unix epoch
+     */
+    std::int64_t timestamp = 0;
+
+    /**
+     * @brief The key of the data source (see createSourceKey())
+     */
+    std::uint64_t source_key = 0;
+
+    /**
+     * @brief The attack value of the td-mon
+     */
+    std::uint32_t attack_value = 0;
+
+    /**
+     * @brief The defense value of the td-mon
+     */
+    std::uint32_t defense_value = 0;
+
+    /**
+     * @brief The speed value of the td-mon
+     */
+    std::uint32_t speed_value = 0;
+
+    /**
+     * @brief Unused. Keeps the records 8 byte aligned.
+     */
+    std::uint32_t reserved = 0;
+  };
+
+  /**
+   * @brief The path of the log file
+   */
+  std::filesystem::path path_;
+
+  /**
+   * @brief The log file, mapped when it was opened
+   */
+  MemoryMappedFile mapped_file_;
+
+  /**
+   * @brief The records in the mapped file
+   */
+  std::span<const Record> mapped_records_;
+
+  /**
+   * @brief The records appended since the file was mapped
+   */
+  std::vector<Record> appended_records_;
+
+  /**
+   * @brief The positions of the records of each data source, ordered by time.
+   * Positions below the size of mapped_records_ refer to it, the others to
+   * appended_records_.
+   */
+  std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> source_index_;
+
+  /**
+   * @brief The time of the last compaction in microseconds since unix epoch
+   */
+  std::chrono::microseconds last_compaction_timestamp_ =
+      std::chrono::microseconds(0);
+
+  /**
+   * @brief Used to append records to the log file. Open, if a log is opened.
+   */
+  std::ofstream appender_;
+
+  /**
+   * @brief Private function to get a record
+   * @param position The position of the record
+   * @return The record
+   */
+  const Record& getRecord(std::uint32_t position) const;
+
+  /**
+   * @brief Private function to add a record to the index of its data source
+   * @param position The position of the record
+   */
+  void addToIndex(std::uint32_t position);
+
+  /**
+   * @brief Private function to write a new log file
+   * @param path The path of the file
+   * @param last_compaction_timestamp The time of the last compaction
+   * @param records The records
+   */
+  static void writeLogFile(const std::filesystem::path& path,
+                           std::chrono::microseconds last_compaction_timestamp,
+                           const std::vector<Record>& records);
+};
+}  // namespace tdmon
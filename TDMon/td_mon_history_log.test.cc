@@ -0,0 +1,145 @@
+#include <TDMon/default_td_mon.h>
+#include <TDMon/td_mon_history_log.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace tdmon {
+/**
+ * @brief The path of the log file used by the tests
+ */
+const std::filesystem::path kTestHistoryLogPath = "./test_td_mon_history.log";
+
+/**
+ * @brief Helper function. Convert hours to microseconds since unix epoch.
+ * @param hours The hours since unix epoch
+ * @return The microseconds since unix epoch
+ */
+std::chrono::microseconds atHour(int hours) {
+  return std::chrono::hours(hours);
+}
+
+/**
+ * @brief Test, if appended records are found by range queries, also after
+ * opening the log again.
+ */
+TEST(TdMonHistoryLog, FindsEntriesOfDataSourceInTimeRange) {
+  std::filesystem::remove(kTestHistoryLogPath);
+
+  {
+    TdMonHistoryLog log;
+    EXPECT_FALSE(log.isOpen());
+    log.open(kTestHistoryLogPath);
+    EXPECT_TRUE(log.isOpen());
+    for (int hour = 0; hour < 10; ++hour) {
+      log.append("Human1", DefaultTdMon(hour, 0, 0), atHour(hour));
+      log.append("Human2", DefaultTdMon(100 + hour, 0, 0), atHour(hour));
+    }
+    EXPECT_EQ(log.getRecordCount(), 20);
+  }
+
+  TdMonHistoryLog log;
+  log.open(kTestHistoryLogPath);
+  EXPECT_EQ(log.getRecordCount(), 20);
+  // one more record, out of order and not yet mapped
+  log.append("Human1", DefaultTdMon(42, 43, 44), atHour(3));
+
+  std::vector<TdMonHistoryLog::Entry> entries =
+      log.getEntries("Human1", atHour(3), atHour(6));
+  ASSERT_EQ(entries.size(), 4);
+  EXPECT_EQ(entries[0].timestamp, atHour(3));
+  EXPECT_EQ(entries[1].timestamp, atHour(3));
+  EXPECT_EQ(entries[1].attack_value, 42);
+  EXPECT_EQ(entries[1].defense_value, 43);
+  EXPECT_EQ(entries[1].speed_value, 44);
+  EXPECT_EQ(entries[3].timestamp, atHour(5));
+  EXPECT_EQ(entries[3].attack_value, 5);
+
+  EXPECT_EQ(log.getEntries("Human2", atHour(0), atHour(100)).size(), 10);
+  EXPECT_TRUE(log.getEntries("Human3", atHour(0), atHour(100)).empty());
+
+  log.close();
+  std::filesystem::remove(kTestHistoryLogPath);
+}
+
+/**
+ * @brief Test, if old records are downsampled to one per time bucket and
+ * recent records are kept.
+ */
+TEST(TdMonHistoryLog, DownsamplesOldRecords) {
+  std::filesystem::remove(kTestHistoryLogPath);
+
+  TdMonHistoryLog log;
+  log.open(kTestHistoryLogPath);
+  // four days with one record per hour
+  for (int hour = 0; hour < 96; ++hour) {
+    log.append("Human1", DefaultTdMon(hour, 0, 0), atHour(hour));
+  }
+
+  // keep the last day in full resolution
+  log.compact(atHour(96), std::chrono::hours(24), std::chrono::hours(24));
+  EXPECT_EQ(log.getLastCompactionTimestamp(), atHour(96));
+  EXPECT_EQ(log.getRecordCount(), 3 + 24);
+
+  std::vector<TdMonHistoryLog::Entry> entries =
+      log.getEntries("Human1", atHour(0), atHour(96));
+  ASSERT_EQ(entries.size(), 27);
+  // the most recent record of each old day
+  EXPECT_EQ(entries[0].attack_value, 23);
+  EXPECT_EQ(entries[1].attack_value, 47);
+  EXPECT_EQ(entries[2].attack_value, 71);
+  EXPECT_EQ(entries[3].attack_value, 72);
+
+  // compacting again does not change anything
+  log.compact(atHour(96), std::chrono::hours(24), std::chrono::hours(24));
+  EXPECT_EQ(log.getRecordCount(), 27);
+
+  // compaction is due once per interval
+  EXPECT_FALSE(log.compactIfDue(atHour(100)));
+  EXPECT_TRUE(
+      log.compactIfDue(atHour(96) + TdMonHistoryLog::kCompactionInterval));
+
+  log.close();
+  std::filesystem::remove(kTestHistoryLogPath);
+}
+
+/**
+ * @brief Test, if an incomplete record at the end of the log is removed and
+ * invalid files are rejected.
+ */
+TEST(TdMonHistoryLog, RecoversFromIncompleteRecords) {
+  std::filesystem::remove(kTestHistoryLogPath);
+
+  {
+    TdMonHistoryLog log;
+    log.open(kTestHistoryLogPath);
+    log.append("Human1", DefaultTdMon(1, 2, 3), atHour(1));
+  }
+  {
+    std::ofstream file(kTestHistoryLogPath, std::ios::binary | std::ios::app);
+    file << "partial";
+  }
+
+  {
+    TdMonHistoryLog log;
+    log.open(kTestHistoryLogPath);
+    EXPECT_EQ(log.getRecordCount(), 1);
+    log.append("Human1", DefaultTdMon(4, 5, 6), atHour(2));
+    log.close();
+    log.open(kTestHistoryLogPath);
+    EXPECT_EQ(log.getEntries("Human1", atHour(0), atHour(3)).size(), 2);
+  }
+
+  {
+    std::ofstream file(kTestHistoryLogPath, std::ios::binary | std::ios::trunc);
+    file << "not a td-mon history log, but long enough for a header";
+  }
+  TdMonHistoryLog log;
+  EXPECT_ANY_THROW(log.open(kTestHistoryLogPath));
+  EXPECT_FALSE(log.isOpen());
+
+  std::filesystem::remove(kTestHistoryLogPath);
+}
+}  // namespace tdmon
@@ -0,0 +1,129 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#include <TDMon/td_mon_refresh_scheduler.h>
+
+#include <algorithm>
+
+namespace tdmon {
+TdMonRefreshScheduler::TdMonRefreshScheduler(ClockFunction clock)
+    : clock_(std::move(clock)) {}
+
+void TdMonRefreshScheduler::setTimeToLive(std::chrono::seconds time_to_live) {
+  time_to_live_ = time_to_live;
+}
+
+std::chrono::seconds TdMonRefreshScheduler::getTimeToLive() const {
+  return time_to_live_;
+}
+
+void TdMonRefreshScheduler::setBackoff(std::chrono::seconds initial_backoff,
+                                       std::chrono::seconds max_backoff) {
+  initial_backoff_ = initial_backoff;
+  max_backoff_ = std::max(initial_backoff, max_backoff);
+}
+
+void TdMonRefreshScheduler::setLastValidatedTime(
+    Clock::time_point last_validated_time) {
+  last_validated_time_ = last_validated_time;
+}
+
+void TdMonRefreshScheduler::requestRefresh() { refresh_requested_ = true; }
+
+bool TdMonRefreshScheduler::isRefreshDue() const {
+  if (refresh_in_flight_) {
+    return false;
+  }
+  if (refresh_requested_) {
+    return true;
+  }
+  return isStale() && clock_() >= next_retry_time_;
+}
+
+std::optional<TdMonRefreshScheduler::Clock::duration>
+TdMonRefreshScheduler::getTimeUntilRefreshDue() const {
+  if (refresh_in_flight_) {
+    return std::nullopt;
+  }
+  if (refresh_requested_) {
+    return Clock::duration::zero();
+  }
+
+  // stale and past the backoff after the last failure
+  Clock::time_point due_time = next_retry_time_;
+  if (last_validated_time_ != Clock::time_point::min()) {
+    due_time = std::max(due_time, last_validated_time_ + time_to_live_);
+  }
+  // compared first, so the minimum time point does not overflow
+  const Clock::time_point now = clock_();
+  if (due_time <= now) {
+    return Clock::duration::zero();
+  }
+  return due_time - now;
+}
+
+bool TdMonRefreshScheduler::isStale() const {
+  // compared as age, so the minimum time point does not overflow
+  return last_validated_time_ == Clock::time_point::min() ||
+         clock_() - last_validated_time_ >= time_to_live_;
+}
+
+bool TdMonRefreshScheduler::isRefreshInFlight() const {
+  return refresh_in_flight_;
+}
+
+unsigned int TdMonRefreshScheduler::getFailureCount() const {
+  return failure_count_;
+}
+
+void TdMonRefreshScheduler::onRefreshStarted() {
+  refresh_in_flight_ = true;
+  // the running refresh serves all requests made so far
+  refresh_requested_ = false;
+}
+
+void TdMonRefreshScheduler::onRefreshSucceeded() {
+  refresh_in_flight_ = false;
+  refresh_requested_ = false;
+  failure_count_ = 0;
+  last_validated_time_ = clock_();
+  next_retry_time_ = Clock::time_point::min();
+}
+
+void TdMonRefreshScheduler::onRefreshFailed() {
+  refresh_in_flight_ = false;
+  ++failure_count_;
+
+  // double the delay for every failure after the first, without overflowing
+  std::chrono::seconds backoff = initial_backoff_;
+  for (unsigned int i = 1; i < failure_count_ && backoff < max_backoff_; ++i) {
+    backoff *= 2;
+  }
+  next_retry_time_ = clock_() + std::min(backoff, max_backoff_);
+}
+
+void TdMonRefreshScheduler::onRefreshCancelled() {
+  refresh_in_flight_ = false;
+}
+}  // namespace tdmon
@@ -0,0 +1,226 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <optional>
+
+namespace tdmon {
+/**
+ * @brief Decides when to create a new td-mon to replace the cached one
+ * (stale-while-revalidate).
+ *
+ * The cached td-mon is always shown right away. Once it is older than the time
+ * to live (TTL), a refresh is due and the td-mon is revalidated in the
+ * background. Refreshes requested explicitly (e.g. by a button) are due right
+ * away. While a refresh is in flight, no other refresh is due, so concurrent
+ * requests are coalesced into the running one.
+ *
+ * After a failed refresh, automatic refreshes are delayed with exponential
+ * backoff: the first retry waits the initial backoff, every further failure
+ * doubles the delay up to the maximum backoff. Explicitly requested refreshes
+ * are not delayed. A successful refresh resets the backoff.
+ *
+ * The scheduler does not start refreshes itself. The owner checks
+ * isRefreshDue() regularly (e.g. once per frame) and reports the start and
+ * result of each refresh. The current time is taken from an injectable clock,
+ * so the behavior can be tested without waiting. Not thread-safe.
+ */
+class TdMonRefreshScheduler {
+ public:
+  /**
+   * @brief The clock used to determine the age of the td-mon. The system clock
+   * is used, because the timestamps of the cache are system clock timestamps.
+   */
+  using Clock = std::chrono::system_clock;
+
+  /**
+   * @brief Returns the current time
+   */
+  using ClockFunction = std::function<Clock::time_point()>;
+
+  /**
+   * @brief The default time after which a td-mon is revalidated
+   */
+  static constexpr std::chrono::seconds kDefaultTimeToLive =
+      std::chrono::minutes(15);
+
+  /**
+   * @brief The default delay before retrying after the first failure
+   */
+  static constexpr std::chrono::seconds kDefaultInitialBackoff =
+      std::chrono::seconds(5);
+
+  /**
+   * @brief The default maximum delay before retrying after failures
+   */
+  static constexpr std::chrono::seconds kDefaultMaxBackoff =
+      std::chrono::minutes(10);
+
+  /**
+   * @brief The constructor. Without a validated td-mon, a refresh is due right
+   * away.
+   * @param clock Returns the current time. Defaults to the system clock.
+   */
+  explicit TdMonRefreshScheduler(ClockFunction clock = &Clock::now);
+
+  /**
+   * @brief Set the time after which a td-mon is revalidated
+   * @param time_to_live The time to live
+   */
+  void setTimeToLive(std::chrono::seconds time_to_live);
+
+  /**
+   * @brief Get the time after which a td-mon is revalidated
+   * @return The time to live
+   */
+  std::chrono::seconds getTimeToLive() const;
+
+  /**
+   * @brief Set the delays used after failed refreshes
+   * @param initial_backoff The delay before retrying after the first failure
+   * @param max_backoff The maximum delay before retrying
+   */
+  void setBackoff(std::chrono::seconds initial_backoff,
+                  std::chrono::seconds max_backoff);
+
+  /**
+   * @brief Set when the current td-mon was last validated, e.g. the timestamp
+   * of a td-mon loaded from the cache on disk
+   * @param last_validated_time The time of the last validation
+   */
+  void setLastValidatedTime(Clock::time_point last_validated_time);
+
+  /**
+   * @brief Request a refresh. It is due right away, unless a refresh is in
+   * flight already.
+   */
+  void requestRefresh();
+
+  /**
+   * @brief Check whether a refresh should be started now: no refresh is in
+   * flight, and either a refresh was requested, or the td-mon is stale and
+   * the backoff after the last failure has passed.
+   * @return true, if a refresh should be started
+   */
+  bool isRefreshDue() const;
+
+  /**
+   * @brief Get the time until isRefreshDue() returns true, unless a refresh
+   * is requested or reported in the meantime
+   * @return The time until a refresh is due. Zero, if it is due now. Empty,
+   * if a refresh is in flight.
+   */
+  std::optional<Clock::duration> getTimeUntilRefreshDue() const;
+
+  /**
+   * @brief Check whether the td-mon is older than the time to live
+   * @return true, if the td-mon is stale
+   */
+  bool isStale() const;
+
+  /**
+   * @brief Check whether a refresh is in flight
+   * @return true, if a refresh was started and has not finished yet
+   */
+  bool isRefreshInFlight() const;
+
+  /**
+   * @brief Get the number of failed refreshes since the last successful one
+   * @return The number of failures
+   */
+  unsigned int getFailureCount() const;
+
+  /**
+   * @brief Report that a refresh was started
+   */
+  void onRefreshStarted();
+
+  /**
+   * @brief Report that a refresh succeeded. The td-mon counts as validated
+   * now. Also used, if the td-mon was found to be up-to-date without
+   * refreshing it.
+   */
+  void onRefreshSucceeded();
+
+  /**
+   * @brief Report that a refresh failed. Delays the next automatic refresh.
+   */
+  void onRefreshFailed();
+
+  /**
+   * @brief Report that a refresh was cancelled. Neither counts as success nor
+   * as failure.
+   */
+  void onRefreshCancelled();
+
+ private:
+  /**
+   * @brief Returns the current time
+   */
+  ClockFunction clock_;
+
+  /**
+   * @brief The time after which a td-mon is revalidated
+   */
+  std::chrono::seconds time_to_live_ = kDefaultTimeToLive;
+
+  /**
+   * @brief The delay before retrying after the first failure
+   */
+  std::chrono::seconds initial_backoff_ = kDefaultInitialBackoff;
+
+  /**
+   * @brief The maximum delay before retrying after failures
+   */
+  std::chrono::seconds max_backoff_ = kDefaultMaxBackoff;
+
+  /**
+   * @brief When the td-mon was last validated. The minimum, if it never was.
+   */
+  Clock::time_point last_validated_time_ = Clock::time_point::min();
+
+  /**
+   * @brief No automatic refresh is due before this time
+   */
+  Clock::time_point next_retry_time_ = Clock::time_point::min();
+
+  /**
+   * @brief True, if a refresh was requested explicitly
+   */
+  bool refresh_requested_ = false;
+
+  /**
+   * @brief True, if a refresh is in flight
+   */
+  bool refresh_in_flight_ = false;
+
+  /**
+   * @brief The number of failed refreshes since the last successful one
+   */
+  unsigned int failure_count_ = 0;
+};
+}  // namespace tdmon
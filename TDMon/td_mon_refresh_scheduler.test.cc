@@ -0,0 +1,158 @@
+#include <TDMon/td_mon_refresh_scheduler.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+namespace tdmon {
+/**
+ * @brief A clock that only advances when told to
+ */
+class FakeRefreshClock {
+ public:
+  /**
+   * @brief Get the current time
+   * @return The current time
+   */
+  TdMonRefreshScheduler::Clock::time_point now() const { return now_; }
+
+  /**
+   * @brief Advance the time
+   * @param duration The duration to advance by
+   */
+  void advance(std::chrono::seconds duration) { now_ += duration; }
+
+ private:
+  /**
+   * @brief The current time
+   */
+  TdMonRefreshScheduler::Clock::time_point now_ =
+      TdMonRefreshScheduler::Clock::time_point(std::chrono::hours(1000));
+};
+
+/**
+ * @brief Helper function. Create a scheduler using the fake clock.
+ * @param clock The fake clock. Must outlive the scheduler.
+ * @return The scheduler
+ */
+TdMonRefreshScheduler createSchedulerWithFakeClock(FakeRefreshClock& clock) {
+  TdMonRefreshScheduler scheduler([&clock]() { return clock.now(); });
+  scheduler.setTimeToLive(std::chrono::seconds(60));
+  scheduler.setBackoff(std::chrono::seconds(5), std::chrono::seconds(30));
+  return scheduler;
+}
+
+TEST(TdMonRefreshScheduler, RevalidatesAfterTimeToLive) {
+  FakeRefreshClock clock;
+  TdMonRefreshScheduler scheduler = createSchedulerWithFakeClock(clock);
+
+  // never validated
+  EXPECT_TRUE(scheduler.isRefreshDue());
+
+  scheduler.setLastValidatedTime(clock.now());
+  EXPECT_FALSE(scheduler.isStale());
+  EXPECT_FALSE(scheduler.isRefreshDue());
+
+  clock.advance(std::chrono::seconds(59));
+  EXPECT_FALSE(scheduler.isRefreshDue());
+  clock.advance(std::chrono::seconds(1));
+  EXPECT_TRUE(scheduler.isStale());
+  EXPECT_TRUE(scheduler.isRefreshDue());
+
+  scheduler.onRefreshStarted();
+  scheduler.onRefreshSucceeded();
+  EXPECT_FALSE(scheduler.isRefreshDue());
+}
+
+TEST(TdMonRefreshScheduler, CoalescesRequests) {
+  FakeRefreshClock clock;
+  TdMonRefreshScheduler scheduler = createSchedulerWithFakeClock(clock);
+  scheduler.setLastValidatedTime(clock.now());
+
+  scheduler.requestRefresh();
+  EXPECT_TRUE(scheduler.isRefreshDue());
+  scheduler.onRefreshStarted();
+  EXPECT_TRUE(scheduler.isRefreshInFlight());
+
+  // requests while a refresh is in flight do not start another one
+  scheduler.requestRefresh();
+  scheduler.requestRefresh();
+  EXPECT_FALSE(scheduler.isRefreshDue());
+
+  scheduler.onRefreshSucceeded();
+  EXPECT_FALSE(scheduler.isRefreshInFlight());
+  EXPECT_FALSE(scheduler.isRefreshDue());
+}
+
+TEST(TdMonRefreshScheduler, BacksOffAfterFailures) {
+  FakeRefreshClock clock;
+  TdMonRefreshScheduler scheduler = createSchedulerWithFakeClock(clock);
+
+  // 5, 10, 20, then capped at 30 seconds
+  for (int backoff_seconds : {5, 10, 20, 30, 30}) {
+    EXPECT_TRUE(scheduler.isRefreshDue());
+    scheduler.onRefreshStarted();
+    scheduler.onRefreshFailed();
+
+    clock.advance(std::chrono::seconds(backoff_seconds - 1));
+    EXPECT_FALSE(scheduler.isRefreshDue());
+    clock.advance(std::chrono::seconds(1));
+  }
+  EXPECT_EQ(scheduler.getFailureCount(), 5);
+
+  // explicit requests are not delayed
+  scheduler.onRefreshStarted();
+  scheduler.onRefreshFailed();
+  scheduler.requestRefresh();
+  EXPECT_TRUE(scheduler.isRefreshDue());
+
+  // success resets the backoff
+  scheduler.onRefreshStarted();
+  scheduler.onRefreshSucceeded();
+  EXPECT_EQ(scheduler.getFailureCount(), 0);
+  clock.advance(std::chrono::seconds(60));
+  scheduler.onRefreshStarted();
+  scheduler.onRefreshFailed();
+  clock.advance(std::chrono::seconds(5));
+  EXPECT_TRUE(scheduler.isRefreshDue());
+}
+
+TEST(TdMonRefreshScheduler, ReportsTimeUntilRefreshDue) {
+  FakeRefreshClock clock;
+  TdMonRefreshScheduler scheduler = createSchedulerWithFakeClock(clock);
+
+  // never validated
+  EXPECT_EQ(scheduler.getTimeUntilRefreshDue(),
+            TdMonRefreshScheduler::Clock::duration::zero());
+
+  scheduler.setLastValidatedTime(clock.now());
+  clock.advance(std::chrono::seconds(20));
+  EXPECT_EQ(scheduler.getTimeUntilRefreshDue(), std::chrono::seconds(40));
+
+  scheduler.requestRefresh();
+  EXPECT_EQ(scheduler.getTimeUntilRefreshDue(),
+            TdMonRefreshScheduler::Clock::duration::zero());
+
+  // nothing is due while a refresh is in flight
+  scheduler.onRefreshStarted();
+  EXPECT_FALSE(scheduler.getTimeUntilRefreshDue().has_value());
+
+  // a failed refresh is retried after the backoff
+  clock.advance(std::chrono::seconds(100));
+  scheduler.onRefreshFailed();
+  EXPECT_EQ(scheduler.getTimeUntilRefreshDue(), std::chrono::seconds(5));
+  clock.advance(std::chrono::seconds(6));
+  EXPECT_EQ(scheduler.getTimeUntilRefreshDue(),
+            TdMonRefreshScheduler::Clock::duration::zero());
+  EXPECT_TRUE(scheduler.isRefreshDue());
+}
+
+TEST(TdMonRefreshScheduler, RetriesCancelledRefreshes) {
+  FakeRefreshClock clock;
+  TdMonRefreshScheduler scheduler = createSchedulerWithFakeClock(clock);
+
+  scheduler.onRefreshStarted();
+  scheduler.onRefreshCancelled();
+  EXPECT_EQ(scheduler.getFailureCount(), 0);
+  EXPECT_TRUE(scheduler.isRefreshDue());
+}
+}  // namespace tdmon
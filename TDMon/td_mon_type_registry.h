@@ -0,0 +1,201 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <TDMon/td_mon.h>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace tdmon {
+/**
+ * @brief A td-mon type, which can be registered in a TdMonTypeRegistry. It
+ * needs a compile-time type identifier, which is also written by toJson(), a
+ * static fromJson() function, and a constructor taking the attack, defense and
+ * speed values, which is used to deserialize binary formats.
+ */
+template <class TdMonType>
+concept RegistrableTdMon =
+    std::derived_from<TdMonType, TdMon> &&
+    std::constructible_from<TdMonType, unsigned int, unsigned int,
+                            unsigned int> &&
+    requires(const nlohmann::json& json) {
+      { TdMonType::kTypeIdentifier } -> std::convertible_to<std::string_view>;
+      { TdMonType::fromJson(json) } -> std::same_as<std::unique_ptr<TdMon>>;
+    };
+
+/**
+ * @brief The deserializers of a td-mon type registered in a TdMonTypeRegistry
+ */
+struct TdMonTypeRegistration {
+  /**
+   * @brief The type id (see TdMon::hashTypeIdentifier())
+   */
+  std::uint32_t type_id;
+
+  /**
+   * @brief The type identifier string
+   */
+  std::string_view type_identifier;
+
+  /**
+   * @brief Create a td-mon of this type from json
+   */
+  std::unique_ptr<TdMon> (*from_json)(const nlohmann::json& json);
+
+  /**
+   * @brief Create a td-mon of this type from its attack, defense and speed
+   * values
+   */
+  std::unique_ptr<TdMon> (*from_values)(unsigned int attack_value,
+                                        unsigned int defense_value,
+                                        unsigned int speed_value);
+};
+
+/**
+ * @brief Deserializes td-mons of all types in a type list.
+ *
+ * The registrations of all types are stored in a table sorted by type id,
+ * which is generated at compile time. Deserializing a td-mon only hashes its
+ * type identifier (or reads the type id from a binary record) and looks up
+ * the deserializer in the table, no matter how many types are registered.
+ * Type ids, which collide, are detected at compile time.
+ *
+ * @tparam TdMonTypes The td-mon types to register
+ */
+template <RegistrableTdMon... TdMonTypes>
+class TdMonTypeRegistry {
+ public:
+  /**
+   * @brief The registrations of all types, sorted by type id
+   */
+  static constexpr std::array<TdMonTypeRegistration, sizeof...(TdMonTypes)>
+      kRegistrations = []() {
+        std::array<TdMonTypeRegistration, sizeof...(TdMonTypes)>
+            registrations = {TdMonTypeRegistration{
+                TdMon::hashTypeIdentifier(TdMonTypes::kTypeIdentifier),
+                TdMonTypes::kTypeIdentifier,
+                [](const nlohmann::json& json) {
+                  return TdMonTypes::fromJson(json);
+                },
+                [](unsigned int attack_value, unsigned int defense_value,
+                   unsigned int speed_value) -> std::unique_ptr<TdMon> {
+                  return std::make_unique<TdMonTypes>(
+                      attack_value, defense_value, speed_value);
+                }}...};
+        std::sort(registrations.begin(), registrations.end(),
+                  [](const TdMonTypeRegistration& lhs,
+                     const TdMonTypeRegistration& rhs) {
+                    return lhs.type_id < rhs.type_id;
+                  });
+        return registrations;
+      }();
+
+  static_assert(std::adjacent_find(kRegistrations.begin(),
+                                   kRegistrations.end(),
+                                   [](const TdMonTypeRegistration& lhs,
+                                      const TdMonTypeRegistration& rhs) {
+                                     return lhs.type_id == rhs.type_id;
+                                   }) == kRegistrations.end(),
+                "the type ids of the registered td-mon types collide");
+
+  /**
+   * @brief Find the registration of a type
+   * @param type_id The type id
+   * @return The registration, or nullptr, if the type is not registered
+   */
+  static constexpr const TdMonTypeRegistration* find(std::uint32_t type_id) {
+    const auto registration = std::lower_bound(
+        kRegistrations.begin(), kRegistrations.end(), type_id,
+        [](const TdMonTypeRegistration& registration, std::uint32_t id) {
+          return registration.type_id < id;
+        });
+    if (registration == kRegistrations.end() ||
+        registration->type_id != type_id) {
+      return nullptr;
+    }
+    return &*registration;
+  }
+
+  /**
+   * @brief Get whether a type is registered
+   * @param type_id The type id
+   * @return true, if the type is registered
+   */
+  static constexpr bool contains(std::uint32_t type_id) {
+    return find(type_id) != nullptr;
+  }
+
+  /**
+   * @brief Get the registration of a type. Throws, if the type is not
+   * registered.
+   * @param type_id The type id
+   * @return The registration
+   */
+  static const TdMonTypeRegistration& get(std::uint32_t type_id) {
+    const TdMonTypeRegistration* registration = find(type_id);
+    if (!registration) {
+      throw std::runtime_error("td-mon type not supported for deserialization");
+    }
+    return *registration;
+  }
+
+  /**
+   * @brief Create a td-mon of the type stored with key
+   * TdMon::kJsonTypeIdentifierKey from json. Throws, if the type is not
+   * registered.
+   * @param json The json to create from
+   * @return The created td-mon
+   */
+  static std::unique_ptr<TdMon> fromJson(const nlohmann::json& json) {
+    const std::string& type_identifier =
+        json.at(TdMon::kJsonTypeIdentifierKey).get_ref<const std::string&>();
+    return get(TdMon::hashTypeIdentifier(type_identifier)).from_json(json);
+  }
+
+  /**
+   * @brief Create a td-mon from its type id and its attack, defense and speed
+   * values. Throws, if the type is not registered.
+   * @param type_id The type id
+   * @param attack_value The attack value
+   * @param defense_value The defense value
+   * @param speed_value The speed value
+   * @return The created td-mon
+   */
+  static std::unique_ptr<TdMon> fromValues(std::uint32_t type_id,
+                                           unsigned int attack_value,
+                                           unsigned int defense_value,
+                                           unsigned int speed_value) {
+    return get(type_id).from_values(attack_value, defense_value, speed_value);
+  }
+};
+}  // namespace tdmon
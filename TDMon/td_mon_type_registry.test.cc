@@ -0,0 +1,113 @@
+#include <TDMon/default_td_mon.h>
+#include <TDMon/td_mon_type_registry.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+namespace tdmon {
+/**
+ * @brief A second td-mon type, to test registries with multiple types
+ */
+class FakeTdMon : public TdMon {
+ public:
+  static constexpr std::string_view kTypeIdentifier = "FakeTdMon";
+
+  FakeTdMon(unsigned int attack_value, unsigned int defense_value,
+            unsigned int speed_value)
+      : attack_value_(attack_value),
+        defense_value_(defense_value),
+        speed_value_(speed_value) {}
+
+  unsigned int getLevel() const override { return 1; }
+  unsigned int getAttackValue() const override { return attack_value_; }
+  unsigned int getDefenseValue() const override { return defense_value_; }
+  unsigned int getSpeedValue() const override { return speed_value_; }
+
+  nlohmann::json toJson() const override {
+    nlohmann::json json;
+    json[kJsonTypeIdentifierKey] = std::string(kTypeIdentifier);
+    json["values"] = {attack_value_, defense_value_, speed_value_};
+    return json;
+  }
+
+  std::uint32_t getTypeId() const override {
+    return hashTypeIdentifier(kTypeIdentifier);
+  }
+
+  const std::string& getTexturePath() const override {
+    return DefaultTdMon::kPathToTex0;
+  }
+
+  static std::unique_ptr<TdMon> fromJson(const nlohmann::json& json) {
+    const nlohmann::json& values = json.at("values");
+    return std::make_unique<FakeTdMon>(values.at(0).get<unsigned int>(),
+                                       values.at(1).get<unsigned int>(),
+                                       values.at(2).get<unsigned int>());
+  }
+
+ private:
+  unsigned int attack_value_;
+  unsigned int defense_value_;
+  unsigned int speed_value_;
+};
+
+/**
+ * @brief The registry used in the tests
+ */
+using TestRegistry = TdMonTypeRegistry<FakeTdMon, DefaultTdMon>;
+
+// the lookup table is generated at compile time
+static_assert(TestRegistry::contains(DefaultTdMon::kTypeId));
+static_assert(TestRegistry::contains(
+    TdMon::hashTypeIdentifier(FakeTdMon::kTypeIdentifier)));
+static_assert(!TestRegistry::contains(TdMon::hashTypeIdentifier("Unknown")));
+static_assert(TestRegistry::kRegistrations[0].type_id <
+              TestRegistry::kRegistrations[1].type_id);
+
+/**
+ * @brief Test, if td-mons of different types are deserialized from json with
+ * their own deserializer
+ */
+TEST(TdMonTypeRegistry, DeserializesHeterogeneousTypesFromJson) {
+  const DefaultTdMon default_td_mon(1, 2, 3);
+  const FakeTdMon fake_td_mon(4, 5, 6);
+
+  std::unique_ptr<TdMon> loaded_default_td_mon =
+      TestRegistry::fromJson(default_td_mon.toJson());
+  std::unique_ptr<TdMon> loaded_fake_td_mon =
+      TestRegistry::fromJson(fake_td_mon.toJson());
+
+  ASSERT_NE(dynamic_cast<DefaultTdMon*>(loaded_default_td_mon.get()),
+            nullptr);
+  EXPECT_EQ(loaded_default_td_mon->getSpeedValue(), 3);
+  ASSERT_NE(dynamic_cast<FakeTdMon*>(loaded_fake_td_mon.get()), nullptr);
+  EXPECT_EQ(loaded_fake_td_mon->getAttackValue(), 4);
+  EXPECT_EQ(loaded_fake_td_mon->getSpeedValue(), 6);
+}
+
+/**
+ * @brief Test, if td-mons are created from their type id and values, and
+ * unknown types are rejected
+ */
+TEST(TdMonTypeRegistry, CreatesTdMonsFromTypeId) {
+  const FakeTdMon fake_td_mon(4, 5, 6);
+
+  std::unique_ptr<TdMon> td_mon =
+      TestRegistry::fromValues(fake_td_mon.getTypeId(), 7, 8, 9);
+  ASSERT_NE(dynamic_cast<FakeTdMon*>(td_mon.get()), nullptr);
+  EXPECT_EQ(td_mon->getDefenseValue(), 8);
+  EXPECT_EQ(TestRegistry::get(DefaultTdMon::kTypeId).type_identifier,
+            DefaultTdMon::kTypeIdentifierString);
+
+  EXPECT_THROW(TestRegistry::fromValues(TdMon::hashTypeIdentifier("Unknown"),
+                                        1, 2, 3),
+               std::runtime_error);
+  nlohmann::json json = fake_td_mon.toJson();
+  json[TdMon::kJsonTypeIdentifierKey] = "Unknown";
+  EXPECT_THROW(TestRegistry::fromJson(json), std::runtime_error);
+
+  // only DefaultTdMon is registered for cache files
+  using DefaultRegistry = TdMonTypeRegistry<DefaultTdMon>;
+  EXPECT_FALSE(DefaultRegistry::contains(fake_td_mon.getTypeId()));
+}
+}  // namespace tdmon
@@ -0,0 +1,484 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/database_file_state.h>
+#include <TDMon/scoped_progress_handler.h>
+#include <TDMon/technical_debt_dataset_aggregate_store.h>
+
+#include <sqlite3.h>
+
+#include <bit>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+
+namespace tdmon {
+namespace {
+/**
+ * @brief The name of the table storing the digest of each range
+ */
+const std::string kRangeDigestTableName = "TDMON_RANGE_DIGESTS";
+
+/**
+ * @brief The name of the table storing the partial values of each user per
+ * range
+ */
+const std::string kUserValueTableName = "TDMON_USER_VALUES";
+
+/**
+ * @brief The offset basis of the 64 bit FNV-1a hash
+ */
+const std::uint64_t kFnvOffsetBasis = 0xCBF29CE484222325ull;
+
+/**
+ * @brief The prime of the 64 bit FNV-1a hash
+ */
+const std::uint64_t kFnvPrime = 0x100000001B3ull;
+
+/**
+ * @brief Continue a FNV-1a hash with more bytes
+ * @param hash The hash of the previous bytes
+ * @param bytes The bytes
+ * @param size The number of bytes
+ * @return The hash including the bytes
+ */
+std::uint64_t hashBytes(std::uint64_t hash, const unsigned char* bytes,
+                        std::size_t size) {
+  for (std::size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+/**
+ * @brief Continue a FNV-1a hash with a 64 bit number, in little endian byte
+ * order, so the hash is the same on every platform
+ * @param hash The hash of the previous bytes
+ * @param value The number
+ * @return The hash including the number
+ */
+std::uint64_t hashNumber(std::uint64_t hash, std::uint64_t value) {
+  unsigned char bytes[8];
+  for (int i = 0; i < 8; ++i) {
+    bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+  }
+  return hashBytes(hash, bytes, sizeof(bytes));
+}
+
+/**
+ * @brief The step function of the digest aggregate function. Hashes all
+ * arguments (one row) and adds the hash to the digest. Since the hashes are
+ * added, the digest does not depend on the order of the rows.
+ * @param context The sqlite function context
+ * @param argument_count The number of arguments
+ * @param arguments The arguments
+ */
+void digestStep(sqlite3_context* context, int argument_count,
+                sqlite3_value** arguments) {
+  auto* digest = static_cast<std::uint64_t*>(
+      sqlite3_aggregate_context(context, sizeof(std::uint64_t)));
+  if (digest == nullptr) {
+    sqlite3_result_error_nomem(context);
+    return;
+  }
+
+  std::uint64_t hash = kFnvOffsetBasis;
+  for (int i = 0; i < argument_count; ++i) {
+    // the type is part of the hash, so e.g. NULL and '' differ
+    const int type = sqlite3_value_type(arguments[i]);
+    hash = hashNumber(hash, static_cast<std::uint64_t>(type));
+
+    switch (type) {
+      case SQLITE_INTEGER:
+        hash = hashNumber(hash, static_cast<std::uint64_t>(
+                                    sqlite3_value_int64(arguments[i])));
+        break;
+      case SQLITE_FLOAT:
+        hash = hashNumber(hash, std::bit_cast<std::uint64_t>(
+                                    sqlite3_value_double(arguments[i])));
+        break;
+      case SQLITE_NULL:
+        break;
+      default:
+        // text and blobs
+        hash = hashBytes(
+            hash, static_cast<const unsigned char*>(
+                      sqlite3_value_blob(arguments[i])),
+            static_cast<std::size_t>(sqlite3_value_bytes(arguments[i])));
+        break;
+    }
+  }
+
+  // spread the bits of the hash (splitmix64 finalizer), so the sum of many
+  // hashes stays well distributed
+  hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+  hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+  *digest += hash ^ (hash >> 31);
+}
+
+/**
+ * @brief The final function of the digest aggregate function
+ * @param context The sqlite function context
+ */
+void digestFinal(sqlite3_context* context) {
+  // no memory is allocated, if no row was aggregated
+  const auto* digest =
+      static_cast<const std::uint64_t*>(sqlite3_aggregate_context(context, 0));
+  sqlite3_result_int64(
+      context, static_cast<sqlite3_int64>(digest == nullptr ? 0 : *digest));
+}
+
+/**
+ * @brief Create the tables of the store, if they do not exist yet
+ * @param store The store
+ */
+void createStoreTables(SQLite::Database& store) {
+  store.exec("CREATE TABLE IF NOT EXISTS " +
+             TechnicalDebtDatasetAggregateStore::kMetadataTableName +
+             " (name TEXT PRIMARY KEY, value TEXT)");
+  store.exec("CREATE TABLE IF NOT EXISTS " + kRangeDigestTableName +
+             " (range_index INTEGER PRIMARY KEY, digest INTEGER NOT NULL)");
+  store.exec("CREATE TABLE IF NOT EXISTS " + kUserValueTableName +
+             " (range_index INTEGER NOT NULL, user TEXT NOT NULL, attack "
+             "INTEGER NOT NULL, defense INTEGER NOT NULL, speed INTEGER NOT "
+             "NULL, PRIMARY KEY (range_index, user)) WITHOUT ROWID");
+  // covers the query summing the values of one user
+  store.exec("CREATE INDEX IF NOT EXISTS " + kUserValueTableName +
+             "_USER_INDEX ON " + kUserValueTableName +
+             " (user, attack, defense, speed)");
+}
+}  // namespace
+
+TechnicalDebtDatasetAggregateStore::TechnicalDebtDatasetAggregateStore(
+    std::filesystem::path path_to_dataset, std::string table_name)
+    : path_to_dataset_(std::move(path_to_dataset)),
+      table_name_(std::move(table_name)) {
+  path_to_store_ = path_to_dataset_;
+  path_to_store_ += kAggregateStoreFileExtension;
+}
+
+TechnicalDebtDatasetAggregateStore::~TechnicalDebtDatasetAggregateStore() =
+    default;
+
+const std::filesystem::path& TechnicalDebtDatasetAggregateStore::getPath()
+    const {
+  return path_to_store_;
+}
+
+std::size_t TechnicalDebtDatasetAggregateStore::refresh(
+    const IssueFilter& issue_filter, const std::stop_token& stop_token,
+    const ProgressCallback& progress_callback) {
+  // read the state before reading the dataset. If the dataset changes while
+  // refreshing, the stored state is outdated and the next refresh checks the
+  // ranges again
+  const DatabaseFileState dataset_state =
+      DatabaseFileState::read(path_to_dataset_);
+
+  openStore();
+
+  std::map<std::string, std::string> stored_metadata;
+  {
+    SQLite::Statement metadata_query(
+        *store_, "SELECT name, value FROM " + kMetadataTableName);
+    while (metadata_query.executeStep()) {
+      stored_metadata[metadata_query.getColumn(0).getString()] =
+          metadata_query.getColumn(1).getString();
+    }
+  }
+
+  // the values are stored as text, so the metadata can be compared uniformly
+  const std::map<std::string, std::string> metadata = {
+      {"format_version", std::to_string(kFormatVersion)},
+      {"issue_filter", issue_filter.createKey()},
+      {"dataset_file_size", std::to_string(dataset_state.file_size)},
+      {"dataset_last_write_time",
+       std::to_string(dataset_state.last_write_time)},
+      {"dataset_file_change_counter",
+       std::to_string(dataset_state.file_change_counter)}};
+
+  bool is_up_to_date = true;
+  bool has_same_layout = true;
+  for (const auto& [name, value] : metadata) {
+    auto it = stored_metadata.find(name);
+    const bool is_equal = it != stored_metadata.end() && it->second == value;
+    is_up_to_date &= is_equal;
+    if (name == "format_version" || name == "issue_filter") {
+      has_same_layout &= is_equal;
+    }
+  }
+
+  if (is_up_to_date) {
+    return 0;
+  }
+
+  SQLite::Transaction transaction(*store_);
+
+  // the highest rowid seen in the last refresh. Ranges above it only contain
+  // new rows
+  long long watermark = 0;
+  if (!has_same_layout) {
+    // the values were calculated for another filter (or layout) and cannot be
+    // reused
+    store_->exec("DROP TABLE IF EXISTS " + kRangeDigestTableName);
+    store_->exec("DROP TABLE IF EXISTS " + kUserValueTableName);
+    createStoreTables(*store_);
+  } else if (auto it = stored_metadata.find("watermark");
+             it != stored_metadata.end()) {
+    watermark = std::stoll(it->second);
+  }
+
+  std::map<long long, std::uint64_t> stored_digests;
+  {
+    SQLite::Statement digest_query(
+        *store_, "SELECT range_index, digest FROM " + kRangeDigestTableName);
+    while (digest_query.executeStep()) {
+      stored_digests[digest_query.getColumn(0).getInt64()] =
+          static_cast<std::uint64_t>(digest_query.getColumn(1).getInt64());
+    }
+  }
+
+  SQLite::Database dataset(path_to_dataset_.string(), SQLite::OPEN_READONLY);
+  registerDigestFunction(dataset);
+  // interrupts the queries of a range, once a stop is requested
+  ScopedProgressHandler progress_handler(dataset, stop_token);
+
+  long long max_rowid = 0;
+  {
+    SQLite::Statement max_rowid_query(dataset,
+                                      "SELECT MAX(rowid) FROM " + table_name_);
+    if (max_rowid_query.executeStep() &&
+        !max_rowid_query.getColumn(0).isNull()) {
+      max_rowid = max_rowid_query.getColumn(0).getInt64();
+    }
+  }
+
+  // the rowid range is parameter 1 and 2, the parameters of the filter follow
+  const std::string range_condition =
+      " FROM " + table_name_ + " WHERE rowid BETWEEN ?1 AND ?2 AND " +
+      issue_filter.createSqlCondition(3);
+  const std::string digest_arguments =
+      "(rowid, assignee, reporter, resolution_date IS NOT '', key IS NOT "
+      "NULL, watch_count)";
+
+  SQLite::Statement range_digest_query(
+      dataset, "SELECT " + kDigestFunctionName + digest_arguments +
+                   range_condition);
+  // the digest of the range is the sum of the digests of the groups
+  SQLite::Statement range_values_query(
+      dataset,
+      "SELECT assignee, reporter, COUNT(CASE WHEN resolution_date IS NOT '' "
+      "THEN key END), COUNT(key), SUM(watch_count), " +
+          kDigestFunctionName + digest_arguments + range_condition +
+          " GROUP BY assignee, reporter");
+  issue_filter.bindSqlParameters(range_digest_query, 3);
+  issue_filter.bindSqlParameters(range_values_query, 3);
+
+  SQLite::Statement delete_user_values(
+      *store_,
+      "DELETE FROM " + kUserValueTableName + " WHERE range_index = ?");
+  SQLite::Statement insert_user_values(
+      *store_,
+      "INSERT INTO " + kUserValueTableName + " VALUES (?, ?, ?, ?, ?)");
+  SQLite::Statement replace_digest(
+      *store_,
+      "INSERT OR REPLACE INTO " + kRangeDigestTableName + " VALUES (?, ?)");
+  SQLite::Statement delete_digest(
+      *store_,
+      "DELETE FROM " + kRangeDigestTableName + " WHERE range_index = ?");
+
+  std::size_t aggregated_range_count = 0;
+
+  const long long last_range_index = max_rowid / kRangeSize;
+  for (long long range_index = 0; range_index <= last_range_index;
+       ++range_index) {
+    if (progress_callback) {
+      progress_callback(static_cast<float>(range_index) /
+                        static_cast<float>(last_range_index + 1));
+    }
+    // the transaction is rolled back, so the previous state stays behind
+    if (stop_token.stop_requested()) {
+      throw std::runtime_error("aggregate store refresh was cancelled");
+    }
+
+    const long long first_rowid = range_index * kRangeSize;
+    const long long last_rowid = first_rowid + kRangeSize - 1;
+
+    auto stored_digest = stored_digests.find(range_index);
+
+    // ranges above the watermark are aggregated without checking their digest
+    if (first_rowid <= watermark) {
+      range_digest_query.reset();
+      range_digest_query.bind(1, static_cast<int64_t>(first_rowid));
+      range_digest_query.bind(2, static_cast<int64_t>(last_rowid));
+      range_digest_query.executeStep();
+      const auto digest = static_cast<std::uint64_t>(
+          range_digest_query.getColumn(0).getInt64());
+
+      // ranges without rows have a digest of 0 and are not stored
+      const std::uint64_t previous_digest =
+          stored_digest == stored_digests.end() ? 0 : stored_digest->second;
+      if (digest == previous_digest) {
+        continue;
+      }
+    }
+
+    std::map<std::string, UserValues> range_values;
+    std::uint64_t digest = 0;
+
+    range_values_query.reset();
+    range_values_query.bind(1, static_cast<int64_t>(first_rowid));
+    range_values_query.bind(2, static_cast<int64_t>(last_rowid));
+    while (range_values_query.executeStep()) {
+      // attack is attributed to the assignee, defense and speed to the
+      // reporter. Issues without assignee or reporter are not attributed
+      if (!range_values_query.getColumn(0).isNull()) {
+        range_values[range_values_query.getColumn(0).getString()]
+            .attack_value += range_values_query.getColumn(2).getUInt();
+      }
+      if (!range_values_query.getColumn(1).isNull()) {
+        UserValues& reporter_values =
+            range_values[range_values_query.getColumn(1).getString()];
+        reporter_values.defense_value +=
+            range_values_query.getColumn(3).getUInt();
+        reporter_values.speed_value +=
+            range_values_query.getColumn(4).getUInt();
+      }
+      digest += static_cast<std::uint64_t>(
+          range_values_query.getColumn(5).getInt64());
+    }
+
+    delete_user_values.reset();
+    delete_user_values.bind(1, static_cast<int64_t>(range_index));
+    delete_user_values.exec();
+
+    for (const auto& [user_identifier, values] : range_values) {
+      insert_user_values.reset();
+      insert_user_values.bind(1, static_cast<int64_t>(range_index));
+      insert_user_values.bind(2, user_identifier);
+      insert_user_values.bind(3, values.attack_value);
+      insert_user_values.bind(4, values.defense_value);
+      insert_user_values.bind(5, values.speed_value);
+      insert_user_values.exec();
+    }
+
+    if (range_values.empty()) {
+      delete_digest.reset();
+      delete_digest.bind(1, static_cast<int64_t>(range_index));
+      delete_digest.exec();
+    } else {
+      replace_digest.reset();
+      replace_digest.bind(1, static_cast<int64_t>(range_index));
+      replace_digest.bind(2, static_cast<int64_t>(digest));
+      replace_digest.exec();
+    }
+
+    ++aggregated_range_count;
+  }
+
+  // rows at the end of the table were deleted
+  for (const std::string& table_name :
+       {kRangeDigestTableName, kUserValueTableName}) {
+    SQLite::Statement delete_ranges(
+        *store_, "DELETE FROM " + table_name + " WHERE range_index > ?");
+    delete_ranges.bind(1, static_cast<int64_t>(last_range_index));
+    delete_ranges.exec();
+  }
+
+  SQLite::Statement metadata_statement(
+      *store_,
+      "INSERT OR REPLACE INTO " + kMetadataTableName + " VALUES (?, ?)");
+  auto store_metadata = [&](const std::string& name, const std::string& value) {
+    metadata_statement.reset();
+    metadata_statement.bind(1, name);
+    metadata_statement.bind(2, value);
+    metadata_statement.exec();
+  };
+  for (const auto& [name, value] : metadata) {
+    store_metadata(name, value);
+  }
+  store_metadata("watermark", std::to_string(max_rowid));
+
+  transaction.commit();
+
+  return aggregated_range_count;
+}
+
+TechnicalDebtDatasetAggregateStore::UserValues
+TechnicalDebtDatasetAggregateStore::getUserValues(
+    const std::string& user_identifier) {
+  openStore();
+
+  SQLite::Statement user_values_query(
+      *store_, "SELECT SUM(attack), SUM(defense), SUM(speed) FROM " +
+                   kUserValueTableName + " WHERE user = ?");
+  user_values_query.bind(1, user_identifier);
+
+  UserValues values;
+  if (user_values_query.executeStep()) {
+    // SUM() is NULL, if the user has no values. getUInt() returns 0 for NULL
+    values.attack_value = user_values_query.getColumn(0).getUInt();
+    values.defense_value = user_values_query.getColumn(1).getUInt();
+    values.speed_value = user_values_query.getColumn(2).getUInt();
+  }
+  return values;
+}
+
+void TechnicalDebtDatasetAggregateStore::registerDigestFunction(
+    SQLite::Database& db) {
+  const int result = sqlite3_create_function_v2(
+      db.getHandle(), kDigestFunctionName.c_str(), -1,
+      SQLITE_UTF8 | SQLITE_DETERMINISTIC, nullptr, nullptr, &digestStep,
+      &digestFinal, nullptr);
+  if (result != SQLITE_OK) {
+    throw std::runtime_error("Cannot register the digest function: " +
+                             std::string(sqlite3_errstr(result)));
+  }
+}
+
+void TechnicalDebtDatasetAggregateStore::openStore() {
+  if (store_ != nullptr) {
+    return;
+  }
+
+  auto store = std::make_unique<SQLite::Database>(
+      path_to_store_.string(), SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+  createStoreTables(*store);
+  store_ = std::move(store);
+}
+
+const int TechnicalDebtDatasetAggregateStore::kFormatVersion;
+const long long TechnicalDebtDatasetAggregateStore::kRangeSize;
+
+const std::string
+    TechnicalDebtDatasetAggregateStore::kAggregateStoreFileExtension =
+        ".tdmon-aggregates";
+const std::string TechnicalDebtDatasetAggregateStore::kMetadataTableName =
+    "TDMON_AGGREGATE_METADATA";
+const std::string TechnicalDebtDatasetAggregateStore::kDigestFunctionName =
+    "tdmon_digest";
+
+}  // namespace tdmon
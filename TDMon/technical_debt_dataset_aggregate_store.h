@@ -0,0 +1,193 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <TDMon/issue_filter.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <stop_token>
+#include <string>
+
+namespace SQLite {
+class Database;
+}  // namespace SQLite
+
+namespace tdmon {
+/**
+ * @brief A sqlite database, stored next to the technical debt dataset, which
+ * contains the partial attack, defense and speed values of all users, so they
+ * can be updated incrementally when the dataset changes.
+ *
+ * The issues table is split into ranges of kRangeSize rowids. For every range,
+ * the store keeps the partial values of each user appearing in it, and a
+ * digest of the rows of the range. The digest is the sum of a hash of each row
+ * (over the rowid and all columns the values depend on), calculated by the
+ * sqlite aggregate function kDigestFunctionName. The store also keeps the
+ * highest rowid seen (the watermark).
+ *
+ * When refreshing, ranges above the watermark only contain new rows and are
+ * aggregated directly. The digests of all other ranges are recalculated and
+ * compared, and only ranges with a different digest (because rows were
+ * updated, inserted or deleted) are aggregated again. So apart from the digest
+ * pass, the cost of a refresh is proportional to the number of changed rows,
+ * not to the size of the table. If the dataset file did not change at all since
+ * the last refresh, nothing is read.
+ *
+ * The values are calculated for one IssueFilter. Refreshing with another filter
+ * recalculates all ranges.
+ */
+class TechnicalDebtDatasetAggregateStore {
+ public:
+  /**
+   * @brief The extension appended to the dataset path to get the store path
+   */
+  static const std::string kAggregateStoreFileExtension;
+
+  /**
+   * @brief The name of the table inside the store storing its metadata
+   */
+  static const std::string kMetadataTableName;
+
+  /**
+   * @brief The name of the sqlite aggregate function calculating the digest of
+   * a range of rows
+   */
+  static const std::string kDigestFunctionName;
+
+  /**
+   * @brief The version of the store layout. Stores with a different version
+   * are recalculated.
+   */
+  static const int kFormatVersion = 1;
+
+  /**
+   * @brief The number of rowids per range
+   */
+  static const long long kRangeSize = 4096;
+
+  /**
+   * @brief Called with the progress of a refresh between 0 and 1
+   */
+  using ProgressCallback = std::function<void(float)>;
+
+  /**
+   * @brief The attack, defense and speed values of one user
+   */
+  struct UserValues {
+    /**
+     * @brief The number of resolved issues assigned to the user
+     */
+    unsigned int attack_value = 0;
+
+    /**
+     * @brief The number of issues reported by the user
+     */
+    unsigned int defense_value = 0;
+
+    /**
+     * @brief The sum of the watch counts of the issues reported by the user
+     */
+    unsigned int speed_value = 0;
+  };
+
+  /**
+   * @brief The constructor.
+   * @param path_to_dataset The path to the technical debt dataset on disk
+   * @param table_name The name of the issues table
+   */
+  TechnicalDebtDatasetAggregateStore(std::filesystem::path path_to_dataset,
+                                     std::string table_name);
+
+  /**
+   * @brief The destructor. Closes the store, if it is open.
+   */
+  ~TechnicalDebtDatasetAggregateStore();
+
+  /**
+   * @brief Get the path of the store on disk
+   * @return The path
+   */
+  const std::filesystem::path& getPath() const;
+
+  /**
+   * @brief Bring the store up-to-date with the dataset, recalculating only the
+   * ranges that changed since the last refresh. Throws, if the dataset cannot
+   * be read or the store cannot be written. The store is updated in a single
+   * transaction, so a failed refresh leaves the previous state behind.
+   * @param issue_filter Specifies which issues to use
+   * @param stop_token Interrupts the refresh, once a stop is requested. The
+   * interrupted refresh throws and leaves the previous state behind.
+   * @param progress_callback Called after each range. May be empty.
+   * @return The number of ranges that were aggregated
+   */
+  std::size_t refresh(const IssueFilter& issue_filter,
+                      const std::stop_token& stop_token = std::stop_token(),
+                      const ProgressCallback& progress_callback = nullptr);
+
+  /**
+   * @brief Get the values of a user, as of the last refresh. Users which do not
+   * appear in the dataset get all values set to 0.
+   * @param user_identifier The user-identifier
+   * @return The values of the user
+   */
+  UserValues getUserValues(const std::string& user_identifier);
+
+  /**
+   * @brief Register the digest function (kDigestFunctionName) on a database
+   * connection
+   * @param db The database connection
+   */
+  static void registerDigestFunction(SQLite::Database& db);
+
+ private:
+  /**
+   * @brief Open the store and create its tables, if it is not open yet
+   */
+  void openStore();
+
+  /**
+   * @brief The path to the technical debt dataset on disk
+   */
+  std::filesystem::path path_to_dataset_;
+
+  /**
+   * @brief The path to the store on disk
+   */
+  std::filesystem::path path_to_store_;
+
+  /**
+   * @brief The name of the issues table in the dataset
+   */
+  std::string table_name_;
+
+  /**
+   * @brief The connection to the store. Opened on first use.
+   */
+  std::unique_ptr<SQLite::Database> store_;
+};
+}  // namespace tdmon
@@ -0,0 +1,206 @@
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/technical_debt_dataset_aggregate_store.h>
+#include <TDMon/technical_debt_dataset_generator.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace tdmon {
+const std::string kAggregateStoreTestDbPath = "./aggregate_store_test.db";
+
+/**
+ * @brief The number of issues in the test dataset. Spans five ranges.
+ */
+const std::uint64_t kAggregateStoreTestIssueCount = 20000;
+
+/**
+ * @brief Helper function. Generate the test dataset and remove the store of a
+ * previous test run.
+ */
+void createAggregateStoreTestDb() {
+  TechnicalDebtDatasetGenerator::Options options;
+  options.issue_count = kAggregateStoreTestIssueCount;
+  options.user_count = 50;
+  TechnicalDebtDatasetGenerator(options).generate(kAggregateStoreTestDbPath);
+
+  std::filesystem::remove(kAggregateStoreTestDbPath +
+                          TechnicalDebtDatasetAggregateStore::
+                              kAggregateStoreFileExtension);
+}
+
+/**
+ * @brief Helper function. Calculate the values of a user by querying the test
+ * dataset directly, using all issues of the given type.
+ * @param user_identifier The user-identifier
+ * @param issue_type The issue type
+ * @return The values of the user
+ */
+TechnicalDebtDatasetAggregateStore::UserValues queryExpectedUserValues(
+    const std::string& user_identifier, const std::string& issue_type) {
+  SQLite::Database db(kAggregateStoreTestDbPath);
+  SQLite::Statement query(
+      db,
+      "SELECT COUNT(CASE WHEN assignee=?1 AND resolution_date IS NOT '' THEN "
+      "key END), COUNT(CASE WHEN reporter=?1 THEN key END), SUM(CASE WHEN "
+      "reporter=?1 THEN watch_count END) FROM JIRA_ISSUES WHERE type=?2");
+  query.bind(1, user_identifier);
+  query.bind(2, issue_type);
+  query.executeStep();
+
+  TechnicalDebtDatasetAggregateStore::UserValues values;
+  values.attack_value = query.getColumn(0).getUInt();
+  values.defense_value = query.getColumn(1).getUInt();
+  values.speed_value = query.getColumn(2).getUInt();
+  return values;
+}
+
+/**
+ * @brief Helper function. Check that the store contains the same values as the
+ * dataset for some users.
+ * @param store The store
+ * @param issue_type The issue type the store was refreshed with
+ */
+void expectStoreMatchesDataset(TechnicalDebtDatasetAggregateStore& store,
+                               const std::string& issue_type) {
+  for (const std::string user_identifier : {"user1", "user2", "user17"}) {
+    const TechnicalDebtDatasetAggregateStore::UserValues expected_values =
+        queryExpectedUserValues(user_identifier, issue_type);
+    const TechnicalDebtDatasetAggregateStore::UserValues values =
+        store.getUserValues(user_identifier);
+    EXPECT_EQ(values.attack_value, expected_values.attack_value);
+    EXPECT_EQ(values.defense_value, expected_values.defense_value);
+    EXPECT_EQ(values.speed_value, expected_values.speed_value);
+  }
+}
+
+TEST(TechnicalDebtDatasetAggregateStoreTest, AggregatesOnlyChangedRanges) {
+  createAggregateStoreTestDb();
+
+  IssueFilter issue_filter;
+  issue_filter.issue_types = {"Bug"};
+
+  TechnicalDebtDatasetAggregateStore store(kAggregateStoreTestDbPath,
+                                           "JIRA_ISSUES");
+  EXPECT_EQ(store.refresh(issue_filter), 5);
+  expectStoreMatchesDataset(store, "Bug");
+
+  // nothing changed
+  EXPECT_EQ(store.refresh(issue_filter), 0);
+
+  // new rows are appended to the last range
+  {
+    SQLite::Database db(kAggregateStoreTestDbPath, SQLite::OPEN_READWRITE);
+    db.exec(
+        "INSERT INTO JIRA_ISSUES (KEY, PROJECT_ID, TYPE, CREATION_DATE, "
+        "RESOLUTION_DATE, ASSIGNEE, REPORTER, WATCH_COUNT) VALUES "
+        "('NEW-1','NEW','Bug','2020-01-01','2020-01-02','user1','user2',7),"
+        "('NEW-2','NEW','Bug','2020-01-01','','user2','user1',3)");
+  }
+  EXPECT_EQ(store.refresh(issue_filter), 1);
+  expectStoreMatchesDataset(store, "Bug");
+
+  // an existing row in the second range is updated
+  {
+    SQLite::Database db(kAggregateStoreTestDbPath, SQLite::OPEN_READWRITE);
+    db.exec(
+        "UPDATE JIRA_ISSUES SET TYPE='Bug', ASSIGNEE='user17', "
+        "RESOLUTION_DATE='2020-01-01', WATCH_COUNT=100 WHERE rowid=5000");
+  }
+  EXPECT_EQ(store.refresh(issue_filter), 1);
+  expectStoreMatchesDataset(store, "Bug");
+
+  // rows of the first range are deleted
+  {
+    SQLite::Database db(kAggregateStoreTestDbPath, SQLite::OPEN_READWRITE);
+    db.exec("DELETE FROM JIRA_ISSUES WHERE rowid < 100");
+  }
+  EXPECT_EQ(store.refresh(issue_filter), 1);
+  expectStoreMatchesDataset(store, "Bug");
+}
+
+TEST(TechnicalDebtDatasetAggregateStoreTest,
+     ReportsProgressAndCancelsRefresh) {
+  createAggregateStoreTestDb();
+
+  IssueFilter issue_filter;
+  issue_filter.issue_types = {"Bug"};
+
+  TechnicalDebtDatasetAggregateStore store(kAggregateStoreTestDbPath,
+                                           "JIRA_ISSUES");
+
+  // cancelled within the third of five ranges
+  std::stop_source stop_source;
+  std::vector<float> reported_progress;
+  EXPECT_THROW(store.refresh(issue_filter, stop_source.get_token(),
+                             [&](float progress) {
+                               reported_progress.push_back(progress);
+                               if (reported_progress.size() == 3) {
+                                 stop_source.request_stop();
+                               }
+                             }),
+               std::runtime_error);
+  ASSERT_EQ(reported_progress.size(), 3);
+  EXPECT_FLOAT_EQ(reported_progress.front(), 0.0f);
+  EXPECT_TRUE(std::is_sorted(reported_progress.begin(),
+                             reported_progress.end()));
+
+  // nothing of the cancelled refresh was kept
+  EXPECT_EQ(store.refresh(issue_filter), 5);
+  expectStoreMatchesDataset(store, "Bug");
+}
+
+TEST(TechnicalDebtDatasetAggregateStoreTest, RecalculatesForOtherFilter) {
+  createAggregateStoreTestDb();
+
+  IssueFilter issue_filter;
+  issue_filter.issue_types = {"Bug"};
+
+  TechnicalDebtDatasetAggregateStore store(kAggregateStoreTestDbPath,
+                                           "JIRA_ISSUES");
+  EXPECT_EQ(store.refresh(issue_filter), 5);
+
+  issue_filter.issue_types = {"Improvement"};
+  EXPECT_EQ(store.refresh(issue_filter), 5);
+  expectStoreMatchesDataset(store, "Improvement");
+
+  // the store is kept on disk
+  TechnicalDebtDatasetAggregateStore reopened_store(kAggregateStoreTestDbPath,
+                                                    "JIRA_ISSUES");
+  EXPECT_EQ(reopened_store.refresh(issue_filter), 0);
+  expectStoreMatchesDataset(reopened_store, "Improvement");
+}
+
+TEST(TechnicalDebtDatasetAggregateStoreTest, DigestDependsOnRowContent) {
+  SQLite::Database db(":memory:", SQLite::OPEN_READWRITE);
+  TechnicalDebtDatasetAggregateStore::registerDigestFunction(db);
+  db.exec(
+      "CREATE TABLE T (A, B); INSERT INTO T VALUES (1, 'x'), (2, NULL), "
+      "(3, '')");
+
+  auto query_digest = [&db](const std::string& sql) {
+    SQLite::Statement query(db, sql);
+    query.executeStep();
+    return query.getColumn(0).getInt64();
+  };
+
+  const long long digest = query_digest("SELECT tdmon_digest(A, B) FROM T");
+  // independent of the order of the rows
+  EXPECT_EQ(digest, query_digest("SELECT tdmon_digest(A, B) FROM (SELECT * "
+                                 "FROM T ORDER BY A DESC)"));
+  // NULL and '' differ
+  EXPECT_NE(query_digest("SELECT tdmon_digest(B) FROM T WHERE A = 2"),
+            query_digest("SELECT tdmon_digest(B) FROM T WHERE A = 3"));
+  // no rows
+  EXPECT_EQ(query_digest("SELECT tdmon_digest(A, B) FROM T WHERE A > 3"), 0);
+
+  db.exec("UPDATE T SET B = 'y' WHERE A = 1");
+  EXPECT_NE(digest, query_digest("SELECT tdmon_digest(A, B) FROM T"));
+}
+}  // namespace tdmon
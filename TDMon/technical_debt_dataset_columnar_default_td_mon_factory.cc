@@ -0,0 +1,174 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#include <TDMon/default_td_mon.h>
+#include <TDMon/issue_filter.h>
+#include <TDMon/technical_debt_dataset_columnar_default_td_mon_factory.h>
+
+#include <iostream>
+
+namespace tdmon {
+std::unique_ptr<TdMon>
+TechnicalDebtDatasetColumnarDefaultTdMonFactory::create() {
+  std::scoped_lock lock(mutex_);
+
+  loadIssuesIfChanged();
+
+  const std::uint32_t user_id = issue_store_.findUserId(user_identifier_);
+  const ColumnarIssueStore::IssueTypeMask issue_types =
+      issue_store_.createIssueTypeMask(kIssueTypesToParse);
+
+  return std::make_unique<DefaultTdMon>(
+      issue_store_.countResolvedIssuesAssignedTo(user_id, issue_types),
+      issue_store_.countIssuesReportedBy(user_id, issue_types),
+      static_cast<unsigned int>(
+          issue_store_.sumWatchCountsOfIssuesReportedBy(user_id, issue_types)));
+}
+
+std::optional<DataSourceFingerprint>
+TechnicalDebtDatasetColumnarDefaultTdMonFactory::getDataSourceFingerprint() {
+  std::scoped_lock lock(mutex_);
+
+  try {
+    // only the issue types can be configured
+    IssueFilter issue_filter;
+    issue_filter.issue_types = kIssueTypesToParse;
+    return DataSourceFingerprint::createForFile(path_to_db_, user_identifier_,
+                                                issue_filter);
+  } catch (const std::exception&) {
+    // without a readable file, there is nothing to compare
+    return std::nullopt;
+  }
+}
+
+void TechnicalDebtDatasetColumnarDefaultTdMonFactory::connectToDataSources() {
+  std::scoped_lock lock(mutex_);
+
+  // this step succeeds, if the issues table can be read from the database on
+  // disk
+  loadIssues();
+
+  // this statement is not reached, if the above statement throws an exception
+  connected_ = true;
+}
+
+bool TechnicalDebtDatasetColumnarDefaultTdMonFactory::
+    isRequiredDataAccessInformationAvailable() {
+  std::scoped_lock lock(mutex_);
+  return !path_to_db_.empty() && user_identifier_ != "";
+}
+
+bool TechnicalDebtDatasetColumnarDefaultTdMonFactory::
+    isConnectedToDataSources() {
+  std::scoped_lock lock(mutex_);
+  return connected_;
+}
+
+void TechnicalDebtDatasetColumnarDefaultTdMonFactory::setUserIdentifier(
+    std::string identifier) {
+  std::scoped_lock lock(mutex_);
+  user_identifier_ = std::move(identifier);
+}
+
+void TechnicalDebtDatasetColumnarDefaultTdMonFactory::setDatabasePath(
+    std::filesystem::path path) {
+  std::scoped_lock lock(mutex_);
+
+  if (path != path_to_db_) {
+    // the loaded issues belong to the old database
+    issues_loaded_ = false;
+    connected_ = false;
+  }
+  path_to_db_ = std::move(path);
+}
+
+void TechnicalDebtDatasetColumnarDefaultTdMonFactory::setSnapshotEnabled(
+    bool enabled) {
+  std::scoped_lock lock(mutex_);
+  snapshot_enabled_ = enabled;
+}
+
+bool TechnicalDebtDatasetColumnarDefaultTdMonFactory::isSnapshotEnabled()
+    const {
+  std::scoped_lock lock(mutex_);
+  return snapshot_enabled_;
+}
+
+std::filesystem::path
+TechnicalDebtDatasetColumnarDefaultTdMonFactory::getSnapshotPath() const {
+  std::scoped_lock lock(mutex_);
+  std::filesystem::path snapshot_path = path_to_db_;
+  snapshot_path += kSnapshotFileExtension;
+  return snapshot_path;
+}
+
+void TechnicalDebtDatasetColumnarDefaultTdMonFactory::loadIssuesIfChanged() {
+  if (!issues_loaded_ ||
+      DatabaseFileState::read(path_to_db_) != db_file_state_) {
+    loadIssues();
+  }
+}
+
+void TechnicalDebtDatasetColumnarDefaultTdMonFactory::loadIssues() {
+  issues_loaded_ = false;
+
+  // read the state before loading, so changes made while loading are detected
+  // on the next call
+  const DatabaseFileState db_file_state = DatabaseFileState::read(path_to_db_);
+
+  std::filesystem::path snapshot_path = path_to_db_;
+  snapshot_path += kSnapshotFileExtension;
+
+  if (!snapshot_enabled_ ||
+      !issue_store_.mapSnapshot(snapshot_path, db_file_state)) {
+    issue_store_.loadFromDatabase(path_to_db_, kTableToParse);
+
+    if (snapshot_enabled_) {
+      try {
+        issue_store_.writeSnapshot(snapshot_path, db_file_state);
+      } catch (const std::exception& e) {
+        // the snapshot is optional, it only speeds up the next start
+        std::cout << "cannot write snapshot of the dataset. Reason: "
+                  << e.what() << std::endl;
+      }
+    }
+  }
+
+  db_file_state_ = db_file_state;
+  issues_loaded_ = true;
+}
+
+const std::vector<std::string>
+    TechnicalDebtDatasetColumnarDefaultTdMonFactory::kIssueTypesToParse =
+        IssueFilter::createDefault().issue_types;
+
+const std::string
+    TechnicalDebtDatasetColumnarDefaultTdMonFactory::kTableToParse =
+        "JIRA_ISSUES";
+
+const std::string
+    TechnicalDebtDatasetColumnarDefaultTdMonFactory::kSnapshotFileExtension =
+        ".tdmon-snapshot";
+
+}  // namespace tdmon
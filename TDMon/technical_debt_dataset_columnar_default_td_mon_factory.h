@@ -0,0 +1,211 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <TDMon/columnar_issue_store.h>
+#include <TDMon/connectable_to_data_sources.h>
+#include <TDMon/database_file_state.h>
+#include <TDMon/td_mon_factory.h>
+#include <TDMon/technical_debt_dataset_access_information_container.h>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief A td-mon factory which can be connected to the technical debt dataset
+ * and answers all queries from an in-memory ColumnarIssueStore.
+ *
+ * The issues table is loaded into the store once, when connecting to the data
+ * sources (or on first use), and reloaded only if the database file on disk
+ * changes. Afterwards, the attack, defense and speed values of any user are
+ * calculated in memory, without touching the database. This makes switching
+ * between users (see setUserIdentifier()) cheap.
+ *
+ * By default, the loaded store is also written to a binary snapshot file next
+ * to the dataset (`<dataset>.tdmon-snapshot`). On the next start, the snapshot
+ * is mapped into memory instead of loading the dataset again, as long as the
+ * dataset did not change.
+ *
+ * All public member functions are thread-safe.
+ */
+class TechnicalDebtDatasetColumnarDefaultTdMonFactory
+    : public TdMonFactory,
+      public ConnectableToDataSources,
+      public TechnicalDebtDatasetAccessInformationContainer {
+ public:
+  /**
+   * @brief The issue types to use when calculating the values of a td-mon.
+   * Other issue types (for example 'bug', because it is not TD) are filtered
+   * out. Matches the issue types of IssueFilter::createDefault().
+   */
+  static const std::vector<std::string> kIssueTypesToParse;
+
+  /**
+   * @brief The table name to load the issues from
+   */
+  static const std::string kTableToParse;
+
+  /**
+   * @brief The extension appended to the path of the dataset to get the path
+   * of the snapshot file
+   */
+  static const std::string kSnapshotFileExtension;
+
+  // Inherited via TdMonFactory
+
+  /**
+   * @brief Create the td-mon of the current user. Loads the issues into memory
+   * first, if they are not loaded yet or the database file changed.
+   * @return The td-mon
+   */
+  std::unique_ptr<TdMon> create() override;
+
+  /**
+   * @brief Get the fingerprint of the dataset file, the user-identifier and the
+   * issue types used. Only reads the state of the file, not its content.
+   * @return The fingerprint. Empty, if the file cannot be read.
+   */
+  std::optional<DataSourceFingerprint> getDataSourceFingerprint() override;
+
+  // Inherited via ConnectableToDataSources
+
+  /**
+   * @brief Loads the issues table from the sqlite database on disk into
+   * memory. Calling this again forces the issues to be reloaded.
+   */
+  void connectToDataSources() override;
+
+  /**
+   * @brief Get whether the path to the sqlite database, as well as, the
+   * required user-identifier for parsing the databse are available
+   * @return true, if the required information is available
+   */
+  bool isRequiredDataAccessInformationAvailable() override;
+
+  /**
+   * @brief Returns true, if loading the issues succeeded in
+   * connectToDataSources().
+   * @return true, if connectToDataSources() was completed successfully before.
+   */
+  bool isConnectedToDataSources() override;
+
+  // Inherited via TechnicalDebtDatasetAccessInformationContainer
+
+  /**
+   * @brief Set the user identifier whose issues to use when parsing the
+   * technical debt dataset.
+   * @param identifier The user-identifier string
+   */
+  void setUserIdentifier(std::string identifier) override;
+
+  /**
+   * @brief Set the path to the technical debt dataset sqlite database on disk.
+   * Discards the loaded issues, if the path differs from the current one.
+   * @param path The path to the sqlite databse.
+   */
+  void setDatabasePath(std::filesystem::path path) override;
+
+  /**
+   * @brief Enable or disable the snapshot file. Enabled by default. If
+   * disabled, the issues are always loaded from the dataset and no snapshot is
+   * written.
+   * @param enabled true, to use the snapshot file
+   */
+  void setSnapshotEnabled(bool enabled);
+
+  /**
+   * @brief Get whether the snapshot file is used
+   * @return true, if the snapshot file is enabled
+   */
+  bool isSnapshotEnabled() const;
+
+  /**
+   * @brief Get the path of the snapshot file of the current dataset
+   * @return The path of the snapshot file
+   */
+  std::filesystem::path getSnapshotPath() const;
+
+ private:
+  /**
+   * @brief Load the issues into the store, if they are not loaded yet, or if
+   * the database file on disk changed since they were loaded.
+   */
+  void loadIssuesIfChanged();
+
+  /**
+   * @brief Load the issues into the store. Maps the snapshot file, if it is
+   * enabled and up to date. Otherwise, loads the dataset and rewrites the
+   * snapshot file.
+   */
+  void loadIssues();
+
+  /**
+   * @brief Guards all members below. Locked by every public member function.
+   */
+  mutable std::mutex mutex_;
+
+  /**
+   * @brief The path to the sqlite database on disk
+   */
+  std::filesystem::path path_to_db_;
+
+  /**
+   * @brief The user-identifier string whose issues to use when parsing the
+   * technical debt dataset.
+   */
+  std::string user_identifier_;
+
+  /**
+   * @brief True, if loading the issues succeeded in connectToDataSources
+   */
+  bool connected_ = false;
+
+  /**
+   * @brief True, if the store contains the issues of the database at
+   * path_to_db_
+   */
+  bool issues_loaded_ = false;
+
+  /**
+   * @brief True, if the snapshot file is used
+   */
+  bool snapshot_enabled_ = true;
+
+  /**
+   * @brief The state of the database file when the issues were loaded. Used to
+   * detect changes to the file on disk.
+   */
+  DatabaseFileState db_file_state_;
+
+  /**
+   * @brief The issues, loaded into memory
+   */
+  ColumnarIssueStore issue_store_;
+};
+}  // namespace tdmon
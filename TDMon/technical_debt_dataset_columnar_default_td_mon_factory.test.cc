@@ -0,0 +1,123 @@
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/technical_debt_dataset_columnar_default_td_mon_factory.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief The path to the database containing test data for the columnar
+ * factory
+ */
+const std::string kColumnarFactoryTestDbPath = "./columnar_factory_test.db";
+
+/**
+ * @brief Helper function. Create the database containing test data for the
+ * columnar factory. Uses the same data as the tests of
+ * TechnicalDebtDatasetConnectableDefaultTdMonFactory.
+ */
+void createColumnarFactoryTestDb() {
+  std::filesystem::remove(kColumnarFactoryTestDbPath);
+
+  SQLite::Database db(kColumnarFactoryTestDbPath,
+                      SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+
+  db.exec(
+      "CREATE TABLE JIRA_ISSUES (KEY INTEGER NOT NULL, TYPE TEXT NOT NULL, "
+      "ASSIGNEE TEXT NOT NULL, RESOLUTION_DATE TEXT NOT NULL, REPORTER TEXT "
+      "NOT NULL, WATCH_COUNT INTEGER NOT NULL);"
+      "INSERT INTO JIRA_ISSUES VALUES (1,'Test','Human1','','Human1',1);"
+      "INSERT INTO JIRA_ISSUES VALUES "
+      "(2,'Documentation','Human1','2000-01-01','Human1',1);"
+      "INSERT INTO JIRA_ISSUES VALUES "
+      "(3,'Test','Human2','2000-01-01','Human1',1);"
+      "INSERT INTO JIRA_ISSUES VALUES "
+      "(4,'Test','Human1','2000-01-01','Human2',1);"
+      "INSERT INTO JIRA_ISSUES VALUES "
+      "(5,'Test','Human3','2000-01-01','Human1',5);"
+      "INSERT INTO JIRA_ISSUES VALUES "
+      "(6,'Other','Human1','2000-01-01','Human1',100);");
+}
+
+/**
+ * @brief Test, if the values of different users are calculated correctly from
+ * memory, and if changes to the database are picked up
+ */
+TEST(TechnicalDebtDatasetColumnarDefaultTdMonFactory, ParsesDataCorrectly) {
+  createColumnarFactoryTestDb();
+
+  TechnicalDebtDatasetColumnarDefaultTdMonFactory factory;
+  factory.setDatabasePath(kColumnarFactoryTestDbPath);
+  factory.setUserIdentifier("Human1");
+  EXPECT_TRUE(factory.isRequiredDataAccessInformationAvailable());
+
+  factory.connectToDataSources();
+  EXPECT_TRUE(factory.isConnectedToDataSources());
+
+  std::unique_ptr<TdMon> td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 2);
+  EXPECT_EQ(td_mon->getDefenseValue(), 4);
+  EXPECT_EQ(td_mon->getSpeedValue(), 8);
+
+  factory.setUserIdentifier("Human2");
+  td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 1);
+  EXPECT_EQ(td_mon->getDefenseValue(), 1);
+  EXPECT_EQ(td_mon->getSpeedValue(), 1);
+
+  factory.setUserIdentifier("Nobody");
+  td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 0);
+  EXPECT_EQ(td_mon->getDefenseValue(), 0);
+  EXPECT_EQ(td_mon->getSpeedValue(), 0);
+
+  {
+    SQLite::Database db(kColumnarFactoryTestDbPath, SQLite::OPEN_READWRITE);
+    db.exec(
+        "INSERT INTO JIRA_ISSUES VALUES "
+        "(7,'Test','Nobody','2000-01-01','Nobody',3)");
+  }
+  td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 1);
+  EXPECT_EQ(td_mon->getDefenseValue(), 1);
+  EXPECT_EQ(td_mon->getSpeedValue(), 3);
+
+  std::filesystem::remove(factory.getSnapshotPath());
+}
+
+/**
+ * @brief Test, if a snapshot is written next to the dataset, and if another
+ * factory creates the same td-mon from it
+ */
+TEST(TechnicalDebtDatasetColumnarDefaultTdMonFactory, UsesSnapshot) {
+  createColumnarFactoryTestDb();
+
+  TechnicalDebtDatasetColumnarDefaultTdMonFactory factory;
+  factory.setDatabasePath(kColumnarFactoryTestDbPath);
+  factory.setUserIdentifier("Human1");
+  std::filesystem::remove(factory.getSnapshotPath());
+  factory.connectToDataSources();
+  EXPECT_TRUE(std::filesystem::exists(factory.getSnapshotPath()));
+
+  TechnicalDebtDatasetColumnarDefaultTdMonFactory second_factory;
+  second_factory.setDatabasePath(kColumnarFactoryTestDbPath);
+  second_factory.setUserIdentifier("Human1");
+  std::unique_ptr<TdMon> td_mon = second_factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 2);
+  EXPECT_EQ(td_mon->getDefenseValue(), 4);
+  EXPECT_EQ(td_mon->getSpeedValue(), 8);
+
+  std::filesystem::remove(factory.getSnapshotPath());
+
+  // without the snapshot, none is written
+  second_factory.setSnapshotEnabled(false);
+  EXPECT_FALSE(second_factory.isSnapshotEnabled());
+  second_factory.connectToDataSources();
+  EXPECT_FALSE(std::filesystem::exists(second_factory.getSnapshotPath()));
+}
+}  // namespace tdmon
@@ -0,0 +1,55 @@
+#include <TDMon/technical_debt_dataset_connectable_default_td_mon_factory.h>
+#include <TDMon/technical_debt_dataset_generator.h>
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief Helper function. Generate a dataset with the given number of issues
+ * for benchmarking, if it does not exist yet. The issues are spread over 100
+ * users.
+ * @param issue_count The number of issues
+ * @return The path to the dataset
+ */
+std::string createFactoryBenchmarkDb(long long issue_count) {
+  const std::string path =
+      "./factory_benchmark_" + std::to_string(issue_count) + ".db";
+  if (std::filesystem::exists(path)) {
+    return path;
+  }
+
+  TechnicalDebtDatasetGenerator::Options options;
+  options.issue_count = static_cast<std::uint64_t>(issue_count);
+  options.user_count = 100;
+  TechnicalDebtDatasetGenerator(options).generate(path);
+
+  return path;
+}
+
+/**
+ * @brief Benchmark creating a td-mon. The first argument is the number of
+ * issues in the dataset, the second whether the sidecar index is used.
+ */
+void BM_TechnicalDebtDatasetConnectableDefaultTdMonFactoryCreate(
+    benchmark::State& state) {
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(createFactoryBenchmarkDb(state.range(0)));
+  // the fifth most active user
+  factory.setUserIdentifier(TechnicalDebtDatasetGenerator::kUserPrefix + "5");
+  factory.setSidecarIndexEnabled(state.range(1) != 0);
+
+  // opening the connection (and building the sidecar) is not measured
+  factory.connectToDataSources();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(factory.create());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TechnicalDebtDatasetConnectableDefaultTdMonFactoryCreate)
+    ->ArgsProduct({{1000, 10000, 100000, 1000000}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+}  // namespace tdmon
@@ -26,79 +26,117 @@
                                // https://github.com/SRombauts/SQLiteCpp/issues/432
 #include <SQLiteCpp/SQLiteCpp.h>
 #include <TDMon/default_td_mon.h>
+#include <TDMon/scoped_progress_handler.h>
+#include <TDMon/technical_debt_dataset_aggregate_store.h>
 #include <TDMon/technical_debt_dataset_connectable_default_td_mon_factory.h>
+#include <TDMon/technical_debt_dataset_sidecar_index.h>
+#include <TDMon/trace_recorder.h>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <vector>
 
 namespace tdmon {
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::
+    TechnicalDebtDatasetConnectableDefaultTdMonFactory() = default;
+
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::
+    ~TechnicalDebtDatasetConnectableDefaultTdMonFactory() {
+  closeDatabase();
+}
+
 std::unique_ptr<TdMon>
 TechnicalDebtDatasetConnectableDefaultTdMonFactory::create() {
-  SQLite::Database db(path_to_db_.string(), SQLite::OPEN_READONLY);
+  return createWithProgress(std::stop_token(), nullptr);
+}
 
-  unsigned int attack_value = 0;
-  unsigned int defense_value = 0;
-  unsigned int speed_value = 0;
+std::future<std::unique_ptr<TdMon>>
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::createAsync(
+    std::stop_token stop_token, ProgressCallback progress_callback) {
+  return std::async(std::launch::async,
+                    [this, stop_token = std::move(stop_token),
+                     progress_callback = std::move(progress_callback)]() {
+                      return createWithProgress(stop_token, progress_callback);
+                    });
+}
 
-  // Calculate attack value
+std::optional<DataSourceFingerprint>
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::getDataSourceFingerprint() {
+  // mutex_ is held for the whole creation of a td-mon, so only the settings
+  // are copied. Reading the file state does not need any lock.
+  std::filesystem::path path_to_db;
+  std::string user_identifier;
+  IssueFilter issue_filter;
   {
-    SQLite::Statement attack_query(
-        db, "SELECT COUNT(key) FROM " + kTableToParse + " WHERE " +
-                kCategoriesToParse +
-                " AND assignee=? AND resolution_date IS NOT ''");
-    // bind the chosen user_identifier to the db query
-    attack_query.bind(1, user_identifier_);
-
-    // the query only produces one result, so the loop is only entered once
-    while (attack_query.executeStep()) {
-      int count = attack_query.getColumn(0);
-      attack_value = count;
-    }
+    std::scoped_lock settings_lock(settings_mutex_);
+    path_to_db = path_to_db_;
+    user_identifier = user_identifier_;
+    issue_filter = issue_filter_;
   }
 
-  // Calculate defense value
-  {
-    SQLite::Statement defense_query(
-        db, "SELECT COUNT(key) FROM " + kTableToParse + " WHERE " +
-                kCategoriesToParse + "AND reporter=?");
-    // bind the chosen user_identifier to the db query
-    defense_query.bind(1, user_identifier_);
-
-    // the query only produces one result, so the loop is only entered once
-    while (defense_query.executeStep()) {
-      int count = defense_query.getColumn(0);
-      defense_value = count;
-    }
+  try {
+    return DataSourceFingerprint::createForFile(path_to_db, user_identifier,
+                                                issue_filter);
+  } catch (const std::exception&) {
+    // without a readable file, there is nothing to compare
+    return std::nullopt;
   }
+}
 
-  // Calculate speed value
-  {
-    SQLite::Statement speed_query(
-        db, "SELECT SUM(watch_count) FROM " + kTableToParse + " WHERE " +
-                kCategoriesToParse + " AND reporter=?");
-    // bind the chosen user_identifier to the db query
-    speed_query.bind(1, user_identifier_);
-
-    // the query only produces one result, so the loop is only entered once
-    while (speed_query.executeStep()) {
-      int count = speed_query.getColumn(0);
-      speed_value = count;
+std::map<std::string, std::unique_ptr<TdMon>>
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::createAll() {
+  std::scoped_lock lock(mutex_);
+
+  std::map<std::string, std::unique_ptr<TdMon>> td_mons;
+
+  for (const auto& [user_identifier, values] : calculateValuesForAllUsers()) {
+    td_mons.emplace(user_identifier, std::make_unique<DefaultTdMon>(
+                                         values.attack_value,
+                                         values.defense_value,
+                                         values.speed_value));
+  }
+
+  return td_mons;
+}
+
+std::map<std::string, std::unique_ptr<TdMon>>
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::createMany(
+    std::span<const std::string> user_identifiers) {
+  std::scoped_lock lock(mutex_);
+
+  const std::unordered_map<std::string, TdMonValues> values_for_all_users =
+      calculateValuesForAllUsers();
+
+  std::map<std::string, std::unique_ptr<TdMon>> td_mons;
+
+  for (const std::string& user_identifier : user_identifiers) {
+    // users that do not appear in the dataset keep the default values of 0
+    TdMonValues values;
+    if (auto it = values_for_all_users.find(user_identifier);
+        it != values_for_all_users.end()) {
+      values = it->second;
     }
+
+    td_mons.insert_or_assign(
+        user_identifier,
+        std::make_unique<DefaultTdMon>(values.attack_value,
+                                       values.defense_value,
+                                       values.speed_value));
   }
 
-  // create and return a DefaultTdMon with the calculated attack, defense and
-  // speed values
-  return std::make_unique<DefaultTdMon>(attack_value, defense_value,
-                                        speed_value);
+  return td_mons;
 }
 
 void TechnicalDebtDatasetConnectableDefaultTdMonFactory::
     connectToDataSources() {
+  std::scoped_lock lock(mutex_);
+
   // this step succeeds, if a connection to the database on disk can be
-  // established (just to make sure connection to database is possible, the
-  // connectToDataSources() method is more relvant when connecting to an
-  // external API like Jira, etc...)
-  SQLite::Database db(path_to_db_.string(), SQLite::OPEN_READONLY);
+  // established and all statements can be prepared. Rebuilding the sidecar
+  // index is left to the next creation, which can be cancelled
+  openDatabase(std::stop_token(), nullptr, false);
 
   // this statement is not reached, if the above statement throws an
   // exception (in case the connection to the database cannot be
@@ -108,27 +146,515 @@ void TechnicalDebtDatasetConnectableDefaultTdMonFactory::
 
 bool TechnicalDebtDatasetConnectableDefaultTdMonFactory::
     isRequiredDataAccessInformationAvailable() {
+  std::scoped_lock lock(mutex_);
   return !path_to_db_.empty() && user_identifier_ != "";
 }
 
 bool TechnicalDebtDatasetConnectableDefaultTdMonFactory::
     isConnectedToDataSources() {
+  std::scoped_lock lock(mutex_);
   return connected_;
 }
 
 void TechnicalDebtDatasetConnectableDefaultTdMonFactory::setDatabasePath(
     std::filesystem::path path) {
+  std::scoped_lock lock(mutex_);
+
+  if (path != path_to_db_) {
+    // the connection and the aggregate store belong to the old database
+    closeDatabase();
+    aggregate_store_ = nullptr;
+    connected_ = false;
+  }
+
+  std::scoped_lock settings_lock(settings_mutex_);
   path_to_db_ = std::move(path);
 }
 
 void TechnicalDebtDatasetConnectableDefaultTdMonFactory::setUserIdentifier(
     std::string identifier) {
+  std::scoped_lock lock(mutex_, settings_mutex_);
   user_identifier_ = std::move(identifier);
 }
 
-const std::string
-    TechnicalDebtDatasetConnectableDefaultTdMonFactory::kCategoriesToParse =
-        "(type='Test' OR type='Documentation')";
+void TechnicalDebtDatasetConnectableDefaultTdMonFactory::setSidecarIndexEnabled(
+    bool enabled) {
+  std::scoped_lock lock(mutex_);
+
+  if (enabled != sidecar_index_enabled_) {
+    // the connection might point to the wrong database now
+    closeDatabase();
+  }
+  sidecar_index_enabled_ = enabled;
+}
+
+bool TechnicalDebtDatasetConnectableDefaultTdMonFactory::isSidecarIndexEnabled()
+    const {
+  std::scoped_lock lock(mutex_);
+  return sidecar_index_enabled_;
+}
+
+void TechnicalDebtDatasetConnectableDefaultTdMonFactory::setThreadCount(
+    unsigned int thread_count) {
+  std::scoped_lock lock(mutex_);
+
+  if (thread_count == 0) {
+    // hardware_concurrency() may return 0, if it cannot be determined
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  }
+  thread_count_ = thread_count;
+}
+
+unsigned int TechnicalDebtDatasetConnectableDefaultTdMonFactory::getThreadCount()
+    const {
+  std::scoped_lock lock(mutex_);
+  return thread_count_;
+}
+
+void TechnicalDebtDatasetConnectableDefaultTdMonFactory::setIssueFilter(
+    IssueFilter issue_filter) {
+  std::scoped_lock lock(mutex_, settings_mutex_);
+  // the statements of the previous filter stay cached
+  issue_filter_ = std::move(issue_filter);
+}
+
+IssueFilter TechnicalDebtDatasetConnectableDefaultTdMonFactory::getIssueFilter()
+    const {
+  std::scoped_lock settings_lock(settings_mutex_);
+  return issue_filter_;
+}
+
+void TechnicalDebtDatasetConnectableDefaultTdMonFactory::
+    setIncrementalRefreshEnabled(bool enabled) {
+  std::scoped_lock lock(mutex_);
+  incremental_refresh_enabled_ = enabled;
+}
+
+bool TechnicalDebtDatasetConnectableDefaultTdMonFactory::
+    isIncrementalRefreshEnabled() const {
+  std::scoped_lock lock(mutex_);
+  return incremental_refresh_enabled_;
+}
+
+std::unordered_map<
+    std::string, TechnicalDebtDatasetConnectableDefaultTdMonFactory::TdMonValues>
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::
+    calculateValuesForAllUsers() {
+  openDatabaseIfChanged();
+
+  std::unordered_map<std::string, TdMonValues> values_for_all_users;
+
+  SQLite::Statement& all_users_query = *getPreparedQueries().all_users_query;
+  all_users_query.reset();
+
+  // One scan over the table, grouped by (assignee, reporter). Attack is
+  // attributed to the assignee, defense and speed to the reporter, so every
+  // group contributes to (up to) two different users when merging below.
+  while (all_users_query.executeStep()) {
+    const std::string assignee = all_users_query.getColumn(0).getString();
+    const std::string reporter = all_users_query.getColumn(1).getString();
+    int resolved_count = all_users_query.getColumn(2);
+    int reported_count = all_users_query.getColumn(3);
+    int watch_count_sum = all_users_query.getColumn(4);
+
+    values_for_all_users[assignee].attack_value += resolved_count;
+
+    TdMonValues& reporter_values = values_for_all_users[reporter];
+    reporter_values.defense_value += reported_count;
+    reporter_values.speed_value += watch_count_sum;
+  }
+  all_users_query.reset();
+
+  return values_for_all_users;
+}
+
+std::optional<
+    TechnicalDebtDatasetConnectableDefaultTdMonFactory::TdMonValues>
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::
+    calculateValuesIncrementally(const std::stop_token& stop_token,
+                                 const ProgressCallback& progress_callback) {
+  if (aggregate_store_ == nullptr) {
+    aggregate_store_ = std::make_unique<TechnicalDebtDatasetAggregateStore>(
+        path_to_db_, kTableToParse);
+  }
+
+  try {
+    aggregate_store_->refresh(issue_filter_, stop_token, progress_callback);
+    const TechnicalDebtDatasetAggregateStore::UserValues user_values =
+        aggregate_store_->getUserValues(user_identifier_);
+
+    TdMonValues values;
+    values.attack_value = user_values.attack_value;
+    values.defense_value = user_values.defense_value;
+    values.speed_value = user_values.speed_value;
+    return values;
+  } catch (const std::exception& e) {
+    // a cancelled refresh cancels the creation, instead of falling back
+    if (stop_token.stop_requested()) {
+      throw TdMonCreationCancelledError();
+    }
+    // the store is optional, fall back to querying the dataset directly
+    std::cout << "cannot use aggregate store, querying the dataset directly. "
+                 "Reason: "
+              << e.what() << std::endl;
+    // the store is opened again on the next call
+    aggregate_store_ = nullptr;
+    return std::nullopt;
+  }
+}
+
+std::unique_ptr<TdMon>
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::createWithProgress(
+    const std::stop_token& stop_token,
+    const ProgressCallback& progress_callback) {
+  TDMON_TRACE_SCOPE("create td-mon");
+  std::scoped_lock lock(mutex_);
+
+  // the share of the progress already used by rebuilding the sidecar index
+  float query_progress_offset = 0.0f;
+  auto report_progress = [&](float progress) {
+    if (progress_callback) {
+      progress_callback(query_progress_offset +
+                        progress * (1.0f - query_progress_offset));
+    }
+  };
+  auto throw_if_stop_requested = [&]() {
+    if (stop_token.stop_requested()) {
+      throw TdMonCreationCancelledError();
+    }
+  };
+
+  throw_if_stop_requested();
+  report_progress(0.0f);
+
+  if (incremental_refresh_enabled_) {
+    if (std::optional<TdMonValues> values =
+            calculateValuesIncrementally(stop_token, report_progress)) {
+      report_progress(1.0f);
+      return std::make_unique<DefaultTdMon>(
+          values->attack_value, values->defense_value, values->speed_value);
+    }
+  }
+
+  // opening may rebuild the sidecar index, which takes a while. It is
+  // interrupted by a stop request and reported as part of the progress
+  bool is_sidecar_rebuilt = false;
+  openDatabaseIfChanged(stop_token, [&](float rebuild_progress) {
+    is_sidecar_rebuilt = true;
+    report_progress(rebuild_progress * kSidecarRebuildProgressShare);
+  });
+  throw_if_stop_requested();
+  if (is_sidecar_rebuilt) {
+    query_progress_offset = kSidecarRebuildProgressShare;
+  }
+
+  if (thread_count_ > 1) {
+    TdMonValues values = calculateValuesInParallel(
+        stop_token, progress_callback ? ProgressCallback(report_progress)
+                                      : ProgressCallback());
+    return std::make_unique<DefaultTdMon>(
+        values.attack_value, values.defense_value, values.speed_value);
+  }
+
+  PreparedQueries& prepared_queries = getPreparedQueries();
+
+  // interrupt the queries below, as soon as a stop is requested
+  ScopedProgressHandler progress_handler(*db_, stop_token,
+                                         kProgressHandlerInstructionCount);
+
+  unsigned int attack_value = 0;
+  unsigned int defense_value = 0;
+  unsigned int speed_value = 0;
+
+  try {
+    // Calculate attack value
+    {
+      TDMON_TRACE_SCOPE("attack query");
+      attack_value =
+          queryValueForUser(*prepared_queries.attack_query, user_identifier_);
+    }
+    throw_if_stop_requested();
+    report_progress(1.0f / 3.0f);
+
+    // Calculate defense value
+    {
+      TDMON_TRACE_SCOPE("defense query");
+      defense_value = queryValueForUser(*prepared_queries.defense_query,
+                                        user_identifier_);
+    }
+    throw_if_stop_requested();
+    report_progress(2.0f / 3.0f);
+
+    // Calculate speed value
+    {
+      TDMON_TRACE_SCOPE("speed query");
+      speed_value =
+          queryValueForUser(*prepared_queries.speed_query, user_identifier_);
+    }
+  } catch (const SQLite::Exception&) {
+    // an interrupted query throws a sqlite exception
+    throw_if_stop_requested();
+    throw;
+  }
+
+  report_progress(1.0f);
+
+  // create and return a DefaultTdMon with the calculated attack, defense and
+  // speed values
+  return std::make_unique<DefaultTdMon>(attack_value, defense_value,
+                                        speed_value);
+}
+
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::TdMonValues
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::calculateValuesInParallel(
+    const std::stop_token& stop_token,
+    const ProgressCallback& progress_callback) {
+  // the rowid range of the table. Reading it is cheap, because the table is
+  // stored as a b-tree ordered by rowid
+  long long min_rowid = 0;
+  long long max_rowid = -1;
+  {
+    SQLite::Statement rowid_range_query(
+        *db_, "SELECT MIN(rowid), MAX(rowid) FROM " + kTableToParse);
+    if (rowid_range_query.executeStep() &&
+        !rowid_range_query.getColumn(0).isNull()) {
+      min_rowid = rowid_range_query.getColumn(0).getInt64();
+      max_rowid = rowid_range_query.getColumn(1).getInt64();
+    }
+  }
+
+  // the table is empty
+  if (max_rowid < min_rowid) {
+    return TdMonValues();
+  }
+
+  const long long shard_count = thread_count_;
+  const long long shard_size =
+      (max_rowid - min_rowid + shard_count) / shard_count;
+
+  // the same conditions as the attack, defense and speed queries, but
+  // evaluated per row, so all three values are calculated in one scan. The
+  // parameters of the issue filter follow the rowid range
+  const std::string shard_sql =
+      "SELECT COUNT(CASE WHEN assignee=?1 AND resolution_date IS NOT '' THEN "
+      "key END), COUNT(CASE WHEN reporter=?1 THEN key END), SUM(CASE WHEN "
+      "reporter=?1 THEN watch_count END) FROM " +
+      kTableToParse + " WHERE " + issue_filter_.createSqlCondition(4) +
+      " AND rowid BETWEEN ?2 AND ?3";
+
+  // progress callbacks are serialized, because shards finish concurrently
+  std::mutex progress_mutex;
+  long long finished_shard_count = 0;
+
+  std::vector<std::future<TdMonValues>> shards;
+  for (long long shard_index = 0; shard_index < shard_count; ++shard_index) {
+    const long long first_rowid = min_rowid + shard_index * shard_size;
+    const long long last_rowid =
+        std::min(max_rowid, first_rowid + shard_size - 1);
+
+    shards.push_back(std::async(std::launch::async, [&, first_rowid,
+                                                     last_rowid]() {
+      TDMON_TRACE_SCOPE("shard query");
+      SQLite::Database db(opened_db_path_.string(), SQLite::OPEN_READONLY);
+      ScopedProgressHandler progress_handler(db, stop_token,
+                                             kProgressHandlerInstructionCount);
+
+      SQLite::Statement shard_query(db, shard_sql);
+      shard_query.bind(1, user_identifier_);
+      shard_query.bind(2, static_cast<int64_t>(first_rowid));
+      shard_query.bind(3, static_cast<int64_t>(last_rowid));
+      issue_filter_.bindSqlParameters(shard_query, 4);
+
+      TdMonValues values;
+      if (shard_query.executeStep()) {
+        values.attack_value = shard_query.getColumn(0).getUInt();
+        values.defense_value = shard_query.getColumn(1).getUInt();
+        // SUM() is NULL, if no row matches. getUInt() returns 0 for NULL
+        values.speed_value = shard_query.getColumn(2).getUInt();
+      }
+
+      if (progress_callback) {
+        std::scoped_lock progress_lock(progress_mutex);
+        ++finished_shard_count;
+        progress_callback(static_cast<float>(finished_shard_count) /
+                          static_cast<float>(shard_count));
+      }
+
+      return values;
+    }));
+  }
+
+  // wait for all shards before merging, so no shard outlives the locals it
+  // references, even if one of them failed
+  for (std::future<TdMonValues>& shard : shards) {
+    shard.wait();
+  }
+
+  TdMonValues merged_values;
+  try {
+    // merge in the order of the shards
+    for (std::future<TdMonValues>& shard : shards) {
+      TdMonValues values = shard.get();
+      merged_values.attack_value += values.attack_value;
+      merged_values.defense_value += values.defense_value;
+      merged_values.speed_value += values.speed_value;
+    }
+  } catch (const SQLite::Exception&) {
+    // an interrupted query throws a sqlite exception
+    if (stop_token.stop_requested()) {
+      throw TdMonCreationCancelledError();
+    }
+    throw;
+  }
+
+  return merged_values;
+}
+
+void TechnicalDebtDatasetConnectableDefaultTdMonFactory::openDatabaseIfChanged(
+    const std::stop_token& stop_token,
+    const ProgressCallback& progress_callback) {
+  if (db_ == nullptr || sidecar_index_rebuild_deferred_ ||
+      DatabaseFileState::read(path_to_db_) != db_file_state_) {
+    openDatabase(stop_token, progress_callback);
+  }
+}
+
+void TechnicalDebtDatasetConnectableDefaultTdMonFactory::openDatabase(
+    const std::stop_token& stop_token,
+    const ProgressCallback& progress_callback, bool rebuild_sidecar_index) {
+  closeDatabase();
+
+  // read the state before opening, so changes made while opening are detected
+  // on the next call
+  const DatabaseFileState db_file_state = DatabaseFileState::read(path_to_db_);
+
+  std::filesystem::path path_to_open = path_to_db_;
+  bool sidecar_index_rebuild_deferred = false;
+  if (sidecar_index_enabled_ && !rebuild_sidecar_index) {
+    TechnicalDebtDatasetSidecarIndex sidecar_index(path_to_db_, kTableToParse);
+    if (sidecar_index.isUpToDate()) {
+      path_to_open = sidecar_index.getPath();
+    } else {
+      sidecar_index_rebuild_deferred = true;
+    }
+  } else if (sidecar_index_enabled_) {
+    TechnicalDebtDatasetSidecarIndex sidecar_index(path_to_db_, kTableToParse);
+    try {
+      sidecar_index.rebuildIfOutdated(stop_token, progress_callback);
+      path_to_open = sidecar_index.getPath();
+    } catch (const std::exception& e) {
+      // a cancelled rebuild cancels the creation, instead of falling back
+      if (stop_token.stop_requested()) {
+        throw TdMonCreationCancelledError();
+      }
+      // the sidecar is optional, fall back to querying the dataset directly
+      std::cout << "cannot use sidecar index, querying the dataset directly. "
+                   "Reason: "
+                << e.what() << std::endl;
+    }
+  }
+
+  auto db = std::make_unique<SQLite::Database>(path_to_open.string(),
+                                               SQLite::OPEN_READONLY);
+
+  // prepare the statements of the current filter right away, so an invalid
+  // filter (e.g. using a column the dataset does not have) is detected here
+  PreparedQueries prepared_queries = prepareQueries(*db, issue_filter_);
+
+  // only take over the new connection, once everything has been prepared
+  // successfully
+  db_file_state_ = db_file_state;
+  opened_db_path_ = path_to_open;
+  sidecar_index_rebuild_deferred_ = sidecar_index_rebuild_deferred;
+  db_ = std::move(db);
+  prepared_queries_.emplace(issue_filter_, std::move(prepared_queries));
+}
+
+void TechnicalDebtDatasetConnectableDefaultTdMonFactory::closeDatabase() {
+  // statements must be finalized before the database can be closed
+  prepared_queries_.clear();
+  db_ = nullptr;
+}
+
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::PreparedQueries&
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::getPreparedQueries() {
+  if (auto it = prepared_queries_.find(issue_filter_);
+      it != prepared_queries_.end()) {
+    return it->second;
+  }
+
+  PreparedQueries prepared_queries = prepareQueries(*db_, issue_filter_);
+
+  // keep the number of open statements bounded
+  if (prepared_queries_.size() >= kMaxPreparedIssueFilterCount) {
+    prepared_queries_.clear();
+  }
+
+  return prepared_queries_.emplace(issue_filter_, std::move(prepared_queries))
+      .first->second;
+}
+
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::PreparedQueries
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::prepareQueries(
+    SQLite::Database& db, const IssueFilter& issue_filter) {
+  // parameter 1 is the user-identifier, the parameters of the filter follow
+  const int first_filter_parameter_index = 2;
+  const std::string where_clause =
+      " FROM " + kTableToParse + " WHERE " +
+      issue_filter.createSqlCondition(first_filter_parameter_index);
+
+  // the sql strings are only built here. Afterwards, the prepared statements
+  // are reset and rebound for every query
+  PreparedQueries prepared_queries;
+  prepared_queries.attack_query = std::make_unique<SQLite::Statement>(
+      db, "SELECT COUNT(key)" + where_clause +
+              " AND assignee=?1 AND resolution_date IS NOT ''");
+  prepared_queries.defense_query = std::make_unique<SQLite::Statement>(
+      db, "SELECT COUNT(key)" + where_clause + " AND reporter=?1");
+  prepared_queries.speed_query = std::make_unique<SQLite::Statement>(
+      db, "SELECT SUM(watch_count)" + where_clause + " AND reporter=?1");
+  // does not use parameter 1, sqlite treats it as NULL
+  prepared_queries.all_users_query = std::make_unique<SQLite::Statement>(
+      db,
+      "SELECT assignee, reporter, COUNT(CASE WHEN resolution_date IS NOT '' "
+      "THEN key END), COUNT(key), SUM(watch_count)" +
+          where_clause + " GROUP BY assignee, reporter");
+
+  // the values of the filter stay bound, resetting a statement keeps its
+  // bindings
+  for (SQLite::Statement* query :
+       {prepared_queries.attack_query.get(),
+        prepared_queries.defense_query.get(),
+        prepared_queries.speed_query.get(),
+        prepared_queries.all_users_query.get()}) {
+    issue_filter.bindSqlParameters(*query, first_filter_parameter_index);
+  }
+
+  return prepared_queries;
+}
+
+unsigned int
+TechnicalDebtDatasetConnectableDefaultTdMonFactory::queryValueForUser(
+    SQLite::Statement& query, const std::string& user_identifier) {
+  unsigned int value = 0;
+
+  // make sure the statement is not left in a running state from a previous
+  // (failed) execution, before rebinding it
+  query.reset();
+  // bind the chosen user_identifier to the db query
+  query.bind(1, user_identifier);
+
+  // the query only produces one result, so the loop is only entered once
+  while (query.executeStep()) {
+    int count = query.getColumn(0);
+    value = count;
+  }
+
+  // reset the statement, so it can be executed again on the next call
+  query.reset();
+
+  return value;
+}
 
 const std::string
     TechnicalDebtDatasetConnectableDefaultTdMonFactory::kTableToParse =
@@ -25,16 +25,58 @@
 #pragma once
 
 #include <TDMon/connectable_to_data_sources.h>
+#include <TDMon/database_file_state.h>
+#include <TDMon/issue_filter.h>
 #include <TDMon/td_mon_factory.h>
 #include <TDMon/technical_debt_dataset_access_information_container.h>
 
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <unordered_map>
+
+namespace SQLite {
+class Database;
+class Statement;
+}  // namespace SQLite
 
 namespace tdmon {
+class TechnicalDebtDatasetAggregateStore;
+
 /**
  * @brief The implementation for a td-mon factory which can be connected to the
  * technical debt dataset
+ *
+ * The factory keeps one read-only connection to the dataset open, together with
+ * the statements used to query it. Both are created once, when connecting to
+ * the data sources (or on first use), and are only recreated if the database
+ * file on disk changes.
+ *
+ * By default, queries are routed through a TechnicalDebtDatasetSidecarIndex,
+ * so per-user queries are index seeks instead of full table scans. If the
+ * sidecar cannot be built (for example because the folder of the dataset is
+ * not writable), the dataset is queried directly.
+ *
+ * All public member functions are thread-safe. Queries from different threads
+ * are serialized on the one connection.
+ *
+ * If the thread count is set to more than one, create() splits the issues table
+ * into rowid ranges (shards) instead. Each shard is aggregated on a separate
+ * read-only connection in a separate thread, and the partial results are
+ * merged afterwards.
+ *
+ * Which issues are used is specified by an IssueFilter. The statements
+ * prepared for a filter are cached, so switching between filters at runtime
+ * reuses the statements instead of building and preparing the sql again.
+ *
+ * If incremental refresh is enabled, create() reads the values from a
+ * TechnicalDebtDatasetAggregateStore instead. It is stored next to the dataset
+ * and only recalculates the parts of the dataset that changed since the last
+ * refresh.
  */
 class TechnicalDebtDatasetConnectableDefaultTdMonFactory
     : public TdMonFactory,
@@ -42,17 +84,25 @@ class TechnicalDebtDatasetConnectableDefaultTdMonFactory
       public TechnicalDebtDatasetAccessInformationContainer {
  public:
   /**
-   * @brief When querying the dataset, certain categories of issues are filtered
-   * out (for example 'bug', because it is not TD). This is the part of the sql
-   * query that determines which categories of issues to use. Modify, if you
-   * want to parse other categories. Must be valid sql.
+   * @brief The table name to gather data from in the sql query.
+   */
+  static const std::string kTableToParse;
+
+  /**
+   * @brief The default number of threads used by create(). 1 means, that the
+   * queries are executed on the persistent connection, without sharding.
    */
-  static const std::string kCategoriesToParse;
+  static const unsigned int kDefaultThreadCount = 1;
 
   /**
-   * @brief The table name to gather data from in the sql query.
+   * @brief The constructor.
    */
-  static const std::string kTableToParse;
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory();
+
+  /**
+   * @brief The destructor. Closes the database connection, if it is open.
+   */
+  ~TechnicalDebtDatasetConnectableDefaultTdMonFactory() override;
 
   // Inherited via TdMonFactory
 
@@ -62,12 +112,57 @@ class TechnicalDebtDatasetConnectableDefaultTdMonFactory
    */
   std::unique_ptr<TdMon> create() override;
 
+  /**
+   * @brief Create the td-mon asynchronously on a worker thread. The progress is
+   * reported after each of the three queries. While a query is running, a
+   * sqlite progress handler checks for cancellation and interrupts the query,
+   * if a stop was requested.
+   * @param stop_token Request a stop to cancel the creation
+   * @param progress_callback Called with the progress of the creation. May be
+   * empty.
+   * @return A future containing the created td-mon
+   */
+  std::future<std::unique_ptr<TdMon>> createAsync(
+      std::stop_token stop_token, ProgressCallback progress_callback) override;
+
+  /**
+   * @brief Get the fingerprint of the dataset file, the user-identifier and the
+   * issue filter. Only reads the state of the file, not its content, and
+   * does not wait for a running creation.
+   * @return The fingerprint. Empty, if the file cannot be read.
+   */
+  std::optional<DataSourceFingerprint> getDataSourceFingerprint() override;
+
+  /**
+   * @brief Create the td-mons for all users found in the dataset at once.
+   *
+   * In contrast to calling create() once per user, the attack, defense and
+   * speed values of all users are calculated in one single grouped scan over
+   * the dataset.
+   * @return A map from user-identifier to the td-mon of that user
+   */
+  std::map<std::string, std::unique_ptr<TdMon>> createAll();
+
+  /**
+   * @brief Create the td-mons for the given users at once. Uses the same
+   * single grouped scan as createAll(). Users which are not found in the
+   * dataset get a td-mon with all values set to 0.
+   * @param user_identifiers The user-identifiers to create td-mons for
+   * @return A map from user-identifier to the td-mon of that user
+   */
+  std::map<std::string, std::unique_ptr<TdMon>> createMany(
+      std::span<const std::string> user_identifiers);
+
   // Inherited via ConnectableToDataSources
 
   /**
-   * @brief Opens the sqlite database from disk. Then closes it again. This
-   * function closes the database again, because a sqlite databse does not need
-   * to be kept open when not reading from it.
+   * @brief Opens the sqlite database from disk (read-only) and prepares all
+   * statements used by the factory. The connection is kept open and reused by
+   * subsequent calls to create(), createAll() and createMany(). Calling this
+   * again forces the connection to be reopened. An outdated sidecar index is
+   * not rebuilt here, since this is called on the UI thread. The dataset is
+   * opened instead, and the next creation rebuilds the sidecar index, which
+   * reports progress and can be cancelled.
    */
   void connectToDataSources() override;
 
@@ -80,9 +175,8 @@ class TechnicalDebtDatasetConnectableDefaultTdMonFactory
 
   /**
    * @brief Returns true, if opening the database succeeded in
-   * connectToDataSources(). Due to the way, that sqlite databases work, this
-   * class is assumed to be connected to the database, if the database was
-   * opened once before. This does not mean that the database is currently open.
+   * connectToDataSources(). The connection may have been reopened since, if
+   * the database file on disk changed.
    * @return true, if connectToDataSources() was completed successfully before.
    */
   bool isConnectedToDataSources() override;
@@ -97,12 +191,250 @@ class TechnicalDebtDatasetConnectableDefaultTdMonFactory
   void setUserIdentifier(std::string identifier) override;
 
   /**
-   * @brief Set the path to the technical debt dataset sqlite database on disk
+   * @brief Set the path to the technical debt dataset sqlite database on disk.
+   * Closes the current connection, if the path differs from the current one.
    * @param path The path to the sqlite databse.
    */
   void setDatabasePath(std::filesystem::path path) override;
 
+  /**
+   * @brief Enable or disable routing the queries through a sidecar index
+   * database stored next to the dataset. Enabled by default. Closes the current
+   * connection, if the setting changes.
+   * @param enabled true, to use the sidecar index
+   */
+  void setSidecarIndexEnabled(bool enabled);
+
+  /**
+   * @brief Get whether queries are routed through a sidecar index database.
+   * @return true, if the sidecar index is enabled
+   */
+  bool isSidecarIndexEnabled() const;
+
+  /**
+   * @brief Set the number of threads used by create() and createAsync(). With
+   * more than one thread, the issues table is split into that many rowid
+   * ranges, which are scanned in parallel on separate connections. This is
+   * meant for large datasets queried without the sidecar index, where each
+   * query is a full table scan.
+   * @param thread_count The number of threads. 0 selects the number of
+   * hardware threads.
+   */
+  void setThreadCount(unsigned int thread_count);
+
+  /**
+   * @brief Get the number of threads used by create() and createAsync().
+   * @return The number of threads
+   */
+  unsigned int getThreadCount() const;
+
+  /**
+   * @brief Set which issues to use when calculating the values of td-mons.
+   * Defaults to IssueFilter::createDefault(). The statements for the filter
+   * are prepared on first use, and reused if the filter is set again later.
+   * @param issue_filter The filter
+   */
+  void setIssueFilter(IssueFilter issue_filter);
+
+  /**
+   * @brief Get which issues are used when calculating the values of td-mons.
+   * @return The filter
+   */
+  IssueFilter getIssueFilter() const;
+
+  /**
+   * @brief Enable or disable incremental refresh. Disabled by default. If
+   * enabled, create() and createAsync() keep the partial values of all users in
+   * a TechnicalDebtDatasetAggregateStore next to the dataset, and only
+   * aggregate the rows that changed since the previous call. If the store
+   * cannot be used (for example because the folder of the dataset is not
+   * writable), the dataset is queried as usual.
+   * @param enabled true, to use incremental refresh
+   */
+  void setIncrementalRefreshEnabled(bool enabled);
+
+  /**
+   * @brief Get whether incremental refresh is enabled.
+   * @return true, if incremental refresh is enabled
+   */
+  bool isIncrementalRefreshEnabled() const;
+
  private:
+  /**
+   * @brief The number of sqlite virtual machine instructions between two calls
+   * of the progress handler, which checks for cancellation.
+   */
+  static const int kProgressHandlerInstructionCount = 10000;
+
+  /**
+   * @brief The share of the progress of a td-mon creation used by rebuilding
+   * the sidecar index, if it has to be rebuilt. The queries use the rest.
+   */
+  static constexpr float kSidecarRebuildProgressShare = 0.5f;
+
+  /**
+   * @brief The maximum number of filters to keep prepared statements for. If
+   * more filters are used, the cache is cleared.
+   */
+  static const std::size_t kMaxPreparedIssueFilterCount = 16;
+
+  /**
+   * @brief The statements prepared for one issue filter. The values of the
+   * filter are bound once, when preparing. Only the user-identifier (parameter
+   * 1) is bound per query.
+   */
+  struct PreparedQueries {
+    /**
+     * @brief The prepared statement to calculate the attack value
+     */
+    std::unique_ptr<SQLite::Statement> attack_query;
+
+    /**
+     * @brief The prepared statement to calculate the defense value
+     */
+    std::unique_ptr<SQLite::Statement> defense_query;
+
+    /**
+     * @brief The prepared statement to calculate the speed value
+     */
+    std::unique_ptr<SQLite::Statement> speed_query;
+
+    /**
+     * @brief The prepared statement to calculate the values of all users at
+     * once
+     */
+    std::unique_ptr<SQLite::Statement> all_users_query;
+  };
+
+  /**
+   * @brief The attack, defense and speed values calculated for one user
+   */
+  struct TdMonValues {
+    unsigned int attack_value = 0;
+    unsigned int defense_value = 0;
+    unsigned int speed_value = 0;
+  };
+
+  /**
+   * @brief Calculate the attack, defense and speed values of all users in the
+   * dataset using one grouped scan with conditional aggregation. The scan
+   * groups by (assignee, reporter) pairs, which are then merged per user.
+   * @return A map from user-identifier to the values of that user
+   */
+  std::unordered_map<std::string, TdMonValues> calculateValuesForAllUsers();
+
+  /**
+   * @brief Calculate the values of the user using the aggregate store. The
+   * store is refreshed first, so it reflects the current state of the dataset.
+   * @param stop_token Interrupts the refresh of the store. Throws
+   * TdMonCreationCancelledError, if a stop was requested during the refresh.
+   * @param progress_callback Called while refreshing the store. May be empty.
+   * @return The values of the user. Empty, if the store cannot be used.
+   */
+  std::optional<TdMonValues> calculateValuesIncrementally(
+      const std::stop_token& stop_token,
+      const ProgressCallback& progress_callback);
+
+  /**
+   * @brief Calculate the attack, defense and speed values of the user by
+   * scanning rowid ranges of the issues table in parallel. Every range is
+   * scanned by a separate thread using a separate read-only connection. The
+   * partial results are merged in the order of the ranges.
+   * @param stop_token Interrupts all running scans, if a stop is requested
+   * @param progress_callback Called after each finished range. May be empty.
+   * @return The values of the user
+   */
+  TdMonValues calculateValuesInParallel(
+      const std::stop_token& stop_token,
+      const ProgressCallback& progress_callback);
+
+  /**
+   * @brief Create the td-mon. Shared implementation of create() and
+   * createAsync().
+   * @param stop_token Checked before and while executing each query. Throws
+   * TdMonCreationCancelledError, if a stop was requested.
+   * @param progress_callback Called after each query and while rebuilding the
+   * sidecar index. May be empty.
+   * @return The td-mon
+   */
+  std::unique_ptr<TdMon> createWithProgress(
+      const std::stop_token& stop_token,
+      const ProgressCallback& progress_callback);
+
+  /**
+   * @brief Open the database and prepare all statements, if the database is
+   * not open yet, if the database file on disk changed since it was opened,
+   * or if the rebuild of the sidecar index was deferred by
+   * connectToDataSources().
+   * @param stop_token Interrupts rebuilding the sidecar index (see
+   * openDatabase())
+   * @param progress_callback Called while rebuilding the sidecar index. May be
+   * empty.
+   */
+  void openDatabaseIfChanged(
+      const std::stop_token& stop_token = std::stop_token(),
+      const ProgressCallback& progress_callback = nullptr);
+
+  /**
+   * @brief Open the database and prepare all statements. Closes the current
+   * connection first, if one exists. If the sidecar index is enabled, it is
+   * rebuilt if necessary and opened instead of the dataset.
+   * @param stop_token Interrupts rebuilding the sidecar index. Throws
+   * TdMonCreationCancelledError, if a stop was requested during the rebuild.
+   * @param progress_callback Called while rebuilding the sidecar index. May be
+   * empty.
+   * @param rebuild_sidecar_index false, if an outdated sidecar index should
+   * not be rebuilt. The dataset is opened instead, and the rebuild is
+   * deferred to the next call of openDatabaseIfChanged().
+   */
+  void openDatabase(const std::stop_token& stop_token = std::stop_token(),
+                    const ProgressCallback& progress_callback = nullptr,
+                    bool rebuild_sidecar_index = true);
+
+  /**
+   * @brief Finalize all prepared statements and close the database.
+   */
+  void closeDatabase();
+
+  /**
+   * @brief Get the statements prepared for the current issue filter. Prepares
+   * them, if they are not cached yet. The database must be open.
+   * @return The prepared statements
+   */
+  PreparedQueries& getPreparedQueries();
+
+  /**
+   * @brief Prepare the statements for an issue filter and bind its values
+   * @param db The database connection
+   * @param issue_filter The filter
+   * @return The prepared statements
+   */
+  static PreparedQueries prepareQueries(SQLite::Database& db,
+                                        const IssueFilter& issue_filter);
+
+  /**
+   * @brief Execute a prepared statement which takes the user-identifier as its
+   * only parameter and produces a single value. The statement is reset, so it
+   * can be executed again later on.
+   * @param query The prepared statement
+   * @param user_identifier The user-identifier to bind to the statement
+   * @return The value produced by the statement. 0 for NULL.
+   */
+  static unsigned int queryValueForUser(SQLite::Statement& query,
+                                        const std::string& user_identifier);
+
+  /**
+   * @brief Guards all members below. Locked by every public member function.
+   */
+  mutable std::mutex mutex_;
+
+  /**
+   * @brief Additionally guards path_to_db_, user_identifier_ and
+   * issue_filter_, so they can be read without waiting for a running
+   * creation. Writers lock mutex_ first, then this mutex.
+   */
+  mutable std::mutex settings_mutex_;
+
   /**
    * @brief The path to the sqlite database on disk
    */
@@ -118,5 +450,59 @@ class TechnicalDebtDatasetConnectableDefaultTdMonFactory
    * @brief True, if openening the database succeeded in connectToDataSources
    */
   bool connected_ = false;
+
+  /**
+   * @brief True, if queries should be routed through the sidecar index
+   */
+  bool sidecar_index_enabled_ = true;
+
+  /**
+   * @brief The number of threads used by create()
+   */
+  unsigned int thread_count_ = kDefaultThreadCount;
+
+  /**
+   * @brief Specifies which issues to use
+   */
+  IssueFilter issue_filter_ = IssueFilter::createDefault();
+
+  /**
+   * @brief True, if create() should use the aggregate store
+   */
+  bool incremental_refresh_enabled_ = false;
+
+  /**
+   * @brief The aggregate store of the dataset. Created on first use.
+   */
+  std::unique_ptr<TechnicalDebtDatasetAggregateStore> aggregate_store_;
+
+  /**
+   * @brief The path of the database that was actually opened. This is the
+   * path of the sidecar, if it is used. Otherwise the path of the dataset.
+   */
+  std::filesystem::path opened_db_path_;
+
+  /**
+   * @brief True, if the dataset was opened, because rebuilding the outdated
+   * sidecar index was deferred
+   */
+  bool sidecar_index_rebuild_deferred_ = false;
+
+  /**
+   * @brief The state of the database file when it was opened. Used to detect
+   * changes to the file on disk.
+   */
+  DatabaseFileState db_file_state_;
+
+  /**
+   * @brief The read-only database connection. nullptr, if not open.
+   */
+  std::unique_ptr<SQLite::Database> db_;
+
+  /**
+   * @brief The statements prepared on the current connection, for each issue
+   * filter used since the connection was opened
+   */
+  std::map<IssueFilter, PreparedQueries> prepared_queries_;
 };
 }  // namespace tdmon
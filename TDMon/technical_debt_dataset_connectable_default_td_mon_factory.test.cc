@@ -3,11 +3,18 @@
 
 #include <SQLiteCpp/SQLiteCpp.h>
 #include <TDMon/technical_debt_dataset_connectable_default_td_mon_factory.h>
+#include <TDMon/technical_debt_dataset_sidecar_index.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <future>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace tdmon {
 /**
@@ -71,6 +78,251 @@ TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory, ParsesDataCorrectly) {
   // EXPECT_EQ(td_mon->getLevel(), 0);
 }
 
+/**
+ * @brief Test, if the values of all users are parsed correctly when creating
+ * the td-mons of all users at once. See
+ * ensureTestDbExistsAndContainsCorrectData for test data string.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     CreatesAllTdMonsCorrectly) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kTestDbPath);
+
+  std::map<std::string, std::unique_ptr<TdMon>> td_mons = factory.createAll();
+
+  // the 'Other' issue of Human1 is filtered out, so only three users remain
+  ASSERT_EQ(td_mons.size(), 3);
+
+  EXPECT_EQ(td_mons.at("Human1")->getAttackValue(), 2);
+  EXPECT_EQ(td_mons.at("Human1")->getDefenseValue(), 4);
+  EXPECT_EQ(td_mons.at("Human1")->getSpeedValue(), 8);
+
+  EXPECT_EQ(td_mons.at("Human2")->getAttackValue(), 1);
+  EXPECT_EQ(td_mons.at("Human2")->getDefenseValue(), 1);
+  EXPECT_EQ(td_mons.at("Human2")->getSpeedValue(), 1);
+
+  EXPECT_EQ(td_mons.at("Human3")->getAttackValue(), 1);
+  EXPECT_EQ(td_mons.at("Human3")->getDefenseValue(), 0);
+  EXPECT_EQ(td_mons.at("Human3")->getSpeedValue(), 0);
+}
+
+/**
+ * @brief Test, if only the requested users are returned when creating many
+ * td-mons at once, and if users missing from the dataset get empty td-mons.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     CreatesManyTdMonsCorrectly) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kTestDbPath);
+
+  const std::vector<std::string> user_identifiers = {"Human1", "Nobody"};
+  std::map<std::string, std::unique_ptr<TdMon>> td_mons =
+      factory.createMany(user_identifiers);
+
+  ASSERT_EQ(td_mons.size(), 2);
+
+  EXPECT_EQ(td_mons.at("Human1")->getAttackValue(), 2);
+  EXPECT_EQ(td_mons.at("Human1")->getDefenseValue(), 4);
+  EXPECT_EQ(td_mons.at("Human1")->getSpeedValue(), 8);
+
+  EXPECT_EQ(td_mons.at("Nobody")->getAttackValue(), 0);
+  EXPECT_EQ(td_mons.at("Nobody")->getDefenseValue(), 0);
+  EXPECT_EQ(td_mons.at("Nobody")->getSpeedValue(), 0);
+}
+
+/**
+ * @brief Test, if issues without a key are ignored in the attack value of
+ * createAll(), just like in create().
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     CreatesAllTdMonsLikeCreateForIssuesWithoutKey) {
+  const std::string null_key_test_db_path = "./null_key_test.db";
+  std::filesystem::remove(null_key_test_db_path);
+  {
+    SQLite::Database db(null_key_test_db_path,
+                        SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+    db.exec(
+        "CREATE TABLE JIRA_ISSUES (KEY INTEGER, TYPE TEXT NOT NULL, ASSIGNEE "
+        "TEXT NOT NULL, RESOLUTION_DATE TEXT NOT NULL, REPORTER TEXT NOT NULL, "
+        "WATCH_COUNT INTEGER NOT NULL);INSERT INTO JIRA_ISSUES VALUES "
+        "(NULL,'Test','Human1','2000-01-01','Human1',1);INSERT INTO "
+        "JIRA_ISSUES VALUES (1,'Test','Human1','2000-01-01','Human1',2);");
+  }
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(null_key_test_db_path);
+  factory.setUserIdentifier("Human1");
+
+  std::unique_ptr<TdMon> td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 1);
+
+  std::map<std::string, std::unique_ptr<TdMon>> td_mons = factory.createAll();
+  ASSERT_EQ(td_mons.count("Human1"), 1);
+  EXPECT_EQ(td_mons.at("Human1")->getAttackValue(), td_mon->getAttackValue());
+  EXPECT_EQ(td_mons.at("Human1")->getDefenseValue(),
+            td_mon->getDefenseValue());
+  EXPECT_EQ(td_mons.at("Human1")->getSpeedValue(), td_mon->getSpeedValue());
+}
+
+/**
+ * @brief Test, if the factory can be used for multiple create() calls with the
+ * same connection, and if changes to the database between the calls are
+ * reflected in the created td-mons.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     ReflectsDatabaseChangesBetweenCreateCalls) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kTestDbPath);
+  factory.setUserIdentifier("Human1");
+  factory.connectToDataSources();
+
+  EXPECT_EQ(factory.create()->getAttackValue(), 2);
+  // the second call reuses the connection and the prepared statements
+  EXPECT_EQ(factory.create()->getAttackValue(), 2);
+
+  // add another resolved issue assigned to Human1
+  {
+    SQLite::Database db(kTestDbPath, SQLite::OPEN_READWRITE);
+    db.exec(
+        "INSERT INTO \"JIRA_ISSUES\" VALUES "
+        "(7,'Test','Human1','2000-01-01','Human2',1);");
+  }
+
+  std::unique_ptr<TdMon> td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 3);
+  EXPECT_EQ(td_mon->getDefenseValue(), 4);
+  EXPECT_EQ(td_mon->getSpeedValue(), 8);
+}
+
+/**
+ * @brief Test, if the td-mon is created correctly on a worker thread, and if
+ * the progress is reported until completion.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     CreatesTdMonAsynchronously) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kTestDbPath);
+  factory.setUserIdentifier("Human1");
+
+  std::vector<float> reported_progress;
+  std::future<std::unique_ptr<TdMon>> future = factory.createAsync(
+      std::stop_token(),
+      [&](float progress) { reported_progress.push_back(progress); });
+
+  std::unique_ptr<TdMon> td_mon = future.get();
+
+  EXPECT_EQ(td_mon->getAttackValue(), 2);
+  EXPECT_EQ(td_mon->getDefenseValue(), 4);
+  EXPECT_EQ(td_mon->getSpeedValue(), 8);
+
+  ASSERT_FALSE(reported_progress.empty());
+  EXPECT_FLOAT_EQ(reported_progress.front(), 0.0f);
+  EXPECT_FLOAT_EQ(reported_progress.back(), 1.0f);
+  EXPECT_TRUE(std::is_sorted(reported_progress.begin(),
+                             reported_progress.end()));
+}
+
+/**
+ * @brief Test, if a cancelled asynchronous creation throws
+ * TdMonCreationCancelledError.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     CancelsAsynchronousCreation) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kTestDbPath);
+  factory.setUserIdentifier("Human1");
+
+  std::stop_source stop_source;
+  stop_source.request_stop();
+
+  std::future<std::unique_ptr<TdMon>> future =
+      factory.createAsync(stop_source.get_token(), nullptr);
+
+  EXPECT_THROW(future.get(), TdMonCreationCancelledError);
+
+  // the factory can still be used after a cancelled creation
+  EXPECT_EQ(factory.create()->getAttackValue(), 2);
+}
+
+/**
+ * @brief Test, if the data source fingerprint can be read while a td-mon is
+ * being created, without waiting for the creation to finish.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     ReadsFingerprintDuringCreation) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kTestDbPath);
+  factory.setUserIdentifier("Human1");
+
+  // the creation is held at its first progress report until the fingerprint
+  // has been read
+  std::promise<void> creation_started;
+  std::promise<void> fingerprint_read;
+  std::shared_future<void> fingerprint_read_future =
+      fingerprint_read.get_future().share();
+  bool first_progress = true;
+  std::future<std::unique_ptr<TdMon>> future = factory.createAsync(
+      std::stop_token(), [&](float /*progress*/) {
+        if (first_progress) {
+          first_progress = false;
+          creation_started.set_value();
+          fingerprint_read_future.wait();
+        }
+      });
+  creation_started.get_future().wait();
+
+  std::future<std::optional<DataSourceFingerprint>> fingerprint_future =
+      std::async(std::launch::async,
+                 [&]() { return factory.getDataSourceFingerprint(); });
+  const bool fingerprint_ready =
+      fingerprint_future.wait_for(std::chrono::seconds(5)) ==
+      std::future_status::ready;
+  fingerprint_read.set_value();
+
+  ASSERT_TRUE(fingerprint_ready);
+  EXPECT_TRUE(fingerprint_future.get().has_value());
+  EXPECT_EQ(future.get()->getAttackValue(), 2);
+}
+
+/**
+ * @brief Test, if the data is parsed correctly, when the table is split into
+ * rowid ranges which are scanned in parallel. This includes more threads than
+ * rows, which results in empty ranges.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     ParsesDataCorrectlyInParallel) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  for (bool sidecar_index_enabled : {false, true}) {
+    for (unsigned int thread_count : {2u, 3u, 16u}) {
+      TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+      factory.setDatabasePath(kTestDbPath);
+      factory.setUserIdentifier("Human1");
+      factory.setSidecarIndexEnabled(sidecar_index_enabled);
+      factory.setThreadCount(thread_count);
+      EXPECT_EQ(factory.getThreadCount(), thread_count);
+
+      std::unique_ptr<TdMon> td_mon = factory.create();
+
+      EXPECT_EQ(td_mon->getAttackValue(), 2);
+      EXPECT_EQ(td_mon->getDefenseValue(), 4);
+      EXPECT_EQ(td_mon->getSpeedValue(), 8);
+    }
+  }
+}
+
 /**
  * @brief Test, if connection to tadabase is only reported as established, when
  * the database actually exists
@@ -101,6 +353,31 @@ TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
   EXPECT_TRUE(factory.isConnectedToDataSources());
 }
 
+/**
+ * @brief Test, if connecting does not rebuild an outdated sidecar index, and
+ * if the next creation rebuilds it instead.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     DefersSidecarIndexRebuildToCreation) {
+  ensureTestDbExistsAndContainsCorrectData();
+  TechnicalDebtDatasetSidecarIndex sidecar_index(kTestDbPath, "JIRA_ISSUES");
+  std::filesystem::remove(sidecar_index.getPath());
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kTestDbPath);
+  factory.setUserIdentifier("Human1");
+  factory.connectToDataSources();
+
+  EXPECT_TRUE(factory.isConnectedToDataSources());
+  EXPECT_FALSE(sidecar_index.isUpToDate());
+
+  std::unique_ptr<TdMon> td_mon = factory.create();
+  EXPECT_TRUE(sidecar_index.isUpToDate());
+  EXPECT_EQ(td_mon->getAttackValue(), 2);
+  EXPECT_EQ(td_mon->getDefenseValue(), 4);
+  EXPECT_EQ(td_mon->getSpeedValue(), 8);
+}
+
 /**
  * @brief Test, if the factory requires access information to be complete.
  */
@@ -117,4 +394,144 @@ TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
 
   EXPECT_TRUE(factory.isRequiredDataAccessInformationAvailable());
 }
+
+/**
+ * @brief Test, if switching between issue filters at runtime uses the issues
+ * of the current filter, with and without parallel scans.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory, SwitchesIssueFilters) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kTestDbPath);
+  factory.setUserIdentifier("Human1");
+  EXPECT_EQ(factory.getIssueFilter(), IssueFilter::createDefault());
+
+  IssueFilter other_filter;
+  other_filter.issue_types = {"Other"};
+
+  for (unsigned int thread_count : {1u, 3u}) {
+    factory.setThreadCount(thread_count);
+
+    factory.setIssueFilter(other_filter);
+    std::unique_ptr<TdMon> td_mon = factory.create();
+    EXPECT_EQ(td_mon->getAttackValue(), 1);
+    EXPECT_EQ(td_mon->getDefenseValue(), 1);
+    EXPECT_EQ(td_mon->getSpeedValue(), 100);
+
+    factory.setIssueFilter(IssueFilter::createDefault());
+    td_mon = factory.create();
+    EXPECT_EQ(td_mon->getAttackValue(), 2);
+    EXPECT_EQ(td_mon->getDefenseValue(), 4);
+    EXPECT_EQ(td_mon->getSpeedValue(), 8);
+  }
+
+  // all issue types
+  factory.setIssueFilter(IssueFilter());
+  std::map<std::string, std::unique_ptr<TdMon>> td_mons = factory.createAll();
+  EXPECT_EQ(td_mons.at("Human1")->getAttackValue(), 3);
+  EXPECT_EQ(td_mons.at("Human1")->getDefenseValue(), 5);
+  EXPECT_EQ(td_mons.at("Human1")->getSpeedValue(), 108);
+}
+
+/**
+ * @brief Test, if incremental refresh produces the same values as querying the
+ * dataset, also after the dataset changed and after switching issue filters.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     RefreshesIncrementally) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kTestDbPath);
+  factory.setUserIdentifier("Human1");
+  EXPECT_FALSE(factory.isIncrementalRefreshEnabled());
+  factory.setIncrementalRefreshEnabled(true);
+  EXPECT_TRUE(factory.isIncrementalRefreshEnabled());
+
+  std::unique_ptr<TdMon> td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 2);
+  EXPECT_EQ(td_mon->getDefenseValue(), 4);
+  EXPECT_EQ(td_mon->getSpeedValue(), 8);
+
+  {
+    SQLite::Database db(kTestDbPath, SQLite::OPEN_READWRITE);
+    db.exec(
+        "INSERT INTO JIRA_ISSUES VALUES "
+        "(7,'Test','Human1','2000-01-01','Human1',3)");
+  }
+
+  td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 3);
+  EXPECT_EQ(td_mon->getDefenseValue(), 5);
+  EXPECT_EQ(td_mon->getSpeedValue(), 11);
+
+  IssueFilter other_filter;
+  other_filter.issue_types = {"Other"};
+  factory.setIssueFilter(other_filter);
+  td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 1);
+  EXPECT_EQ(td_mon->getDefenseValue(), 1);
+  EXPECT_EQ(td_mon->getSpeedValue(), 100);
+}
+
+/**
+ * @brief Test, if an incremental refresh is cancelled, instead of falling back
+ * to querying the dataset directly.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     CancelsIncrementalRefresh) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kTestDbPath);
+  factory.setUserIdentifier("Human1");
+  factory.setIncrementalRefreshEnabled(true);
+
+  // the stop is requested once the creation has started
+  std::stop_source stop_source;
+  std::future<std::unique_ptr<TdMon>> future = factory.createAsync(
+      stop_source.get_token(),
+      [&](float /*progress*/) { stop_source.request_stop(); });
+
+  EXPECT_THROW(future.get(), TdMonCreationCancelledError);
+
+  // the store can still be used after a cancelled refresh
+  EXPECT_EQ(factory.create()->getAttackValue(), 2);
+}
+
+/**
+ * @brief Test, if the data source fingerprint changes with the issue filter
+ * and with the dataset, and stays the same otherwise.
+ */
+TEST(TechnicalDebtDatasetConnectableDefaultTdMonFactory,
+     ReportsDataSourceFingerprint) {
+  ensureTestDbExistsAndContainsCorrectData();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath("./does_not_exist.db");
+  factory.setUserIdentifier("Human1");
+  EXPECT_FALSE(factory.getDataSourceFingerprint().has_value());
+
+  factory.setDatabasePath(kTestDbPath);
+  const std::optional<DataSourceFingerprint> fingerprint =
+      factory.getDataSourceFingerprint();
+  ASSERT_TRUE(fingerprint.has_value());
+  EXPECT_EQ(factory.getDataSourceFingerprint(), fingerprint);
+
+  IssueFilter other_filter;
+  other_filter.issue_types = {"Other"};
+  factory.setIssueFilter(other_filter);
+  EXPECT_NE(factory.getDataSourceFingerprint()->identity,
+            fingerprint->identity);
+  factory.setIssueFilter(IssueFilter::createDefault());
+
+  {
+    SQLite::Database db(kTestDbPath, SQLite::OPEN_READWRITE);
+    db.exec(
+        "INSERT INTO JIRA_ISSUES VALUES "
+        "(7,'Test','Human1','2000-01-01','Human1',3)");
+  }
+  EXPECT_NE(factory.getDataSourceFingerprint()->version, fingerprint->version);
+}
 }  // namespace tdmon
@@ -0,0 +1,285 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#include <TDMon/csv_reader.h>
+#include <TDMon/default_td_mon.h>
+#include <TDMon/memory_mapped_file.h>
+#include <TDMon/technical_debt_dataset_csv_default_td_mon_factory.h>
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+namespace tdmon {
+namespace {
+/**
+ * @brief Compare two strings case-insensitively (ASCII only)
+ * @param a The first string
+ * @param b The second string
+ * @return true, if the strings are equal ignoring case
+ */
+bool equalsIgnoringCase(std::string_view a, std::string_view b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                    [](char a_character, char b_character) {
+                      auto to_lower = [](char character) {
+                        return character >= 'A' && character <= 'Z'
+                                   ? static_cast<char>(character - 'A' + 'a')
+                                   : character;
+                      };
+                      return to_lower(a_character) == to_lower(b_character);
+                    });
+}
+
+/**
+ * @brief Find a column in the header row
+ * @param header The fields of the header row
+ * @param column_name The name of the column, in lower case
+ * @return The index of the column, if it exists
+ */
+std::optional<std::size_t> findColumn(
+    const std::vector<std::string_view>& header, std::string_view column_name) {
+  for (std::size_t i = 0; i < header.size(); ++i) {
+    if (equalsIgnoringCase(header[i], column_name)) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Find a column in the header row, which must exist
+ * @param header The fields of the header row
+ * @param column_name The name of the column, in lower case
+ * @return The index of the column
+ */
+std::size_t findRequiredColumn(const std::vector<std::string_view>& header,
+                               std::string_view column_name) {
+  std::optional<std::size_t> index = findColumn(header, column_name);
+  if (!index) {
+    throw std::runtime_error("The csv file has no column named '" +
+                             std::string(column_name) + "'");
+  }
+  return *index;
+}
+
+/**
+ * @brief Parse a watch count
+ * @param field The field containing the watch count
+ * @return The watch count. 0, if the field is empty or not a number.
+ */
+unsigned int parseWatchCount(std::string_view field) {
+  unsigned int watch_count = 0;
+  std::from_chars(field.data(), field.data() + field.size(), watch_count);
+  return watch_count;
+}
+}  // namespace
+
+std::unique_ptr<TdMon> TechnicalDebtDatasetCsvDefaultTdMonFactory::create() {
+  std::scoped_lock lock(mutex_);
+
+  // mapped again on every call, so changes to the file are picked up
+  MemoryMappedFile csv_file(path_to_csv_);
+  const std::span<const std::byte> data = csv_file.getData();
+  CsvReader reader(
+      {reinterpret_cast<const char*>(data.data()), data.size()});
+
+  std::vector<std::string_view> fields;
+  if (!reader.readRow(fields)) {
+    throw std::runtime_error("The csv file is empty");
+  }
+  const ColumnIndices column_indices = findColumnIndices(fields, issue_filter_);
+  const std::size_t required_field_count =
+      column_indices.getRequiredFieldCount();
+
+  unsigned int attack_value = 0;
+  unsigned int defense_value = 0;
+  unsigned int speed_value = 0;
+
+  while (reader.readRow(fields)) {
+    // skips empty lines
+    if (fields.size() < required_field_count ||
+        !matchesIssueFilter(fields, column_indices, issue_filter_)) {
+      continue;
+    }
+
+    // an empty key counts like NULL
+    const bool has_key = !fields[column_indices.key].empty();
+
+    // same conditions as the attack, defense and speed queries
+    if (fields[column_indices.assignee] == user_identifier_ && has_key &&
+        !fields[column_indices.resolution_date].empty()) {
+      ++attack_value;
+    }
+    if (fields[column_indices.reporter] == user_identifier_) {
+      if (has_key) {
+        ++defense_value;
+      }
+      speed_value += parseWatchCount(fields[column_indices.watch_count]);
+    }
+  }
+
+  return std::make_unique<DefaultTdMon>(attack_value, defense_value,
+                                        speed_value);
+}
+
+std::optional<DataSourceFingerprint>
+TechnicalDebtDatasetCsvDefaultTdMonFactory::getDataSourceFingerprint() {
+  std::scoped_lock lock(mutex_);
+
+  try {
+    return DataSourceFingerprint::createForFile(path_to_csv_,
+                                                user_identifier_, issue_filter_);
+  } catch (const std::exception&) {
+    // without a readable file, there is nothing to compare
+    return std::nullopt;
+  }
+}
+
+void TechnicalDebtDatasetCsvDefaultTdMonFactory::connectToDataSources() {
+  std::scoped_lock lock(mutex_);
+
+  connected_ = false;
+
+  MemoryMappedFile csv_file(path_to_csv_);
+  const std::span<const std::byte> data = csv_file.getData();
+  CsvReader reader(
+      {reinterpret_cast<const char*>(data.data()), data.size()});
+
+  std::vector<std::string_view> header;
+  if (!reader.readRow(header)) {
+    throw std::runtime_error("The csv file is empty");
+  }
+  // throws, if a column is missing
+  findColumnIndices(header, issue_filter_);
+
+  connected_ = true;
+}
+
+bool TechnicalDebtDatasetCsvDefaultTdMonFactory::
+    isRequiredDataAccessInformationAvailable() {
+  std::scoped_lock lock(mutex_);
+  return !path_to_csv_.empty() && user_identifier_ != "";
+}
+
+bool TechnicalDebtDatasetCsvDefaultTdMonFactory::isConnectedToDataSources() {
+  std::scoped_lock lock(mutex_);
+  return connected_;
+}
+
+void TechnicalDebtDatasetCsvDefaultTdMonFactory::setUserIdentifier(
+    std::string identifier) {
+  std::scoped_lock lock(mutex_);
+  user_identifier_ = std::move(identifier);
+}
+
+void TechnicalDebtDatasetCsvDefaultTdMonFactory::setDatabasePath(
+    std::filesystem::path path) {
+  std::scoped_lock lock(mutex_);
+
+  if (path != path_to_csv_) {
+    connected_ = false;
+  }
+  path_to_csv_ = std::move(path);
+}
+
+void TechnicalDebtDatasetCsvDefaultTdMonFactory::setIssueFilter(
+    IssueFilter issue_filter) {
+  std::scoped_lock lock(mutex_);
+  issue_filter_ = std::move(issue_filter);
+}
+
+IssueFilter TechnicalDebtDatasetCsvDefaultTdMonFactory::getIssueFilter() const {
+  std::scoped_lock lock(mutex_);
+  return issue_filter_;
+}
+
+std::size_t TechnicalDebtDatasetCsvDefaultTdMonFactory::ColumnIndices::
+    getRequiredFieldCount() const {
+  return std::max({type, assignee, reporter, resolution_date, watch_count, key,
+                   creation_date.value_or(0), project_id.value_or(0)}) +
+         1;
+}
+
+TechnicalDebtDatasetCsvDefaultTdMonFactory::ColumnIndices
+TechnicalDebtDatasetCsvDefaultTdMonFactory::findColumnIndices(
+    const std::vector<std::string_view>& header,
+    const IssueFilter& issue_filter) {
+  ColumnIndices column_indices;
+  column_indices.type = findRequiredColumn(header, "type");
+  column_indices.assignee = findRequiredColumn(header, "assignee");
+  column_indices.reporter = findRequiredColumn(header, "reporter");
+  column_indices.resolution_date =
+      findRequiredColumn(header, "resolution_date");
+  column_indices.watch_count = findRequiredColumn(header, "watch_count");
+  column_indices.key = findRequiredColumn(header, "key");
+
+  // like the sql queries, the columns are only required if the filter uses
+  // them
+  if (issue_filter.created_from || issue_filter.created_before) {
+    column_indices.creation_date = findRequiredColumn(header, "creation_date");
+  }
+  if (!issue_filter.projects.empty()) {
+    column_indices.project_id = findRequiredColumn(header, "project_id");
+  }
+
+  return column_indices;
+}
+
+bool TechnicalDebtDatasetCsvDefaultTdMonFactory::matchesIssueFilter(
+    const std::vector<std::string_view>& fields,
+    const ColumnIndices& column_indices, const IssueFilter& issue_filter) {
+  // the same conditions as IssueFilter::createSqlCondition()
+  if (!issue_filter.issue_types.empty() &&
+      std::find(issue_filter.issue_types.begin(),
+                issue_filter.issue_types.end(),
+                fields[column_indices.type]) ==
+          issue_filter.issue_types.end()) {
+    return false;
+  }
+  if (issue_filter.created_from &&
+      fields[*column_indices.creation_date] < *issue_filter.created_from) {
+    return false;
+  }
+  if (issue_filter.created_before &&
+      !(fields[*column_indices.creation_date] < *issue_filter.created_before)) {
+    return false;
+  }
+  if (!issue_filter.projects.empty() &&
+      std::find(issue_filter.projects.begin(), issue_filter.projects.end(),
+                fields[*column_indices.project_id]) ==
+          issue_filter.projects.end()) {
+    return false;
+  }
+
+  const bool resolved = !fields[column_indices.resolution_date].empty();
+  if ((issue_filter.resolution_state == ResolutionState::kResolved &&
+       !resolved) ||
+      (issue_filter.resolution_state == ResolutionState::kUnresolved &&
+       resolved)) {
+    return false;
+  }
+
+  return true;
+}
+}  // namespace tdmon
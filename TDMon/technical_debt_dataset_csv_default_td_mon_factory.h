@@ -0,0 +1,235 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <TDMon/connectable_to_data_sources.h>
+#include <TDMon/issue_filter.h>
+#include <TDMon/td_mon_factory.h>
+#include <TDMon/technical_debt_dataset_access_information_container.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief A td-mon factory which reads the issues of the technical debt dataset
+ * directly from a csv export of the issues table, without importing it into a
+ * sqlite database first.
+ *
+ * The csv file is mapped into memory and parsed by a CsvReader in a single
+ * streaming pass. Only the attack, defense and speed values of the current user
+ * are aggregated while reading, so the memory used does not depend on the size
+ * of the file (apart from the mapping, which the operating system pages in and
+ * out as needed).
+ *
+ * The first row of the file must contain the column names. They are matched
+ * case-insensitively to the columns of the issues table (type, assignee,
+ * reporter, resolution_date, watch_count, key and, if used by the issue
+ * filter, creation_date and project_id). Empty fields are treated like NULL
+ * for the key and watch_count, and like '' for all other columns, matching
+ * TechnicalDebtDatasetConnectableDefaultTdMonFactory.
+ *
+ * All public member functions are thread-safe.
+ */
+class TechnicalDebtDatasetCsvDefaultTdMonFactory
+    : public TdMonFactory,
+      public ConnectableToDataSources,
+      public TechnicalDebtDatasetAccessInformationContainer {
+ public:
+  // Inherited via TdMonFactory
+
+  /**
+   * @brief Create the td-mon of the current user by reading the csv file
+   * @return The td-mon
+   */
+  std::unique_ptr<TdMon> create() override;
+
+  /**
+   * @brief Get the fingerprint of the csv file, the user-identifier and the
+   * issue filter. Only reads the state of the file, not its content.
+   * @return The fingerprint. Empty, if the file cannot be read.
+   */
+  std::optional<DataSourceFingerprint> getDataSourceFingerprint() override;
+
+  // Inherited via ConnectableToDataSources
+
+  /**
+   * @brief Maps the csv file into memory and checks, that its first row
+   * contains all required columns.
+   */
+  void connectToDataSources() override;
+
+  /**
+   * @brief Get whether the path to the csv file, as well as, the required
+   * user-identifier for parsing the file are available
+   * @return true, if the required information is available
+   */
+  bool isRequiredDataAccessInformationAvailable() override;
+
+  /**
+   * @brief Returns true, if checking the csv file succeeded in
+   * connectToDataSources().
+   * @return true, if connectToDataSources() was completed successfully before.
+   */
+  bool isConnectedToDataSources() override;
+
+  // Inherited via TechnicalDebtDatasetAccessInformationContainer
+
+  /**
+   * @brief Set the user identifier whose issues to use when parsing the
+   * technical debt dataset.
+   * @param identifier The user-identifier string
+   */
+  void setUserIdentifier(std::string identifier) override;
+
+  /**
+   * @brief Set the path to the csv export of the issues table on disk
+   * @param path The path to the csv file.
+   */
+  void setDatabasePath(std::filesystem::path path) override;
+
+  /**
+   * @brief Set which issues to use when calculating the values of td-mons.
+   * Defaults to IssueFilter::createDefault().
+   * @param issue_filter The filter
+   */
+  void setIssueFilter(IssueFilter issue_filter);
+
+  /**
+   * @brief Get which issues are used when calculating the values of td-mons.
+   * @return The filter
+   */
+  IssueFilter getIssueFilter() const;
+
+ private:
+  /**
+   * @brief The index of each used column in the rows of the csv file
+   */
+  struct ColumnIndices {
+    /**
+     * @brief The index of the 'type' column
+     */
+    std::size_t type = 0;
+
+    /**
+     * @brief The index of the 'assignee' column
+     */
+    std::size_t assignee = 0;
+
+    /**
+     * @brief The index of the 'reporter' column
+     */
+    std::size_t reporter = 0;
+
+    /**
+     * @brief The index of the 'resolution_date' column
+     */
+    std::size_t resolution_date = 0;
+
+    /**
+     * @brief The index of the 'watch_count' column
+     */
+    std::size_t watch_count = 0;
+
+    /**
+     * @brief The index of the 'key' column
+     */
+    std::size_t key = 0;
+
+    /**
+     * @brief The index of the 'creation_date' column. Only set, if the issue
+     * filter uses it.
+     */
+    std::optional<std::size_t> creation_date;
+
+    /**
+     * @brief The index of the 'project_id' column. Only set, if the issue
+     * filter uses it.
+     */
+    std::optional<std::size_t> project_id;
+
+    /**
+     * @brief Get the number of fields a row must have to contain all used
+     * columns
+     * @return The number of fields
+     */
+    std::size_t getRequiredFieldCount() const;
+  };
+
+  /**
+   * @brief Find the used columns in the header row. Throws, if a required
+   * column, or a column used by the issue filter, is missing.
+   * @param header The fields of the header row
+   * @param issue_filter The issue filter
+   * @return The column indices
+   */
+  static ColumnIndices findColumnIndices(
+      const std::vector<std::string_view>& header,
+      const IssueFilter& issue_filter);
+
+  /**
+   * @brief Check, if a row matches the issue filter
+   * @param fields The fields of the row
+   * @param column_indices The column indices
+   * @param issue_filter The issue filter
+   * @return true, if the issue is used
+   */
+  static bool matchesIssueFilter(const std::vector<std::string_view>& fields,
+                                 const ColumnIndices& column_indices,
+                                 const IssueFilter& issue_filter);
+
+  /**
+   * @brief Guards all members below. Locked by every public member function.
+   */
+  mutable std::mutex mutex_;
+
+  /**
+   * @brief The path to the csv file on disk
+   */
+  std::filesystem::path path_to_csv_;
+
+  /**
+   * @brief The user-identifier string whose issues to use when parsing the
+   * technical debt dataset.
+   */
+  std::string user_identifier_;
+
+  /**
+   * @brief Specifies which issues to use
+   */
+  IssueFilter issue_filter_ = IssueFilter::createDefault();
+
+  /**
+   * @brief True, if checking the csv file succeeded in connectToDataSources
+   */
+  bool connected_ = false;
+};
+}  // namespace tdmon
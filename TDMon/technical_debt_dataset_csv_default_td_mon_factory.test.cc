@@ -0,0 +1,105 @@
+#include <TDMon/technical_debt_dataset_csv_default_td_mon_factory.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief The path to the csv file containing test data
+ */
+const std::string kCsvTestFilePath = "./csv_test.csv";
+
+/**
+ * @brief Helper function. Create the csv file containing test data. Uses the
+ * same issues as the tests of
+ * TechnicalDebtDatasetConnectableDefaultTdMonFactory, plus an unused column
+ * containing quoted fields with line breaks.
+ */
+void createCsvTestFile() {
+  std::ofstream file(kCsvTestFilePath, std::ios::binary | std::ios::trunc);
+  file << "PROJECT_ID,KEY,TYPE,ASSIGNEE,RESOLUTION_DATE,REPORTER,WATCH_COUNT,"
+          "DESCRIPTION,CREATION_DATE\r\n"
+          "p1,1,Test,Human1,,Human1,1,\"first line\r\nsecond, line\",2000\r\n"
+          "p1,2,Documentation,Human1,2000-01-01,Human1,1,,2001\r\n"
+          "p2,3,Test,Human2,2000-01-01,Human1,1,\"\"\"quoted\"\"\",2002\r\n"
+          "p2,4,Test,Human1,2000-01-01,Human2,1,,2003\r\n"
+          "p2,5,Test,Human3,2000-01-01,Human1,5,,2004\r\n"
+          "p2,6,Other,Human1,2000-01-01,Human1,100,,2005\r\n";
+}
+
+/**
+ * @brief Test, if the csv file is parsed correctly, with the same results as
+ * the sql based factory
+ */
+TEST(TechnicalDebtDatasetCsvDefaultTdMonFactory, ParsesDataCorrectly) {
+  createCsvTestFile();
+
+  TechnicalDebtDatasetCsvDefaultTdMonFactory factory;
+  EXPECT_FALSE(factory.isRequiredDataAccessInformationAvailable());
+  factory.setDatabasePath(kCsvTestFilePath);
+  factory.setUserIdentifier("Human1");
+  EXPECT_TRUE(factory.isRequiredDataAccessInformationAvailable());
+
+  factory.connectToDataSources();
+  EXPECT_TRUE(factory.isConnectedToDataSources());
+
+  std::unique_ptr<TdMon> td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 2);
+  EXPECT_EQ(td_mon->getDefenseValue(), 4);
+  EXPECT_EQ(td_mon->getSpeedValue(), 8);
+
+  factory.setUserIdentifier("Human2");
+  td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 1);
+  EXPECT_EQ(td_mon->getDefenseValue(), 1);
+  EXPECT_EQ(td_mon->getSpeedValue(), 1);
+}
+
+/**
+ * @brief Test, if the issue filter is applied
+ */
+TEST(TechnicalDebtDatasetCsvDefaultTdMonFactory, AppliesIssueFilter) {
+  createCsvTestFile();
+
+  TechnicalDebtDatasetCsvDefaultTdMonFactory factory;
+  factory.setDatabasePath(kCsvTestFilePath);
+  factory.setUserIdentifier("Human1");
+
+  IssueFilter filter = IssueFilter::createDefault();
+  filter.projects = {"p2"};
+  filter.created_before = "2005";
+  filter.resolution_state = ResolutionState::kResolved;
+  factory.setIssueFilter(filter);
+  EXPECT_EQ(factory.getIssueFilter(), filter);
+
+  std::unique_ptr<TdMon> td_mon = factory.create();
+  EXPECT_EQ(td_mon->getAttackValue(), 1);
+  EXPECT_EQ(td_mon->getDefenseValue(), 2);
+  EXPECT_EQ(td_mon->getSpeedValue(), 6);
+}
+
+/**
+ * @brief Test, if connecting fails, if the file does not exist or a required
+ * column is missing
+ */
+TEST(TechnicalDebtDatasetCsvDefaultTdMonFactory, RequiresAllColumns) {
+  TechnicalDebtDatasetCsvDefaultTdMonFactory factory;
+  factory.setUserIdentifier("Human1");
+  factory.setDatabasePath("./does_not_exist.csv");
+  EXPECT_THROW(factory.connectToDataSources(), std::exception);
+  EXPECT_FALSE(factory.isConnectedToDataSources());
+
+  const std::string path = "./csv_test_missing_column.csv";
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "KEY,TYPE,ASSIGNEE,RESOLUTION_DATE,REPORTER\n";
+  }
+  factory.setDatabasePath(path);
+  EXPECT_THROW(factory.connectToDataSources(), std::exception);
+  EXPECT_FALSE(factory.isConnectedToDataSources());
+  std::filesystem::remove(path);
+}
+}  // namespace tdmon
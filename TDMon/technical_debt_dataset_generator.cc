@@ -0,0 +1,357 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/technical_debt_dataset_generator.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace tdmon {
+namespace {
+/**
+ * @brief The number of columns of the generated table
+ */
+const int kColumnCount = 8;
+
+/**
+ * @brief The issue types, with their relative frequency
+ */
+const std::array<std::pair<std::string_view, double>, 8> kIssueTypeWeights = {
+    {{"Bug", 0.40},
+     {"Improvement", 0.22},
+     {"Task", 0.10},
+     {"New Feature", 0.08},
+     {"Sub-task", 0.07},
+     {"Test", 0.06},
+     {"Documentation", 0.04},
+     {"Wish", 0.03}}};
+
+/**
+ * @brief The first possible creation date
+ */
+const std::chrono::sys_days kFirstCreationDate =
+    std::chrono::year(2005) / std::chrono::January / 1;
+
+/**
+ * @brief The number of days creation dates are spread over
+ */
+const int kCreationDateDayCount = 15 * 365;
+
+/**
+ * @brief The mean number of days between creation and resolution of an issue
+ */
+const double kMeanResolutionDays = 60.0;
+
+/**
+ * @brief A small, fast random number generator (xoshiro256**), seeded using
+ * splitmix64. Produces the same sequence on every platform.
+ */
+class RandomNumberGenerator {
+ public:
+  /**
+   * @brief The constructor
+   * @param seed The seed
+   */
+  explicit RandomNumberGenerator(std::uint64_t seed) {
+    for (std::uint64_t& state : state_) {
+      seed += 0x9E3779B97F4A7C15ull;
+      std::uint64_t value = seed;
+      value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+      value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+      state = value ^ (value >> 31);
+    }
+  }
+
+  /**
+   * @brief Get the next random number
+   * @return A uniformly distributed 64 bit number
+   */
+  std::uint64_t next() {
+    const std::uint64_t result = rotateLeft(state_[1] * 5, 7) * 9;
+    const std::uint64_t shifted = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= shifted;
+    state_[3] = rotateLeft(state_[3], 45);
+    return result;
+  }
+
+  /**
+   * @brief Get the next random number between 0 (inclusive) and 1 (exclusive)
+   * @return A uniformly distributed number
+   */
+  double nextDouble() {
+    return static_cast<double>(next() >> 11) * 0x1.0p-53;
+  }
+
+ private:
+  /**
+   * @brief Rotate the bits of a number to the left
+   * @param value The number
+   * @param bit_count The number of bits to rotate by
+   * @return The rotated number
+   */
+  static std::uint64_t rotateLeft(std::uint64_t value, int bit_count) {
+    return (value << bit_count) | (value >> (64 - bit_count));
+  }
+
+  /**
+   * @brief The state of the generator
+   */
+  std::array<std::uint64_t, 4> state_ = {};
+};
+
+/**
+ * @brief Build the cumulative distribution function of a discrete
+ * distribution
+ * @param weights The relative frequency of each value
+ * @return The cumulative distribution, normalized to end at 1
+ */
+std::vector<double> createCumulativeDistribution(
+    const std::vector<double>& weights) {
+  std::vector<double> cumulative_distribution;
+  cumulative_distribution.reserve(weights.size());
+
+  double sum = 0.0;
+  for (double weight : weights) {
+    sum += weight;
+    cumulative_distribution.push_back(sum);
+  }
+  for (double& value : cumulative_distribution) {
+    value /= sum;
+  }
+  return cumulative_distribution;
+}
+
+/**
+ * @brief Sample a discrete distribution
+ * @param cumulative_distribution The cumulative distribution function
+ * @param random_number_generator The random number generator
+ * @return The index of the sampled value
+ */
+std::size_t sample(const std::vector<double>& cumulative_distribution,
+                   RandomNumberGenerator& random_number_generator) {
+  const auto it = std::upper_bound(cumulative_distribution.begin(),
+                                   cumulative_distribution.end(),
+                                   random_number_generator.nextDouble());
+  // rounding may leave the last value slightly below 1
+  return std::min(
+      static_cast<std::size_t>(it - cumulative_distribution.begin()),
+      cumulative_distribution.size() - 1);
+}
+
+/**
+ * @brief Format a point in time as 'YYYY-MM-DD HH:MM:SS'
+ * @param time The point in time
+ * @param formatted_date Receives the formatted date
+ */
+void formatDate(std::chrono::sys_seconds time, std::string& formatted_date) {
+  const std::chrono::sys_days day = std::chrono::floor<std::chrono::days>(time);
+  const std::chrono::year_month_day date(day);
+  const std::chrono::hh_mm_ss time_of_day(time - day);
+
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u %02d:%02d:%02d",
+                static_cast<int>(date.year()),
+                static_cast<unsigned int>(date.month()),
+                static_cast<unsigned int>(date.day()),
+                static_cast<int>(time_of_day.hours().count()),
+                static_cast<int>(time_of_day.minutes().count()),
+                static_cast<int>(time_of_day.seconds().count()));
+  formatted_date = buffer;
+}
+
+/**
+ * @brief Create an insert statement for a number of issues
+ * @param db The database
+ * @param issue_count The number of issues inserted by the statement
+ * @return The statement
+ */
+std::unique_ptr<SQLite::Statement> createInsertStatement(
+    SQLite::Database& db, std::uint64_t issue_count) {
+  std::string sql =
+      "INSERT INTO " + TechnicalDebtDatasetGenerator::kTableName +
+      " (KEY, PROJECT_ID, TYPE, CREATION_DATE, RESOLUTION_DATE, ASSIGNEE, "
+      "REPORTER, WATCH_COUNT) VALUES ";
+  for (std::uint64_t i = 0; i < issue_count; ++i) {
+    sql += i == 0 ? "(?,?,?,?,?,?,?,?)" : ",(?,?,?,?,?,?,?,?)";
+  }
+  return std::make_unique<SQLite::Statement>(db, sql);
+}
+}  // namespace
+
+TechnicalDebtDatasetGenerator::TechnicalDebtDatasetGenerator(Options options)
+    : options_(options) {}
+
+void TechnicalDebtDatasetGenerator::generate(
+    const std::filesystem::path& path) const {
+  if (options_.user_count == 0 || options_.project_count == 0) {
+    throw std::runtime_error(
+        "The dataset needs at least one user and one project");
+  }
+
+  std::filesystem::remove(path);
+
+  SQLite::Database db(path.string(),
+                      SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+  // the dataset can always be generated again, so there is no need for a
+  // journal
+  db.exec("PRAGMA journal_mode=OFF; PRAGMA synchronous=OFF;");
+  db.exec("CREATE TABLE " + kTableName +
+          " (KEY TEXT NOT NULL, PROJECT_ID TEXT NOT NULL, TYPE TEXT NOT NULL, "
+          "CREATION_DATE TEXT NOT NULL, RESOLUTION_DATE TEXT NOT NULL, "
+          "ASSIGNEE TEXT NOT NULL, REPORTER TEXT NOT NULL, WATCH_COUNT "
+          "INTEGER NOT NULL)");
+
+  RandomNumberGenerator random_number_generator(options_.seed);
+
+  std::vector<double> user_weights(options_.user_count);
+  for (std::uint32_t rank = 1; rank <= options_.user_count; ++rank) {
+    user_weights[rank - 1] = 1.0 / std::pow(rank, options_.user_zipf_exponent);
+  }
+  const std::vector<double> user_distribution =
+      createCumulativeDistribution(user_weights);
+
+  std::vector<double> issue_type_weights;
+  for (const auto& [issue_type, weight] : kIssueTypeWeights) {
+    issue_type_weights.push_back(weight);
+  }
+  const std::vector<double> issue_type_distribution =
+      createCumulativeDistribution(issue_type_weights);
+
+  // the user and project names are created once, instead of once per issue
+  std::vector<std::string> user_names(options_.user_count);
+  for (std::uint32_t rank = 1; rank <= options_.user_count; ++rank) {
+    user_names[rank - 1] = kUserPrefix + std::to_string(rank);
+  }
+  std::vector<std::string> project_names(options_.project_count);
+  for (std::uint32_t i = 0; i < options_.project_count; ++i) {
+    project_names[i] = "PROJECT" + std::to_string(i);
+  }
+
+  // the texts of the issues of one statement. Binding without copying is
+  // several times faster, so they have to stay alive until the statement is
+  // executed.
+  std::vector<std::string> keys(kIssuesPerStatement);
+  std::vector<std::string> creation_dates(kIssuesPerStatement);
+  std::vector<std::string> resolution_dates(kIssuesPerStatement);
+
+  // watch counts are geometrically distributed with the configured mean
+  const double watch_count_log =
+      std::log(options_.mean_watch_count / (options_.mean_watch_count + 1.0));
+
+  const std::unique_ptr<SQLite::Statement> full_insert =
+      createInsertStatement(db, kIssuesPerStatement);
+  std::unique_ptr<SQLite::Statement> partial_insert;
+
+  std::uint64_t issue_index = 0;
+  while (issue_index < options_.issue_count) {
+    SQLite::Transaction transaction(db);
+
+    const std::uint64_t transaction_end = std::min(
+        options_.issue_count, issue_index + kIssuesPerTransaction);
+    while (issue_index < transaction_end) {
+      const std::uint64_t statement_issue_count =
+          std::min(kIssuesPerStatement, transaction_end - issue_index);
+      if (statement_issue_count != kIssuesPerStatement) {
+        partial_insert = createInsertStatement(db, statement_issue_count);
+      }
+      SQLite::Statement& insert = statement_issue_count == kIssuesPerStatement
+                                      ? *full_insert
+                                      : *partial_insert;
+
+      for (std::uint64_t i = 0; i < statement_issue_count; ++i) {
+        const std::string& project_name =
+            project_names[random_number_generator.next() %
+                          options_.project_count];
+        const std::string_view issue_type =
+            kIssueTypeWeights[sample(issue_type_distribution,
+                                     random_number_generator)]
+                .first;
+        keys[i].assign(project_name)
+            .append("-")
+            .append(std::to_string(issue_index + i + 1));
+
+        const std::chrono::sys_seconds creation_date =
+            kFirstCreationDate +
+            std::chrono::seconds(random_number_generator.next() %
+                                 (kCreationDateDayCount * 86400ull));
+        formatDate(creation_date, creation_dates[i]);
+        resolution_dates[i].clear();
+        if (random_number_generator.nextDouble() < options_.resolved_ratio) {
+          // exponentially distributed time to resolution
+          const double resolution_days =
+              -std::log(1.0 - random_number_generator.nextDouble()) *
+              kMeanResolutionDays;
+          formatDate(creation_date +
+                         std::chrono::seconds(
+                             static_cast<long long>(resolution_days * 86400.0)),
+                     resolution_dates[i]);
+        }
+
+        const std::string& assignee =
+            user_names[sample(user_distribution, random_number_generator)];
+        const std::string& reporter =
+            user_names[sample(user_distribution, random_number_generator)];
+        const long long watch_count = static_cast<long long>(
+            std::log(1.0 - random_number_generator.nextDouble()) /
+            watch_count_log);
+
+        const int first_parameter = static_cast<int>(i) * kColumnCount + 1;
+        insert.bindNoCopy(first_parameter, keys[i]);
+        insert.bindNoCopy(first_parameter + 1, project_name);
+        // the issue types are null terminated literals
+        insert.bindNoCopy(first_parameter + 2, issue_type.data());
+        insert.bindNoCopy(first_parameter + 3, creation_dates[i]);
+        insert.bindNoCopy(first_parameter + 4, resolution_dates[i]);
+        insert.bindNoCopy(first_parameter + 5, assignee);
+        insert.bindNoCopy(first_parameter + 6, reporter);
+        insert.bind(first_parameter + 7, static_cast<int64_t>(watch_count));
+      }
+
+      insert.exec();
+      insert.reset();
+      issue_index += statement_issue_count;
+    }
+
+    transaction.commit();
+  }
+}
+
+const std::string TechnicalDebtDatasetGenerator::kTableName = "JIRA_ISSUES";
+
+const std::string TechnicalDebtDatasetGenerator::kUserPrefix = "user";
+
+}  // namespace tdmon
@@ -0,0 +1,135 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief Generates synthetic, schema compatible technical debt datasets
+ * (a sqlite database with a JIRA_ISSUES table) for benchmarks and scale tests.
+ *
+ * The generated data only depends on the options, including the seed: the
+ * same options produce the same issues on every platform. The generator uses
+ * its own random number generator and distributions for this, as the
+ * distributions of the standard library are implementation specific.
+ *
+ * The data is modelled after the real dataset:
+ * - Assignees and reporters follow a Zipf distribution, so a few users work on
+ * most of the issues.
+ * - Issue types follow a fixed mix, dominated by bugs and improvements.
+ * - A configurable ratio of issues is resolved. Resolution dates lie after the
+ * creation dates.
+ * - Watch counts follow a geometric distribution.
+ *
+ * Issues are inserted with multi-row insert statements, in large transactions,
+ * with journaling disabled.
+ */
+class TechnicalDebtDatasetGenerator {
+ public:
+  /**
+   * @brief The options of the generated dataset
+   */
+  struct Options {
+    /**
+     * @brief The number of issues to generate
+     */
+    std::uint64_t issue_count = 10000;
+
+    /**
+     * @brief The seed of the random number generator
+     */
+    std::uint64_t seed = 1;
+
+    /**
+     * @brief The number of distinct users (assignees and reporters)
+     */
+    std::uint32_t user_count = 1000;
+
+    /**
+     * @brief The exponent of the Zipf distribution of users. Higher values
+     * concentrate the issues on fewer users.
+     */
+    double user_zipf_exponent = 1.0;
+
+    /**
+     * @brief The number of distinct projects
+     */
+    std::uint32_t project_count = 30;
+
+    /**
+     * @brief The ratio of resolved issues, between 0 and 1
+     */
+    double resolved_ratio = 0.8;
+
+    /**
+     * @brief The mean watch count of an issue
+     */
+    double mean_watch_count = 2.0;
+  };
+
+  /**
+   * @brief The name of the generated table
+   */
+  static const std::string kTableName;
+
+  /**
+   * @brief The prefix of the generated user-identifiers. The user with rank i
+   * (starting at 1, the most active user) is named kUserPrefix + i.
+   */
+  static const std::string kUserPrefix;
+
+  /**
+   * @brief The number of issues inserted per transaction
+   */
+  static const std::uint64_t kIssuesPerTransaction = 1000000;
+
+  /**
+   * @brief The number of issues inserted by one insert statement
+   */
+  static const std::uint64_t kIssuesPerStatement = 100;
+
+  /**
+   * @brief The constructor
+   * @param options The options of the generated dataset
+   */
+  explicit TechnicalDebtDatasetGenerator(Options options);
+
+  /**
+   * @brief Generate the dataset. An existing file is replaced. Throws, if the
+   * database cannot be written or the options are invalid.
+   * @param path The path of the generated sqlite database
+   */
+  void generate(const std::filesystem::path& path) const;
+
+ private:
+  /**
+   * @brief The options of the generated dataset
+   */
+  Options options_;
+};
+}  // namespace tdmon
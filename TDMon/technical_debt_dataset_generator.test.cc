@@ -0,0 +1,136 @@
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/technical_debt_dataset_connectable_default_td_mon_factory.h>
+#include <TDMon/technical_debt_dataset_generator.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+namespace tdmon {
+const std::string kGeneratorTestDbPath = "./generator_test.db";
+const std::string kGeneratorTestOtherDbPath = "./generator_test_other.db";
+
+/**
+ * @brief Helper function. Get all issues of a generated dataset as one string.
+ * @param path The path to the dataset
+ * @return The concatenated issues
+ */
+std::string readGeneratedIssues(const std::string& path) {
+  SQLite::Database db(path);
+  SQLite::Statement query(
+      db,
+      "SELECT KEY, PROJECT_ID, TYPE, CREATION_DATE, RESOLUTION_DATE, "
+      "ASSIGNEE, REPORTER, WATCH_COUNT FROM JIRA_ISSUES ORDER BY ROWID");
+
+  std::string issues;
+  while (query.executeStep()) {
+    for (int i = 0; i < query.getColumnCount(); ++i) {
+      issues += query.getColumn(i).getString() + ";";
+    }
+    issues += "\n";
+  }
+  return issues;
+}
+
+/**
+ * @brief Helper function. Execute a query returning a single number.
+ * @param db The database
+ * @param sql The query
+ * @return The number
+ */
+double queryNumber(SQLite::Database& db, const std::string& sql) {
+  SQLite::Statement query(db, sql);
+  query.executeStep();
+  return query.getColumn(0).getDouble();
+}
+
+TEST(TechnicalDebtDatasetGeneratorTest, GeneratesRequestedIssueCount) {
+  TechnicalDebtDatasetGenerator::Options options;
+  // not a multiple of the issues per statement
+  options.issue_count = 1234;
+  TechnicalDebtDatasetGenerator(options).generate(kGeneratorTestDbPath);
+
+  SQLite::Database db(kGeneratorTestDbPath);
+  EXPECT_EQ(queryNumber(db, "SELECT COUNT(*) FROM JIRA_ISSUES"), 1234);
+  EXPECT_EQ(queryNumber(db, "SELECT COUNT(DISTINCT KEY) FROM JIRA_ISSUES"),
+            1234);
+  EXPECT_EQ(queryNumber(db,
+                        "SELECT COUNT(*) FROM JIRA_ISSUES WHERE "
+                        "RESOLUTION_DATE IS NOT '' AND RESOLUTION_DATE < "
+                        "CREATION_DATE"),
+            0);
+}
+
+TEST(TechnicalDebtDatasetGeneratorTest, IsDeterministic) {
+  TechnicalDebtDatasetGenerator::Options options;
+  options.issue_count = 500;
+  options.seed = 42;
+  TechnicalDebtDatasetGenerator(options).generate(kGeneratorTestDbPath);
+  TechnicalDebtDatasetGenerator(options).generate(kGeneratorTestOtherDbPath);
+  EXPECT_EQ(readGeneratedIssues(kGeneratorTestDbPath),
+            readGeneratedIssues(kGeneratorTestOtherDbPath));
+
+  options.seed = 43;
+  TechnicalDebtDatasetGenerator(options).generate(kGeneratorTestOtherDbPath);
+  EXPECT_NE(readGeneratedIssues(kGeneratorTestDbPath),
+            readGeneratedIssues(kGeneratorTestOtherDbPath));
+}
+
+TEST(TechnicalDebtDatasetGeneratorTest, FollowsConfiguredDistributions) {
+  TechnicalDebtDatasetGenerator::Options options;
+  options.issue_count = 20000;
+  options.user_count = 100;
+  options.resolved_ratio = 0.5;
+  options.mean_watch_count = 3.0;
+  TechnicalDebtDatasetGenerator(options).generate(kGeneratorTestDbPath);
+
+  SQLite::Database db(kGeneratorTestDbPath);
+  const double resolved_ratio =
+      queryNumber(db,
+                  "SELECT AVG(RESOLUTION_DATE IS NOT '') FROM JIRA_ISSUES");
+  EXPECT_NEAR(resolved_ratio, 0.5, 0.02);
+
+  const double mean_watch_count =
+      queryNumber(db, "SELECT AVG(WATCH_COUNT) FROM JIRA_ISSUES");
+  EXPECT_NEAR(mean_watch_count, 3.0, 0.15);
+
+  // with a Zipf exponent of 1, the most active user has about twice as many
+  // issues as the second one
+  const std::string count_query =
+      "SELECT COUNT(*) FROM JIRA_ISSUES WHERE ASSIGNEE = ?";
+  SQLite::Statement first_user_query(db, count_query);
+  first_user_query.bind(1, TechnicalDebtDatasetGenerator::kUserPrefix + "1");
+  first_user_query.executeStep();
+  SQLite::Statement second_user_query(db, count_query);
+  second_user_query.bind(1, TechnicalDebtDatasetGenerator::kUserPrefix + "2");
+  second_user_query.executeStep();
+  const double ratio = first_user_query.getColumn(0).getDouble() /
+                       second_user_query.getColumn(0).getDouble();
+  EXPECT_NEAR(ratio, 2.0, 0.3);
+}
+
+TEST(TechnicalDebtDatasetGeneratorTest, IsReadableByFactory) {
+  TechnicalDebtDatasetGenerator::Options options;
+  options.issue_count = 1000;
+  TechnicalDebtDatasetGenerator(options).generate(kGeneratorTestDbPath);
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kGeneratorTestDbPath);
+  factory.setUserIdentifier(TechnicalDebtDatasetGenerator::kUserPrefix + "1");
+  factory.setSidecarIndexEnabled(false);
+  factory.connectToDataSources();
+  EXPECT_TRUE(factory.isConnectedToDataSources());
+  EXPECT_NO_THROW(factory.create());
+}
+
+TEST(TechnicalDebtDatasetGeneratorTest, ThrowsWithoutUsers) {
+  TechnicalDebtDatasetGenerator::Options options;
+  options.user_count = 0;
+  EXPECT_THROW(
+      TechnicalDebtDatasetGenerator(options).generate(kGeneratorTestDbPath),
+      std::runtime_error);
+}
+}  // namespace tdmon
@@ -29,8 +29,10 @@
 #include <TDMon/constants.h>
 #include <TDMon/technical_debt_dataset_access_information_container.h>
 
+#include <chrono>
 #include <concepts>
 #include <iostream>
+#include <optional>
 
 namespace tdmon {
 /**
@@ -152,6 +154,26 @@ class TechnicalDebtDatasetSetupMenu : public ApplicationState {
    */
   void cleanup(tgui::GuiSFML& gui) override { gui.remove(setup_group_); };
 
+  /**
+   * @brief Implementation of the suspend function from ApplicationState.
+   * Hides the gui elements that were added in init(). The entered access
+   * information is kept.
+   * @param gui The gui
+   */
+  void suspend(tgui::GuiSFML& /*gui*/) override {
+    setup_group_->setVisible(false);
+  };
+
+  /**
+   * @brief Implementation of the resume function from ApplicationState.
+   * Shows the gui elements that were added in init() again
+   * @param gui The gui
+   */
+  void resume(tgui::GuiSFML& /*gui*/) override {
+    next_application_state_change_ = SupportedApplicationStateChanges::kNull;
+    setup_group_->setVisible(true);
+  };
+
   /**
    * @brief Get this classes application state type
    * @return The application state type
@@ -160,6 +182,27 @@ class TechnicalDebtDatasetSetupMenu : public ApplicationState {
     return SupportedApplicationStateTypes::kSetupMenu;
   };
 
+  /**
+   * @brief The setup menu only changes in reaction to events
+   * @return false
+   */
+  bool needsUpdatesWithoutEvents() const override { return false; };
+
+  /**
+   * @brief The setup menu does not need scheduled updates
+   * @return Empty
+   */
+  std::optional<std::chrono::microseconds> getTimeUntilNextUpdate()
+      const override {
+    return std::nullopt;
+  };
+
+  /**
+   * @brief The setup menu only changes in reaction to events
+   * @return false
+   */
+  bool takeRedrawRequest() override { return false; };
+
  private:
   /**
    * @brief Store the next application state change to be requested in update().
@@ -0,0 +1,216 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/scoped_progress_handler.h>
+#include <TDMon/technical_debt_dataset_sidecar_index.h>
+
+#include <map>
+#include <stdexcept>
+
+namespace tdmon {
+TechnicalDebtDatasetSidecarIndex::TechnicalDebtDatasetSidecarIndex(
+    std::filesystem::path path_to_dataset, std::string table_name)
+    : path_to_dataset_(std::move(path_to_dataset)),
+      table_name_(std::move(table_name)) {
+  path_to_sidecar_ = path_to_dataset_;
+  path_to_sidecar_ += kSidecarFileExtension;
+}
+
+const std::filesystem::path& TechnicalDebtDatasetSidecarIndex::getPath() const {
+  return path_to_sidecar_;
+}
+
+bool TechnicalDebtDatasetSidecarIndex::isUpToDate() const {
+  if (!std::filesystem::exists(path_to_sidecar_)) {
+    return false;
+  }
+
+  try {
+    SQLite::Database sidecar(path_to_sidecar_.string(), SQLite::OPEN_READONLY);
+    SQLite::Statement metadata_query(
+        sidecar, "SELECT name, value FROM " + kMetadataTableName);
+
+    std::map<std::string, long long> metadata;
+    while (metadata_query.executeStep()) {
+      metadata[metadata_query.getColumn(0).getString()] =
+          metadata_query.getColumn(1).getInt64();
+    }
+
+    const DatabaseFileState dataset_state =
+        DatabaseFileState::read(path_to_dataset_);
+
+    return metadata.at("format_version") == kFormatVersion &&
+           metadata.at("dataset_file_size") ==
+               static_cast<long long>(dataset_state.file_size) &&
+           metadata.at("dataset_last_write_time") ==
+               dataset_state.last_write_time &&
+           metadata.at("dataset_file_change_counter") ==
+               dataset_state.file_change_counter;
+  } catch (const std::exception&) {
+    // a sidecar that cannot be read (or a dataset that cannot be read) is
+    // treated like an outdated sidecar
+    return false;
+  }
+}
+
+void TechnicalDebtDatasetSidecarIndex::rebuild(
+    const std::stop_token& stop_token,
+    const ProgressCallback& progress_callback) const {
+  // report the progress after each step and stop between the steps, too.
+  // Small steps may finish before the progress handler is called
+  auto finish_step = [&](float progress) {
+    if (progress_callback) {
+      progress_callback(progress);
+    }
+    if (stop_token.stop_requested()) {
+      throw std::runtime_error("sidecar rebuild was cancelled");
+    }
+  };
+  finish_step(0.0f);
+
+  // read the state before copying. If the dataset changes while copying, the
+  // stored state is outdated and the sidecar is rebuilt on the next check
+  const DatabaseFileState dataset_state =
+      DatabaseFileState::read(path_to_dataset_);
+
+  std::filesystem::path path_to_temporary_sidecar = path_to_sidecar_;
+  path_to_temporary_sidecar += ".tmp";
+  std::filesystem::remove(path_to_temporary_sidecar);
+
+  {
+    SQLite::Database sidecar(path_to_temporary_sidecar.string(),
+                             SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+    // the sidecar can always be rebuilt from the dataset, so there is no need
+    // for a journal while building it
+    sidecar.exec("PRAGMA journal_mode=OFF; PRAGMA synchronous=OFF;");
+
+    // interrupt copying and indexing, as soon as a stop is requested. The
+    // transaction is rolled back then, the temporary file is replaced by the
+    // next rebuild
+    ScopedProgressHandler progress_handler(sidecar, stop_token);
+
+    SQLite::Statement attach_statement(sidecar, "ATTACH DATABASE ? AS dataset");
+    attach_statement.bind(1, path_to_dataset_.string());
+    attach_statement.exec();
+
+    // the columns only used by some issue filters are copied, if the dataset
+    // has them. Otherwise, queries using them fail like on the dataset
+    std::string optional_columns;
+    std::string optional_column_definitions;
+    {
+      SQLite::Statement table_info_query(
+          sidecar,
+          "SELECT lower(name), type FROM pragma_table_info(?, 'dataset') "
+          "WHERE lower(name) IN ('creation_date', 'project_id')");
+      table_info_query.bind(1, table_name_);
+      while (table_info_query.executeStep()) {
+        const std::string column_name =
+            table_info_query.getColumn(0).getString();
+        const std::string column_type =
+            table_info_query.getColumn(1).getString();
+        optional_columns += ", " + column_name;
+        optional_column_definitions += ", " + column_name + " " + column_type;
+      }
+    }
+
+    SQLite::Transaction transaction(sidecar);
+
+    // The queries only count keys, so 'key' just stores whether the issue has
+    // a key (1) or not (NULL). This keeps the indexes below small, while still
+    // covering the queries. The rowids of the dataset are kept. The optional
+    // columns are declared with the type of the dataset, so comparisons with
+    // them behave the same
+    sidecar.exec("CREATE TABLE " + table_name_ +
+                 " (type TEXT, assignee TEXT, resolution_date TEXT, "
+                 "reporter TEXT, watch_count INTEGER, key INTEGER" +
+                 optional_column_definitions + ")");
+    sidecar.exec("INSERT INTO " + table_name_ +
+                 " (rowid, type, assignee, resolution_date, reporter, "
+                 "watch_count, key" +
+                 optional_columns +
+                 ") SELECT rowid, type, assignee, resolution_date, reporter, "
+                 "watch_count, CASE WHEN key IS NULL THEN NULL ELSE 1 END" +
+                 optional_columns + " FROM dataset." + table_name_);
+    // copying the table takes most of the time
+    finish_step(0.6f);
+
+    // covers the attack query
+    sidecar.exec("CREATE INDEX " + table_name_ + "_ASSIGNEE_INDEX ON " +
+                 table_name_ + " (type, assignee, resolution_date, key)");
+    finish_step(0.8f);
+    // covers the defense and speed queries
+    sidecar.exec("CREATE INDEX " + table_name_ + "_REPORTER_INDEX ON " +
+                 table_name_ + " (type, reporter, watch_count, key)");
+    finish_step(0.95f);
+
+    sidecar.exec("CREATE TABLE " + kMetadataTableName +
+                 " (name TEXT PRIMARY KEY, value INTEGER)");
+    SQLite::Statement metadata_statement(
+        sidecar, "INSERT INTO " + kMetadataTableName + " VALUES (?, ?)");
+    const std::map<std::string, long long> metadata = {
+        {"format_version", kFormatVersion},
+        {"dataset_file_size", static_cast<long long>(dataset_state.file_size)},
+        {"dataset_last_write_time", dataset_state.last_write_time},
+        {"dataset_file_change_counter", dataset_state.file_change_counter}};
+    for (const auto& [name, value] : metadata) {
+      metadata_statement.reset();
+      metadata_statement.bind(1, name);
+      metadata_statement.bind(2, static_cast<int64_t>(value));
+      metadata_statement.exec();
+    }
+
+    transaction.commit();
+
+    sidecar.exec("DETACH DATABASE dataset");
+  }
+
+  // replace the old sidecar, only after the new one was written completely
+  std::filesystem::rename(path_to_temporary_sidecar, path_to_sidecar_);
+  if (progress_callback) {
+    progress_callback(1.0f);
+  }
+}
+
+bool TechnicalDebtDatasetSidecarIndex::rebuildIfOutdated(
+    const std::stop_token& stop_token,
+    const ProgressCallback& progress_callback) const {
+  if (isUpToDate()) {
+    return false;
+  }
+
+  rebuild(stop_token, progress_callback);
+  return true;
+}
+
+const int TechnicalDebtDatasetSidecarIndex::kFormatVersion;
+
+const std::string TechnicalDebtDatasetSidecarIndex::kSidecarFileExtension =
+    ".tdmon-index";
+const std::string TechnicalDebtDatasetSidecarIndex::kMetadataTableName =
+    "TDMON_SIDECAR_METADATA";
+
+}  // namespace tdmon
@@ -0,0 +1,140 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+
+#pragma once
+
+#include <TDMon/database_file_state.h>
+
+#include <filesystem>
+#include <functional>
+#include <stop_token>
+#include <string>
+
+namespace tdmon {
+/**
+ * @brief A sidecar sqlite database, stored next to the technical debt dataset,
+ * which contains a copy of the columns of the dataset needed to create td-mons,
+ * together with covering indexes for the per-user queries.
+ *
+ * The technical debt dataset is opened read-only, so no indexes can be added to
+ * it directly. Without indexes, every per-user query scans the whole issues
+ * table. Queries against the sidecar are index seeks instead. The sidecar
+ * stores the state of the dataset file it was built from and is rebuilt, if the
+ * dataset changes.
+ *
+ * The sidecar contains a table with the same name and the same relevant columns
+ * as the dataset, so the same queries can be run against both. The covering
+ * indexes are on (type, assignee, resolution_date) and (type, reporter,
+ * watch_count). Since the queries only count keys, the 'key' column of the
+ * sidecar only stores whether an issue has a key, and is appended to both
+ * indexes.
+ *
+ * The columns only used by some issue filters (see IssueFilter) are copied as
+ * well, if the dataset has them. They are not part of the indexes.
+ */
+class TechnicalDebtDatasetSidecarIndex {
+ public:
+  /**
+   * @brief The extension appended to the dataset path to get the sidecar path
+   */
+  static const std::string kSidecarFileExtension;
+
+  /**
+   * @brief The name of the table inside the sidecar storing its metadata
+   */
+  static const std::string kMetadataTableName;
+
+  /**
+   * @brief The version of the sidecar layout. Sidecars with a different
+   * version are rebuilt.
+   */
+  static const int kFormatVersion = 2;
+
+  /**
+   * @brief Called with the progress of a rebuild between 0 and 1
+   */
+  using ProgressCallback = std::function<void(float)>;
+
+  /**
+   * @brief The constructor.
+   * @param path_to_dataset The path to the technical debt dataset on disk
+   * @param table_name The name of the issues table to index
+   */
+  TechnicalDebtDatasetSidecarIndex(std::filesystem::path path_to_dataset,
+                                   std::string table_name);
+
+  /**
+   * @brief Get the path of the sidecar database on disk
+   * @return The path
+   */
+  const std::filesystem::path& getPath() const;
+
+  /**
+   * @brief Check whether the sidecar exists and was built from the current
+   * state of the dataset.
+   * @return true, if the sidecar can be used
+   */
+  bool isUpToDate() const;
+
+  /**
+   * @brief Build the sidecar from the dataset. Replaces an existing sidecar.
+   * The sidecar is written to a temporary file first, so an interrupted build
+   * never leaves a partially written sidecar behind. Throws, if the dataset
+   * cannot be read or the sidecar cannot be written.
+   * @param stop_token Interrupts the rebuild, once a stop is requested. The
+   * interrupted rebuild throws and leaves the existing sidecar unchanged.
+   * @param progress_callback Called after each step of the rebuild. May be
+   * empty.
+   */
+  void rebuild(const std::stop_token& stop_token = std::stop_token(),
+               const ProgressCallback& progress_callback = nullptr) const;
+
+  /**
+   * @brief Rebuild the sidecar, if it is not up-to-date.
+   * @param stop_token Interrupts the rebuild (see rebuild())
+   * @param progress_callback Called after each step of the rebuild. May be
+   * empty.
+   * @return true, if the sidecar was rebuilt
+   */
+  bool rebuildIfOutdated(
+      const std::stop_token& stop_token = std::stop_token(),
+      const ProgressCallback& progress_callback = nullptr) const;
+
+ private:
+  /**
+   * @brief The path to the technical debt dataset on disk
+   */
+  std::filesystem::path path_to_dataset_;
+
+  /**
+   * @brief The path to the sidecar database on disk
+   */
+  std::filesystem::path path_to_sidecar_;
+
+  /**
+   * @brief The name of the issues table, both in the dataset and the sidecar
+   */
+  std::string table_name_;
+};
+}  // namespace tdmon
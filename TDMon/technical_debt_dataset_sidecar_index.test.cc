@@ -0,0 +1,279 @@
+#define SQLITECPP_COMPILE_DLL  // this is a workaround for
+                               // https://github.com/SRombauts/SQLiteCpp/issues/432
+
+#include <SQLiteCpp/SQLiteCpp.h>
+#include <TDMon/issue_filter.h>
+#include <TDMon/technical_debt_dataset_connectable_default_td_mon_factory.h>
+#include <TDMon/technical_debt_dataset_sidecar_index.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief The path to the dataset used by the sidecar index tests
+ */
+const std::string kSidecarTestDbPath = "./sidecar_test.db";
+
+/**
+ * @brief Helper function. Create the dataset used by the sidecar index tests.
+ * Removes an existing sidecar, so every test starts without one.
+ */
+void createSidecarTestDb() {
+  std::filesystem::remove(kSidecarTestDbPath);
+  std::filesystem::remove(
+      kSidecarTestDbPath +
+      TechnicalDebtDatasetSidecarIndex::kSidecarFileExtension);
+
+  SQLite::Database db(kSidecarTestDbPath,
+                      SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+  db.exec(
+      "CREATE TABLE JIRA_ISSUES (KEY TEXT, TYPE TEXT NOT NULL, ASSIGNEE TEXT "
+      "NOT NULL, RESOLUTION_DATE TEXT NOT NULL, REPORTER TEXT NOT NULL, "
+      "WATCH_COUNT INTEGER NOT NULL, DESCRIPTION TEXT);"
+      "INSERT INTO JIRA_ISSUES VALUES "
+      "('A-1','Test','Human1','2000-01-01','Human2',3,'not copied');"
+      "INSERT INTO JIRA_ISSUES VALUES "
+      "('A-2','Documentation','Human1','','Human1',2,'not copied');"
+      "INSERT INTO JIRA_ISSUES VALUES "
+      "(NULL,'Test','Human1','2000-01-01','Human1',7,'no key');");
+}
+
+/**
+ * @brief Test, if the sidecar is only reported as up-to-date after it was
+ * built, and if it contains the issues of the dataset.
+ */
+TEST(TechnicalDebtDatasetSidecarIndex, BuildsSidecar) {
+  createSidecarTestDb();
+
+  TechnicalDebtDatasetSidecarIndex sidecar_index(kSidecarTestDbPath,
+                                                 "JIRA_ISSUES");
+  EXPECT_FALSE(sidecar_index.isUpToDate());
+
+  EXPECT_TRUE(sidecar_index.rebuildIfOutdated());
+  EXPECT_TRUE(sidecar_index.isUpToDate());
+  EXPECT_TRUE(std::filesystem::exists(sidecar_index.getPath()));
+
+  // nothing to do, if the sidecar is already up-to-date
+  EXPECT_FALSE(sidecar_index.rebuildIfOutdated());
+
+  SQLite::Database sidecar(sidecar_index.getPath().string(),
+                           SQLite::OPEN_READONLY);
+  SQLite::Statement count_query(sidecar, "SELECT COUNT(key) FROM JIRA_ISSUES");
+  ASSERT_TRUE(count_query.executeStep());
+  // the issue without a key is copied, but not counted
+  EXPECT_EQ(count_query.getColumn(0).getInt(), 2);
+}
+
+/**
+ * @brief Test, if the progress of a rebuild is reported, and if a cancelled
+ * rebuild leaves no sidecar behind.
+ */
+TEST(TechnicalDebtDatasetSidecarIndex, ReportsProgressAndCancelsRebuild) {
+  createSidecarTestDb();
+
+  TechnicalDebtDatasetSidecarIndex sidecar_index(kSidecarTestDbPath,
+                                                 "JIRA_ISSUES");
+
+  // stop after copying the issues, before indexing them
+  std::stop_source stop_source;
+  EXPECT_ANY_THROW(sidecar_index.rebuild(
+      stop_source.get_token(), [&stop_source](float progress) {
+        if (progress > 0.0f) {
+          stop_source.request_stop();
+        }
+      }));
+  EXPECT_FALSE(sidecar_index.isUpToDate());
+  EXPECT_FALSE(std::filesystem::exists(sidecar_index.getPath()));
+
+  std::vector<float> progress_values;
+  EXPECT_TRUE(sidecar_index.rebuildIfOutdated(
+      std::stop_token(),
+      [&progress_values](float progress) {
+        progress_values.push_back(progress);
+      }));
+  EXPECT_TRUE(sidecar_index.isUpToDate());
+  ASSERT_FALSE(progress_values.empty());
+  EXPECT_EQ(progress_values.front(), 0.0f);
+  EXPECT_EQ(progress_values.back(), 1.0f);
+  EXPECT_TRUE(
+      std::is_sorted(progress_values.begin(), progress_values.end()));
+}
+
+/**
+ * @brief Test, if the sidecar is detected as outdated after the dataset
+ * changed, and if it contains the new data after rebuilding it.
+ */
+TEST(TechnicalDebtDatasetSidecarIndex, DetectsChangedDataset) {
+  createSidecarTestDb();
+
+  TechnicalDebtDatasetSidecarIndex sidecar_index(kSidecarTestDbPath,
+                                                 "JIRA_ISSUES");
+  sidecar_index.rebuild();
+  EXPECT_TRUE(sidecar_index.isUpToDate());
+
+  {
+    SQLite::Database db(kSidecarTestDbPath, SQLite::OPEN_READWRITE);
+    db.exec(
+        "INSERT INTO JIRA_ISSUES VALUES "
+        "('A-3','Test','Human2','','Human1',1,'');");
+  }
+
+  EXPECT_FALSE(sidecar_index.isUpToDate());
+  EXPECT_TRUE(sidecar_index.rebuildIfOutdated());
+  EXPECT_TRUE(sidecar_index.isUpToDate());
+
+  SQLite::Database sidecar(sidecar_index.getPath().string(),
+                           SQLite::OPEN_READONLY);
+  SQLite::Statement count_query(sidecar, "SELECT COUNT(key) FROM JIRA_ISSUES");
+  ASSERT_TRUE(count_query.executeStep());
+  EXPECT_EQ(count_query.getColumn(0).getInt(), 3);
+}
+
+/**
+ * @brief Test, if the per-user queries of the factory are answered from the
+ * covering indexes of the sidecar, instead of scanning the table.
+ */
+TEST(TechnicalDebtDatasetSidecarIndex, CoversPerUserQueries) {
+  createSidecarTestDb();
+
+  TechnicalDebtDatasetSidecarIndex sidecar_index(kSidecarTestDbPath,
+                                                 "JIRA_ISSUES");
+  sidecar_index.rebuild();
+
+  SQLite::Database sidecar(sidecar_index.getPath().string(),
+                           SQLite::OPEN_READONLY);
+
+  const std::string where_clause =
+      " FROM JIRA_ISSUES WHERE " +
+      IssueFilter::createDefault().createSqlCondition(2);
+  const std::string queries[] = {
+      "SELECT COUNT(key)" + where_clause +
+          " AND assignee=?1 AND resolution_date IS NOT ''",
+      "SELECT COUNT(key)" + where_clause + " AND reporter=?1",
+      "SELECT SUM(watch_count)" + where_clause + " AND reporter=?1"};
+
+  for (const std::string& query : queries) {
+    SQLite::Statement plan_query(sidecar, "EXPLAIN QUERY PLAN " + query);
+
+    std::string plan;
+    while (plan_query.executeStep()) {
+      plan += plan_query.getColumn(3).getString() + "\n";
+    }
+
+    EXPECT_NE(plan.find("COVERING INDEX"), std::string::npos) << query;
+  }
+}
+
+/**
+ * @brief Test, if the factory creates the same td-mon with and without the
+ * sidecar index.
+ */
+TEST(TechnicalDebtDatasetSidecarIndex, FactoryCreatesSameTdMonWithSidecar) {
+  createSidecarTestDb();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kSidecarTestDbPath);
+  factory.setUserIdentifier("Human1");
+
+  factory.setSidecarIndexEnabled(false);
+  std::unique_ptr<TdMon> without_sidecar = factory.create();
+
+  factory.setSidecarIndexEnabled(true);
+  std::unique_ptr<TdMon> with_sidecar = factory.create();
+
+  EXPECT_TRUE(
+      TechnicalDebtDatasetSidecarIndex(kSidecarTestDbPath, "JIRA_ISSUES")
+          .isUpToDate());
+
+  EXPECT_EQ(without_sidecar->getAttackValue(), 1);
+  EXPECT_EQ(without_sidecar->getDefenseValue(), 1);
+  EXPECT_EQ(without_sidecar->getSpeedValue(), 9);
+
+  EXPECT_EQ(with_sidecar->getAttackValue(), without_sidecar->getAttackValue());
+  EXPECT_EQ(with_sidecar->getDefenseValue(),
+            without_sidecar->getDefenseValue());
+  EXPECT_EQ(with_sidecar->getSpeedValue(), without_sidecar->getSpeedValue());
+}
+
+/**
+ * @brief Test, if stopping a td-mon creation while the sidecar is rebuilt
+ * cancels the creation, instead of querying the dataset directly.
+ */
+TEST(TechnicalDebtDatasetSidecarIndex, FactoryCancelsCreationDuringRebuild) {
+  createSidecarTestDb();
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kSidecarTestDbPath);
+  factory.setUserIdentifier("Human1");
+  factory.setSidecarIndexEnabled(true);
+
+  // the rebuild reports the first half of the progress
+  std::stop_source stop_source;
+  float stop_progress = -1.0f;
+  std::future<std::unique_ptr<TdMon>> future = factory.createAsync(
+      stop_source.get_token(), [&](float progress) {
+        if (progress > 0.0f && !stop_source.stop_requested()) {
+          stop_progress = progress;
+          stop_source.request_stop();
+        }
+      });
+
+  EXPECT_THROW(future.get(), TdMonCreationCancelledError);
+  EXPECT_GT(stop_progress, 0.0f);
+  EXPECT_LT(stop_progress, 0.5f);
+  EXPECT_FALSE(
+      TechnicalDebtDatasetSidecarIndex(kSidecarTestDbPath, "JIRA_ISSUES")
+          .isUpToDate());
+
+  // the next creation rebuilds the sidecar
+  EXPECT_EQ(factory.create()->getAttackValue(), 1);
+}
+
+/**
+ * @brief Test, if the columns used by some issue filters are copied to the
+ * sidecar, so filters using them create the same td-mon with and without the
+ * sidecar index.
+ */
+TEST(TechnicalDebtDatasetSidecarIndex, CopiesColumnsUsedByIssueFilters) {
+  createSidecarTestDb();
+  {
+    SQLite::Database db(kSidecarTestDbPath, SQLite::OPEN_READWRITE);
+    db.exec(
+        "ALTER TABLE JIRA_ISSUES ADD COLUMN PROJECT_ID INTEGER;"
+        "ALTER TABLE JIRA_ISSUES ADD COLUMN CREATION_DATE TEXT;"
+        "UPDATE JIRA_ISSUES SET PROJECT_ID=rowid, CREATION_DATE='2000-0' || "
+        "rowid;");
+  }
+
+  IssueFilter filter = IssueFilter::createDefault();
+  filter.projects = {"1", "3"};
+  filter.created_from = "2000-02";
+
+  TechnicalDebtDatasetConnectableDefaultTdMonFactory factory;
+  factory.setDatabasePath(kSidecarTestDbPath);
+  factory.setUserIdentifier("Human1");
+  factory.setIssueFilter(filter);
+
+  factory.setSidecarIndexEnabled(false);
+  std::unique_ptr<TdMon> without_sidecar = factory.create();
+
+  factory.setSidecarIndexEnabled(true);
+  std::unique_ptr<TdMon> with_sidecar = factory.create();
+
+  // only the issue without key matches
+  EXPECT_EQ(without_sidecar->getAttackValue(), 0);
+  EXPECT_EQ(without_sidecar->getDefenseValue(), 0);
+  EXPECT_EQ(without_sidecar->getSpeedValue(), 7);
+
+  EXPECT_EQ(with_sidecar->getAttackValue(), without_sidecar->getAttackValue());
+  EXPECT_EQ(with_sidecar->getDefenseValue(),
+            without_sidecar->getDefenseValue());
+  EXPECT_EQ(with_sidecar->getSpeedValue(), without_sidecar->getSpeedValue());
+}
+}  // namespace tdmon
@@ -0,0 +1,155 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/texture_manager.h>
+#include <TDMon/trace_recorder.h>
+
+#include <algorithm>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+namespace tdmon {
+TextureManager::TextureManager(std::size_t byte_budget)
+    : byte_budget_(byte_budget) {}
+
+std::vector<std::string> TextureManager::findTextures(
+    const std::filesystem::path& directory) {
+  std::vector<std::string> paths;
+  std::error_code error;
+  for (const std::filesystem::directory_entry& entry :
+       std::filesystem::directory_iterator(directory, error)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".png") {
+      paths.push_back(entry.path().string());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+void TextureManager::preload(const std::string& path) {
+  const std::string key = normalizePath(path);
+  std::unique_lock<std::mutex> lock(mutex_);
+  decode(lock, key);
+}
+
+std::shared_ptr<const sf::Texture> TextureManager::getTexture(
+    const std::string& path) {
+  const std::string key = normalizePath(path);
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  if (auto texture = textures_.find(key); texture != textures_.end()) {
+    byte_budget_.touch(key);
+    return texture->second;
+  }
+
+  decode(lock, key);
+  // another thread may have uploaded the texture while this one waited
+  if (auto texture = textures_.find(key); texture != textures_.end()) {
+    byte_budget_.touch(key);
+    return texture->second;
+  }
+  auto image = decoded_images_.find(key);
+  if (image == decoded_images_.end()) {
+    // cannot be decoded
+    return std::make_shared<const sf::Texture>();
+  }
+  // the decoded image is not needed anymore, once it is uploaded. Other
+  // threads wait for the upload, like for decoding
+  const sf::Image decoded_image = std::move(image->second);
+  decoded_images_.erase(image);
+  byte_budget_.erase(key);
+  decoding_paths_.insert(key);
+  lock.unlock();
+
+  auto texture = std::make_shared<sf::Texture>();
+  {
+    TDMON_TRACE_SCOPE("upload texture " + key);
+    texture->loadFromImage(decoded_image);
+  }
+
+  lock.lock();
+  decoding_paths_.erase(key);
+  decoded_condition_.notify_all();
+  textures_.insert_or_assign(key, texture);
+  hold(key, texture->getSize());
+  return texture;
+}
+
+bool TextureManager::isLoaded(const std::string& path) const {
+  const std::string key = normalizePath(path);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return decoded_images_.contains(key) || textures_.contains(key);
+}
+
+std::size_t TextureManager::getUsedBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return byte_budget_.getUsedBytes();
+}
+
+std::string TextureManager::normalizePath(const std::string& path) {
+  return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+void TextureManager::decode(std::unique_lock<std::mutex>& lock,
+                            const std::string& key) {
+  // another thread may decode the same file right now
+  decoded_condition_.wait(lock,
+                          [&]() { return !decoding_paths_.contains(key); });
+  if (decoded_images_.contains(key) || textures_.contains(key)) {
+    byte_budget_.touch(key);
+    return;
+  }
+
+  // decode without holding the lock, so multiple files can be decoded at once
+  decoding_paths_.insert(key);
+  lock.unlock();
+  sf::Image image;
+  bool decoded = false;
+  {
+    TDMON_TRACE_SCOPE("decode texture " + key);
+    decoded = image.loadFromFile(key);
+  }
+  lock.lock();
+  decoding_paths_.erase(key);
+  decoded_condition_.notify_all();
+
+  if (!decoded) {
+    std::cout << "cannot load texture " << key << std::endl;
+    return;
+  }
+  const sf::Vector2u size = image.getSize();
+  decoded_images_.insert_or_assign(key, std::move(image));
+  hold(key, size);
+}
+
+void TextureManager::hold(const std::string& key, sf::Vector2u size) {
+  const std::size_t bytes = std::size_t(size.x) * size.y * 4;
+  for (const std::string& evicted_key : byte_budget_.insert(key, bytes)) {
+    decoded_images_.erase(evicted_key);
+    textures_.erase(evicted_key);
+  }
+}
+
+const std::string TextureManager::kTextureDirectory = "./data";
+}  // namespace tdmon
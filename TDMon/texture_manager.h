@@ -0,0 +1,174 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <TDMon/lru_byte_budget.h>
+
+#include <SFML/Graphics.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief Loads textures once and shares them between all application states.
+ *
+ * Decoding an image file is slow and does not need an OpenGL context, so it
+ * can be done on any thread with preload(), e.g. by the StartupPipeline.
+ * Uploading the decoded image to the graphics card must happen on the thread
+ * that owns the window, which is done in getTexture(). Files are decoded at
+ * most once while they are held, so showing a texture again does not access
+ * the disk.
+ *
+ * The memory used by decoded images and textures is limited by a budget (see
+ * LruByteBudget). Once it is exceeded, the least recently used ones are
+ * released, and decoded again when they are needed.
+ */
+class TextureManager {
+ public:
+  /**
+   * @brief The default memory budget for decoded images and textures in bytes
+   */
+  static constexpr std::size_t kDefaultByteBudget = 64 * 1024 * 1024;
+
+  /**
+   * @brief The directory holding the textures of the application
+   */
+  static const std::string kTextureDirectory;
+
+  /**
+   * @brief The constructor
+   * @param byte_budget The memory budget for decoded images and textures in
+   * bytes. Each one uses 4 bytes per pixel.
+   */
+  explicit TextureManager(std::size_t byte_budget = kDefaultByteBudget);
+
+  /**
+   * @brief Find all png files in a directory
+   * @param directory The directory
+   * @return The paths of the png files, sorted. Empty, if the directory does
+   * not exist.
+   */
+  static std::vector<std::string> findTextures(
+      const std::filesystem::path& directory);
+
+  /**
+   * @brief Decode an image file, so a later call to getTexture() only has to
+   * upload it. Thread-safe. Does nothing, if the file was decoded before, and
+   * waits, if another thread decodes it right now. Failures are printed and
+   * ignored, since getTexture() tries again.
+   * @param path The path to the image file
+   */
+  void preload(const std::string& path);
+
+  /**
+   * @brief Get the texture of an image file. Uses the preloaded image, if
+   * available, or loads the file otherwise. Must be called on the thread that
+   * owns the window.
+   * @param path The path to the image file
+   * @return The texture. Empty, if the file cannot be loaded. Stays valid,
+   * even if the texture manager releases it.
+   */
+  std::shared_ptr<const sf::Texture> getTexture(const std::string& path);
+
+  /**
+   * @brief Get whether an image file is decoded or uploaded. Thread-safe.
+   * @param path The path to the image file
+   * @return true, if getTexture() does not have to access the file
+   */
+  bool isLoaded(const std::string& path) const;
+
+  /**
+   * @brief Get the memory used by decoded images and textures. Thread-safe.
+   * @return The used memory in bytes
+   */
+  std::size_t getUsedBytes() const;
+
+ private:
+  /**
+   * @brief Protects all members below
+   */
+  mutable std::mutex mutex_;
+
+  /**
+   * @brief Notified when a file is decoded or uploaded
+   */
+  std::condition_variable decoded_condition_;
+
+  /**
+   * @brief The images decoded by preload(), which were not uploaded yet. Keys
+   * are the normalized paths of the image files.
+   */
+  std::map<std::string, sf::Image> decoded_images_;
+
+  /**
+   * @brief The uploaded textures. Keys are the normalized paths of the image
+   * files.
+   */
+  std::map<std::string, std::shared_ptr<const sf::Texture>> textures_;
+
+  /**
+   * @brief The normalized paths of the files decoded or uploaded right now
+   */
+  std::set<std::string> decoding_paths_;
+
+  /**
+   * @brief Decides which decoded images and textures to release. Keys are
+   * the normalized paths of the image files.
+   */
+  LruByteBudget byte_budget_;
+
+  /**
+   * @brief Private function to normalize a path, so different spellings of the
+   * same path refer to the same texture
+   * @param path The path
+   * @return The normalized path
+   */
+  static std::string normalizePath(const std::string& path);
+
+  /**
+   * @brief Private function to decode an image file and hold the decoded
+   * image. Must be called with mutex_ locked by lock. Unlocks it while
+   * decoding.
+   * @param lock The lock of mutex_
+   * @param key The normalized path to the image file
+   */
+  void decode(std::unique_lock<std::mutex>& lock, const std::string& key);
+
+  /**
+   * @brief Private function to count the memory of an image or texture against
+   * the budget and release the ones evicted to keep it. Must be called with
+   * mutex_ locked.
+   * @param key The normalized path to the image file
+   * @param size The size of the image or texture
+   */
+  void hold(const std::string& key, sf::Vector2u size);
+};
+}  // namespace tdmon
@@ -0,0 +1,250 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#include <TDMon/atomic_file_writer.h>
+#include <TDMon/trace_recorder.h>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace tdmon {
+namespace {
+/**
+ * @brief The id of the next constructed TraceRecorder. 0 is never used, it
+ * marks threads without a cached buffer.
+ */
+std::atomic<std::uint64_t> next_recorder_id = 1;
+}  // namespace
+
+struct TraceRecorder::ThreadBufferPool {
+  /**
+   * @brief Guards all other members
+   */
+  std::mutex mutex;
+
+  /**
+   * @brief All buffers allocated so far
+   */
+  std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers;
+
+  /**
+   * @brief The buffers no thread records into
+   */
+  std::vector<ThreadBuffer*> free_thread_buffers;
+};
+
+struct TraceRecorder::ThreadBufferLease {
+  /**
+   * @brief The id of the recorder the buffer belongs to. 0, if the thread has
+   * no buffer.
+   */
+  std::uint64_t recorder_id = 0;
+
+  /**
+   * @brief The pool of the recorder the buffer belongs to. Expired, once the
+   * recorder was destroyed.
+   */
+  std::weak_ptr<ThreadBufferPool> thread_buffer_pool;
+
+  /**
+   * @brief The buffer the thread records into
+   */
+  ThreadBuffer* thread_buffer = nullptr;
+
+  /**
+   * @brief The destructor. Runs when the thread exits.
+   */
+  ~ThreadBufferLease() { release(); }
+
+  /**
+   * @brief Return the buffer to its pool, so other threads can use it
+   */
+  void release() {
+    if (std::shared_ptr<ThreadBufferPool> pool = thread_buffer_pool.lock()) {
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      pool->free_thread_buffers.push_back(thread_buffer);
+    }
+    recorder_id = 0;
+    thread_buffer_pool.reset();
+    thread_buffer = nullptr;
+  }
+};
+
+TraceRecorder::TraceRecorder()
+    : id_(next_recorder_id.fetch_add(1)),
+      construction_time_(std::chrono::steady_clock::now()),
+      thread_buffer_pool_(std::make_shared<ThreadBufferPool>()) {}
+
+TraceRecorder& TraceRecorder::getGlobal() {
+  static TraceRecorder global_recorder;
+  return global_recorder;
+}
+
+void TraceRecorder::record(const TraceEvent& event) {
+  ThreadBuffer& thread_buffer = getThreadBuffer();
+  // only this thread writes the count
+  const std::size_t event_count =
+      thread_buffer.event_count.load(std::memory_order_relaxed);
+  if (event_count == kEventsPerThread) {
+    thread_buffer.dropped_event_count.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  thread_buffer.events[event_count] = event;
+  // publish the event to toChromeTrace()
+  thread_buffer.event_count.store(event_count + 1, std::memory_order_release);
+}
+
+std::size_t TraceRecorder::getEventCount() const {
+  std::lock_guard<std::mutex> lock(thread_buffer_pool_->mutex);
+  std::size_t event_count = 0;
+  for (const std::unique_ptr<ThreadBuffer>& thread_buffer :
+       thread_buffer_pool_->thread_buffers) {
+    event_count += thread_buffer->event_count.load(std::memory_order_acquire);
+  }
+  return event_count;
+}
+
+std::size_t TraceRecorder::getDroppedEventCount() const {
+  std::lock_guard<std::mutex> lock(thread_buffer_pool_->mutex);
+  std::size_t dropped_event_count = 0;
+  for (const std::unique_ptr<ThreadBuffer>& thread_buffer :
+       thread_buffer_pool_->thread_buffers) {
+    dropped_event_count +=
+        thread_buffer->dropped_event_count.load(std::memory_order_relaxed);
+  }
+  return dropped_event_count;
+}
+
+std::size_t TraceRecorder::getThreadBufferCount() const {
+  std::lock_guard<std::mutex> lock(thread_buffer_pool_->mutex);
+  return thread_buffer_pool_->thread_buffers.size();
+}
+
+nlohmann::json TraceRecorder::toChromeTrace() const {
+  const auto to_microseconds = [](std::chrono::steady_clock::duration time) {
+    return std::chrono::duration<double, std::micro>(time).count();
+  };
+
+  nlohmann::json trace_events = nlohmann::json::array();
+  std::size_t dropped_event_count = 0;
+  {
+    std::lock_guard<std::mutex> lock(thread_buffer_pool_->mutex);
+    for (const std::unique_ptr<ThreadBuffer>& thread_buffer :
+         thread_buffer_pool_->thread_buffers) {
+      // name the thread in the trace viewer
+      trace_events.push_back(
+          {{"name", "thread_name"},
+           {"ph", "M"},
+           {"pid", 1},
+           {"tid", thread_buffer->thread_index},
+           {"args",
+            {{"name",
+              "thread " + std::to_string(thread_buffer->thread_index)}}}});
+
+      const std::size_t event_count =
+          thread_buffer->event_count.load(std::memory_order_acquire);
+      for (std::size_t i = 0; i < event_count; ++i) {
+        const TraceEvent& event = thread_buffer->events[i];
+        // complete events, which hold their start time and duration
+        trace_events.push_back(
+            {{"name", event.name.data()},
+             {"cat", "tdmon"},
+             {"ph", "X"},
+             {"ts", to_microseconds(event.start_time - construction_time_)},
+             {"dur", to_microseconds(event.duration)},
+             {"pid", 1},
+             {"tid", thread_buffer->thread_index}});
+      }
+      dropped_event_count +=
+          thread_buffer->dropped_event_count.load(std::memory_order_relaxed);
+    }
+  }
+
+  return {{"traceEvents", std::move(trace_events)},
+          {"displayTimeUnit", "ms"},
+          {"otherData", {{"dropped_events", dropped_event_count}}}};
+}
+
+void TraceRecorder::writeChromeTrace(const std::filesystem::path& path) const {
+  // truncated names may end within a multi-byte character
+  const std::string contents = toChromeTrace().dump(
+      -1, ' ', false, nlohmann::json::error_handler_t::replace);
+  AtomicFileWriter::write(path, contents);
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::getThreadBuffer() {
+  // the buffer of the recorder the calling thread recorded into last
+  thread_local ThreadBufferLease lease;
+  if (lease.recorder_id == id_) {
+    return *lease.thread_buffer;
+  }
+  // the buffer of the other recorder can be used by another thread now
+  lease.release();
+
+  ThreadBuffer* thread_buffer = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(thread_buffer_pool_->mutex);
+    if (!thread_buffer_pool_->free_thread_buffers.empty()) {
+      // new events are appended to the ones of the previous thread
+      thread_buffer = thread_buffer_pool_->free_thread_buffers.back();
+      thread_buffer_pool_->free_thread_buffers.pop_back();
+    }
+  }
+
+  if (!thread_buffer) {
+    // allocated without holding the lock, since it is large
+    auto new_thread_buffer = std::make_unique<ThreadBuffer>();
+    new_thread_buffer->events =
+        std::make_unique<TraceEvent[]>(kEventsPerThread);
+    std::lock_guard<std::mutex> lock(thread_buffer_pool_->mutex);
+    new_thread_buffer->thread_index =
+        thread_buffer_pool_->thread_buffers.size();
+    thread_buffer = new_thread_buffer.get();
+    thread_buffer_pool_->thread_buffers.push_back(
+        std::move(new_thread_buffer));
+  }
+
+  lease.recorder_id = id_;
+  lease.thread_buffer_pool = thread_buffer_pool_;
+  lease.thread_buffer = thread_buffer;
+  return *thread_buffer;
+}
+
+const std::string TraceRecorder::kTraceFilePath = "./trace.json";
+
+ScopedTrace::ScopedTrace(TraceRecorder& recorder, std::string_view name)
+    : recorder_(recorder) {
+  const std::size_t name_length =
+      std::min(name.size(), TraceRecorder::kMaxNameLength);
+  std::copy_n(name.begin(), name_length, event_.name.begin());
+  event_.name[name_length] = '\0';
+  // start last, so copying the name is not measured
+  event_.start_time = std::chrono::steady_clock::now();
+}
+
+ScopedTrace::~ScopedTrace() {
+  event_.duration = std::chrono::steady_clock::now() - event_.start_time;
+  recorder_.record(event_);
+}
+}  // namespace tdmon
@@ -0,0 +1,258 @@
+/*********************************
+ *
+ * TD-Mon - Copyright 2023 (c) Kay Leon Gonschior
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the Software), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED AS IS,
+ * WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+ * THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *********************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+
+// Record a trace event for the rest of the enclosing scope. Expands to
+// nothing, unless the build defines TDMON_ENABLE_TRACING (cmake option of the
+// same name), so the name expression is not evaluated either.
+#ifdef TDMON_ENABLE_TRACING
+#define TDMON_TRACE_CONCAT_IMPL(a, b) a##b
+#define TDMON_TRACE_CONCAT(a, b) TDMON_TRACE_CONCAT_IMPL(a, b)
+#define TDMON_TRACE_SCOPE(name)                                  \
+  ::tdmon::ScopedTrace TDMON_TRACE_CONCAT(tdmon_trace_scope_,    \
+                                          __LINE__)(             \
+      ::tdmon::TraceRecorder::getGlobal(), name)
+#else
+#define TDMON_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+namespace tdmon {
+/**
+ * @brief Records trace events (a name, a start time and a duration) of
+ * multiple threads and exports them in the Chrome trace event format, which
+ * can be opened in chrome://tracing or Perfetto.
+ *
+ * Each thread records into its own preallocated buffer, which only it writes
+ * to, so recording neither locks nor allocates memory after the first event
+ * of a thread. Events of a thread are dropped, once its buffer is full.
+ * Buffers live as long as the recorder, so events of finished threads are
+ * exported, too. When a thread exits, or records into another recorder, its
+ * buffer is handed to the next thread that needs one, so short-lived threads
+ * (e.g. of std::async) do not allocate a buffer each. Only as many buffers as
+ * threads recording at the same time are allocated.
+ *
+ * Use the TDMON_TRACE_SCOPE macro instead of this class directly, so tracing
+ * costs nothing in builds without TDMON_ENABLE_TRACING.
+ */
+class TraceRecorder {
+ public:
+  /**
+   * @brief The maximum length of an event name. Longer names are truncated.
+   */
+  static constexpr std::size_t kMaxNameLength = 63;
+
+  /**
+   * @brief The number of events each thread can record
+   */
+  static constexpr std::size_t kEventsPerThread = 16384;
+
+  /**
+   * @brief The path the trace of the application is written to
+   */
+  static const std::string kTraceFilePath;
+
+  /**
+   * @brief A recorded trace event
+   */
+  struct TraceEvent {
+    /**
+     * @brief The null-terminated name of the event
+     */
+    std::array<char, kMaxNameLength + 1> name;
+
+    /**
+     * @brief The time the event started
+     */
+    std::chrono::steady_clock::time_point start_time;
+
+    /**
+     * @brief The duration of the event
+     */
+    std::chrono::steady_clock::duration duration;
+  };
+
+  /**
+   * @brief The constructor. Event times are exported relative to the time of
+   * construction.
+   */
+  TraceRecorder();
+
+  TraceRecorder(const TraceRecorder&) = delete;
+  TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+  /**
+   * @brief Get the recorder used by TDMON_TRACE_SCOPE
+   * @return The global recorder
+   */
+  static TraceRecorder& getGlobal();
+
+  /**
+   * @brief Record an event of the calling thread. Lock-free, except for the
+   * first event of each thread, which registers the buffer of the thread.
+   * @param event The event
+   */
+  void record(const TraceEvent& event);
+
+  /**
+   * @brief Get the number of recorded events of all threads
+   * @return The number of events
+   */
+  std::size_t getEventCount() const;
+
+  /**
+   * @brief Get the number of events dropped, because the buffer of their
+   * thread was full
+   * @return The number of dropped events
+   */
+  std::size_t getDroppedEventCount() const;
+
+  /**
+   * @brief Get the number of allocated thread buffers
+   * @return The number of buffers
+   */
+  std::size_t getThreadBufferCount() const;
+
+  /**
+   * @brief Get the recorded events in the Chrome trace event format. Events
+   * may still be recorded meanwhile, they are either included or not.
+   * @return The trace as json object
+   */
+  nlohmann::json toChromeTrace() const;
+
+  /**
+   * @brief Write the recorded events to a file in the Chrome trace event
+   * format. Throws, if the file cannot be written.
+   * @param path The path of the file
+   */
+  void writeChromeTrace(const std::filesystem::path& path) const;
+
+ private:
+  /**
+   * @brief The events of a single thread
+   */
+  struct ThreadBuffer {
+    /**
+     * @brief The index of the buffer in the order the buffers were allocated.
+     * Exported as thread id, which threads that did not record at the same
+     * time may share.
+     */
+    std::size_t thread_index = 0;
+
+    /**
+     * @brief The preallocated events. Only the first event_count are valid.
+     */
+    std::unique_ptr<TraceEvent[]> events;
+
+    /**
+     * @brief The number of valid events. Only written by the owning thread,
+     * the events before it are complete once it is read.
+     */
+    std::atomic<std::size_t> event_count = 0;
+
+    /**
+     * @brief The number of events dropped, because the buffer was full
+     */
+    std::atomic<std::size_t> dropped_event_count = 0;
+  };
+
+  /**
+   * @brief All thread buffers and the ones not used by any thread. Shared with
+   * the threads, so they can return their buffer on exit, even if the
+   * recorder was destroyed before.
+   */
+  struct ThreadBufferPool;
+
+  /**
+   * @brief The buffer a thread currently records into. Thread-local.
+   */
+  struct ThreadBufferLease;
+
+  /**
+   * @brief Get the buffer of the calling thread. On the first call of the
+   * thread, a free buffer is taken from the pool, or a new one is allocated.
+   * @return The buffer
+   */
+  ThreadBuffer& getThreadBuffer();
+
+  /**
+   * @brief Identifies this recorder in the thread-local buffer lookup. Unlike
+   * the address, it is never reused by a later recorder.
+   */
+  const std::uint64_t id_;
+
+  /**
+   * @brief The time the recorder was constructed
+   */
+  const std::chrono::steady_clock::time_point construction_time_;
+
+  /**
+   * @brief The buffers of all threads, which recorded events
+   */
+  std::shared_ptr<ThreadBufferPool> thread_buffer_pool_;
+};
+
+/**
+ * @brief Records a trace event from its construction until its destruction.
+ * Created by TDMON_TRACE_SCOPE.
+ */
+class ScopedTrace {
+ public:
+  /**
+   * @brief The constructor. Starts the event.
+   * @param recorder The recorder to record the event into
+   * @param name The name of the event. Copied, so it may be a temporary.
+   */
+  ScopedTrace(TraceRecorder& recorder, std::string_view name);
+
+  /**
+   * @brief The destructor. Records the event.
+   */
+  ~ScopedTrace();
+
+  ScopedTrace(const ScopedTrace&) = delete;
+  ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+ private:
+  /**
+   * @brief The recorder to record the event into
+   */
+  TraceRecorder& recorder_;
+
+  /**
+   * @brief The event. Its duration is set on destruction.
+   */
+  TraceRecorder::TraceEvent event_;
+};
+}  // namespace tdmon
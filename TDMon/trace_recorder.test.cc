@@ -0,0 +1,158 @@
+#include <TDMon/trace_recorder.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <latch>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tdmon {
+/**
+ * @brief The path of the trace file used by the tests
+ */
+const std::filesystem::path kTestTraceFilePath = "./test_trace.json";
+
+/**
+ * @brief Test, if scoped traces are exported as complete events in the Chrome
+ * trace event format.
+ */
+TEST(TraceRecorder, ExportsScopedTracesAsCompleteEvents) {
+  TraceRecorder recorder;
+  {
+    ScopedTrace outer(recorder, "outer");
+    ScopedTrace inner(recorder, std::string("inner"));
+  }
+  EXPECT_EQ(recorder.getEventCount(), 2);
+
+  const nlohmann::json trace = recorder.toChromeTrace();
+  std::vector<nlohmann::json> complete_events;
+  for (const nlohmann::json& event : trace.at("traceEvents")) {
+    if (event.at("ph") == "X") {
+      complete_events.push_back(event);
+    }
+  }
+  ASSERT_EQ(complete_events.size(), 2);
+
+  // the inner scope ends first
+  const nlohmann::json& inner = complete_events[0];
+  const nlohmann::json& outer = complete_events[1];
+  EXPECT_EQ(inner.at("name"), "inner");
+  EXPECT_EQ(outer.at("name"), "outer");
+  EXPECT_EQ(inner.at("tid"), outer.at("tid"));
+  EXPECT_GE(inner.at("ts").get<double>(), outer.at("ts").get<double>());
+  EXPECT_LE(inner.at("ts").get<double>() + inner.at("dur").get<double>(),
+            outer.at("ts").get<double>() + outer.at("dur").get<double>());
+  EXPECT_EQ(trace.at("otherData").at("dropped_events"), 0);
+}
+
+/**
+ * @brief Test, if each thread records into its own buffer and the events of
+ * finished threads are exported.
+ */
+TEST(TraceRecorder, RecordsEventsOfMultipleThreads) {
+  TraceRecorder recorder;
+  constexpr int kThreadCount = 4;
+  constexpr int kEventsPerThread = 100;
+
+  // all threads record at the same time, so none reuses the buffer of another
+  std::latch all_recording(kThreadCount);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&recorder, &all_recording]() {
+      for (int j = 0; j < kEventsPerThread; ++j) {
+        ScopedTrace trace(recorder, "work");
+      }
+      all_recording.arrive_and_wait();
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(recorder.getEventCount(), kThreadCount * kEventsPerThread);
+  const nlohmann::json trace = recorder.toChromeTrace();
+  std::set<std::size_t> thread_ids;
+  for (const nlohmann::json& event : trace.at("traceEvents")) {
+    if (event.at("ph") == "X") {
+      thread_ids.insert(event.at("tid").get<std::size_t>());
+    }
+  }
+  EXPECT_EQ(thread_ids.size(), kThreadCount);
+}
+
+/**
+ * @brief Test, if events are dropped once the buffer of a thread is full and
+ * long names are truncated.
+ */
+TEST(TraceRecorder, ReusesBuffersOfFinishedThreads) {
+  TraceRecorder recorder;
+  constexpr int kThreadCount = 20;
+
+  // one thread after another, like the threads of std::async
+  for (int i = 0; i < kThreadCount; ++i) {
+    std::thread([&recorder]() { ScopedTrace trace(recorder, "work"); })
+        .join();
+  }
+
+  EXPECT_EQ(recorder.getEventCount(), kThreadCount);
+  EXPECT_EQ(recorder.getThreadBufferCount(), 1);
+}
+
+TEST(TraceRecorder, ReusesBuffersWhenSwitchingRecorders) {
+  TraceRecorder first_recorder;
+  TraceRecorder second_recorder;
+
+  for (int i = 0; i < 10; ++i) {
+    { ScopedTrace trace(first_recorder, "first"); }
+    { ScopedTrace trace(second_recorder, "second"); }
+  }
+
+  EXPECT_EQ(first_recorder.getEventCount(), 10);
+  EXPECT_EQ(first_recorder.getThreadBufferCount(), 1);
+  EXPECT_EQ(second_recorder.getEventCount(), 10);
+  EXPECT_EQ(second_recorder.getThreadBufferCount(), 1);
+}
+
+TEST(TraceRecorder, DropsEventsOfFullBuffersAndTruncatesNames) {
+  TraceRecorder recorder;
+  const std::string long_name(TraceRecorder::kMaxNameLength + 10, 'a');
+  for (std::size_t i = 0; i < TraceRecorder::kEventsPerThread + 3; ++i) {
+    ScopedTrace trace(recorder, long_name);
+  }
+
+  EXPECT_EQ(recorder.getEventCount(), TraceRecorder::kEventsPerThread);
+  EXPECT_EQ(recorder.getDroppedEventCount(), 3);
+
+  const nlohmann::json trace = recorder.toChromeTrace();
+  EXPECT_EQ(trace.at("otherData").at("dropped_events"), 3);
+  for (const nlohmann::json& event : trace.at("traceEvents")) {
+    if (event.at("ph") == "X") {
+      EXPECT_EQ(event.at("name"),
+                long_name.substr(0, TraceRecorder::kMaxNameLength));
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Test, if the written trace file can be parsed again.
+ */
+TEST(TraceRecorder, WritesTraceFile) {
+  std::filesystem::remove(kTestTraceFilePath);
+
+  TraceRecorder recorder;
+  { ScopedTrace trace(recorder, "write"); }
+  recorder.writeChromeTrace(kTestTraceFilePath);
+
+  std::ifstream file(kTestTraceFilePath);
+  ASSERT_TRUE(file.is_open());
+  const nlohmann::json trace = nlohmann::json::parse(file);
+  EXPECT_EQ(trace, recorder.toChromeTrace());
+
+  file.close();
+  std::filesystem::remove(kTestTraceFilePath);
+}
+}  // namespace tdmon